@@ -34,6 +34,7 @@ option (ENABLE_PYBINDS "Whether compile Python bindings" OFF)
 option (ENABLE_NODE_BINDS "Whether compile Node.js bindings" OFF)
 option (ENABLE_MOCKIMPL "Whether compile mock implementation" OFF)
 option (ENABLE_LIBAIO "Whether to enable libaio support" ON)
+option (ENABLE_IO_URING "Whether to enable io_uring support" ON)
 option (DISABLE_SSE_FORCE "Force disable sse and higher instructions" OFF)
 option (DISABLE_AVX_FORCE "Force disable avx and higher instructions" OFF)
 option (DISABLE_AVX2_FORCE "Force disable avx2 and higher instructions" OFF)
@@ -34,6 +34,25 @@ if (NOT HAVE_LIBAIO)
     add_compile_definitions (NO_LIBAIO=1)
 endif ()
 
+# io_uring is driven through the raw syscalls, only the kernel uapi header is required
+set (HAVE_IO_URING 0)
+if (ENABLE_IO_URING)
+    include (CheckCSourceCompiles)
+    check_c_source_compiles ("
+        #include <linux/io_uring.h>
+        int main(void) { return IORING_OP_READ + IORING_REGISTER_FILES_UPDATE; }
+    " IO_URING_HEADER_USABLE)
+    if (IO_URING_HEADER_USABLE)
+        set (HAVE_IO_URING 1)
+        message (STATUS "Found linux/io_uring.h, io_uring_io enabled")
+    else ()
+        message (WARNING "linux/io_uring.h not usable, io_uring_io falls back to buffer_io")
+    endif ()
+else ()
+    message (STATUS "io_uring support disabled by user")
+endif ()
+add_compile_definitions (HAVE_IO_URING=${HAVE_IO_URING})
+
 find_program (CCACHE_PROGRAM ccache)
 if (ENABLE_CCACHE)
     if (CCACHE_PROGRAM)
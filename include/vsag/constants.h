@@ -130,6 +130,8 @@ extern const char* const PYRAMID_PARAMETER_EF_SEARCH;
 extern const char* const PYRAMID_PARAMETER_SUBINDEX_EF_SEARCH;
 extern const char* const PYRAMID_NO_BUILD_LEVELS;
 extern const char* const PYRAMID_INDEX_MIN_SIZE;
+extern const char* const PYRAMID_ASYNC_BUILD;
+extern const char* const PYRAMID_MAX_BACKGROUND_BUILDS;
 
 extern const char PART_SLASH;
 extern const char PART_BAR;
@@ -190,9 +192,13 @@ extern const char* const HGRAPH_PRECISE_IO_TYPE;
 extern const char* const HGRAPH_PRECISE_FILE_PATH;
 extern const char* const HGRAPH_PARAMETER_EF_RUNTIME;
 extern const char* const HGRAPH_PARAMETER_HOPS_LIMIT;
+extern const char* const HGRAPH_PARAMETER_INTERLEAVE_COUNT;
 extern const char* const HGRAPH_EXTRA_INFO_SIZE;
 extern const char* const HGRAPH_SUPPORT_DUPLICATE;
 extern const char* const HGRAPH_SUPPORT_TOMBSTONE;
+extern const char* const HGRAPH_CONCURRENT_INSERT;
+extern const char* const HGRAPH_BLOCK_CACHE_SIZE;
+extern const char* const HGRAPH_SUPPORT_DELTA_SNAPSHOT;
 extern const char* const HGRAPH_LABEL_REMAP_TYPE;
 extern const char* const HGRAPH_USE_EXTRA_INFO_FILTER;
 extern const char* const STORE_RAW_VECTOR;
@@ -83,6 +83,20 @@ public:
     [[nodiscard]] static std::shared_ptr<Allocator>
     CreateDefaultAllocator();
 
+    /**
+     * @brief Creates an allocator that serves large blocks from huge pages.
+     *
+     * Large allocations, such as the blocks of index datacells, are carved out of one virtual
+     * reservation that is committed in chunks backed by explicit huge pages when the system
+     * huge page pool can serve them, and by transparent huge pages otherwise. Small allocations
+     * go to malloc. Indexes built with it report the arena usage and fragmentation under
+     * "allocator" in GetMemoryUsageDetail.
+     *
+     * @return std::shared_ptr<Allocator> A shared pointer to the created Allocator.
+     */
+    [[nodiscard]] static std::shared_ptr<Allocator>
+    CreateHugePageAllocator();
+
     /**
      * @brief Creates a thread pool for concurrent task execution.
      *
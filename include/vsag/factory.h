@@ -61,6 +61,38 @@ public:
     static std::shared_ptr<Reader>
     CreateLocalFileReader(const std::string& filename, int64_t base_offset, int64_t size);
 
+    /**
+     * @brief Creates a local file reader whose reads are submitted through io_uring.
+     *
+     * All readers created this way share one ring. DiskANN issues the sector reads of a beam
+     * search step through it as one batched submission, which removes most syscalls when many
+     * searches run concurrently. When io_uring is unavailable at build time or refused by the
+     * kernel, a reader equivalent to CreateLocalFileReader is returned.
+     *
+     * @param filename The path to the local file to be read.
+     * @param base_offset The offset in the file from which to start reading.
+     * @param size The number of bytes to read from the file.
+     * @return std::shared_ptr<Reader> A shared pointer to the created reader.
+     */
+    static std::shared_ptr<Reader>
+    CreateIOUringFileReader(const std::string& filename, int64_t base_offset, int64_t size);
+
+    /**
+     * @brief Creates a reader over a read-only memory mapping of the specified file.
+     *
+     * Indexes deserialized from a ReaderSet built on such readers (HGraph, and IVF when its
+     * buckets use "reader_io") do not copy their codes and graph into memory: reads are served
+     * straight from the mapping, so loading is nearly instant and the page cache is shared by
+     * every process serving the same file.
+     *
+     * @param filename The path to the local file to be mapped.
+     * @param base_offset The offset in the file from which to start mapping.
+     * @param size The number of bytes to map, 0 maps the rest of the file.
+     * @return std::shared_ptr<Reader> A shared pointer to the created reader.
+     */
+    static std::shared_ptr<Reader>
+    CreateMMapFileReader(const std::string& filename, int64_t base_offset, int64_t size);
+
 private:
     Factory() = default;
 };
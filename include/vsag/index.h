@@ -721,6 +721,9 @@ public:
      *   - id_map_func: Filter+remap function that for each source ID (int64_t) returns:
      *     * bool: true if the ID should be included in the merge
      *     * int64_t: Target ID in destination index (only valid when bool is true)
+     *
+     * HGraph copies the sub-indexes and links them into its graph in parallel on the build
+     * thread pool, and keeps answering searches while it merges.
      */
     virtual tl::expected<void, Error>
     Merge(const std::vector<MergeUnit>& merge_units) {
@@ -809,6 +812,31 @@ public:
     virtual tl::expected<void, Error>
     Deserialize(const ReaderSet& reader_set) = 0;
 
+    /**
+      * @brief Serialize the changes since the last snapshot of the index, that is the last
+      *   Serialize, Deserialize, SerializeDelta or DeserializeDelta. The delta then becomes
+      *   the last snapshot. Needs support_delta_snapshot, snapshots of one index must not be
+      *   taken concurrently
+      *
+      * @return binaryset contains the delta
+      */
+    [[nodiscard]] virtual tl::expected<BinarySet, Error>
+    SerializeDelta() {
+        throw std::runtime_error("Index doesn't support SerializeDelta");
+    }
+
+    /**
+      * @brief Apply a delta written by SerializeDelta. The index must hold exactly the snapshot
+      *   the delta is based on, a chain of deltas is applied in the order they were written.
+      *   Must not run concurrently with any write to the index
+      *
+      * @param binaryset contains the delta
+      */
+    virtual tl::expected<void, Error>
+    DeserializeDelta(const BinarySet& binary_set) {
+        throw std::runtime_error("Index doesn't support DeserializeDelta");
+    }
+
 public:
     // [serialize/deserialize with file stream]
 
@@ -834,6 +862,39 @@ public:
         throw std::runtime_error("Index not support deserialize from a file stream");
     }
 
+public:
+    // [operation log for crash recovery]
+
+    /**
+      * @brief Attach an append-only operation log file, created if it does not exist. The
+      *   records newer than the last deserialized snapshot are replayed first, then every
+      *   Add, Remove, UpdateVector, UpdateAttribute, UpdateId and UpdateExtraInfo is appended
+      *   to the log and synced before it returns. Build is not logged. Must be called before
+      *   any concurrent use of the index. Mutations of the same ids are logged in the order they
+      *   are applied, mutations of disjoint ids run concurrently and replay to the same contents.
+      *   Once a log write fails, the mutation it belongs to stays applied in memory but its call
+      *   returns an error, and every later logged mutation is rejected without being applied:
+      *   Serialize the index and attach a new log to resume writing
+      *
+      * @param path is the file of the log
+      * @param group_commit_delay_us is how long a sync waits for concurrent writers to join it,
+      *   0 syncs at once and still groups the writers queued behind a running sync
+      * @return the number of replayed operations
+      */
+    virtual tl::expected<uint64_t, Error>
+    AttachOperationLog(const std::string& path, uint64_t group_commit_delay_us = 0) {
+        throw std::runtime_error("Index doesn't support AttachOperationLog");
+    }
+
+    /**
+      * @brief Drop the log records contained in the last Serialize of this index. Call it after
+      *   that snapshot is persisted, writes are blocked while Serialize runs with a log attached
+      */
+    virtual tl::expected<void, Error>
+    CheckpointOperationLog() {
+        throw std::runtime_error("Index doesn't support CheckpointOperationLog");
+    }
+
 public:
     // [statstics methods]
 
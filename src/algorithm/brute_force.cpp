@@ -260,17 +260,12 @@ BruteForce::SearchWithRequest(const SearchRequest& request) const {
         search_func(0, total_count_, heaps[0]);
         heap = heaps[0];
     } else {
-        std::vector<std::future<void>> futures;
         auto chunk_size = (total_count_ + parallel_count - 1) / parallel_count;
-        for (auto i = 0; i < parallel_count; ++i) {
+        this->thread_pool_->ParallelFor(parallel_count, [&](uint64_t i) {
             auto start = i * chunk_size;
             auto end = std::min(start + chunk_size, total_count_);
-            auto future = this->thread_pool_->GeneralEnqueue(search_func, start, end, heaps[i]);
-            futures.emplace_back(std::move(future));
-        }
-        for (auto& future : futures) {
-            future.get();
-        }
+            search_func(start, end, heaps[i]);
+        });
         heap = heaps[0];
         for (auto i = 1; i < parallel_count; ++i) {
             heap->Merge(*heaps[i]);
@@ -359,6 +354,7 @@ BruteForce::Serialize(StreamWriter& writer) const {
     basic_info["total_count"].SetInt(total_count_);
     basic_info[INDEX_PARAM].SetString(this->create_param_ptr_->ToString());
     metadata->Set("basic_info", basic_info);
+    this->write_operation_lsn(metadata);
     auto footer = std::make_shared<Footer>(metadata);
     footer->Write(writer);
 }
@@ -396,6 +392,7 @@ BruteForce::Deserialize(StreamReader& reader) {
         }
         dim_ = basic_info["dim"].GetInt();
         total_count_ = basic_info["total_count"].GetInt();
+        this->read_operation_lsn(metadata);
 
         if (this->use_attribute_filter_ and this->attr_filter_index_ != nullptr) {
             this->attr_filter_index_->Deserialize(buffer_reader);
@@ -20,6 +20,7 @@
 
 #include <atomic>
 #include <memory>
+#include <random>
 #include <stdexcept>
 
 #include "algorithm/inner_index_interface.h"
@@ -30,6 +31,7 @@
 #include "datacell/sparse_graph_datacell.h"
 #include "dataset_impl.h"
 #include "impl/filter/filter_headers.h"
+#include "impl/allocator/huge_page_arena_allocator.h"
 #include "impl/heap/standard_heap.h"
 #include "impl/odescent/odescent_graph_builder.h"
 #include "impl/pruning_strategy.h"
@@ -37,6 +39,7 @@
 #include "index/index_impl.h"
 #include "index/iterator_filter.h"
 #include "io/reader_io_parameter.h"
+#include "storage/section_serialization.h"
 #include "storage/serialization.h"
 #include "storage/stream_reader.h"
 #include "typing.h"
@@ -46,6 +49,17 @@
 
 namespace vsag {
 
+// random, so that a delta never matches the snapshot of an unrelated index
+static uint64_t
+generate_snapshot_id() {
+    static thread_local std::mt19937_64 generator{std::random_device{}()};
+    uint64_t id = 0;
+    while (id == 0) {
+        id = generator() >> 1;  // fits the signed integers of the json metadata
+    }
+    return id;
+}
+
 static DatasetPtr
 make_empty_dataset_with_stats() {
     SearchStatistics stats;
@@ -67,10 +81,15 @@ HGraph::HGraph(const HGraphParameterPtr& hgraph_param, const vsag::IndexCommonPa
       odescent_param_(hgraph_param->odescent_param),
       graph_type_(hgraph_param->graph_type),
       hierarchical_datacell_param_(hgraph_param->hierarchical_graph_param),
+      delta_trackers_(common_param.allocator_.get()),
       use_old_serial_format_(common_param.use_old_serial_format_) {
     this->label_table_->support_tombstone_ = hgraph_param->support_tombstone;
     this->support_duplicate_ = hgraph_param->support_duplicate;
-    neighbors_mutex_ = std::make_shared<PointsMutex>(0, common_param.allocator_.get());
+    if (hgraph_param->concurrent_insert) {
+        neighbors_mutex_ = std::make_shared<PointsSpinLock>(0, common_param.allocator_.get());
+    } else {
+        neighbors_mutex_ = std::make_shared<PointsMutex>(0, common_param.allocator_.get());
+    }
     this->basic_flatten_codes_ =
         FlattenInterface::MakeInstance(hgraph_param->base_codes_param, common_param);
     if (use_reorder_) {
@@ -81,9 +100,22 @@ HGraph::HGraph(const HGraphParameterPtr& hgraph_param, const vsag::IndexCommonPa
 
     this->bottom_graph_ =
         GraphInterface::MakeInstance(hgraph_param->bottom_graph_param, common_param);
+    if (hgraph_param->bottom_graph_param->graph_storage_type_ ==
+        GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_COLOCATED) {
+        this->basic_flatten_codes_->ColocateWith(this->bottom_graph_);
+    }
     if (this->support_duplicate_) {
         this->label_table_->SetDuplicateTracker(this->bottom_graph_->GetDuplicateTracker());
     }
+    if (hgraph_param->block_cache_size > 0) {
+        this->block_cache_ =
+            std::make_shared<BlockCache>(hgraph_param->block_cache_size, allocator_);
+        this->bottom_graph_->SetBlockCache(this->block_cache_);
+        this->basic_flatten_codes_->SetBlockCache(this->block_cache_);
+        if (use_reorder_) {
+            this->high_precise_codes_->SetBlockCache(this->block_cache_);
+        }
+    }
     mult_ = 1 / log(1.0 * static_cast<double>(this->bottom_graph_->MaximumDegree()));
 
     init_resize_bit_and_reorder();
@@ -100,6 +132,10 @@ HGraph::HGraph(const HGraphParameterPtr& hgraph_param, const vsag::IndexCommonPa
         optimizer_ = std::make_shared<Optimizer<BasicSearcher>>(common_param);
     }
     check_and_init_raw_vector(hgraph_param->raw_vector_param, common_param);
+    if (hgraph_param->support_delta_snapshot) {
+        this->delta_epoch_ = DeltaTracker::MakeEpoch();
+        this->attach_delta_trackers();
+    }
     resize(bottom_graph_->max_capacity_);
 }
 void
@@ -133,6 +169,7 @@ HGraph::Build(const DatasetPtr& data) {
     if (use_elp_optimizer_) {
         elp_optimize();
     }
+    this->pin_hot_set();
     return ret;
 }
 
@@ -447,6 +484,24 @@ HGraph::map_hgraph_param(const JsonType& hgraph_json) {
             {
                 LABEL_REMAP_TYPE_KEY,
             },
+        },
+        {
+            HGRAPH_CONCURRENT_INSERT,
+            {
+                CONCURRENT_INSERT_KEY,
+            },
+        },
+        {
+            HGRAPH_BLOCK_CACHE_SIZE,
+            {
+                BLOCK_CACHE_SIZE_KEY,
+            },
+        },
+        {
+            HGRAPH_SUPPORT_DELTA_SNAPSHOT,
+            {
+                SUPPORT_DELTA_SNAPSHOT_KEY,
+            },
         }};
     const std::string hgraph_params_template =
         R"(
@@ -532,6 +587,9 @@ HGraph::map_hgraph_param(const JsonType& hgraph_json) {
         },
         "{HGRAPH_SUPPORT_DUPLICATE}": false,
         "{HGRAPH_SUPPORT_TOMBSTONE}": false,
+        "{CONCURRENT_INSERT_KEY}": false,
+        "{BLOCK_CACHE_SIZE_KEY}": 0,
+        "{SUPPORT_DELTA_SNAPSHOT_KEY}": false,
         "{EF_CONSTRUCTION_KEY}": 400
     })";
 
@@ -586,6 +644,12 @@ HGraph::Tune(const std::string& parameters, bool disable_future_tuning) {
     if (basic_flatten_codes_->GetQuantizerName() != new_basic_code->GetQuantizerName()) {
         // [case 1] base_code is not same
         is_tune_base_code = true;
+        if (param->bottom_graph_param->graph_storage_type_ ==
+            GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_COLOCATED) {
+            // the record layout of the graph is fixed by the size of the base codes
+            throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                                "can not tune the base codes of a colocated graph");
+        }
     }
     if (use_reorder_ and inner_parameter->use_reorder and
         this->high_precise_codes_->GetQuantizerName() != new_precise_code->GetQuantizerName()) {
@@ -659,6 +723,13 @@ HGraph::Tune(const std::string& parameters, bool disable_future_tuning) {
         check_and_init_raw_vector(param->raw_vector_param, common_param, false);
         init_resize_bit_and_reorder();
 
+        // the tuned codes are not in the last snapshot, the next one must be a full one
+        if (this->delta_epoch_ != nullptr) {
+            this->attach_delta_trackers();
+            std::lock_guard snapshot_lock(this->snapshot_mutex_);
+            this->snapshot_id_ = 0;
+        }
+
         // set status
         if (disable_future_tuning) {
             this->index_feature_list_->SetFeature(IndexFeature::SUPPORT_TUNE, false);
@@ -783,10 +854,9 @@ HGraph::Add(const DatasetPtr& data, AddMode mode) {
     const auto* labels = data->GetIds();
     const auto* extra_infos = data->GetExtraInfos();
     const auto* attr_sets = data->GetAttributeSets();
-    Vector<std::pair<InnerIdType, LabelType>> inner_ids(allocator_);
+    Vector<int64_t> valid_indices(allocator_);
+    UnorderedSet<LabelType> seen_labels(allocator_);
     for (int64_t j = 0; j < total; ++j) {
-        InnerIdType inner_id;
-
         // try recover tombstone
         if (this->data_type_ != DataTypes::DATA_TYPE_SPARSE) {
             auto one_base = get_single_dataset(data, j);
@@ -795,28 +865,44 @@ HGraph::Add(const DatasetPtr& data, AddMode mode) {
                 continue;
             }
         }
+        // the labels of this batch are inserted together below
+        if (not seen_labels.insert(labels[j]).second) {
+            failed_ids.emplace_back(labels[j]);
+            continue;
+        }
+        valid_indices.emplace_back(j);
+    }
+    if (valid_indices.empty()) {
+        return failed_ids;
+    }
 
-        {
-            std::scoped_lock lock(this->add_mutex_);
-            inner_id = this->get_unique_inner_ids(1).at(0);
-            if (inner_id >= total_count_) {
-                this->resize(total_count_.load() + 1);
-                ++total_count_;
+    // reserve the inner ids of the whole batch and grow the capacity once
+    Vector<InnerIdType> reserved_ids(allocator_);
+    {
+        std::scoped_lock lock(this->add_mutex_);
+        reserved_ids = this->get_unique_inner_ids(static_cast<InnerIdType>(valid_indices.size()));
+        auto current_count = total_count_.load();
+        uint64_t new_ids_count = 0;
+        for (auto inner_id : reserved_ids) {
+            if (inner_id >= current_count) {
+                ++new_ids_count;
             }
         }
+        this->resize(current_count + new_ids_count);
+        total_count_ += new_ids_count;
+    }
 
-        {
-            std::scoped_lock label_lock(this->label_lookup_mutex_);
-            this->label_table_->Insert(inner_id, labels[j]);
-            inner_ids.emplace_back(inner_id, j);
+    Vector<std::tuple<InnerIdType, int64_t, int>> inner_ids(allocator_);
+    inner_ids.reserve(valid_indices.size());
+    {
+        std::scoped_lock label_lock(this->label_lookup_mutex_);
+        for (uint64_t i = 0; i < valid_indices.size(); ++i) {
+            this->label_table_->Insert(reserved_ids[i], labels[valid_indices[i]]);
+            inner_ids.emplace_back(
+                reserved_ids[i], valid_indices[i], this->get_random_level() - 1);
         }
     }
-    for (auto& [inner_id, local_idx] : inner_ids) {
-        int level;
-        {
-            std::scoped_lock label_lock(this->label_lookup_mutex_);
-            level = this->get_random_level() - 1;
-        }
+    for (auto& [inner_id, local_idx, level] : inner_ids) {
         const auto* extra_info = extra_infos + local_idx * extra_info_size_;
         const AttributeSet* cur_attr_set = nullptr;
         if (attr_sets != nullptr) {
@@ -870,6 +956,7 @@ HGraph::KnnSearch(const DatasetPtr& query,
                   IteratorContext*& iter_ctx,
                   bool is_last_filter) const {
     SearchStatistics stats;
+    SearchStatistics::ThreadScope stats_scope(&stats);
     QueryContext ctx{.alloc = allocator_, .stats = &stats};
     if (allocator != nullptr) {
         ctx.alloc = allocator;
@@ -1057,8 +1144,11 @@ HGraph::EstimateMemory(uint64_t num_elements) const {
                                (static_cast<double>(this->bottom_graph_->maximum_degree_) / 2 + 1);
     estimate_memory += static_cast<uint64_t>(sparse_graph_memory);
 
-    auto other_memory = element_count * (sizeof(LabelType) + sizeof(std::shared_mutex) +
-                                         sizeof(std::shared_ptr<std::shared_mutex>));
+    // PointsSpinLock keeps two uint32_t per point instead of a shared_mutex
+    auto lock_memory = std::dynamic_pointer_cast<PointsSpinLock>(neighbors_mutex_) != nullptr
+                           ? 2 * sizeof(uint32_t)
+                           : sizeof(std::shared_mutex);
+    auto other_memory = element_count * (sizeof(LabelType) + lock_memory);
     estimate_memory += other_memory;
 
     return estimate_memory;
@@ -1121,6 +1211,7 @@ HGraph::RangeSearch(const DatasetPtr& query,
                     const FilterPtr& filter,
                     int64_t limited_size) const {
     SearchStatistics stats;
+    SearchStatistics::ThreadScope stats_scope(&stats);
     QueryContext ctx{.stats = &stats};
 
     auto combined_filter = std::make_shared<CombinedFilter>();
@@ -1384,6 +1475,47 @@ HGraph::deserialize_label_info(StreamReader& reader) const {
     this->label_table_->total_count_.store(static_cast<int64_t>(size));
 }
 
+void
+HGraph::deserialize_sections(StreamReader& reader,
+                             uint64_t begin,
+                             const MetadataPtr& metadata) {
+    SectionReader section_reader(this->thread_pool_.get(), this->allocator_);
+    section_reader.Add("label_table",
+                       [this](StreamReader& section) { this->deserialize_label_info(section); });
+    section_reader.Add("basic_flatten_codes", [this](StreamReader& section) {
+        this->basic_flatten_codes_->Deserialize(section);
+    });
+    section_reader.Add("bottom_graph", [this](StreamReader& section) {
+        this->bottom_graph_->Deserialize(section);
+    });
+    if (this->use_reorder_) {
+        section_reader.Add("high_precise_codes", [this](StreamReader& section) {
+            this->high_precise_codes_->Deserialize(section);
+        });
+    }
+    for (uint64_t i = 0; i < this->route_graphs_.size(); ++i) {
+        section_reader.Add(fmt::format("route_graph_{}", i), [this, i](StreamReader& section) {
+            this->route_graphs_[i]->Deserialize(section);
+        });
+    }
+    if (this->extra_info_size_ > 0 && this->extra_infos_ != nullptr) {
+        section_reader.Add("extra_infos", [this](StreamReader& section) {
+            this->extra_infos_->Deserialize(section);
+        });
+    }
+    if (this->use_attribute_filter_ and this->attr_filter_index_ != nullptr) {
+        section_reader.Add("attr_filter_index", [this](StreamReader& section) {
+            this->attr_filter_index_->Deserialize(section);
+        });
+    }
+    if (create_new_raw_vector_) {
+        section_reader.Add("raw_vector", [this](StreamReader& section) {
+            this->raw_vector_->Deserialize(section);
+        });
+    }
+    section_reader.Read(reader, begin, metadata);
+}
+
 void
 HGraph::Serialize(StreamWriter& writer) const {
     if (this->ignore_reorder_) {
@@ -1410,11 +1542,86 @@ HGraph::Serialize(StreamWriter& writer) const {
         return;
     }
 
+    // every datacell is an independent section, written concurrently when possible
+    SectionWriter section_writer(this->thread_pool_.get());
+    section_writer.Add("label_table",
+                       [this](StreamWriter& section) { this->serialize_label_info(section); });
+    section_writer.Add("basic_flatten_codes", [this](StreamWriter& section) {
+        this->basic_flatten_codes_->Serialize(section);
+    });
+    section_writer.Add("bottom_graph",
+                       [this](StreamWriter& section) { this->bottom_graph_->Serialize(section); });
+    if (this->use_reorder_) {
+        section_writer.Add("high_precise_codes", [this](StreamWriter& section) {
+            this->high_precise_codes_->Serialize(section);
+        });
+    }
+    for (uint64_t i = 0; i < this->route_graphs_.size(); ++i) {
+        section_writer.Add(fmt::format("route_graph_{}", i), [this, i](StreamWriter& section) {
+            this->route_graphs_[i]->Serialize(section);
+        });
+    }
+    if (this->extra_info_size_ > 0 && this->extra_infos_ != nullptr) {
+        section_writer.Add("extra_infos", [this](StreamWriter& section) {
+            this->extra_infos_->Serialize(section);
+        });
+    }
+    if (this->use_attribute_filter_ and this->attr_filter_index_ != nullptr) {
+        section_writer.Add("attr_filter_index", [this](StreamWriter& section) {
+            this->attr_filter_index_->Serialize(section);
+        });
+    }
+    if (create_new_raw_vector_) {
+        section_writer.Add("raw_vector", [this](StreamWriter& section) {
+            this->raw_vector_->Serialize(section);
+        });
+    }
+    auto metadata = std::make_shared<Metadata>();
+    section_writer.Write(writer, metadata);
+
+    // serialize footer (introduced since v0.15)
+    auto jsonify_basic_info = this->serialize_basic_info();
+    metadata->Set(BASIC_INFO, jsonify_basic_info);
+    if (this->support_duplicate_) {
+        metadata->Set("duplicate_format_version", 1);
+    }
+    this->write_operation_lsn(metadata);
+    if (this->delta_epoch_ != nullptr) {
+        std::lock_guard snapshot_lock(this->snapshot_mutex_);
+        if (this->pending_snapshot_id_ != 0) {
+            metadata->Set(SNAPSHOT_ID_KEY, this->pending_snapshot_id_);
+        }
+    }
+    logger::debug(jsonify_basic_info.Dump());
+
+    auto footer = std::make_shared<Footer>(metadata);
+    footer->Write(writer);
+}
+
+void
+HGraph::SerializeDelta(StreamWriter& writer) {
+    if (this->delta_epoch_ == nullptr) {
+        throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                            "SerializeDelta needs support_delta_snapshot");
+    }
+    std::lock_guard snapshot_lock(this->snapshot_mutex_);
+    if (this->snapshot_id_ == 0) {
+        throw VsagException(ErrorType::INVALID_ARGUMENT,
+                            "no snapshot to base the delta on, serialize the index in full first");
+    }
+    if (this->ignore_reorder_) {
+        this->use_reorder_ = false;
+    }
+    auto base_epoch = this->snapshot_epoch_;
+    auto epoch = DeltaTracker::Cut(this->delta_epoch_);
+    auto snapshot_id = generate_snapshot_id();
+
+    // the graph goes first, it grows the records that colocated codes are written into
     this->serialize_label_info(writer);
-    this->basic_flatten_codes_->Serialize(writer);
-    this->bottom_graph_->Serialize(writer);
+    this->bottom_graph_->SerializeDelta(writer, base_epoch);
+    this->basic_flatten_codes_->SerializeDelta(writer, base_epoch);
     if (this->use_reorder_) {
-        this->high_precise_codes_->Serialize(writer);
+        this->high_precise_codes_->SerializeDelta(writer, base_epoch);
     }
     for (const auto& route_graph : this->route_graphs_) {
         route_graph->Serialize(writer);
@@ -1426,24 +1633,26 @@ HGraph::Serialize(StreamWriter& writer) const {
         this->attr_filter_index_->Serialize(writer);
     }
     if (create_new_raw_vector_) {
-        this->raw_vector_->Serialize(writer);
+        this->raw_vector_->SerializeDelta(writer, base_epoch);
     }
 
-    // serialize footer (introduced since v0.15)
-    auto jsonify_basic_info = this->serialize_basic_info();
     auto metadata = std::make_shared<Metadata>();
-    metadata->Set(BASIC_INFO, jsonify_basic_info);
+    metadata->Set(BASIC_INFO, this->serialize_basic_info());
     if (this->support_duplicate_) {
         metadata->Set("duplicate_format_version", 1);
     }
-    logger::debug(jsonify_basic_info.Dump());
-
+    metadata->Set(BASE_SNAPSHOT_ID_KEY, this->snapshot_id_);
+    metadata->Set(SNAPSHOT_ID_KEY, snapshot_id);
     auto footer = std::make_shared<Footer>(metadata);
     footer->Write(writer);
+
+    this->snapshot_id_ = snapshot_id;
+    this->snapshot_epoch_ = epoch;
 }
 
 void
 HGraph::Deserialize(StreamReader& reader) {
+    auto begin = reader.GetCursor();
     // try to deserialize footer (only in new version)
     auto footer = Footer::Parse(reader);
 
@@ -1481,8 +1690,13 @@ HGraph::Deserialize(StreamReader& reader) {
             &reader, std::numeric_limits<uint64_t>::max(), this->allocator_);
 
         auto metadata = footer->GetMetadata();
+        if (metadata->Get(BASE_SNAPSHOT_ID_KEY).IsNumberInteger()) {
+            throw VsagException(ErrorType::INVALID_ARGUMENT,
+                                "the binary is a delta snapshot, apply it with DeserializeDelta");
+        }
         // metadata should NOT be nullptr if footer is not nullptr
         this->deserialize_basic_info(metadata->Get(BASIC_INFO));
+        this->read_operation_lsn(metadata);
 
         int64_t dup_version = 0;
         if (metadata->Get("duplicate_format_version").IsNumberInteger()) {
@@ -1490,39 +1704,52 @@ HGraph::Deserialize(StreamReader& reader) {
         }
         this->label_table_->is_legacy_duplicate_format_ = (dup_version == 0);
 
-        this->deserialize_label_info(buffer_reader);
+        if (SectionReader::Contains(metadata)) {
+            this->deserialize_sections(reader, begin, metadata);
+        } else {  // sequential layout before the datacells became sections
+            this->deserialize_label_info(buffer_reader);
 
-        this->basic_flatten_codes_->Deserialize(buffer_reader);
-        this->bottom_graph_->Deserialize(buffer_reader);
-        if (this->use_reorder_) {
-            this->high_precise_codes_->Deserialize(buffer_reader);
-        }
+            this->basic_flatten_codes_->Deserialize(buffer_reader);
+            this->bottom_graph_->Deserialize(buffer_reader);
+            if (this->use_reorder_) {
+                this->high_precise_codes_->Deserialize(buffer_reader);
+            }
 
-        for (auto& route_graph : this->route_graphs_) {
-            route_graph->Deserialize(buffer_reader);
+            for (auto& route_graph : this->route_graphs_) {
+                route_graph->Deserialize(buffer_reader);
+            }
+            if (this->extra_info_size_ > 0 && this->extra_infos_ != nullptr) {
+                this->extra_infos_->Deserialize(buffer_reader);
+            }
+            if (this->use_attribute_filter_ and this->attr_filter_index_ != nullptr) {
+                this->attr_filter_index_->Deserialize(buffer_reader);
+            }
+            if (create_new_raw_vector_) {
+                this->raw_vector_->Deserialize(buffer_reader);
+            }
         }
         auto new_size = max_capacity_.load();
         this->neighbors_mutex_->Resize(new_size);
 
         pool_ = std::make_shared<VisitedListPool>(1, allocator_, new_size, allocator_);
-
-        if (this->extra_info_size_ > 0 && this->extra_infos_ != nullptr) {
-            this->extra_infos_->Deserialize(buffer_reader);
-        }
         this->total_count_ = this->basic_flatten_codes_->TotalCount();
 
-        if (this->use_attribute_filter_ and this->attr_filter_index_ != nullptr) {
-            this->attr_filter_index_->Deserialize(buffer_reader);
-        }
-
-        if (create_new_raw_vector_) {
-            this->raw_vector_->Deserialize(buffer_reader);
-        }
         if (this->raw_vector_ != nullptr) {
             this->has_raw_vector_ = true;
         }
+
+        // the loaded index is the base of the next delta
+        if (this->delta_epoch_ != nullptr) {
+            std::lock_guard snapshot_lock(this->snapshot_mutex_);
+            this->snapshot_id_ = 0;
+            if (metadata->Get(SNAPSHOT_ID_KEY).IsNumberInteger()) {
+                this->snapshot_id_ = metadata->Get(SNAPSHOT_ID_KEY).GetInt();
+            }
+            this->snapshot_epoch_ = DeltaTracker::Cut(this->delta_epoch_);
+        }
     }
     this->cal_memory_usage();
+    this->pin_hot_set();
 
     // post serialize procedure
     if (use_elp_optimizer_) {
@@ -1530,6 +1757,113 @@ HGraph::Deserialize(StreamReader& reader) {
     }
 }
 
+void
+HGraph::DeserializeDelta(StreamReader& reader) {
+    if (this->delta_epoch_ == nullptr) {
+        throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                            "DeserializeDelta needs support_delta_snapshot");
+    }
+    auto footer = Footer::Parse(reader);
+    if (footer == nullptr or
+        not footer->GetMetadata()->Get(BASE_SNAPSHOT_ID_KEY).IsNumberInteger()) {
+        throw VsagException(ErrorType::INVALID_ARGUMENT, "the binary is not a delta snapshot");
+    }
+    auto metadata = footer->GetMetadata();
+    auto base_snapshot_id = static_cast<uint64_t>(metadata->Get(BASE_SNAPSHOT_ID_KEY).GetInt());
+
+    std::lock_guard snapshot_lock(this->snapshot_mutex_);
+    std::scoped_lock add_lock(this->add_mutex_);
+    std::scoped_lock<std::shared_mutex> wlock(this->global_mutex_);
+    if (base_snapshot_id != this->snapshot_id_) {
+        throw VsagException(
+            ErrorType::INVALID_ARGUMENT,
+            fmt::format("the delta is based on snapshot {}, but the index holds snapshot {}",
+                        base_snapshot_id,
+                        this->snapshot_id_));
+    }
+    for (const auto& tracker : this->delta_trackers_) {
+        if (not tracker->ChangedSince(this->snapshot_epoch_, this->max_capacity_).empty()) {
+            throw VsagException(ErrorType::INVALID_ARGUMENT,
+                                "the index is changed after its snapshot, can not apply a delta");
+        }
+    }
+
+    BufferStreamReader buffer_reader(
+        &reader, std::numeric_limits<uint64_t>::max(), this->allocator_);
+    // the route graphs are written in full, they are rebuilt from scratch
+    this->route_graphs_.clear();
+    this->deserialize_basic_info(metadata->Get(BASIC_INFO));
+    this->label_table_->is_legacy_duplicate_format_ = false;
+
+    this->deserialize_label_info(buffer_reader);
+    this->bottom_graph_->DeserializeDelta(buffer_reader);
+    this->basic_flatten_codes_->DeserializeDelta(buffer_reader);
+    if (this->use_reorder_) {
+        this->high_precise_codes_->DeserializeDelta(buffer_reader);
+    }
+    for (auto& route_graph : this->route_graphs_) {
+        route_graph->Deserialize(buffer_reader);
+    }
+    if (this->extra_info_size_ > 0 && this->extra_infos_ != nullptr) {
+        this->extra_infos_->Deserialize(buffer_reader);
+    }
+    if (this->use_attribute_filter_ and this->attr_filter_index_ != nullptr) {
+        this->attr_filter_index_ = AttributeInvertedInterface::MakeInstance(
+            allocator_, this->create_param_ptr_->attr_inverted_interface_param);
+        this->attr_filter_index_->Deserialize(buffer_reader);
+    }
+    if (create_new_raw_vector_) {
+        this->raw_vector_->DeserializeDelta(buffer_reader);
+    }
+
+    auto new_size = max_capacity_.load();
+    this->neighbors_mutex_->Resize(new_size);
+    pool_ = std::make_shared<VisitedListPool>(1, allocator_, new_size, allocator_);
+    this->total_count_ = this->basic_flatten_codes_->TotalCount();
+
+    this->snapshot_id_ = metadata->Get(SNAPSHOT_ID_KEY).GetInt();
+    this->snapshot_epoch_ = DeltaTracker::Cut(this->delta_epoch_);
+    this->cal_memory_usage();
+}
+
+void
+HGraph::prepare_snapshot() const {
+    if (this->delta_epoch_ == nullptr) {
+        return;
+    }
+    std::lock_guard snapshot_lock(this->snapshot_mutex_);
+    this->pending_snapshot_id_ = generate_snapshot_id();
+    this->pending_snapshot_epoch_ = DeltaTracker::Cut(this->delta_epoch_);
+}
+
+void
+HGraph::commit_snapshot() const {
+    if (this->delta_epoch_ == nullptr) {
+        return;
+    }
+    std::lock_guard snapshot_lock(this->snapshot_mutex_);
+    this->snapshot_id_ = this->pending_snapshot_id_;
+    this->snapshot_epoch_ = this->pending_snapshot_epoch_;
+}
+
+void
+HGraph::attach_delta_trackers() {
+    this->delta_trackers_.clear();
+    auto attach = [this](const auto& datacell) {
+        auto tracker = std::make_shared<DeltaTracker>(this->delta_epoch_, this->allocator_);
+        datacell->SetDeltaTracker(tracker);
+        this->delta_trackers_.emplace_back(tracker);
+    };
+    attach(this->basic_flatten_codes_);
+    attach(this->bottom_graph_);
+    if (this->use_reorder_ and this->high_precise_codes_ != nullptr) {
+        attach(this->high_precise_codes_);
+    }
+    if (this->create_new_raw_vector_ and this->raw_vector_ != nullptr) {
+        attach(this->raw_vector_);
+    }
+}
+
 std::string
 HGraph::GetMemoryUsageDetail() const {
     JsonType memory_usage;
@@ -1549,6 +1883,12 @@ HGraph::GetMemoryUsageDetail() const {
     if (this->extra_info_size_ > 0 && this->extra_infos_ != nullptr) {
         memory_usage["extra_infos"].SetInt(this->extra_infos_->CalcSerializeSize());
     }
+    if (auto* arena = HugePageArenaAllocator::Unwrap(this->allocator_); arena != nullptr) {
+        memory_usage["allocator"].SetJson(arena->GetStats().ToJson());
+    }
+    if (this->block_cache_ != nullptr) {
+        memory_usage["block_cache"].SetJson(this->block_cache_->GetStats().ToJson());
+    }
     memory_usage["__total_size__"].SetInt(this->CalSerializeSize());
     return memory_usage.Dump();
 }
@@ -1601,6 +1941,7 @@ HGraph::GetMinAndMaxId() const {
 
 void
 HGraph::add_one_point(const void* data, int level, InnerIdType inner_id) {
+    bool need_new_level = false;
     {
         std::shared_lock add_lock(add_mutex_);
         this->basic_flatten_codes_->InsertVector(data, inner_id);
@@ -1610,6 +1951,14 @@ HGraph::add_one_point(const void* data, int level, InnerIdType inner_id) {
         if (create_new_raw_vector_) {
             raw_vector_->InsertVector(data, inner_id);
         }
+        need_new_level = level >= static_cast<int>(this->route_graphs_.size()) ||
+                         bottom_graph_->TotalCount() == 0;
+    }
+    if (not need_new_level) {
+        // route graphs only grow, so the common case never needs the exclusive add lock
+        std::shared_lock rlock(this->global_mutex_);
+        this->graph_add_one(data, level, inner_id);
+        return;
     }
     std::unique_lock add_lock(add_mutex_);
     if (level >= static_cast<int>(this->route_graphs_.size()) || bottom_graph_->TotalCount() == 0) {
@@ -1733,12 +2082,15 @@ HGraph::resize(uint64_t new_size) {
     if (cur_size >= new_size_power_2) {
         return;
     }
-    std::scoped_lock lock(this->global_mutex_);
+    std::scoped_lock resize_lock(this->resize_mutex_);
     cur_size = this->max_capacity_.load();
-    if (cur_size < new_size_power_2) {
+    if (cur_size >= new_size_power_2) {
+        return;
+    }
+    if (this->support_concurrent_resize()) {
+        // the new capacity is appended as extra blocks while searches and inserts go on,
+        // ids beyond the old capacity are not handed out before max_capacity_ is published
         this->neighbors_mutex_->Resize(new_size_power_2);
-        pool_ = std::make_shared<VisitedListPool>(1, allocator_, new_size_power_2, allocator_);
-        this->label_table_->Resize(new_size_power_2);
         bottom_graph_->Resize(new_size_power_2);
         this->basic_flatten_codes_->Resize(new_size_power_2);
         if (use_reorder_) {
@@ -1750,9 +2102,50 @@ HGraph::resize(uint64_t new_size) {
         if (this->extra_infos_ != nullptr) {
             this->extra_infos_->Resize(new_size_power_2);
         }
+        auto new_pool =
+            std::make_shared<VisitedListPool>(1, allocator_, new_size_power_2, allocator_);
+
+        // only the label table is still copied, readers wait for that and the pool swap; the
+        // old pool is released by new_pool after the lock
+        std::scoped_lock lock(this->global_mutex_);
+        this->label_table_->Resize(new_size_power_2);
+        pool_.swap(new_pool);
         this->max_capacity_.store(new_size_power_2);
         this->cal_memory_usage();
+        return;
+    }
+    std::scoped_lock lock(this->global_mutex_);
+    this->neighbors_mutex_->Resize(new_size_power_2);
+    pool_ = std::make_shared<VisitedListPool>(1, allocator_, new_size_power_2, allocator_);
+    this->label_table_->Resize(new_size_power_2);
+    bottom_graph_->Resize(new_size_power_2);
+    this->basic_flatten_codes_->Resize(new_size_power_2);
+    if (use_reorder_) {
+        this->high_precise_codes_->Resize(new_size_power_2);
+    }
+    if (create_new_raw_vector_) {
+        this->raw_vector_->Resize(new_size_power_2);
+    }
+    if (this->extra_infos_ != nullptr) {
+        this->extra_infos_->Resize(new_size_power_2);
     }
+    this->max_capacity_.store(new_size_power_2);
+    this->cal_memory_usage();
+}
+
+bool
+HGraph::support_concurrent_resize() const {
+    if (not bottom_graph_->SupportConcurrentResize() or
+        not this->basic_flatten_codes_->SupportConcurrentResize()) {
+        return false;
+    }
+    if (use_reorder_ and not this->high_precise_codes_->SupportConcurrentResize()) {
+        return false;
+    }
+    if (create_new_raw_vector_ and not this->raw_vector_->SupportConcurrentResize()) {
+        return false;
+    }
+    return this->extra_infos_ == nullptr or this->extra_infos_->SupportConcurrentResize();
 }
 void
 HGraph::InitFeatures() {
@@ -1769,6 +2162,8 @@ HGraph::InitFeatures() {
         IndexFeature::SUPPORT_KNN_SEARCH,
         IndexFeature::SUPPORT_KNN_SEARCH_WITH_ID_FILTER,
         IndexFeature::SUPPORT_KNN_ITERATOR_FILTER_SEARCH,
+        IndexFeature::SUPPORT_BATCH_SEARCH,
+        IndexFeature::SUPPORT_BATCH_SEARCH_WITH_MULTI_THREAD,
     });
     // update
     if (data_type_ != DataTypes::DATA_TYPE_SPARSE) {
@@ -2199,61 +2594,170 @@ HGraph::try_recover_tombstone(const DatasetPtr& data, std::vector<int64_t>& fail
 
 void
 HGraph::Merge(const std::vector<MergeUnit>& merge_units) {
-    int64_t total_count = this->GetNumElements();
-    for (const auto& unit : merge_units) {
-        total_count += unit.index->GetNumElements();
-    }
-    if (max_capacity_ < total_count) {
-        this->resize(total_count);
-    }
+    // every unit is copied behind the current nodes at a fixed bias, so the units are copied in
+    // parallel, and the copied nodes stay unreachable from the entry point until linked below
+    Vector<std::shared_ptr<HGraph>> others(allocator_);
+    Vector<InnerIdType> biases(allocator_);
+    auto begin_count = static_cast<InnerIdType>(this->total_count_.load());
+    InnerIdType end_count = begin_count;
+    uint64_t max_level = route_graphs_.size();
     for (const auto& merge_unit : merge_units) {
-        const auto other_index = std::dynamic_pointer_cast<HGraph>(
-            std::dynamic_pointer_cast<IndexImpl<HGraph>>(merge_unit.index)->GetInnerIndex());
-        if (total_count_ == 0) {
-            this->entry_point_id_ = other_index->entry_point_id_;
+        auto index_impl = std::dynamic_pointer_cast<IndexImpl<HGraph>>(merge_unit.index);
+        CHECK_ARGUMENT(index_impl != nullptr, "merge unit must be an hgraph index");
+        auto other_index = std::dynamic_pointer_cast<HGraph>(index_impl->GetInnerIndex());
+        others.emplace_back(other_index);
+        biases.emplace_back(end_count);
+        end_count += static_cast<InnerIdType>(other_index->total_count_.load());
+        max_level = std::max(max_level, other_index->route_graphs_.size());
+    }
+    if (end_count == begin_count) {
+        return;
+    }
+    this->resize(end_count);
+    {
+        std::scoped_lock<std::shared_mutex> wlock(this->global_mutex_);
+        while (route_graphs_.size() < max_level) {
+            route_graphs_.emplace_back(this->generate_one_route_graph());
         }
-        basic_flatten_codes_->MergeOther(other_index->basic_flatten_codes_, this->total_count_);
-        label_table_->MergeOther(other_index->label_table_, merge_unit.id_map_func);
+    }
+
+    auto merge_one = [&](uint64_t i) {
+        const auto& other = others[i];
+        auto bias = biases[i];
+        basic_flatten_codes_->MergeOther(other->basic_flatten_codes_, bias);
         if (use_reorder_) {
-            high_precise_codes_->MergeOther(other_index->high_precise_codes_, this->total_count_);
+            high_precise_codes_->MergeOther(other->high_precise_codes_, bias);
         }
-        bottom_graph_->MergeOther(other_index->bottom_graph_, this->total_count_);
-        if (route_graphs_.size() < other_index->route_graphs_.size()) {
-            route_graphs_.push_back(this->generate_one_route_graph());
+        if (create_new_raw_vector_) {
+            raw_vector_->MergeOther(other->raw_vector_, bias);
         }
-        for (int j = 0; j < std::min(other_index->route_graphs_.size(), route_graphs_.size());
-             ++j) {
-            route_graphs_[j]->MergeOther(other_index->route_graphs_[j], this->total_count_);
+        bottom_graph_->MergeOther(other->bottom_graph_, bias);
+        for (uint64_t j = 0; j < other->route_graphs_.size(); ++j) {
+            route_graphs_[j]->MergeOther(other->route_graphs_[j], bias);
+        }
+    };
+    if (this->thread_pool_ != nullptr) {
+        this->thread_pool_->ParallelFor(others.size(), merge_one);
+    } else {
+        for (uint64_t i = 0; i < others.size(); ++i) {
+            merge_one(i);
         }
-        this->total_count_ += other_index->GetNumElements();
     }
-    if (this->odescent_param_ == nullptr) {
-        odescent_param_ = std::make_shared<ODescentParameter>();
+    {
+        // the label table of each unit is appended at the current end, in unit order
+        std::scoped_lock label_lock(this->label_lookup_mutex_);
+        for (uint64_t i = 0; i < others.size(); ++i) {
+            label_table_->MergeOther(others[i]->label_table_, merge_units[i].id_map_func);
+        }
     }
 
-    auto build_data = (use_reorder_ and not build_by_base_) ? this->high_precise_codes_
-                                                            : this->basic_flatten_codes_;
-    for (InnerIdType inner_id = 0; inner_id < this->total_count_; ++inner_id) {
-        Vector<InnerIdType> neighbors(this->allocator_);
-        this->bottom_graph_->GetNeighbors(inner_id, neighbors);
-        neighbors.resize(neighbors.size() / 2);
-        this->bottom_graph_->InsertNeighborsById(inner_id, neighbors);
+    // an empty target adopts the first non-empty unit as is, the other units are linked to it
+    auto link_begin = begin_count;
+    if (begin_count == 0) {
+        for (uint64_t i = 0; i < others.size(); ++i) {
+            if (others[i]->total_count_ != 0) {
+                link_begin = biases[i] + static_cast<InnerIdType>(others[i]->total_count_.load());
+                std::scoped_lock<std::shared_mutex> wlock(this->global_mutex_);
+                entry_point_id_ = others[i]->entry_point_id_ + biases[i];
+                break;
+            }
+        }
     }
-    {
-        odescent_param_->max_degree = bottom_graph_->MaximumDegree();
-        ODescent odescent_builder(
-            odescent_param_, build_data, allocator_, this->thread_pool_.get());
-        odescent_builder.Build(bottom_graph_);
-        odescent_builder.SaveGraph(bottom_graph_);
+    this->total_count_.store(end_count);
+
+    Vector<int> levels(end_count - link_begin, -1, allocator_);
+    for (uint64_t i = 0; i < others.size(); ++i) {
+        for (uint64_t j = 0; j < others[i]->route_graphs_.size(); ++j) {
+            for (auto id : others[i]->route_graphs_[j]->GetIds()) {
+                if (id + biases[i] >= link_begin) {
+                    levels[id + biases[i] - link_begin] = static_cast<int>(j);
+                }
+            }
+        }
     }
-    for (auto& graph : route_graphs_) {
-        odescent_param_->max_degree = bottom_graph_->MaximumDegree() / 2;
-        ODescent sparse_odescent_builder(
-            odescent_param_, build_data, allocator_, this->thread_pool_.get());
-        auto ids = graph->GetIds();
-        sparse_odescent_builder.Build(ids, graph);
-        sparse_odescent_builder.SaveGraph(graph);
-        this->entry_point_id_ = ids.back();
+
+    // each copied node is linked by one bounded search per layer, like an insertion that keeps
+    // the edges it already has inside its unit; searches go on under the shared lock meanwhile
+    constexpr InnerIdType LINK_CHUNK_SIZE = 1024;
+    auto chunk_count = (end_count - link_begin + LINK_CHUNK_SIZE - 1) / LINK_CHUNK_SIZE;
+    auto link_chunk = [&](uint64_t chunk) {
+        Vector<float> data(dim_, allocator_);
+        auto chunk_begin = link_begin + static_cast<InnerIdType>(chunk) * LINK_CHUNK_SIZE;
+        auto chunk_end = std::min(chunk_begin + LINK_CHUNK_SIZE, end_count);
+        std::shared_lock rlock(this->global_mutex_);
+        for (auto inner_id = chunk_begin; inner_id < chunk_end; ++inner_id) {
+            this->GetVectorByInnerId(inner_id, data.data());
+            this->link_merged_point(data.data(), levels[inner_id - link_begin], inner_id);
+        }
+    };
+    if (this->thread_pool_ != nullptr) {
+        this->thread_pool_->ParallelFor(chunk_count, link_chunk);
+    } else {
+        for (uint64_t i = 0; i < chunk_count; ++i) {
+            link_chunk(i);
+        }
+    }
+
+    // a unit may bring more route levels than the target (or than the adopted unit), the entry
+    // point moves to the highest route graph like an insertion that raises the top level
+    std::scoped_lock<std::shared_mutex> wlock(this->global_mutex_);
+    if (not route_graphs_.empty() and
+        not route_graphs_.back()->CheckIdExists(this->entry_point_id_)) {
+        auto top_ids = route_graphs_.back()->GetIds();
+        if (not top_ids.empty()) {
+            this->entry_point_id_ = top_ids.front();
+        }
+    }
+}
+
+void
+HGraph::link_merged_point(const void* data, int level, InnerIdType inner_id) {
+    auto flatten_codes = basic_flatten_codes_;
+    if (use_reorder_ and not build_by_base_) {
+        flatten_codes = high_precise_codes_;
+    }
+    InnerSearchParam param;
+    param.topk = 1;
+    param.ep = this->entry_point_id_;
+    param.ef = 1;
+    param.is_inner_id_allowed = nullptr;
+    for (auto j = static_cast<int64_t>(this->route_graphs_.size()) - 1; j > level; --j) {
+        auto result = search_one_graph(
+            data, route_graphs_[j], flatten_codes, param, (VisitedListPtr) nullptr, nullptr);
+        param.ep = result->Top().second;
+    }
+    param.ef = this->ef_construct_;
+    param.topk = static_cast<int64_t>(ef_construct_);
+
+    auto link_one_graph = [&](const GraphInterfacePtr& graph) {
+        auto result = search_one_graph(
+            data, graph, flatten_codes, param, (VisitedListPtr) nullptr, nullptr);
+        auto candidates = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+        UnorderedSet<InnerIdType> seen(allocator_);
+        while (not result->Empty()) {
+            auto [dist, id] = result->Top();
+            result->Pop();
+            if (id != inner_id and seen.insert(id).second) {
+                candidates->Push(dist, id);
+            }
+        }
+        LockGuard cur_lock(neighbors_mutex_, inner_id);
+        Vector<InnerIdType> neighbors(allocator_);
+        graph->GetNeighbors(inner_id, neighbors);
+        for (auto neighbor : neighbors) {
+            if (seen.insert(neighbor).second) {
+                candidates->Push(flatten_codes->ComputePairVectors(inner_id, neighbor), neighbor);
+            }
+        }
+        if (candidates->Empty()) {
+            return;
+        }
+        mutually_connect_new_element(
+            inner_id, candidates, graph, flatten_codes, neighbors_mutex_, allocator_, alpha_);
+    };
+    link_one_graph(this->bottom_graph_);
+    for (int64_t j = 0; j <= level; ++j) {
+        link_one_graph(route_graphs_[j]);
     }
 }
 
@@ -2294,11 +2798,13 @@ HGraph::SetIO(const std::shared_ptr<Reader> reader) {
     }
     basic_flatten_codes_->InitIO(reader_param);
     bottom_graph_->InitIO(reader_param);
+    this->pin_hot_set();
 }
 
 [[nodiscard]] DatasetPtr
 HGraph::SearchWithRequest(const SearchRequest& request) const {
     SearchStatistics stats;
+    SearchStatistics::ThreadScope stats_scope(&stats);
     QueryContext ctx{.alloc = this->allocator_, .stats = &stats};
     if (request.search_allocator_ != nullptr) {
         ctx.alloc = request.search_allocator_;
@@ -2320,6 +2826,10 @@ HGraph::SearchWithRequest(const SearchRequest& request) const {
         (1 <= params.ef_search) and (params.ef_search <= ef_search_threshold),
         fmt::format("ef_search({}) must in range[1, {}]", params.ef_search, ef_search_threshold));
 
+    if (query->GetNumElements() > 1) {
+        return this->search_batch(request, params);
+    }
+
     std::shared_lock force_remove_rlock(this->force_remove_mutex_);
     std::shared_lock shared_lock(this->global_mutex_);
 
@@ -2493,6 +3003,202 @@ HGraph::SearchWithRequest(const SearchRequest& request) const {
     return std::move(dataset_results);
 }
 
+DatasetPtr
+HGraph::search_batch(const SearchRequest& request, const HGraphSearchParameters& params) const {
+    SearchStatistics stats;
+    Allocator* result_alloc = this->allocator_;
+    if (request.search_allocator_ != nullptr) {
+        result_alloc = request.search_allocator_;
+    }
+
+    CHECK_ARGUMENT(request.expected_labels_.empty(),
+                   "expected_labels is not supported in batch search");
+
+    const auto& query = request.query_;
+    auto query_count = query->GetNumElements();
+    auto k = request.topk_;
+
+    std::shared_lock force_remove_rlock(this->force_remove_mutex_);
+    std::shared_lock shared_lock(this->global_mutex_);
+
+    // check k
+    CHECK_ARGUMENT(k > 0, fmt::format("k({}) must be greater than 0", k));
+
+    // the result is N x k even when the index holds fewer than k vectors or none, the slots a
+    // query does not fill keep id -1 and FLT_MAX; lambdas can't capture structured bindings
+    // in c++17
+    DatasetPtr dataset_results;
+    float* dists = nullptr;
+    int64_t* ids = nullptr;
+    std::tie(dataset_results, dists, ids) = create_fast_dataset(query_count * k, result_alloc);
+    dataset_results->NumElements(query_count)->Dim(k);
+    std::fill(ids, ids + query_count * k, -1);
+    std::fill(dists, dists + query_count * k, std::numeric_limits<float>::max());
+    if (this->entry_point_id_ == INVALID_ENTRY_POINT) {
+        dataset_results->Statistics(stats.Dump());
+        return dataset_results;
+    }
+
+    // filters are built once and shared by every query of the batch
+    auto combined_filter = std::make_shared<CombinedFilter>();
+    combined_filter->AppendFilter(this->label_table_->GetDeletedIdsFilter());
+    if (request.filter_ != nullptr) {
+        if (params.use_extra_info_filter) {
+            combined_filter->AppendFilter(
+                std::make_shared<ExtraInfoWrapperFilter>(request.filter_, this->extra_infos_));
+        } else {
+            combined_filter->AppendFilter(
+                std::make_shared<InnerIdWrapperFilter>(request.filter_, *this->label_table_));
+        }
+    }
+    ExecutorPtr executor = nullptr;
+    if (request.enable_attribute_filter_ and this->attr_filter_index_ != nullptr) {
+        auto& schema = this->attr_filter_index_->field_type_map_;
+        auto expr = AstParse(request.attribute_filter_str_, &schema);
+        executor = Executor::MakeInstance(this->allocator_, expr, this->attr_filter_index_);
+        executor->Init();
+        executor->Clear();
+        // the executor owns the filter, so share its lifetime through an aliasing pointer
+        combined_filter->AppendFilter(FilterPtr(executor, executor->Run()));
+    }
+    FilterPtr ft = nullptr;
+    if (not combined_filter->IsEmpty()) {
+        ft = combined_filter;
+    }
+
+    InnerSearchParam bottom_param;
+    bottom_param.ef = std::max(params.ef_search, k);
+    bottom_param.is_inner_id_allowed = ft;
+    bottom_param.topk = static_cast<int64_t>(bottom_param.ef);
+    if (params.topk_factor > 1.0F) {
+        bottom_param.topk = std::min(
+            bottom_param.topk, static_cast<int64_t>(static_cast<float>(k) * params.topk_factor));
+    }
+    bottom_param.consider_duplicate = true;
+    if (params.hops_limit > static_cast<uint32_t>(params.ef_search)) {
+        bottom_param.hops_limit = params.hops_limit;
+    }
+
+    char* extra_infos = nullptr;
+    if (extra_info_size_ > 0 && this->extra_infos_ != nullptr) {
+        extra_infos =
+            static_cast<char*>(result_alloc->Allocate(extra_info_size_ * query_count * k));
+        std::memset(extra_infos, 0, extra_info_size_ * query_count * k);
+        dataset_results->ExtraInfos(extra_infos);
+    }
+
+    auto collect_result = [&](int64_t i, DistHeapPtr& search_result, QueryContext& ctx) -> void {
+        const auto* raw_query = get_data(query, i);
+        if (use_reorder_) {
+            this->reorder(raw_query, this->high_precise_codes_, search_result, k, nullptr, ctx);
+        }
+        while (search_result->Size() > k) {
+            search_result->Pop();
+        }
+        auto offset = i * k;
+        for (auto j = static_cast<int64_t>(search_result->Size()) - 1; j >= 0; --j) {
+            const auto& top = search_result->Top();
+            dists[offset + j] = top.first;
+            ids[offset + j] = this->label_table_->GetLabelById(top.second);
+            if (extra_infos != nullptr) {
+                this->extra_infos_->GetExtraInfoById(
+                    top.second, extra_infos + extra_info_size_ * (offset + j));
+            }
+            search_result->Pop();
+        }
+    };
+
+    auto interleave_count = std::max<int64_t>(params.interleave_count, 1);
+
+    // the queries of one worker share visited lists and the parsed search parameters, and
+    // every interleave_count queries of them traverse the bottom graph together
+    auto search_range = [&](int64_t begin, int64_t end, Allocator* alloc) -> void {
+        SearchStatistics::ThreadScope stats_scope(&stats);
+        QueryContext ctx{.alloc = alloc, .stats = &stats};
+        std::vector<VisitedListPtr> vts;
+        for (int64_t i = 0; i < std::min(interleave_count, end - begin); ++i) {
+            vts.emplace_back(this->pool_->TakeOne());
+        }
+        std::vector<const void*> group_queries;
+        std::vector<InnerSearchParam> group_params;
+        for (int64_t group_begin = begin; group_begin < end; group_begin += interleave_count) {
+            auto group_end = std::min(group_begin + interleave_count, end);
+            group_queries.clear();
+            group_params.clear();
+            for (int64_t i = group_begin; i < group_end; ++i) {
+                const auto* raw_query = get_data(query, i);
+                InnerSearchParam route_param;
+                route_param.ep = this->entry_point_id_;
+                route_param.topk = 1;
+                route_param.ef = 1;
+                for (auto j = static_cast<int64_t>(this->route_graphs_.size() - 1); j >= 0;
+                     --j) {
+                    auto result = this->search_one_graph(raw_query,
+                                                         this->route_graphs_[j],
+                                                         this->basic_flatten_codes_,
+                                                         route_param,
+                                                         vts[0],
+                                                         &ctx);
+                    route_param.ep = result->Top().second;
+                }
+                group_queries.emplace_back(raw_query);
+                group_params.emplace_back(bottom_param);
+                group_params.back().ep = route_param.ep;
+                if (params.enable_time_record) {
+                    group_params.back().time_cost = std::make_shared<Timer>();
+                    group_params.back().time_cost->SetThreshold(params.timeout_ms);
+                }
+            }
+
+            if (group_queries.size() == 1) {
+                auto search_result = this->search_one_graph(group_queries[0],
+                                                            this->bottom_graph_,
+                                                            this->basic_flatten_codes_,
+                                                            group_params[0],
+                                                            vts[0],
+                                                            &ctx);
+                collect_result(group_begin, search_result, ctx);
+                continue;
+            }
+
+            std::vector<VisitedListPtr> group_vts(vts.begin(),
+                                                  vts.begin() + (group_end - group_begin));
+            for (const auto& vt : group_vts) {
+                vt->Reset();
+            }
+            auto results = this->searcher_->SearchInterleaved(this->bottom_graph_,
+                                                              this->basic_flatten_codes_,
+                                                              group_vts,
+                                                              group_queries,
+                                                              group_params,
+                                                              &ctx);
+            for (int64_t i = group_begin; i < group_end; ++i) {
+                collect_result(i, results[i - group_begin], ctx);
+            }
+        }
+        for (auto& vt : vts) {
+            this->pool_->ReturnOne(vt);
+        }
+    };
+
+    auto worker_count = std::min(params.parallel_search_thread_count, query_count);
+    if (worker_count <= 1 or this->thread_pool_ == nullptr) {
+        search_range(0, query_count, result_alloc);
+    } else {
+        // the search allocator is not required to be thread-safe, use the index allocator
+        // for the temporary structures of the workers
+        auto step = (query_count + worker_count - 1) / worker_count;
+        auto chunk_count = (query_count + step - 1) / step;
+        this->thread_pool_->ParallelFor(chunk_count, [&](uint64_t i) {
+            auto begin = static_cast<int64_t>(i) * step;
+            search_range(begin, std::min(begin + step, query_count), this->allocator_);
+        });
+    }
+
+    dataset_results->Statistics(stats.Dump());
+    return std::move(dataset_results);
+}
+
 void
 HGraph::UpdateAttribute(int64_t id, const AttributeSet& new_attrs) {
     auto inner_id = this->label_table_->GetIdByLabel(id);
@@ -2687,8 +3393,39 @@ HGraph::cal_memory_usage() {
         memory += raw_vector_->GetMemoryUsage();
     }
 
+    if (this->block_cache_ != nullptr) {
+        memory += this->block_cache_->GetStats().capacity_bytes;
+    }
+
     std::unique_lock lock(this->memory_usage_mutex_);
     this->current_memory_usage_.store(static_cast<int64_t>(memory));
 }
 
+void
+HGraph::pin_hot_set() {
+    if (this->block_cache_ == nullptr or this->entry_point_id_ == INVALID_ENTRY_POINT) {
+        return;
+    }
+    // every search enters through the route graphs and the entry point, so their neighbor
+    // lists and codes are read by every query; the cache caps how much of it stays pinned
+    auto pin = [&](InnerIdType id) {
+        auto pinned = this->bottom_graph_->PinInBlockCache(id);
+        this->basic_flatten_codes_->PinInBlockCache(id);
+        return pinned;
+    };
+    Vector<InnerIdType> neighbors(allocator_);
+    // a disk-resident graph that is not pinned waits for SetIO and can not be read yet
+    if (pin(this->entry_point_id_) or this->bottom_graph_->InMemory()) {
+        this->bottom_graph_->GetNeighbors(this->entry_point_id_, neighbors);
+    }
+    for (const auto& neighbor : neighbors) {
+        pin(neighbor);
+    }
+    for (auto level = static_cast<int64_t>(this->route_graphs_.size()) - 1; level >= 0; --level) {
+        for (const auto& id : this->route_graphs_[level]->GetIds()) {
+            pin(id);
+        }
+    }
+}
+
 }  // namespace vsag
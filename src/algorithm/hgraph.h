@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <random>
 #include <shared_mutex>
 #include <string>
@@ -35,7 +36,9 @@
 #include "index_common_param.h"
 #include "index_feature_list.h"
 #include "inner_index_interface.h"
+#include "storage/serialization.h"
 #include "typing.h"
+#include "utils/delta_tracker.h"
 #include "utils/lock_strategy.h"
 #include "utils/util_functions.h"
 #include "utils/visited_list.h"
@@ -87,6 +90,9 @@ public:
     void
     Deserialize(StreamReader& reader) override;
 
+    void
+    DeserializeDelta(StreamReader& reader) override;
+
     InnerIndexPtr
     ExportModel(const IndexCommonParam& param) const override;
 
@@ -180,6 +186,9 @@ public:
     void
     Serialize(StreamWriter& writer) const override;
 
+    void
+    SerializeDelta(StreamWriter& writer) override;
+
     void
     SetBuildThreadsCount(uint64_t count) {
         this->build_thread_count_ = count;
@@ -259,9 +268,16 @@ public:
     bool
     graph_add_one(const void* data, int level, InnerIdType inner_id);
 
+    // links a node copied in by Merge into the graphs it belongs to, keeping its own edges
+    void
+    link_merged_point(const void* data, int level, InnerIdType inner_id);
+
     void
     resize(uint64_t new_size);
 
+    [[nodiscard]] bool
+    support_concurrent_resize() const;
+
     GraphInterfacePtr
     generate_one_route_graph();
 
@@ -286,6 +302,15 @@ public:
                      QueryContext* ctx) const;
 
 private:
+    void
+    prepare_snapshot() const override;
+
+    void
+    commit_snapshot() const override;
+
+    void
+    attach_delta_trackers();
+
     // since v0.15
     JsonType
     serialize_basic_info() const;
@@ -299,6 +324,9 @@ private:
     void
     deserialize_label_info(StreamReader& reader) const;
 
+    void
+    deserialize_sections(StreamReader& reader, uint64_t begin, const MetadataPtr& metadata);
+
     // used in version [0.12.*, 0.14.*]
     void
     serialize_basic_info_v0_14(StreamWriter& writer) const;
@@ -344,6 +372,9 @@ private:
     DatasetPtr
     get_single_dataset(const DatasetPtr& data, uint32_t j);
 
+    DatasetPtr
+    search_batch(const SearchRequest& request, const HGraphSearchParameters& params) const;
+
 private:
     void
     check_and_init_raw_vector(const FlattenInterfaceParamPtr& raw_vector_param,
@@ -356,12 +387,18 @@ private:
     void
     cal_memory_usage();
 
+    void
+    pin_hot_set();
+
 private:
     FlattenInterfacePtr basic_flatten_codes_{nullptr};
     FlattenInterfacePtr high_precise_codes_{nullptr};
 
     Vector<GraphInterfacePtr> route_graphs_;
     GraphInterfacePtr bottom_graph_{nullptr};
+
+    // shared by the disk-resident datacells, nullptr when block_cache_size is 0
+    BlockCachePtr block_cache_{nullptr};
     SparseGraphDatacellParamPtr hierarchical_datacell_param_{nullptr};
 
     bool use_elp_optimizer_{false};
@@ -390,6 +427,8 @@ private:
     mutable MutexArrayPtr neighbors_mutex_;
     mutable std::shared_mutex add_mutex_;
     mutable std::shared_mutex force_remove_mutex_;
+    // serializes resize, which grows the datacells before taking global_mutex_
+    std::mutex resize_mutex_;
 
     std::atomic<InnerIdType> max_capacity_{0};
 
@@ -405,6 +444,19 @@ private:
     bool create_new_raw_vector_{false};
     FlattenInterfacePtr raw_vector_{nullptr};
 
+    // stamps the changes of the datacells for delta snapshots, nullptr unless
+    // support_delta_snapshot is set
+    DeltaTracker::EpochPtr delta_epoch_{nullptr};
+    Vector<DeltaTrackerPtr> delta_trackers_;
+
+    // the snapshot the next delta is based on, snapshot_id_ is 0 when there is none
+    mutable std::mutex snapshot_mutex_;
+    mutable uint64_t snapshot_id_{0};
+    mutable uint32_t snapshot_epoch_{0};
+    // cut by prepare_snapshot for the full serialization in progress
+    mutable uint64_t pending_snapshot_id_{0};
+    mutable uint32_t pending_snapshot_epoch_{0};
+
     ReorderInterfacePtr reorder_{nullptr};
 
     bool use_old_serial_format_{false};
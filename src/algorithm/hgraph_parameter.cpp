@@ -72,8 +72,12 @@ HGraphParameter::FromJson(const JsonType& json) {
         if (graph_storage_type_str == GRAPH_STORAGE_TYPE_VALUE_COMPRESSED) {
             graph_storage_type = GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_COMPRESSED;
         }
+        if (graph_storage_type_str == GRAPH_STORAGE_TYPE_VALUE_COLOCATED) {
+            graph_storage_type = GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_COLOCATED;
+        }
 
         if (graph_storage_type_str != GRAPH_STORAGE_TYPE_VALUE_COMPRESSED &&
+            graph_storage_type_str != GRAPH_STORAGE_TYPE_VALUE_COLOCATED &&
             graph_storage_type_str != GRAPH_STORAGE_TYPE_VALUE_FLAT) {
             throw VsagException(
                 ErrorType::INVALID_ARGUMENT,
@@ -82,10 +86,18 @@ HGraphParameter::FromJson(const JsonType& json) {
     }
     this->bottom_graph_param =
         GraphInterfaceParameter::GetGraphParameterByJson(graph_storage_type, graph_json);
+    if (graph_storage_type == GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_COLOCATED) {
+        // the base codes are stored inside the graph records, so they follow the graph io
+        auto graph_param =
+            std::dynamic_pointer_cast<GraphDataCellParameter>(this->bottom_graph_param);
+        this->base_codes_param->io_parameter = graph_param->io_parameter_;
+        this->base_codes_param->colocated = true;
+    }
 
     hierarchical_graph_param = std::make_shared<SparseGraphDatacellParameter>();
     hierarchical_graph_param->max_degree_ = this->bottom_graph_param->max_degree_ / 2;
-    if (graph_storage_type == GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_FLAT) {
+    if (graph_storage_type == GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_FLAT or
+        graph_storage_type == GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_COLOCATED) {
         auto graph_param =
             std::dynamic_pointer_cast<GraphDataCellParameter>(this->bottom_graph_param);
         if (graph_param != nullptr) {
@@ -128,6 +140,15 @@ HGraphParameter::FromJson(const JsonType& json) {
     if (json.Contains(SUPPORT_TOMBSTONE)) {
         this->support_tombstone = json[SUPPORT_TOMBSTONE].GetBool();
     }
+    if (json.Contains(CONCURRENT_INSERT_KEY)) {
+        this->concurrent_insert = json[CONCURRENT_INSERT_KEY].GetBool();
+    }
+    if (json.Contains(BLOCK_CACHE_SIZE_KEY)) {
+        this->block_cache_size = json[BLOCK_CACHE_SIZE_KEY].GetInt();
+    }
+    if (json.Contains(SUPPORT_DELTA_SNAPSHOT_KEY)) {
+        this->support_delta_snapshot = json[SUPPORT_DELTA_SNAPSHOT_KEY].GetBool();
+    }
 }
 
 JsonType
@@ -142,6 +163,9 @@ HGraphParameter::ToJson() const {
     json[EF_CONSTRUCTION_KEY].SetInt(this->ef_construction);
     json[ALPHA_KEY].SetFloat(this->alpha);
     json[SUPPORT_DUPLICATE].SetBool(this->support_duplicate);
+    json[CONCURRENT_INSERT_KEY].SetBool(this->concurrent_insert);
+    json[BLOCK_CACHE_SIZE_KEY].SetInt(static_cast<int64_t>(this->block_cache_size));
+    json[SUPPORT_DELTA_SNAPSHOT_KEY].SetBool(this->support_delta_snapshot);
     json[TRAIN_SAMPLE_COUNT_KEY].SetInt(this->train_sample_count);
     return json;
 }
@@ -211,6 +235,14 @@ HGraphSearchParameters::FromJson(const std::string& json_string) {
         obj.use_extra_info_filter =
             params[INDEX_TYPE_HGRAPH][HGRAPH_USE_EXTRA_INFO_FILTER].GetBool();
     }
+    if (params[INDEX_TYPE_HGRAPH].Contains(HGRAPH_PARAMETER_INTERLEAVE_COUNT)) {
+        obj.interleave_count =
+            params[INDEX_TYPE_HGRAPH][HGRAPH_PARAMETER_INTERLEAVE_COUNT].GetInt();
+        CHECK_ARGUMENT(obj.interleave_count >= 1,
+                       fmt::format("{}({}) must be greater than 0",
+                                   HGRAPH_PARAMETER_INTERLEAVE_COUNT,
+                                   obj.interleave_count));
+    }
 
     return obj;
 }
@@ -65,6 +65,15 @@ public:
     bool support_duplicate{false};
     bool support_tombstone{false};
 
+    // guard the graph with PointsSpinLock and read neighbors optimistically
+    bool concurrent_insert{false};
+
+    // bytes of the block cache shared by the disk-resident datacells, 0 disables it
+    uint64_t block_cache_size{0};
+
+    // track the changed nodes, so that SerializeDelta writes only them
+    bool support_delta_snapshot{false};
+
     DataTypes data_type{DataTypes::DATA_TYPE_FLOAT};
 
     std::string name;
@@ -81,6 +90,9 @@ public:
     bool use_reorder{false};
     bool use_extra_info_filter{false};
 
+    // only for batch search, the number of queries traversing the graph together in one thread
+    int64_t interleave_count{1};
+
 private:
     HGraphSearchParameters() = default;
 };
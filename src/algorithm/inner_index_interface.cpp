@@ -24,6 +24,7 @@
 #include "index_common_param.h"
 #include "index_detail_data.h"
 #include "index_feature_list.h"
+#include "inner_string_params.h"
 #include "storage/empty_index_binary_set.h"
 #include "storage/serialization.h"
 #include "utils/slow_task_timer.h"
@@ -147,6 +148,8 @@ InnerIndexInterface::Serialize() const {
     std::string time_record_name = this->GetName() + " Serialize";
     SlowTaskTimer t(time_record_name);
 
+    auto log_lock = this->lock_operation_log();
+    this->prepare_snapshot();
     uint64_t num_bytes = this->CalSerializeSize();
     // TODO(LHT): use try catch
 
@@ -154,6 +157,8 @@ InnerIndexInterface::Serialize() const {
     auto* buffer = reinterpret_cast<char*>(const_cast<int8_t*>(bin.get()));
     BufferStreamWriter writer(buffer);
     this->Serialize(writer);
+    this->commit_snapshot();
+    this->serialized_operation_lsn_.store(this->current_operation_lsn());
     Binary b{
         .data = bin,
         .size = num_bytes,
@@ -164,13 +169,45 @@ InnerIndexInterface::Serialize() const {
     return bs;
 }
 
+BinarySet
+InnerIndexInterface::SerializeDelta() {
+    std::string time_record_name = this->GetName() + " SerializeDelta";
+    SlowTaskTimer t(time_record_name);
+
+    // written in one pass, the nodes changed while measuring would not fit a measured buffer
+    std::vector<char> buffer;
+    WriteFuncStreamWriter writer(
+        [&buffer](uint64_t cursor, uint64_t size, void* data) {
+            if (buffer.size() < cursor + size) {
+                buffer.resize(cursor + size);
+            }
+            std::memcpy(buffer.data() + cursor, data, size);
+        },
+        0);
+    this->SerializeDelta(writer);
+
+    std::shared_ptr<int8_t[]> bin(new int8_t[buffer.size()]);
+    std::memcpy(bin.get(), buffer.data(), buffer.size());
+    Binary b{
+        .data = bin,
+        .size = buffer.size(),
+    };
+    BinarySet bs;
+    bs.Set(this->GetName(), b);
+    return bs;
+}
+
 void
 InnerIndexInterface::Serialize(const WriteFuncType& write_func) const {
     std::string time_record_name = this->GetName() + " Serialize";
     SlowTaskTimer t(time_record_name);
 
+    auto log_lock = this->lock_operation_log();
+    this->prepare_snapshot();
     WriteFuncStreamWriter writer(write_func, 0);
     this->Serialize(writer);
+    this->commit_snapshot();
+    this->serialized_operation_lsn_.store(this->current_operation_lsn());
 }
 
 void
@@ -247,6 +284,23 @@ InnerIndexInterface::Deserialize(const ReaderSet& reader_set) {
     }
 }
 
+void
+InnerIndexInterface::DeserializeDelta(const BinarySet& binary_set) {
+    std::string time_record_name = this->GetName() + " DeserializeDelta";
+    SlowTaskTimer t(time_record_name);
+
+    Binary b = binary_set.Get(this->GetName());
+    if (b.data == nullptr) {
+        throw VsagException(ErrorType::INVALID_ARGUMENT,
+                            fmt::format("no delta of {} in the binary set", this->GetName()));
+    }
+    auto func = [&](uint64_t offset, uint64_t len, void* dest) -> void {
+        std::memcpy(dest, b.data.get() + offset, len);
+    };
+    auto reader = ReadFuncStreamReader(func, 0, b.size);
+    this->DeserializeDelta(reader);
+}
+
 bool
 InnerIndexInterface::CheckFeature(IndexFeature feature) const {
     return this->index_feature_list_->CheckFeature(feature);
@@ -261,8 +315,12 @@ void
 InnerIndexInterface::Serialize(std::ostream& out_stream) const {
     std::string time_record_name = this->GetName() + " Serialize";
     SlowTaskTimer t(time_record_name);
+    auto log_lock = this->lock_operation_log();
+    this->prepare_snapshot();
     IOStreamWriter writer(out_stream);
     this->Serialize(writer);
+    this->commit_snapshot();
+    this->serialized_operation_lsn_.store(this->current_operation_lsn());
 }
 
 void
@@ -629,6 +687,314 @@ InnerIndexInterface::UpdateExtraInfo(const DatasetPtr& new_base) {
     throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION, "extra_infos is not initialized");
 }
 
+uint64_t
+InnerIndexInterface::AttachOperationLog(const std::string& path, uint64_t group_commit_delay_us) {
+    std::unique_lock lock(this->operation_log_mutex_);
+    if (this->operation_log_ != nullptr) {
+        throw VsagException(ErrorType::WRONG_STATUS, "an operation log is attached already");
+    }
+    auto operation_log = std::make_shared<OperationLog>(path, group_commit_delay_us);
+
+    // a record failing again on replay failed when it was first applied, e.g. a duplicated id
+    auto replay = [this](uint64_t lsn, OperationType type, StreamReader& reader) {
+        try {
+            this->replay_operation(type, reader);
+        } catch (const VsagException& e) {
+            logger::warn("skip operation {} of type {} on replay: {}",
+                         lsn,
+                         static_cast<int>(type),
+                         e.what());
+        }
+    };
+    auto count = operation_log->Replay(this->restored_operation_lsn_, replay);
+    if (operation_log->LastLsn() < this->restored_operation_lsn_) {
+        // the snapshot is newer than the log, e.g. the log was checkpointed away
+        operation_log->Truncate(this->restored_operation_lsn_);
+    }
+    logger::info("replayed {} operations from {} on top of lsn {}",
+                 count,
+                 path,
+                 this->restored_operation_lsn_);
+    this->operation_log_ = operation_log;
+    return count;
+}
+
+void
+InnerIndexInterface::CheckpointOperationLog() {
+    std::shared_lock lock(this->operation_log_mutex_);
+    if (this->operation_log_ == nullptr) {
+        throw VsagException(ErrorType::WRONG_STATUS, "no operation log is attached");
+    }
+    this->operation_log_->Truncate(this->serialized_operation_lsn_.load());
+}
+
+void
+InnerIndexInterface::apply_logged(OperationType type,
+                                  const int64_t* labels,
+                                  uint64_t label_count,
+                                  const std::function<bool()>& apply,
+                                  const OperationLog::PayloadWriter& payload) {
+    // AttachOperationLog sets the log under the exclusive lock
+    std::shared_lock lock(this->operation_log_mutex_);
+    if (this->operation_log_ == nullptr) {
+        apply();
+        return;
+    }
+    // the record depends on the arguments only, a record too large to log fails before applying
+    auto record = OperationLog::Prepare(type, payload);
+
+    std::array<bool, OPERATION_ORDER_STRIPES> stripes{};
+    if (labels == nullptr) {
+        stripes.fill(true);
+    } else {
+        for (uint64_t i = 0; i < label_count; ++i) {
+            stripes[static_cast<uint64_t>(labels[i]) % OPERATION_ORDER_STRIPES] = true;
+        }
+    }
+    uint64_t lsn = 0;
+    {
+        // the records of a label are queued in the order its mutations are applied, replay
+        // repeats that order; stripes are taken in increasing order so no two writers deadlock
+        std::vector<std::unique_lock<std::mutex>> order_locks;
+        for (uint64_t i = 0; i < OPERATION_ORDER_STRIPES; ++i) {
+            if (stripes[i]) {
+                order_locks.emplace_back(this->operation_order_mutexes_[i]);
+            }
+        }
+        // once a write failed no mutation is applied anymore, it could never be made durable
+        this->operation_log_->CheckWritable();
+        if (not apply()) {
+            return;
+        }
+        lsn = this->operation_log_->Enqueue(record);
+    }
+    // the sync is shared with the writers queued meanwhile
+    this->operation_log_->WaitDurable(lsn);
+}
+
+std::vector<int64_t>
+InnerIndexInterface::LoggedAdd(const DatasetPtr& base, AddMode mode) {
+    std::vector<int64_t> failed_ids;
+    auto extra_info_size = static_cast<int64_t>(this->extra_info_size_);
+    this->apply_logged(
+        OperationType::ADD,
+        base->GetIds(),
+        base->GetIds() == nullptr ? 0 : static_cast<uint64_t>(base->GetNumElements()),
+        [&]() {
+            failed_ids = this->Add(base, mode);
+            return failed_ids.size() < static_cast<uint64_t>(base->GetNumElements());
+        },
+        [&](StreamWriter& writer) {
+            StreamWriter::WriteObj(writer, mode);
+            OperationLog::WriteDataset(writer, base, extra_info_size);
+        });
+    return failed_ids;
+}
+
+uint32_t
+InnerIndexInterface::LoggedRemove(const std::vector<int64_t>& ids, RemoveMode mode) {
+    uint32_t removed = 0;
+    this->apply_logged(
+        OperationType::REMOVE,
+        ids.data(),
+        ids.size(),
+        [&]() {
+            removed = this->Remove(ids, mode);
+            return removed > 0;
+        },
+        [&](StreamWriter& writer) {
+            StreamWriter::WriteObj(writer, mode);
+            StreamWriter::WriteVector(writer, ids);
+        });
+    return removed;
+}
+
+bool
+InnerIndexInterface::LoggedUpdateVector(int64_t id, const DatasetPtr& new_base, bool force_update) {
+    bool updated = false;
+    this->apply_logged(
+        OperationType::UPDATE_VECTOR,
+        &id,
+        1,
+        [&]() {
+            updated = this->UpdateVector(id, new_base, force_update);
+            return updated;
+        },
+        [&](StreamWriter& writer) {
+            StreamWriter::WriteObj(writer, id);
+            StreamWriter::WriteObj(writer, force_update);
+            OperationLog::WriteDataset(writer, new_base, 0);
+        });
+    return updated;
+}
+
+void
+InnerIndexInterface::LoggedUpdateAttribute(int64_t id,
+                                           const AttributeSet& new_attrs,
+                                           const AttributeSet* origin_attrs) {
+    this->apply_logged(
+        OperationType::UPDATE_ATTRIBUTE,
+        &id,
+        1,
+        [&]() {
+            if (origin_attrs == nullptr) {
+                this->UpdateAttribute(id, new_attrs);
+            } else {
+                this->UpdateAttribute(id, new_attrs, *origin_attrs);
+            }
+            return true;
+        },
+        [&](StreamWriter& writer) {
+            StreamWriter::WriteObj(writer, id);
+            StreamWriter::WriteObj(writer, origin_attrs != nullptr);
+            OperationLog::WriteAttributeSet(writer, new_attrs);
+            if (origin_attrs != nullptr) {
+                OperationLog::WriteAttributeSet(writer, *origin_attrs);
+            }
+        });
+}
+
+bool
+InnerIndexInterface::LoggedUpdateId(int64_t old_id, int64_t new_id) {
+    bool updated = false;
+    const std::array<int64_t, 2> labels{old_id, new_id};
+    this->apply_logged(
+        OperationType::UPDATE_ID,
+        labels.data(),
+        labels.size(),
+        [&]() {
+            updated = this->UpdateId(old_id, new_id);
+            return updated and old_id != new_id;
+        },
+        [&](StreamWriter& writer) {
+            StreamWriter::WriteObj(writer, old_id);
+            StreamWriter::WriteObj(writer, new_id);
+        });
+    return updated;
+}
+
+bool
+InnerIndexInterface::LoggedUpdateExtraInfo(const DatasetPtr& new_base) {
+    bool updated = false;
+    auto extra_info_size = static_cast<int64_t>(this->extra_info_size_);
+    this->apply_logged(
+        OperationType::UPDATE_EXTRA_INFO,
+        new_base->GetIds(),
+        new_base->GetIds() == nullptr ? 0 : static_cast<uint64_t>(new_base->GetNumElements()),
+        [&]() {
+            updated = this->UpdateExtraInfo(new_base);
+            return updated;
+        },
+        [&](StreamWriter& writer) {
+            OperationLog::WriteDataset(writer, new_base, extra_info_size);
+        });
+    return updated;
+}
+
+std::unique_lock<std::shared_mutex>
+InnerIndexInterface::lock_operation_log() const {
+    // operation_log_ is only read under the lock, AttachOperationLog may set it concurrently
+    std::unique_lock lock(this->operation_log_mutex_);
+    if (this->operation_log_ == nullptr) {
+        return {};
+    }
+    return lock;
+}
+
+uint64_t
+InnerIndexInterface::current_operation_lsn() const {
+    if (this->operation_log_ == nullptr) {
+        return this->restored_operation_lsn_;
+    }
+    return this->operation_log_->LastLsn();
+}
+
+void
+InnerIndexInterface::write_operation_lsn(const MetadataPtr& metadata) const {
+    auto lsn = this->current_operation_lsn();
+    if (lsn > 0) {
+        metadata->Set(OPERATION_LSN_KEY, lsn);
+    }
+}
+
+void
+InnerIndexInterface::read_operation_lsn(const MetadataPtr& metadata) {
+    auto lsn = metadata->Get(OPERATION_LSN_KEY);
+    this->restored_operation_lsn_ = lsn.IsNumberInteger() ? lsn.GetInt() : 0;
+}
+
+void
+InnerIndexInterface::replay_operation(OperationType type, StreamReader& reader) {
+    switch (type) {
+        case OperationType::ADD: {
+            AddMode mode;
+            StreamReader::ReadObj(reader, mode);
+            this->Add(OperationLog::ReadDataset(reader), mode);
+            break;
+        }
+        case OperationType::REMOVE: {
+            RemoveMode mode;
+            std::vector<int64_t> ids;
+            StreamReader::ReadObj(reader, mode);
+            StreamReader::ReadVector(reader, ids);
+            this->Remove(ids, mode);
+            break;
+        }
+        case OperationType::UPDATE_VECTOR: {
+            int64_t id = 0;
+            bool force_update = false;
+            StreamReader::ReadObj(reader, id);
+            StreamReader::ReadObj(reader, force_update);
+            this->UpdateVector(id, OperationLog::ReadDataset(reader), force_update);
+            break;
+        }
+        case OperationType::UPDATE_ATTRIBUTE: {
+            int64_t id = 0;
+            bool has_origin = false;
+            AttributeSet new_attrs;
+            AttributeSet origin_attrs;
+            auto release = [&]() {
+                for (auto* attr : new_attrs.attrs_) {
+                    delete attr;
+                }
+                for (auto* attr : origin_attrs.attrs_) {
+                    delete attr;
+                }
+            };
+            try {
+                StreamReader::ReadObj(reader, id);
+                StreamReader::ReadObj(reader, has_origin);
+                OperationLog::ReadAttributeSet(reader, new_attrs);
+                if (has_origin) {
+                    OperationLog::ReadAttributeSet(reader, origin_attrs);
+                    this->UpdateAttribute(id, new_attrs, origin_attrs);
+                } else {
+                    this->UpdateAttribute(id, new_attrs);
+                }
+            } catch (...) {
+                release();
+                throw;
+            }
+            release();
+            break;
+        }
+        case OperationType::UPDATE_ID: {
+            int64_t old_id = 0;
+            int64_t new_id = 0;
+            StreamReader::ReadObj(reader, old_id);
+            StreamReader::ReadObj(reader, new_id);
+            this->UpdateId(old_id, new_id);
+            break;
+        }
+        case OperationType::UPDATE_EXTRA_INFO:
+            this->UpdateExtraInfo(OperationLog::ReadDataset(reader));
+            break;
+        default:
+            throw VsagException(ErrorType::INVALID_BINARY,
+                                fmt::format("unknown operation type {}", static_cast<int>(type)));
+    }
+}
+
 void
 InnerIndexInterface::analyze_quantizer(JsonType& stats,
                                        const float* data,
@@ -15,7 +15,10 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <functional>
+#include <mutex>
 #include <shared_mutex>
 #include <vector>
 
@@ -27,6 +30,8 @@
 #include "inner_index_parameter.h"
 #include "metric_type.h"
 #include "parameter.h"
+#include "storage/operation_log.h"
+#include "storage/serialization.h"
 #include "storage/stream_reader.h"
 #include "storage/stream_writer.h"
 #include "typing.h"
@@ -196,6 +201,15 @@ public:
     virtual void
     Deserialize(StreamReader& reader) = 0;
 
+    virtual void
+    DeserializeDelta(const BinarySet& binary_set);
+
+    virtual void
+    DeserializeDelta(StreamReader& reader) {
+        throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                            "Index doesn't support DeserializeDelta");
+    }
+
     [[nodiscard]] virtual uint64_t
     EstimateMemory(uint64_t num_elements) const {
         throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
@@ -440,6 +454,15 @@ public:
     [[nodiscard]] virtual BinarySet
     Serialize() const;
 
+    [[nodiscard]] virtual BinarySet
+    SerializeDelta();
+
+    virtual void
+    SerializeDelta(StreamWriter& writer) {
+        throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                            "Index doesn't support SerializeDelta");
+    }
+
     virtual void
     SetIO(const std::shared_ptr<Reader> reader) {
     }
@@ -477,7 +500,78 @@ public:
                             "Index doesn't support UpdateVector");
     }
 
+    /**
+     * @brief Opens the operation log at path, replays its records newer than the current state,
+     * then appends every mutation made through the Logged* methods before it returns.
+     *
+     * @return The count of the replayed records.
+     */
+    uint64_t
+    AttachOperationLog(const std::string& path, uint64_t group_commit_delay_us);
+
+    // drops the records covered by the last Serialize, call it once that snapshot is persisted
+    void
+    CheckpointOperationLog();
+
+    std::vector<int64_t>
+    LoggedAdd(const DatasetPtr& base, AddMode mode);
+
+    uint32_t
+    LoggedRemove(const std::vector<int64_t>& ids, RemoveMode mode);
+
+    bool
+    LoggedUpdateVector(int64_t id, const DatasetPtr& new_base, bool force_update);
+
+    // origin_attrs may be nullptr
+    void
+    LoggedUpdateAttribute(int64_t id,
+                          const AttributeSet& new_attrs,
+                          const AttributeSet* origin_attrs);
+
+    bool
+    LoggedUpdateId(int64_t old_id, int64_t new_id);
+
+    bool
+    LoggedUpdateExtraInfo(const DatasetPtr& new_base);
+
 protected:
+    // called around the full serializations of the public Serialize, the index written in
+    // between becomes the base of the next delta once commit_snapshot is called
+    virtual void
+    prepare_snapshot() const {
+    }
+
+    virtual void
+    commit_snapshot() const {
+    }
+
+    // held by the public Serialize while a log is attached, so that the snapshot matches a lsn
+    [[nodiscard]] std::unique_lock<std::shared_mutex>
+    lock_operation_log() const;
+
+    // applies a mutation of the given labels (all of them when labels is nullptr) that returns
+    // whether it changed the index, and logs it if so
+    void
+    apply_logged(OperationType type,
+                 const int64_t* labels,
+                 uint64_t label_count,
+                 const std::function<bool()>& apply,
+                 const OperationLog::PayloadWriter& payload);
+
+    // the lsn of the last logged mutation contained in the index
+    [[nodiscard]] uint64_t
+    current_operation_lsn() const;
+
+    // keeps the lsn in the footer of a snapshot, the log is replayed after it on recovery
+    void
+    write_operation_lsn(const MetadataPtr& metadata) const;
+
+    void
+    read_operation_lsn(const MetadataPtr& metadata);
+
+    void
+    replay_operation(OperationType type, StreamReader& reader);
+
     void
     analyze_quantizer(JsonType& stats,
                       const float* data,
@@ -532,6 +626,17 @@ protected:
     std::shared_ptr<SafeThreadPool> thread_pool_{nullptr};
 
     AttrInvertedInterfacePtr attr_filter_index_{nullptr};
+
+    OperationLogPtr operation_log_{nullptr};
+    // shared by the logged mutations, exclusive for a snapshot and for attaching the log
+    mutable std::shared_mutex operation_log_mutex_{};
+    // held by a logged mutation from applying it until its record is queued, one stripe per
+    // label class: mutations of a label are logged in the order they are applied, those of
+    // disjoint labels commute and run concurrently
+    static constexpr uint64_t OPERATION_ORDER_STRIPES = 64;
+    std::array<std::mutex, OPERATION_ORDER_STRIPES> operation_order_mutexes_{};
+    uint64_t restored_operation_lsn_{0};
+    mutable std::atomic<uint64_t> serialized_operation_lsn_{0};
 };
 
 }  // namespace vsag
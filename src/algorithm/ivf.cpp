@@ -15,24 +15,33 @@
 
 #include "ivf.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cmath>
+#include <numeric>
 #include <random>
 #include <set>
+#include <tuple>
 
 #include "algorithm/inner_index_interface.h"
 #include "attr/argparse.h"
 #include "attr/executor/executor.h"
 #include "datacell/flatten_interface.h"
+#include "impl/cluster/kmeans_cluster.h"
 #include "impl/heap/standard_heap.h"
 #include "impl/inner_search_param.h"
 #include "impl/reorder/flatten_reorder.h"
 #include "impl/searcher/basic_searcher.h"
 #include "index/index_impl.h"
+#include "impl/logger/logger.h"
 #include "index_feature_list.h"
 #include "inner_string_params.h"
+#include "io/reader_io_parameter.h"
 #include "ivf_partition/gno_imi_partition.h"
 #include "ivf_partition/ivf_nearest_partition.h"
 #include "query_context.h"
+#include "simd/fp32_simd.h"
+#include "simd/normalize.h"
 #include "storage/serialization.h"
 #include "storage/stream_reader.h"
 #include "storage/stream_writer.h"
@@ -178,6 +187,27 @@ IVF::CheckAndMappingExternalParam(const JsonType& external_param,
                 GNO_IMI_SECOND_ORDER_BUCKETS_COUNT_KEY,
             },
         },
+        {
+            IVF_ROUTER_MAX_DEGREE_KEY,
+            {
+                IVF_PARTITION_STRATEGY_PARAMS_KEY,
+                IVF_ROUTER_MAX_DEGREE_KEY,
+            },
+        },
+        {
+            IVF_ROUTER_EF_CONSTRUCTION_KEY,
+            {
+                IVF_PARTITION_STRATEGY_PARAMS_KEY,
+                IVF_ROUTER_EF_CONSTRUCTION_KEY,
+            },
+        },
+        {
+            IVF_ROUTER_EF_SEARCH_KEY,
+            {
+                IVF_PARTITION_STRATEGY_PARAMS_KEY,
+                IVF_ROUTER_EF_SEARCH_KEY,
+            },
+        },
         {
             BUCKET_PER_DATA_KEY,
             {
@@ -223,6 +253,24 @@ IVF::CheckAndMappingExternalParam(const JsonType& external_param,
                 TRAIN_SAMPLE_COUNT_KEY,
             },
         },
+        {
+            IVF_AUTO_REBALANCE_KEY,
+            {
+                IVF_AUTO_REBALANCE_KEY,
+            },
+        },
+        {
+            IVF_REBALANCE_SPLIT_RATIO_KEY,
+            {
+                IVF_REBALANCE_SPLIT_RATIO_KEY,
+            },
+        },
+        {
+            IVF_REBALANCE_MERGE_RATIO_KEY,
+            {
+                IVF_REBALANCE_MERGE_RATIO_KEY,
+            },
+        },
     };
 
     if (common_param.data_type_ == DataTypes::DATA_TYPE_INT8) {
@@ -243,7 +291,8 @@ IVF::CheckAndMappingExternalParam(const JsonType& external_param,
 IVF::IVF(const IVFParameterPtr& param, const IndexCommonParam& common_param)
     : InnerIndexInterface(param, common_param),
       buckets_per_data_(param->buckets_per_data),
-      location_map_(common_param.allocator_.get()) {
+      location_map_(common_param.allocator_.get()),
+      bucket_radius_(common_param.allocator_.get()) {
     this->bucket_ = BucketInterface::MakeInstance(param->bucket_param, common_param);
     if (this->bucket_ == nullptr) {
         throw VsagException(ErrorType::INTERNAL_ERROR, "bucket init error");
@@ -274,10 +323,38 @@ IVF::IVF(const IVFParameterPtr& param, const IndexCommonParam& common_param)
     if (bucket_->GetQuantizerName() == QUANTIZATION_TYPE_VALUE_FP32) {
         this->has_raw_vector_ = true;
     }
+    this->scan_buffer_pool_ = std::make_shared<ScanBufferPool>(0, allocator_, allocator_);
+    this->bucket_radius_.resize(bucket_->bucket_count_, 0.0F);
+
+    this->auto_rebalance_ = param->auto_rebalance;
+    this->rebalance_split_ratio_ = param->rebalance_split_ratio;
+    this->rebalance_merge_ratio_ = param->rebalance_merge_ratio;
+    if (this->auto_rebalance_) {
+        // moved vectors are routed by the centroid router and the attribute index is keyed by
+        // the (bucket, offset) a vector was inserted at
+        CHECK_ARGUMENT(param->ivf_partition_strategy_parameter->partition_strategy_type ==
+                           IVFPartitionStrategyType::IVF,
+                       "auto_rebalance only supports the ivf partition strategy");
+        CHECK_ARGUMENT(not this->use_attribute_filter_,
+                       "auto_rebalance doesn't support attribute filter");
+        // moved vectors are re-encoded, from lossy codes every move would add quantization error
+        CHECK_ARGUMENT(this->has_raw_vector_ or
+                           (this->use_reorder_ and this->reorder_codes_->GetQuantizerName() ==
+                                                       QUANTIZATION_TYPE_VALUE_FP32),
+                       "auto_rebalance needs fp32 base codes or fp32 precise codes");
+    }
+}
+
+IVF::~IVF() {
+    std::lock_guard lock(this->rebalance_mutex_);
+    if (this->rebalance_future_.valid()) {
+        this->rebalance_future_.wait();
+    }
 }
 
 void
 IVF::GetCodeByInnerId(InnerIdType inner_id, uint8_t* data) const {
+    std::shared_lock layout_lock(this->layout_mutex_);
     auto [bucket_id, offset_id] = this->get_location(inner_id);
     this->bucket_->GetCodesById(bucket_id, offset_id, data);
 }
@@ -296,6 +373,8 @@ IVF::InitFeatures() {
     this->index_feature_list_->SetFeatures({
         IndexFeature::SUPPORT_KNN_SEARCH,
         IndexFeature::SUPPORT_KNN_SEARCH_WITH_ID_FILTER,
+        IndexFeature::SUPPORT_BATCH_SEARCH,
+        IndexFeature::SUPPORT_BATCH_SEARCH_WITH_MULTI_THREAD,
     });
     // concurrency
     this->index_feature_list_->SetFeature(IndexFeature::SUPPORT_SEARCH_CONCURRENT);
@@ -381,6 +460,7 @@ IVF::Add(const DatasetPtr& base, AddMode mode) {
     if (not partition_strategy_->is_trained_) {
         throw VsagException(ErrorType::INTERNAL_ERROR, "ivf index add without train error");
     }
+    std::shared_lock layout_lock(this->layout_mutex_);
     this->bucket_->Unpack();
     auto num_element = base->GetNumElements();
     const auto* ids = base->GetIds();
@@ -412,11 +492,13 @@ IVF::Add(const DatasetPtr& base, AddMode mode) {
     }
 
     auto add_func = [&](int64_t i) -> void {
+        Vector<float> radius_buffer(2 * dim_, allocator_);
         for (int64_t j = 0; j < buckets_per_data_; ++j) {
             const auto* data_ptr = vectors + i * dim_;
             auto idx = i * buckets_per_data_ + j;
             InnerIdType offset_id = bucket_->InsertVector(
                 data_ptr, buckets[idx], idx + current_num * buckets_per_data_);
+            this->update_bucket_radius(data_ptr, buckets[idx], radius_buffer);
             if (j == 0) {
                 std::lock_guard lock(label_lookup_mutex_);
                 location_map_[i + current_num] =
@@ -450,12 +532,316 @@ IVF::Add(const DatasetPtr& base, AddMode mode) {
         }
     }
     this->bucket_->Package();
+    if (num_element > 0) {
+        this->calibrate_probe_error(vectors, num_element, current_num);
+    }
     if (need_cal_memory_usage) {
         this->cal_memory_usage();
     }
+    layout_lock.unlock();
+    if (this->auto_rebalance_) {
+        this->schedule_rebalance();
+    }
     return {};
 }
 
+void
+IVF::update_bucket_radius(const float* vector, BucketIdType bucket_id, Vector<float>& buffer) {
+    // buffer holds the centroid followed by the normalized vector for cosine,
+    // an index deserialized without the radius section keeps no radii to maintain
+    if (bucket_id >= bucket_radius_.size()) {
+        return;
+    }
+    partition_strategy_->GetCentroid(bucket_id, buffer);
+    if (metric_ == MetricType::METRIC_TYPE_COSINE) {
+        Normalize(vector, buffer.data() + dim_, dim_);
+        vector = buffer.data() + dim_;
+    }
+    auto radius = std::sqrt(FP32ComputeL2Sqr(vector, buffer.data(), dim_));
+    std::lock_guard lock(label_lookup_mutex_);
+    if (radius > bucket_radius_[bucket_id]) {
+        bucket_radius_[bucket_id] = radius;
+    }
+}
+
+void
+IVF::calibrate_probe_error(const float* vectors, int64_t count, int64_t first_inner_id) {
+    // the bucket bounds hold for exact distances while the scanned codes may underestimate them,
+    // the largest underestimate over samples of pairs of the added batches widens the bounds; the
+    // batches are sampled until PROBE_ERROR_MIN_SAMPLES vectors are seen, then again each time
+    // the index doubled
+    {
+        std::lock_guard lock(label_lookup_mutex_);
+        if (this->probe_error_samples_ >= PROBE_ERROR_MIN_SAMPLES and
+            first_inner_id + count < this->next_probe_calibration_) {
+            return;
+        }
+    }
+    constexpr int64_t query_sample_count = 32;
+    constexpr int64_t base_sample_count = PROBE_ERROR_MIN_SAMPLES;
+    auto query_count = std::min(count, query_sample_count);
+    auto base_count = std::min(count, base_sample_count);
+    auto query_step = count / query_count;
+    auto base_step = count / base_count;
+    Vector<float> query(dim_, allocator_);
+    Vector<float> base(dim_, allocator_);
+    float error = 0.0F;
+    for (int64_t i = 0; i < query_count; ++i) {
+        const auto* query_ptr = vectors + i * query_step * dim_;
+        auto computer = bucket_->FactoryComputer(query_ptr);
+        if (metric_ == MetricType::METRIC_TYPE_COSINE) {
+            Normalize(query_ptr, query.data(), dim_);
+            query_ptr = query.data();
+        }
+        for (int64_t j = 0; j < base_count; ++j) {
+            auto base_id = j * base_step;
+            const auto* base_ptr = vectors + base_id * dim_;
+            auto [bucket_id, offset_id] = this->get_location(first_inner_id + base_id);
+            auto scanned = bucket_->QueryOneById(computer, bucket_id, offset_id);
+            float exact = 0.0F;
+            if (metric_ == MetricType::METRIC_TYPE_L2SQR) {
+                exact = FP32ComputeL2Sqr(query_ptr, base_ptr, dim_);
+            } else {
+                if (metric_ == MetricType::METRIC_TYPE_COSINE) {
+                    Normalize(base_ptr, base.data(), dim_);
+                    base_ptr = base.data();
+                }
+                exact = 1.0F - FP32ComputeIP(query_ptr, base_ptr, dim_);
+            }
+            error = std::max(error, exact - scanned);
+        }
+    }
+    std::lock_guard lock(label_lookup_mutex_);
+    this->probe_error_max_ = std::max(this->probe_error_max_, error);
+    this->probe_error_samples_ += base_count;
+    this->next_probe_calibration_ = 2 * (first_inner_id + count);
+    if (this->probe_error_samples_ >= PROBE_ERROR_MIN_SAMPLES) {
+        this->probe_error_bound_ = this->probe_error_max_;
+    }
+}
+
+std::pair<BucketIdType, BucketIdType>
+IVF::find_rebalance_buckets() const {
+    // the bucket budget is fixed, an oversized bucket is only split when an undersized one can be
+    // merged into its neighbours to free a slot for the second half
+    auto bucket_count = bucket_->bucket_count_;
+    if (bucket_count < 2) {
+        return {-1, -1};
+    }
+    BucketIdType largest = 0;
+    BucketIdType smallest = 1;
+    uint64_t total = 0;
+    for (BucketIdType i = 0; i < bucket_count; ++i) {
+        auto size = bucket_->GetBucketSize(i);
+        total += size;
+        if (size > bucket_->GetBucketSize(largest)) {
+            largest = i;
+        }
+    }
+    for (BucketIdType i = 0; i < bucket_count; ++i) {
+        if (i != largest and (smallest == largest or
+                              bucket_->GetBucketSize(i) < bucket_->GetBucketSize(smallest))) {
+            smallest = i;
+        }
+    }
+    auto avg = static_cast<float>(total) / static_cast<float>(bucket_count);
+    auto largest_size = static_cast<float>(bucket_->GetBucketSize(largest));
+    auto smallest_size = static_cast<float>(bucket_->GetBucketSize(smallest));
+    if (largest_size < 2.0F or largest_size <= rebalance_split_ratio_ * avg or
+        smallest_size > rebalance_merge_ratio_ * avg) {
+        return {-1, -1};
+    }
+    return {largest, smallest};
+}
+
+void
+IVF::schedule_rebalance() {
+    // concurrent adds schedule at most one pass, a running pass sees their vectors anyway
+    std::unique_lock lock(this->rebalance_mutex_, std::try_to_lock);
+    if (not lock.owns_lock()) {
+        return;
+    }
+    if (this->rebalance_future_.valid()) {
+        if (this->rebalance_future_.wait_for(std::chrono::seconds(0)) !=
+            std::future_status::ready) {
+            return;
+        }
+        this->rebalance_future_.get();
+    }
+    {
+        std::shared_lock layout_lock(this->layout_mutex_);
+        if (this->find_rebalance_buckets().first < 0) {
+            return;
+        }
+    }
+    if (this->thread_pool_ == nullptr) {
+        this->rebalance();
+        return;
+    }
+    // not enqueued into thread_pool_, the adds waiting on the pool would block the pass
+    this->rebalance_future_ = std::async(std::launch::async, [this]() { this->rebalance(); });
+}
+
+void
+IVF::rebalance() {
+    try {
+        auto max_steps = bucket_->bucket_count_ / MAX_REBALANCE_STEP_RATIO + 1;
+        for (uint64_t step = 0; step < max_steps; ++step) {
+            std::unique_lock layout_lock(this->layout_mutex_);
+            auto [split_bucket, merge_bucket] = this->find_rebalance_buckets();
+            if (split_bucket < 0) {
+                break;
+            }
+            this->bucket_->Unpack();
+            auto progress = this->rebalance_step(split_bucket, merge_bucket);
+            this->bucket_->Package();
+            logger::debug("ivf rebalance split bucket {} into slot {}", split_bucket, merge_bucket);
+            if (not progress) {
+                break;
+            }
+        }
+    } catch (const std::exception& e) {
+        logger::error("ivf rebalance failed: {}", e.what());
+    }
+}
+
+bool
+IVF::rebalance_step(BucketIdType split_bucket, BucketIdType merge_bucket) {
+    Vector<InnerIdType> inner_ids(allocator_);
+    Vector<float> vectors(allocator_);
+    Vector<float> buffer(2 * dim_, allocator_);
+
+    // move the vectors of the undersized bucket to their nearest other bucket
+    this->decode_bucket(merge_bucket, inner_ids, vectors);
+    auto count = static_cast<int64_t>(inner_ids.size());
+    if (count > 0) {
+        auto buckets = partition_strategy_->ClassifyDatas(vectors.data(), count, 2, nullptr);
+        for (int64_t i = 0; i < count; ++i) {
+            auto target = buckets[2 * i] == merge_bucket ? buckets[2 * i + 1] : buckets[2 * i];
+            this->move_vector(vectors.data() + i * dim_, target, inner_ids[i], buffer);
+        }
+    }
+
+    // split the oversized bucket in two, the second half takes over the freed slot
+    this->decode_bucket(split_bucket, inner_ids, vectors);
+    count = static_cast<int64_t>(inner_ids.size());
+    KMeansCluster cluster(static_cast<int32_t>(dim_), allocator_);
+    auto labels = cluster.Run(2, vectors.data(), count);
+    Vector<BucketIdType> bucket_ids({split_bucket, merge_bucket}, allocator_);
+    partition_strategy_->UpdateCentroids(bucket_ids, cluster.k_centroids_);
+    int64_t split_size = 0;
+    for (int64_t i = 0; i < count; ++i) {
+        auto target = labels[i] == 1 ? merge_bucket : split_bucket;
+        split_size += static_cast<int64_t>(target == split_bucket);
+        this->move_vector(vectors.data() + i * dim_, target, inner_ids[i], buffer);
+    }
+    // identical vectors can't be split, stop instead of emptying more buckets for nothing
+    return split_size < count and split_size > 0;
+}
+
+void
+IVF::decode_bucket(BucketIdType bucket_id,
+                   Vector<InnerIdType>& inner_ids,
+                   Vector<float>& vectors) {
+    auto size = bucket_->GetBucketSize(bucket_id);
+    const auto* ids = bucket_->GetInnerIds(bucket_id);
+    inner_ids.assign(ids, ids + size);
+    vectors.resize(static_cast<uint64_t>(size) * dim_);
+    for (InnerIdType i = 0; i < size; ++i) {
+        auto* vector = vectors.data() + static_cast<uint64_t>(i) * dim_;
+        if (has_raw_vector_) {
+            bucket_->DecodeById(bucket_id, i, vector);
+            continue;
+        }
+        // lossy bucket codes are re-encoded from the fp32 precise codes of the same vector
+        bool need_release = false;
+        const auto* codes = reorder_codes_->GetCodesById(ids[i] / buckets_per_data_, need_release);
+        reorder_codes_->Decode(codes, vector);
+        if (need_release) {
+            reorder_codes_->Release(codes);
+        }
+    }
+    bucket_->ResetBucket(bucket_id);
+    if (not bucket_radius_.empty()) {
+        bucket_radius_[bucket_id] = 0.0F;
+    }
+}
+
+void
+IVF::move_vector(const float* vector,
+                 BucketIdType bucket_id,
+                 InnerIdType inner_id,
+                 Vector<float>& buffer) {
+    auto offset_id = bucket_->InsertVector(vector, bucket_id, inner_id);
+    this->update_bucket_radius(vector, bucket_id, buffer);
+    if (inner_id % buckets_per_data_ == 0) {
+        location_map_[inner_id / buckets_per_data_] =
+            (static_cast<uint64_t>(bucket_id) << LOCATION_SPLIT_BIT) |
+            static_cast<uint64_t>(offset_id);
+    }
+}
+
+std::pair<float, float>
+IVF::probe_bounds(const float* query,
+                  float query_norm,
+                  BucketIdType bucket_id,
+                  Vector<float>& centroid) const {
+    partition_strategy_->GetCentroid(bucket_id, centroid);
+    auto radius = bucket_radius_[bucket_id];
+    if (metric_ == MetricType::METRIC_TYPE_L2SQR) {
+        // |q - x| >= |q - c| - |x - c|
+        auto centroid_dist = FP32ComputeL2Sqr(query, centroid.data(), dim_);
+        auto gap = std::sqrt(centroid_dist) - radius;
+        return {centroid_dist, gap > 0.0F ? gap * gap : 0.0F};
+    }
+    // 1 - <q, x> = 1 - <q, c> - <q, x - c> >= 1 - <q, c> - |q| * |x - c|
+    auto centroid_dist = 1.0F - FP32ComputeIP(query, centroid.data(), dim_);
+    return {centroid_dist, centroid_dist - query_norm * radius};
+}
+
+float
+IVF::prepare_probe_query(const float* query, Vector<float>& normalized) const {
+    if (metric_ == MetricType::METRIC_TYPE_COSINE) {
+        Normalize(query, normalized.data(), dim_);
+        return 1.0F;
+    }
+    std::copy(query, query + dim_, normalized.data());
+    return std::sqrt(FP32ComputeIP(query, query, dim_));
+}
+
+void
+IVF::order_probes(const float* query,
+                  Vector<BucketIdType>& buckets,
+                  Vector<float>& bounds,
+                  Vector<float>& remaining_bounds) const {
+    Vector<float> probe_query(dim_, allocator_);
+    Vector<float> centroid(dim_, allocator_);
+    auto query_norm = this->prepare_probe_query(query, probe_query);
+    auto count = std::find(buckets.begin(), buckets.end(), -1) - buckets.begin();
+    Vector<std::tuple<float, BucketIdType, float>> probes(allocator_);
+    probes.reserve(count);
+    for (int64_t i = 0; i < count; ++i) {
+        auto [centroid_dist, bound] =
+            this->probe_bounds(probe_query.data(), query_norm, buckets[i], centroid);
+        probes.emplace_back(centroid_dist, buckets[i], bound);
+    }
+    std::sort(probes.begin(), probes.end());
+    buckets.resize(count);
+    bounds.resize(count);
+    remaining_bounds.resize(count);
+    for (int64_t i = 0; i < count; ++i) {
+        buckets[i] = std::get<1>(probes[i]);
+        bounds[i] = std::get<2>(probes[i]);
+    }
+    // probes are scanned nearest centroid first, the search stops at the first position whose
+    // remaining buckets all have a bound past the heap threshold
+    auto remaining = std::numeric_limits<float>::max();
+    for (auto i = count - 1; i >= 0; --i) {
+        remaining = std::min(remaining, bounds[i]);
+        remaining_bounds[i] = remaining;
+    }
+}
+
 DatasetPtr
 IVF::KnnSearch(const DatasetPtr& query,
                int64_t k,
@@ -464,6 +850,15 @@ IVF::KnnSearch(const DatasetPtr& query,
     SearchStatistics stats;
     QueryContext ctx{.stats = &stats};
 
+    if (query->GetNumElements() > 1) {
+        SearchRequest request;
+        request.query_ = query;
+        request.topk_ = k;
+        request.filter_ = filter;
+        request.params_str_ = parameters;
+        return this->search_batch(request);
+    }
+
     auto param = this->create_search_param(parameters, filter);
     param.search_mode = KNN_SEARCH;
     param.topk = k;
@@ -534,6 +929,7 @@ IVF::GetNumElements() const {
 
 void
 IVF::Merge(const std::vector<MergeUnit>& merge_units) {
+    std::unique_lock layout_lock(this->layout_mutex_);
     this->bucket_->Unpack();
     for (const auto& unit : merge_units) {
         this->merge_one_unit(unit);
@@ -586,6 +982,7 @@ IVF::UpdateAttribute(int64_t id, const AttributeSet& new_attrs, const AttributeS
 
 void
 IVF::Serialize(StreamWriter& writer) const {
+    std::shared_lock layout_lock(this->layout_mutex_);
     JsonType datacell_offsets;
     JsonType datacell_sizes;
     uint64_t offset = 0;
@@ -602,6 +999,15 @@ IVF::Serialize(StreamWriter& writer) const {
         WRITE_DATACELL_WITH_NAME(writer, "attr_filter_index", attr_filter_index_);
     }
 
+    // bucket radii and the calibrated error bound of adaptive probing
+    datacell_offsets["bucket_radius"].SetInt(offset);
+    auto bucket_radius_start = writer.GetCursor();
+    StreamWriter::WriteVector(writer, this->bucket_radius_);
+    StreamWriter::WriteObj(writer, this->probe_error_bound_);
+    auto bucket_radius_size = writer.GetCursor() - bucket_radius_start;
+    datacell_sizes["bucket_radius"].SetInt(bucket_radius_size);
+    offset += bucket_radius_size;
+
     // serialize footer (introduced since v0.15)
     JsonType basic_info;
     basic_info["total_elements"].SetInt(this->total_elements_);
@@ -617,6 +1023,7 @@ IVF::Serialize(StreamWriter& writer) const {
     metadata->Set(BASIC_INFO, basic_info);
     metadata->Set("datacell_offsets", datacell_offsets);
     metadata->Set("datacell_sizes", datacell_sizes);
+    this->write_operation_lsn(metadata);
 
     auto footer = std::make_shared<Footer>(metadata);
     footer->Write(writer);
@@ -653,6 +1060,7 @@ IVF::Deserialize(StreamReader& reader) {
             this->attr_filter_index_->Deserialize(buffer_reader);
             this->has_attribute_ = true;
         }
+        this->bucket_radius_.clear();
     } else {  // create like `else if ( ver in [v0.15, v0.17] )` here if need in the future
         logger::debug("parse with new version format");
 
@@ -662,6 +1070,7 @@ IVF::Deserialize(StreamReader& reader) {
         }
 
         auto basic_info = metadata->Get(BASIC_INFO);
+        this->read_operation_lsn(metadata);
         this->total_elements_ = basic_info["total_elements"].GetInt();
         this->use_reorder_ = basic_info["use_reorder"].GetBool();
         this->is_trained_ = basic_info["is_trained"].GetBool();
@@ -693,14 +1102,44 @@ IVF::Deserialize(StreamReader& reader) {
             READ_DATACELL_WITH_NAME(buffer_reader, "attr_filter_index", this->attr_filter_index_);
             this->has_attribute_ = true;
         }
+        if (datacell_offsets.Contains("bucket_radius")) {
+            buffer_reader.PushSeek(datacell_offsets["bucket_radius"].GetInt());
+            auto radius_reader = buffer_reader.Slice(datacell_sizes["bucket_radius"].GetInt());
+            StreamReader::ReadVector(radius_reader, this->bucket_radius_);
+            StreamReader::ReadObj(radius_reader, this->probe_error_bound_);
+            buffer_reader.PopSeek();
+            if (this->bucket_radius_.size() != this->bucket_->bucket_count_) {
+                logger::warn("bucket radius count {} mismatches bucket count {}, ignored",
+                             this->bucket_radius_.size(),
+                             this->bucket_->bucket_count_);
+                this->bucket_radius_.clear();
+            }
+        } else {
+            this->bucket_radius_.clear();
+        }
         if (this->bucket_->GetQuantizerName() == QUANTIZATION_TYPE_VALUE_FP32) {
             this->has_raw_vector_ = true;
         }
     }
+    // a deserialized bound was calibrated on enough samples, it is sampled again once the index
+    // doubled
+    this->probe_error_max_ = std::max(this->probe_error_bound_, 0.0F);
+    this->probe_error_samples_ = this->probe_error_bound_ >= 0.0F ? PROBE_ERROR_MIN_SAMPLES : 0;
+    this->next_probe_calibration_ = 2 * this->total_elements_;
     this->fill_location_map();
     this->cal_memory_usage();
 }
 
+void
+IVF::SetIO(const std::shared_ptr<Reader> reader) {
+    auto reader_param = std::make_shared<ReaderIOParameter>();
+    reader_param->reader = reader;
+    this->bucket_->InitIO(reader_param);
+    if (use_reorder_) {
+        this->reorder_codes_->InitIO(reader_param);
+    }
+}
+
 InnerSearchParam
 IVF::create_search_param(const std::string& parameters, const FilterPtr& filter) const {
     InnerSearchParam param;
@@ -721,6 +1160,13 @@ IVF::create_search_param(const std::string& parameters, const FilterPtr& filter)
     param.factor = search_param.topk_factor;
     param.first_order_scan_ratio = search_param.first_order_scan_ratio;
     param.parallel_search_thread_count = search_param.parallel_search_thread_count;
+    param.router_ef_search = search_param.router_ef_search;
+    param.probe_error_bound = search_param.probe_error_bound >= 0.0F
+                                  ? search_param.probe_error_bound
+                                  : this->probe_error_bound_;
+    // an index serialized before the bucket radii were recorded can't bound its buckets
+    param.adaptive_probe = search_param.adaptive_probe and param.probe_error_bound >= 0.0F and
+                           this->bucket_radius_.size() == bucket_->bucket_count_;
     if (search_param.enable_time_record) {
         param.time_cost = std::make_shared<Timer>();
         param.time_cost->SetThreshold(search_param.timeout_ms);
@@ -757,14 +1203,41 @@ IVF::ExportModel(const IndexCommonParam& param) const {
     return index;
 }
 
+// no vector of a bucket can enter the heap once the lower bound of its distances, widened by
+// the error of the scanned codes, passes the threshold
+static bool
+probe_pruned(float bound, float error_bound, float threshold) {
+    constexpr float relative_error = 1e-5F;
+    return bound - error_bound - relative_error * std::abs(bound) > threshold;
+}
+
+template <InnerSearchMode mode>
+static float
+probe_threshold(const DistHeapPtr& heap, int64_t topk, float cur_heap_top, float radius) {
+    auto threshold = std::numeric_limits<float>::max();
+    if (static_cast<int64_t>(heap->Size()) >= topk) {
+        threshold = cur_heap_top;
+    }
+    if constexpr (mode == RANGE_SEARCH) {
+        threshold = std::min(threshold, radius + THRESHOLD_ERROR);
+    }
+    return threshold;
+}
+
 template <InnerSearchMode mode>
 DistHeapPtr
 IVF::search(const DatasetPtr& query, const InnerSearchParam& param, QueryContext& ctx) const {
+    std::shared_lock layout_lock(this->layout_mutex_);
     const auto* query_data = query->GetFloat32Vectors();
     Vector<float> normalize_data(dim_, allocator_);
     auto candidate_buckets =
         partition_strategy_->ClassifyDatasForSearch(query_data, 1, param, &ctx);
     auto computer = bucket_->FactoryComputer(query_data);
+    Vector<float> bounds(allocator_);
+    Vector<float> remaining_bounds(allocator_);
+    if (param.adaptive_probe) {
+        this->order_probes(query_data, candidate_buckets, bounds, remaining_bounds);
+    }
 
     auto cur_heap_top = std::numeric_limits<float>::max();
     int64_t topk = param.topk;
@@ -797,8 +1270,7 @@ IVF::search(const DatasetPtr& query, const InnerSearchParam& param, QueryContext
     auto search_func = [&](int64_t thread_id) -> void {
         heaps[thread_id] = DistanceHeap::MakeInstanceBySize<true, false>(this->allocator_, topk);
         auto& heap = heaps[thread_id];
-        Vector<float> centroid(dim_, allocator_);
-        Vector<float> dist(allocator_);
+        auto buffer = scan_buffer_pool_->TakeOne();
         uint64_t i = cur_bucket_num.fetch_add(1);
         for (; i < bucket_count; i = cur_bucket_num.fetch_add(1)) {
             if (param.time_cost != nullptr and param.time_cost->CheckOvertime() and
@@ -810,58 +1282,40 @@ IVF::search(const DatasetPtr& query, const InnerSearchParam& param, QueryContext
             if (bucket_id == -1) {
                 break;
             }
+            if (param.adaptive_probe) {
+                auto threshold = probe_threshold<mode>(heap, topk, cur_heap_top, param.radius);
+                if (probe_pruned(remaining_bounds[i], param.probe_error_bound, threshold)) {
+                    break;
+                }
+                if (probe_pruned(bounds[i], param.probe_error_bound, threshold)) {
+                    continue;
+                }
+            }
             auto bucket_size = bucket_->GetBucketSize(bucket_id);
             const auto* ids = bucket_->GetInnerIds(bucket_id);
-            if (bucket_size > dist.size()) {
-                dist.resize(bucket_size);
-            }
+            auto* dist = buffer->Dists(bucket_size);
 
-            bucket_->ScanBucketById(dist.data(), computer, bucket_id);
+            bucket_->ScanBucketById(dist, computer, bucket_id);
             Filter* attr_ft = nullptr;
             if (param.executors.size() > thread_id and param.executors[thread_id] != nullptr) {
                 param.executors[thread_id]->Clear();
                 attr_ft = param.executors[thread_id]->Run(bucket_id);
             }
-            for (int j = 0; j < bucket_size; ++j) {
-                auto origin_id = ids[j] / buckets_per_data_;
-                if (attr_ft != nullptr and not attr_ft->CheckValid(j)) {
-                    continue;
-                }
-                if (ft == nullptr or ft->CheckValid(origin_id)) {
-                    if constexpr (mode == KNN_SEARCH) {
-                        if (heap->Size() < topk or dist[j] < cur_heap_top) {
-                            heap->Push(dist[j], ids[j]);
-                        }
-                    } else if constexpr (mode == RANGE_SEARCH) {
-                        if (dist[j] <= param.radius + THRESHOLD_ERROR and dist[j] < cur_heap_top) {
-                            heap->Push(dist[j], ids[j]);
-                        }
-                    }
-                    if (heap->Size() > topk) {
-                        heap->Pop();
-                    }
-                    if (not heap->Empty() and heap->Size() == topk) {
-                        cur_heap_top = heap->Top().first;
-                    }
-                }
-            }
+            this->select_candidates<mode>(dist,
+                                          ids,
+                                          bucket_size,
+                                          attr_ft,
+                                          ft.get(),
+                                          param.radius,
+                                          topk,
+                                          heap,
+                                          cur_heap_top,
+                                          *buffer);
         }
+        scan_buffer_pool_->ReturnOne(buffer);
     };
-    std::vector<std::future<void>> futures;
     if (this->thread_pool_ != nullptr and search_thread_count > 1) {
-        for (int64_t thread_id = 0; thread_id < search_thread_count; ++thread_id) {
-            auto future = this->thread_pool_->GeneralEnqueue(search_func, thread_id);
-            futures.emplace_back(std::move(future));
-        }
-    } else {
-        search_func(0);
-        search_result = heaps[0];
-    }
-
-    if (this->thread_pool_ != nullptr and search_thread_count > 1) {
-        for (auto& future : futures) {
-            future.get();
-        }
+        this->thread_pool_->ParallelFor(search_thread_count, search_func);
         search_result = DistanceHeap::MakeInstanceBySize<true, true>(this->allocator_, topk);
         for (auto& heap : heaps) {
             auto size = heap->Size();
@@ -870,37 +1324,294 @@ IVF::search(const DatasetPtr& query, const InnerSearchParam& param, QueryContext
                 search_result->Push(data[i]);
             }
         }
+    } else {
+        search_func(0);
+        search_result = heaps[0];
     }
 
     // Deduplicate ids when buckets_per_data_ > 1
     if (buckets_per_data_ > 1) {
-        std::unordered_map<InnerIdType, float> id_to_min_dist;
-        while (!search_result->Empty()) {
-            const auto& [dist_val, id] = search_result->Top();
-            auto origin_id = id / buckets_per_data_;
-            // Keep the smallest distance for each id
-            if (id_to_min_dist.find(origin_id) == id_to_min_dist.end() ||
-                dist_val < id_to_min_dist[origin_id]) {
-                id_to_min_dist[origin_id] = dist_val;
-            }
+        this->deduplicate(search_result, origin_topk);
+    }
+
+    return search_result;
+}
+
+void
+IVF::deduplicate(DistHeapPtr& search_result, int64_t topk) const {
+    std::unordered_map<InnerIdType, float> id_to_min_dist;
+    while (!search_result->Empty()) {
+        const auto& [dist_val, id] = search_result->Top();
+        auto origin_id = id / buckets_per_data_;
+        // Keep the smallest distance for each id
+        if (id_to_min_dist.find(origin_id) == id_to_min_dist.end() ||
+            dist_val < id_to_min_dist[origin_id]) {
+            id_to_min_dist[origin_id] = dist_val;
+        }
+        search_result->Pop();
+    }
+
+    auto cur_heap_top = std::numeric_limits<float>::max();
+    for (const auto& [origin_id, dist_val] : id_to_min_dist) {
+        if (dist_val < cur_heap_top) {
+            search_result->Push(dist_val, origin_id);
+        }
+        if (search_result->Size() > topk) {
             search_result->Pop();
         }
+        if (not search_result->Empty() and search_result->Size() == topk) {
+            cur_heap_top = search_result->Top().first;
+        }
+    }
+}
+
+template <InnerSearchMode mode>
+void
+IVF::select_candidates(const float* dist,
+                       const InnerIdType* ids,
+                       InnerIdType bucket_size,
+                       const Filter* attr_ft,
+                       const Filter* ft,
+                       float radius,
+                       int64_t topk,
+                       DistHeapPtr& heap,
+                       float& cur_heap_top,
+                       ScanBuffer& buffer) const {
+    // a block is first narrowed to the distances below the current heap threshold with a simd
+    // compare + compress, only those survivors pay for the filters and the heap. the threshold
+    // only tightens while pushing, so every survivor is still checked against the latest top
+    auto* selected = buffer.Selected(SELECT_BLOCK_SIZE);
+    float range_bound = std::numeric_limits<float>::max();
+    if constexpr (mode == RANGE_SEARCH) {
+        range_bound = std::nextafter(radius + THRESHOLD_ERROR, std::numeric_limits<float>::max());
+    }
+    for (InnerIdType begin = 0; begin < bucket_size; begin += SELECT_BLOCK_SIZE) {
+        auto block_size = std::min<uint64_t>(SELECT_BLOCK_SIZE, bucket_size - begin);
+        uint64_t selected_count = block_size;
+        if (mode == KNN_SEARCH and heap->Size() < topk) {
+            std::iota(selected, selected + block_size, 0U);
+        } else {
+            auto threshold = std::min(range_bound, cur_heap_top);
+            selected_count = FP32SelectLessThan(dist + begin, block_size, threshold, selected);
+        }
+        for (uint64_t s = 0; s < selected_count; ++s) {
+            auto j = begin + selected[s];
+            if (attr_ft != nullptr and not attr_ft->CheckValid(j)) {
+                continue;
+            }
+            if (ft != nullptr and not ft->CheckValid(ids[j] / buckets_per_data_)) {
+                continue;
+            }
+            if constexpr (mode == KNN_SEARCH) {
+                if (heap->Size() < topk or dist[j] < cur_heap_top) {
+                    heap->Push(dist[j], ids[j]);
+                }
+            } else if constexpr (mode == RANGE_SEARCH) {
+                if (dist[j] <= radius + THRESHOLD_ERROR and dist[j] < cur_heap_top) {
+                    heap->Push(dist[j], ids[j]);
+                }
+            }
+            if (heap->Size() > topk) {
+                heap->Pop();
+            }
+            if (not heap->Empty() and heap->Size() == topk) {
+                cur_heap_top = heap->Top().first;
+            }
+        }
+    }
+}
+
+DatasetPtr
+IVF::search_batch(const SearchRequest& request) const {
+    std::shared_lock layout_lock(this->layout_mutex_);
+    SearchStatistics stats;
+    Allocator* result_alloc = this->allocator_;
+    if (request.search_allocator_ != nullptr) {
+        result_alloc = request.search_allocator_;
+    }
+    QueryContext ctx{.alloc = request.search_allocator_, .stats = &stats};
+
+    const auto& query = request.query_;
+    auto query_count = query->GetNumElements();
+    const auto* query_data = query->GetFloat32Vectors();
+    auto k = request.topk_;
+    CHECK_ARGUMENT(k > 0, fmt::format("k({}) must be greater than 0", k));
+
+    auto param = this->create_search_param(request.params_str_, request.filter_);
+    param.search_mode = KNN_SEARCH;
+    param.topk = k;
+    if (use_reorder_) {
+        CHECK_ARGUMENT(
+            param.factor > 0.0F,
+            fmt::format("factor must be positive when use_reorder is true, got {}", param.factor));
+        param.topk = static_cast<int64_t>(param.factor * static_cast<float>(k));
+    }
+    int64_t topk = param.topk;
+    if (buckets_per_data_ > 1) {
+        if (topk <= std::numeric_limits<int64_t>::max() / buckets_per_data_) {
+            topk *= buckets_per_data_;
+        } else {
+            topk = std::numeric_limits<int64_t>::max();
+        }
+    }
+    const auto& ft = param.is_inner_id_allowed;
+    ExprPtr expr = nullptr;
+    if (request.enable_attribute_filter_ and this->attr_filter_index_ != nullptr) {
+        auto& schema = this->attr_filter_index_->field_type_map_;
+        expr = AstParse(request.attribute_filter_str_, &schema);
+    }
+
+    // the probed buckets of all queries are classified in one call
+    auto scan_bucket_size = static_cast<int64_t>(param.scan_bucket_size);
+    auto candidate_buckets =
+        partition_strategy_->ClassifyDatasForSearch(query_data, query_count, param, &ctx);
+
+    // lambdas can't capture structured bindings in c++17
+    DatasetPtr dataset_results;
+    float* dists = nullptr;
+    int64_t* labels = nullptr;
+    std::tie(dataset_results, dists, labels) = create_fast_dataset(query_count * k, result_alloc);
+    dataset_results->NumElements(query_count)->Dim(k);
+    std::fill(labels, labels + query_count * k, -1);
+    std::fill(dists, dists + query_count * k, std::numeric_limits<float>::max());
+
+    // the queries of one worker are grouped by probed bucket, every bucket is scanned once for
+    // each block of BATCH_QUERY_BLOCK_SIZE queries probing it instead of once per query
+    auto search_range = [&](int64_t begin, int64_t end, Allocator* alloc) -> void {
+        QueryContext worker_ctx{.alloc = alloc, .stats = &stats};
+        auto range_count = end - begin;
+        Vector<ComputerInterfacePtr> computers(allocator_);
+        Vector<DistHeapPtr> heaps(allocator_);
+        Vector<float> heap_tops(range_count, std::numeric_limits<float>::max(), allocator_);
+        // (bucket, query, lower bound of the distances in the bucket)
+        Vector<std::tuple<BucketIdType, int64_t, float>> probes(allocator_);
+        probes.reserve(range_count * scan_bucket_size);
+        Vector<float> probe_query(dim_, allocator_);
+        Vector<float> centroid(dim_, allocator_);
+        for (int64_t i = begin; i < end; ++i) {
+            computers.emplace_back(bucket_->FactoryComputer(query_data + i * dim_));
+            heaps.emplace_back(DistanceHeap::MakeInstanceBySize<true, false>(allocator_, topk));
+            float query_norm = 0.0F;
+            if (param.adaptive_probe) {
+                query_norm = this->prepare_probe_query(query_data + i * dim_, probe_query);
+            }
+            for (int64_t j = 0; j < scan_bucket_size; ++j) {
+                auto bucket_id = candidate_buckets[i * scan_bucket_size + j];
+                if (bucket_id == -1) {
+                    break;
+                }
+                float bound = std::numeric_limits<float>::lowest();
+                if (param.adaptive_probe) {
+                    bound = this->probe_bounds(probe_query.data(), query_norm, bucket_id, centroid)
+                                .second;
+                }
+                probes.emplace_back(bucket_id, i - begin, bound);
+            }
+        }
+        std::sort(probes.begin(), probes.end());
+
+        ExecutorPtr executor = nullptr;
+        if (expr != nullptr) {
+            executor = Executor::MakeInstance(this->allocator_, expr, this->attr_filter_index_);
+            executor->Init();
+        }
+        Vector<ComputerInterfacePtr> block_computers(allocator_);
+        Vector<int64_t> block_queries(allocator_);
+        auto buffer = scan_buffer_pool_->TakeOne();
+        uint64_t group_begin = 0;
+        while (group_begin < probes.size()) {
+            if (param.time_cost != nullptr and param.time_cost->CheckOvertime()) {
+                stats.is_timeout.store(true, std::memory_order_relaxed);
+                break;
+            }
+            auto bucket_id = std::get<0>(probes[group_begin]);
+            auto group_end = group_begin;
+            while (group_end < probes.size() and std::get<0>(probes[group_end]) == bucket_id) {
+                ++group_end;
+            }
+            auto bucket_size = bucket_->GetBucketSize(bucket_id);
+            const auto* ids = bucket_->GetInnerIds(bucket_id);
+            Filter* attr_ft = nullptr;
+            if (executor != nullptr) {
+                executor->Clear();
+                attr_ft = executor->Run(bucket_id);
+            }
+            auto p = group_begin;
+            while (p < group_end) {
+                block_computers.clear();
+                block_queries.clear();
+                for (; p < group_end and block_queries.size() < BATCH_QUERY_BLOCK_SIZE; ++p) {
+                    auto local_id = std::get<1>(probes[p]);
+                    if (param.adaptive_probe and
+                        probe_pruned(std::get<2>(probes[p]),
+                                     param.probe_error_bound,
+                                     probe_threshold<KNN_SEARCH>(
+                                         heaps[local_id], topk, heap_tops[local_id], 0.0F))) {
+                        continue;
+                    }
+                    block_queries.emplace_back(local_id);
+                    block_computers.emplace_back(computers[local_id]);
+                }
+                if (block_queries.empty()) {
+                    continue;
+                }
+                auto* dist = buffer->Dists(block_queries.size() * bucket_size);
+                bucket_->ScanBucketByIdBatch(
+                    dist, block_computers.data(), block_queries.size(), bucket_id);
+                for (uint64_t q = 0; q < block_queries.size(); ++q) {
+                    this->select_candidates<KNN_SEARCH>(dist + q * bucket_size,
+                                                        ids,
+                                                        bucket_size,
+                                                        attr_ft,
+                                                        ft.get(),
+                                                        0.0F,
+                                                        topk,
+                                                        heaps[block_queries[q]],
+                                                        heap_tops[block_queries[q]],
+                                                        *buffer);
+                }
+            }
+            group_begin = group_end;
+        }
+        scan_buffer_pool_->ReturnOne(buffer);
 
-        auto cur_heap_top2 = std::numeric_limits<float>::max();
-        for (const auto& [origin_id, dist_val] : id_to_min_dist) {
-            if (dist_val < cur_heap_top2) {
-                search_result->Push(dist_val, origin_id);
+        for (int64_t i = begin; i < end; ++i) {
+            auto& search_result = heaps[i - begin];
+            if (buckets_per_data_ > 1) {
+                this->deduplicate(search_result, param.topk);
             }
-            if (search_result->Size() > origin_topk) {
+            if (use_reorder_) {
+                search_result =
+                    reorder_->Reorder(search_result, query_data + i * dim_, k, worker_ctx);
+            }
+            while (search_result->Size() > k) {
                 search_result->Pop();
             }
-            if (not search_result->Empty() and search_result->Size() == origin_topk) {
-                cur_heap_top2 = search_result->Top().first;
+            auto offset = i * k;
+            for (auto j = static_cast<int64_t>(search_result->Size()) - 1; j >= 0; --j) {
+                dists[offset + j] = search_result->Top().first;
+                labels[offset + j] = label_table_->GetLabelById(search_result->Top().second);
+                search_result->Pop();
             }
         }
+    };
+
+    auto worker_count = std::min<int64_t>(param.parallel_search_thread_count, query_count);
+    if (worker_count <= 1 or this->thread_pool_ == nullptr) {
+        search_range(0, query_count, result_alloc);
+    } else {
+        // the search allocator is not required to be thread-safe, use the index allocator
+        // for the temporary structures of the workers
+        auto step = (query_count + worker_count - 1) / worker_count;
+        auto chunk_count = (query_count + step - 1) / step;
+        this->thread_pool_->ParallelFor(chunk_count, [&](uint64_t i) {
+            auto begin = static_cast<int64_t>(i) * step;
+            search_range(begin, std::min(begin + step, query_count), this->allocator_);
+        });
     }
 
-    return search_result;
+    dataset_results->Statistics(stats.Dump());
+    return std::move(dataset_results);
 }
 
 void
@@ -917,7 +1628,22 @@ IVF::merge_one_unit(const MergeUnit& unit) {
     if (this->use_reorder_) {
         this->reorder_codes_->MergeOther(other_index->reorder_codes_, bias);
     }
+    // both indexes share the partition, the merged buckets are bounded by the larger radius
+    if (other_index->bucket_radius_.size() == this->bucket_radius_.size()) {
+        for (uint64_t i = 0; i < this->bucket_radius_.size(); ++i) {
+            this->bucket_radius_[i] =
+                std::max(this->bucket_radius_[i], other_index->bucket_radius_[i]);
+        }
+    } else {
+        this->bucket_radius_.clear();
+    }
+    this->probe_error_max_ = std::max(this->probe_error_max_, other_index->probe_error_max_);
+    this->probe_error_samples_ += other_index->probe_error_samples_;
+    if (this->probe_error_samples_ >= PROBE_ERROR_MIN_SAMPLES) {
+        this->probe_error_bound_ = this->probe_error_max_;
+    }
     this->total_elements_ += other_index->total_elements_;
+    this->next_probe_calibration_ = 2 * this->total_elements_;
 }
 
 void
@@ -960,6 +1686,9 @@ IVF::check_merge_illegal(const vsag::MergeUnit& unit) const {
 
 DatasetPtr
 IVF::SearchWithRequest(const SearchRequest& request) const {
+    if (request.query_->GetNumElements() > 1) {
+        return this->search_batch(request);
+    }
     SearchStatistics stats;
     QueryContext ctx{.alloc = request.search_allocator_, .stats = &stats};
 
@@ -1030,6 +1759,7 @@ IVF::CalDistanceById(const float* query,
     if (this->use_reorder_ && calculate_precise_distance) {
         return this->cal_distance_by_id(query, ids, count, this->reorder_codes_);
     }
+    std::shared_lock layout_lock(this->layout_mutex_);
     auto result = Dataset::Make();
     result->Owner(true, allocator_);
     auto* distances = static_cast<float*>(allocator_->Allocate(sizeof(float) * count));
@@ -1054,6 +1784,7 @@ IVF::CalDistanceById(const float* query,
 
 float
 IVF::CalcDistanceById(const float* query, int64_t id, bool calculate_precise_distance) const {
+    std::shared_lock layout_lock(this->layout_mutex_);
     if (this->use_reorder_ && calculate_precise_distance) {
         float dist = 0.0F;
         auto computer = this->reorder_codes_->FactoryComputer(query);
@@ -1069,6 +1800,7 @@ IVF::CalcDistanceById(const float* query, int64_t id, bool calculate_precise_dis
 
 void
 IVF::GetVectorByInnerId(InnerIdType inner_id, float* data) const {
+    std::shared_lock layout_lock(this->layout_mutex_);
     auto [bucket_id, bucket_offset] = this->get_location(inner_id);
     this->bucket_->GetCodesById(bucket_id, bucket_offset, reinterpret_cast<uint8_t*>(data));
 }
@@ -1129,6 +1861,7 @@ get_data_stats(const Vector<float>& data) {
 
 std::string
 IVF::GetStats() const {
+    std::shared_lock layout_lock(this->layout_mutex_);
     JsonType stats;
     // bucket_radius
     stats["bucket_count"].SetInt(this->bucket_->bucket_count_);
@@ -1180,6 +1913,7 @@ IVF::cal_memory_usage() {
     }
     memory += this->label_table_->GetMemoryUsage();
     memory += location_map_.size() * sizeof(uint64_t);
+    memory += bucket_radius_.size() * sizeof(float);
     memory += partition_strategy_->GetMemoryUsage();
     std::unique_lock lock(this->memory_usage_mutex_);
     this->current_memory_usage_.store(static_cast<int64_t>(memory));
@@ -15,6 +15,10 @@
 
 #pragma once
 
+#include <future>
+#include <mutex>
+#include <shared_mutex>
+
 #include "datacell/attribute_bucket_inverted_datacell.h"
 #include "datacell/bucket_datacell.h"
 #include "datacell/flatten_interface.h"
@@ -29,6 +33,7 @@
 #include "storage/stream_reader.h"
 #include "storage/stream_writer.h"
 #include "typing.h"
+#include "utils/scan_buffer.h"
 #include "vsag/index.h"
 
 namespace vsag {
@@ -46,7 +51,7 @@ public:
     explicit IVF(const ParamPtr& param, const IndexCommonParam& common_param)
         : IVF(std::dynamic_pointer_cast<IVFParameter>(param), common_param){};
 
-    ~IVF() override = default;
+    ~IVF() override;
 
     std::vector<int64_t>
     Add(const DatasetPtr& base, AddMode mode = AddMode::DEFAULT) override;
@@ -137,6 +142,9 @@ public:
     void
     Serialize(StreamWriter& writer) const override;
 
+    void
+    SetIO(const std::shared_ptr<Reader> reader) override;
+
     void
     Train(const DatasetPtr& data) override;
 
@@ -159,6 +167,67 @@ private:
     DistHeapPtr
     search(const DatasetPtr& query, const InnerSearchParam& param, QueryContext& ctx) const;
 
+    DatasetPtr
+    search_batch(const SearchRequest& request) const;
+
+    void
+    deduplicate(DistHeapPtr& search_result, int64_t topk) const;
+
+    template <InnerSearchMode mode>
+    void
+    select_candidates(const float* dist,
+                      const InnerIdType* ids,
+                      InnerIdType bucket_size,
+                      const Filter* attr_ft,
+                      const Filter* ft,
+                      float radius,
+                      int64_t topk,
+                      DistHeapPtr& heap,
+                      float& cur_heap_top,
+                      ScanBuffer& buffer) const;
+
+    std::pair<float, float>
+    probe_bounds(const float* query,
+                 float query_norm,
+                 BucketIdType bucket_id,
+                 Vector<float>& centroid) const;
+
+    float
+    prepare_probe_query(const float* query, Vector<float>& normalized) const;
+
+    void
+    order_probes(const float* query,
+                 Vector<BucketIdType>& buckets,
+                 Vector<float>& bounds,
+                 Vector<float>& remaining_bounds) const;
+
+    void
+    update_bucket_radius(const float* vector, BucketIdType bucket_id, Vector<float>& buffer);
+
+    void
+    calibrate_probe_error(const float* vectors, int64_t count, int64_t first_inner_id);
+
+    [[nodiscard]] std::pair<BucketIdType, BucketIdType>
+    find_rebalance_buckets() const;
+
+    void
+    schedule_rebalance();
+
+    void
+    rebalance();
+
+    bool
+    rebalance_step(BucketIdType split_bucket, BucketIdType merge_bucket);
+
+    void
+    decode_bucket(BucketIdType bucket_id, Vector<InnerIdType>& inner_ids, Vector<float>& vectors);
+
+    void
+    move_vector(const float* vector,
+                BucketIdType bucket_id,
+                InnerIdType inner_id,
+                Vector<float>& buffer);
+
     DatasetPtr
     reorder(int64_t topk,
             DistHeapPtr& input,
@@ -197,8 +266,43 @@ private:
 
     Vector<uint64_t> location_map_;
 
+    // max euclidean distance from a vector of each bucket to the bucket centroid, empty when the
+    // index was serialized before it was recorded (adaptive probing is then disabled)
+    Vector<float> bucket_radius_;
+    // max underestimate of the exact distance by the scanned codes, negative until the added
+    // batches gave PROBE_ERROR_MIN_SAMPLES vectors to calibrate it
+    float probe_error_bound_{-1.0F};
+    // the largest underestimate sampled so far, the number of sampled vectors and the index size
+    // from which the next added batch is sampled again; a deserialized bound counts as complete
+    float probe_error_max_{0.0F};
+    int64_t probe_error_samples_{0};
+    int64_t next_probe_calibration_{0};
+
+    static constexpr int64_t PROBE_ERROR_MIN_SAMPLES = 256;
+
     static const uint64_t LOCATION_SPLIT_BIT = 32;
 
+    // max queries scanning a bucket together in a batch search, bounds the distance buffer
+    static const uint64_t BATCH_QUERY_BLOCK_SIZE = 64;
+
+    // distances compared against the heap threshold at once before the survivors are pushed
+    static const uint64_t SELECT_BLOCK_SIZE = 256;
+
+    ScanBufferPoolPtr scan_buffer_pool_{nullptr};
+
+    // split oversized buckets into the slot of an undersized one after Add
+    bool auto_rebalance_{false};
+    float rebalance_split_ratio_{4.0F};
+    float rebalance_merge_ratio_{0.25F};
+    // held shared by the readers and writers of bucket layout, exclusive by a rebalance step
+    mutable std::shared_mutex layout_mutex_;
+    // guards scheduling of the background rebalance pass
+    std::mutex rebalance_mutex_;
+    std::future<void> rebalance_future_;
+
+    // at most bucket_count_ / MAX_REBALANCE_STEP_RATIO + 1 steps per rebalance pass
+    static const uint64_t MAX_REBALANCE_STEP_RATIO = 8;
+
     std::atomic<int64_t> delete_count_{0};
 
     // last_cal_memory_element_ is used to avoid cal memory usage too frequently
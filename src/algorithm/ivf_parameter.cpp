@@ -29,6 +29,25 @@ IVFParameter::FromJson(const JsonType& json) {
         this->buckets_per_data = static_cast<BucketIdType>(json[BUCKET_PER_DATA_KEY].GetInt());
     }
 
+    if (json.Contains(IVF_AUTO_REBALANCE_KEY)) {
+        this->auto_rebalance = json[IVF_AUTO_REBALANCE_KEY].GetBool();
+    }
+    if (json.Contains(IVF_REBALANCE_SPLIT_RATIO_KEY)) {
+        this->rebalance_split_ratio = json[IVF_REBALANCE_SPLIT_RATIO_KEY].GetFloat();
+        CHECK_ARGUMENT(this->rebalance_split_ratio > 1.0F,
+                       fmt::format("{} must be greater than 1.0, got: {}",
+                                   IVF_REBALANCE_SPLIT_RATIO_KEY,
+                                   this->rebalance_split_ratio));
+    }
+    if (json.Contains(IVF_REBALANCE_MERGE_RATIO_KEY)) {
+        this->rebalance_merge_ratio = json[IVF_REBALANCE_MERGE_RATIO_KEY].GetFloat();
+        CHECK_ARGUMENT(
+            this->rebalance_merge_ratio >= 0.0F and this->rebalance_merge_ratio < 1.0F,
+            fmt::format("{} must be in [0.0, 1.0), got: {}",
+                        IVF_REBALANCE_MERGE_RATIO_KEY,
+                        this->rebalance_merge_ratio));
+    }
+
     this->bucket_param = std::make_shared<BucketDataCellParameter>();
 
     CHECK_ARGUMENT(json.Contains(BUCKET_PARAMS_KEY),
@@ -57,6 +76,9 @@ IVFParameter::ToJson() const {
     json[IVF_PARTITION_STRATEGY_PARAMS_KEY].SetJson(
         this->ivf_partition_strategy_parameter->ToJson());
     json[BUCKET_PER_DATA_KEY].SetInt(this->buckets_per_data);
+    json[IVF_AUTO_REBALANCE_KEY].SetBool(this->auto_rebalance);
+    json[IVF_REBALANCE_SPLIT_RATIO_KEY].SetFloat(this->rebalance_split_ratio);
+    json[IVF_REBALANCE_MERGE_RATIO_KEY].SetFloat(this->rebalance_merge_ratio);
     return json;
 }
 bool
@@ -114,6 +136,21 @@ IVFSearchParameters::FromJson(const std::string& json_string) {
             params[INDEX_TYPE_IVF][GNO_IMI_SEARCH_PARAM_FIRST_ORDER_SCAN_RATIO].GetFloat();
     }
 
+    if (params[INDEX_TYPE_IVF].Contains(IVF_SEARCH_PARAM_ADAPTIVE_PROBE)) {
+        obj.adaptive_probe = params[INDEX_TYPE_IVF][IVF_SEARCH_PARAM_ADAPTIVE_PROBE].GetBool();
+    }
+    if (params[INDEX_TYPE_IVF].Contains(IVF_SEARCH_PARAM_PROBE_ERROR_BOUND)) {
+        obj.probe_error_bound =
+            params[INDEX_TYPE_IVF][IVF_SEARCH_PARAM_PROBE_ERROR_BOUND].GetFloat();
+    }
+    if (params[INDEX_TYPE_IVF].Contains(IVF_SEARCH_PARAM_ROUTER_EF_SEARCH)) {
+        obj.router_ef_search = params[INDEX_TYPE_IVF][IVF_SEARCH_PARAM_ROUTER_EF_SEARCH].GetInt();
+        CHECK_ARGUMENT(obj.router_ef_search >= 0,
+                       fmt::format("{} must be non-negative, got {}",
+                                   IVF_SEARCH_PARAM_ROUTER_EF_SEARCH,
+                                   obj.router_ef_search));
+    }
+
     return obj;
 }
 }  // namespace vsag
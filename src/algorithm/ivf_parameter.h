@@ -47,6 +47,12 @@ public:
     IVFPartitionStrategyParametersPtr ivf_partition_strategy_parameter{nullptr};
     BucketIdType buckets_per_data{1};
     int64_t train_sample_count{65536L};
+
+    // split buckets growing past split_ratio x the average size after inserts, the bucket slot
+    // is taken from a bucket below merge_ratio x the average whose vectors are merged away
+    bool auto_rebalance{false};
+    float rebalance_split_ratio{4.0F};
+    float rebalance_merge_ratio{0.25F};
 };
 
 class IVFSearchParameters : public IndexSearchParameter {
@@ -57,6 +63,12 @@ public:
 public:
     int64_t scan_buckets_count{30};
     float first_order_scan_ratio{1.0F};
+    // stop probing once no remaining bucket can improve the result
+    bool adaptive_probe{false};
+    // tolerated underestimate of the scanned distances, negative uses the calibrated one
+    float probe_error_bound{-1.0F};
+    // ef of the graph over the centroids, 0 uses the one set at build
+    int64_t router_ef_search{0};
 
 private:
     IVFSearchParameters() {
@@ -101,6 +101,7 @@ TEST_CASE("IVF Parameters Test", "[ut][IVFParameter]") {
     REQUIRE(param->build_thread_count == 3);
     REQUIRE(param->precise_codes_param->quantizer_parameter->GetTypeName() == "fp32");
     REQUIRE(param->train_sample_count == 65536L);
+    REQUIRE(param->auto_rebalance == false);
 
     index_param.ivf_train_type = "random";
     index_param.partition_strategy_type = "gno_imi";
@@ -142,6 +143,23 @@ TEST_CASE("IVF Parameters Test", "[ut][IVFParameter]") {
     search_param = vsag::IVFSearchParameters::FromJson(param_str);
     REQUIRE(search_param.scan_buckets_count == 20);
     REQUIRE(search_param.first_order_scan_ratio == 0.1f);
+    REQUIRE(search_param.adaptive_probe == false);
+    REQUIRE(search_param.probe_error_bound < 0.0f);
+    REQUIRE(search_param.router_ef_search == 0);
+
+    param_str = R"(
+    {
+        "ivf": {
+            "scan_buckets_count": 20,
+            "adaptive_probe": true,
+            "probe_error_bound": 0.5,
+            "router_ef_search": 64
+        }
+    })";
+    search_param = vsag::IVFSearchParameters::FromJson(param_str);
+    REQUIRE(search_param.adaptive_probe == true);
+    REQUIRE(search_param.probe_error_bound == 0.5f);
+    REQUIRE(search_param.router_ef_search == 64);
 }
 
 #define TEST_COMPATIBILITY_CASE(section_name, param_member, val1, val2, expect_compatible) \
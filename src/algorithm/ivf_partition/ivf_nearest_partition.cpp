@@ -43,22 +43,15 @@ IVFNearestPartition::IVFNearestPartition(BucketIdType bucket_count,
                                          const IndexCommonParam& common_param,
                                          IVFPartitionStrategyParametersPtr param)
     : IVFPartitionStrategy(common_param, bucket_count),
-      ivf_partition_strategy_param_(std::move(param)) {
+      ivf_partition_strategy_param_(std::move(param)),
+      common_param_(common_param) {
     this->factory_router_index(common_param);
 }
 
 void
 IVFNearestPartition::Train(const DatasetPtr dataset) {
     auto dim = this->dim_;
-    auto centroids = Dataset::Make();
     Vector<float> data(bucket_count_ * dim, allocator_);
-    Vector<LabelType> ids(this->bucket_count_, allocator_);
-    std::iota(ids.begin(), ids.end(), 0);
-    centroids->Ids(ids.data())
-        ->Dim(dim)
-        ->Float32Vectors(data.data())
-        ->NumElements(this->bucket_count_)
-        ->Owner(false);
 
     if (ivf_partition_strategy_param_->partition_train_type ==
         IVFNearestPartitionTrainerType::KMeansTrainer) {
@@ -78,14 +71,48 @@ IVFNearestPartition::Train(const DatasetPtr dataset) {
                    dim * sizeof(float));
         }
     }
+    this->build_router_index(data);
+    this->is_trained_ = true;
+}
+
+void
+IVFNearestPartition::UpdateCentroids(const Vector<BucketIdType>& bucket_ids,
+                                     const float* centroids) {
+    if (!is_trained_) {
+        throw VsagException(ErrorType::WRONG_STATUS, "Partition not trained");
+    }
+    Vector<float> data(bucket_count_ * dim_, allocator_);
+    for (BucketIdType i = 0; i < bucket_count_; ++i) {
+        this->route_index_ptr_->GetCodeByInnerId(i, (uint8_t*)(data.data() + i * dim_));
+    }
+    for (uint64_t i = 0; i < bucket_ids.size(); ++i) {
+        if (bucket_ids[i] < 0 or bucket_ids[i] >= bucket_count_) {
+            throw VsagException(ErrorType::INVALID_ARGUMENT, "Invalid bucket_id");
+        }
+        memcpy(data.data() + bucket_ids[i] * dim_, centroids + i * dim_, dim_ * sizeof(float));
+    }
+    // a moved centroid keeps stale graph edges, so the router graph is rebuilt, it only holds
+    // bucket_count_ vectors
+    this->factory_router_index(common_param_);
+    this->build_router_index(data);
+}
+
+void
+IVFNearestPartition::build_router_index(Vector<float>& centroids) {
     if (metric_type_ == MetricType::METRIC_TYPE_COSINE) {
         for (int i = 0; i < bucket_count_; ++i) {
-            Normalize(data.data() + i * dim_, data.data() + i * dim_, dim_);
+            Normalize(centroids.data() + i * dim_, centroids.data() + i * dim_, dim_);
         }
     }
-
-    auto build_result = this->route_index_ptr_->Build(centroids);
-    this->is_trained_ = true;
+    auto dataset = Dataset::Make();
+    Vector<LabelType> ids(this->bucket_count_, allocator_);
+    std::iota(ids.begin(), ids.end(), 0);
+    dataset->Ids(ids.data())
+        ->Dim(dim_)
+        ->Float32Vectors(centroids.data())
+        ->NumElements(this->bucket_count_)
+        ->Owner(false);
+    auto build_result = this->route_index_ptr_->Build(dataset);
 }
 
 Vector<BucketIdType>
@@ -93,6 +120,33 @@ IVFNearestPartition::ClassifyDatas(const void* datas,
                                    int64_t count,
                                    BucketIdType buckets_per_data,
                                    QueryContext* ctx) const {
+    return std::move(this->classify_datas(
+        datas, count, buckets_per_data, ivf_partition_strategy_param_->router_ef_search, ctx));
+}
+
+Vector<BucketIdType>
+IVFNearestPartition::ClassifyDatasForSearch(const void* datas,
+                                            int64_t count,
+                                            const InnerSearchParam& param,
+                                            QueryContext* ctx) {
+    auto ef_search = param.router_ef_search > 0 ? param.router_ef_search
+                                                : ivf_partition_strategy_param_->router_ef_search;
+    return std::move(this->classify_datas(datas, count, param.scan_bucket_size, ef_search, ctx));
+}
+
+Vector<BucketIdType>
+IVFNearestPartition::classify_datas(const void* datas,
+                                    int64_t count,
+                                    BucketIdType buckets_per_data,
+                                    int64_t ef_search,
+                                    QueryContext* ctx) const {
+    // the router graph only holds the centroids, so the ef scales with the buckets asked for
+    // unless one is given at build or search time
+    if (ef_search <= 0) {
+        ef_search = std::max<int64_t>(10, static_cast<int64_t>(buckets_per_data * 1.2));
+    }
+    auto search_param = fmt::format(
+        SEARCH_PARAM_TEMPLATE_STR, std::max<int64_t>(ef_search, buckets_per_data));
     std::mutex dist_cmp_reduce_mutex;
     uint32_t dist_cmp = 0;
     Vector<BucketIdType> result(buckets_per_data * count, -1, this->allocator_);
@@ -102,9 +156,6 @@ IVFNearestPartition::ClassifyDatas(const void* datas,
             ->Float32Vectors(reinterpret_cast<const float*>(datas) + i * this->dim_)
             ->NumElements(1)
             ->Owner(false);
-        auto search_param =
-            fmt::format(SEARCH_PARAM_TEMPLATE_STR,
-                        std::max<int64_t>(10, static_cast<int64_t>(buckets_per_data * 1.2)));
         FilterPtr filter = nullptr;
         auto search_result =
             this->route_index_ptr_->KnnSearch(query, buckets_per_data, search_param, filter);
@@ -155,8 +206,8 @@ IVFNearestPartition::factory_router_index(const IndexCommonParam& common_param)
     ParamPtr param_ptr;
     JsonType hgraph_json;
     hgraph_json["base_quantization_type"].SetString("fp32");
-    hgraph_json["max_degree"].SetInt(64);
-    hgraph_json["ef_construction"].SetInt(300);
+    hgraph_json["max_degree"].SetInt(ivf_partition_strategy_param_->router_max_degree);
+    hgraph_json["ef_construction"].SetInt(ivf_partition_strategy_param_->router_ef_construction);
 
     param_ptr = HGraph::CheckAndMappingExternalParam(hgraph_json, common_param);
     this->route_index_ptr_ = std::make_shared<HGraph>(param_ptr, common_param);
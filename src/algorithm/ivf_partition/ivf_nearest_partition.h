@@ -38,9 +38,18 @@ public:
                   BucketIdType buckets_per_data,
                   QueryContext* ctx) const override;
 
+    Vector<BucketIdType>
+    ClassifyDatasForSearch(const void* datas,
+                           int64_t count,
+                           const InnerSearchParam& param,
+                           QueryContext* ctx) override;
+
     void
     GetCentroid(BucketIdType bucket_id, Vector<float>& centroid) override;
 
+    void
+    UpdateCentroids(const Vector<BucketIdType>& bucket_ids, const float* centroids) override;
+
     void
     Serialize(StreamWriter& writer) override;
 
@@ -58,6 +67,19 @@ public:
 private:
     void
     factory_router_index(const IndexCommonParam& common_param);
+
+    void
+    build_router_index(Vector<float>& centroids);
+
+    Vector<BucketIdType>
+    classify_datas(const void* datas,
+                   int64_t count,
+                   BucketIdType buckets_per_data,
+                   int64_t ef_search,
+                   QueryContext* ctx) const;
+
+private:
+    IndexCommonParam common_param_;
 };
 
 }  // namespace vsag
@@ -110,3 +110,47 @@ TEST_CASE("IVF Nearest Partition Serialize Test", "[ut][IVFNearestPartition]") {
         REQUIRE(id == class_result[i]);
     }
 }
+
+TEST_CASE("IVF Nearest Partition Router EF Test", "[ut][IVFNearestPartition]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 64;
+    int64_t bucket_count = 200;
+    IndexCommonParam param;
+    param.dim_ = dim;
+    param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    param.allocator_ = allocator;
+    IVFPartitionStrategyParametersPtr strategy_param =
+        std::make_shared<IVFPartitionStrategyParameters>();
+    strategy_param->router_ef_search = 20;
+    auto partition = std::make_unique<IVFNearestPartition>(bucket_count, param, strategy_param);
+
+    int64_t data_count = 1000L;
+    auto vec = fixtures::generate_vectors(data_count, dim, true, 95);
+    auto dataset = Dataset::Make();
+    dataset->Float32Vectors(vec.data())->Dim(dim)->NumElements(data_count)->Owner(false);
+    partition->Train(dataset);
+
+    std::vector<float> centroids(bucket_count * dim);
+    Vector<float> centroid(dim, allocator.get());
+    for (BucketIdType i = 0; i < bucket_count; ++i) {
+        partition->GetCentroid(i, centroid);
+        std::copy(centroid.begin(), centroid.end(), centroids.begin() + i * dim);
+    }
+
+    // a search ef covering every centroid makes the router exact
+    InnerSearchParam search_param;
+    search_param.scan_bucket_size = 5;
+    search_param.router_ef_search = bucket_count;
+    int64_t query_count = 100;
+    auto buckets =
+        partition->ClassifyDatasForSearch(vec.data(), query_count, search_param, nullptr);
+    REQUIRE(buckets.size() == query_count * search_param.scan_bucket_size);
+    for (int64_t i = 0; i < query_count; ++i) {
+        std::vector<std::pair<float, BucketIdType>> dists;
+        for (BucketIdType j = 0; j < bucket_count; ++j) {
+            dists.emplace_back(L2Sqr(vec.data() + i * dim, centroids.data() + j * dim, &dim), j);
+        }
+        std::sort(dists.begin(), dists.end());
+        REQUIRE(buckets[i * search_param.scan_bucket_size] == dists[0].second);
+    }
+}
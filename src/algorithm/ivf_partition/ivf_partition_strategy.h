@@ -72,6 +72,17 @@ public:
     virtual void
     GetCentroid(BucketIdType bucket_id, Vector<float>& centroid) = 0;
 
+    /**
+     * @brief Replaces the centroids of some buckets, e.g. after a bucket is split.
+     *
+     * centroids holds bucket_ids.size() vectors of dim floats.
+     */
+    virtual void
+    UpdateCentroids(const Vector<BucketIdType>& bucket_ids, const float* centroids) {
+        throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                            "partition strategy doesn't support UpdateCentroids");
+    }
+
     virtual void
     Serialize(StreamWriter& writer) {
         StreamWriter::WriteObj(writer, this->is_trained_);
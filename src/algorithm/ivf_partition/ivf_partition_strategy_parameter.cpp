@@ -51,6 +51,28 @@ IVFPartitionStrategyParameters::FromJson(const JsonType& json) {
                         IVF_PARTITION_STRATEGY_TYPE_GNO_IMI));
         this->gnoimi_param->FromJson(json[IVF_PARTITION_STRATEGY_TYPE_GNO_IMI]);
     }
+
+    if (json.Contains(IVF_ROUTER_MAX_DEGREE_KEY)) {
+        this->router_max_degree = json[IVF_ROUTER_MAX_DEGREE_KEY].GetInt();
+        CHECK_ARGUMENT(this->router_max_degree > 0,
+                       fmt::format("{} must be positive, got {}",
+                                   IVF_ROUTER_MAX_DEGREE_KEY,
+                                   this->router_max_degree));
+    }
+    if (json.Contains(IVF_ROUTER_EF_CONSTRUCTION_KEY)) {
+        this->router_ef_construction = json[IVF_ROUTER_EF_CONSTRUCTION_KEY].GetInt();
+        CHECK_ARGUMENT(this->router_ef_construction > 0,
+                       fmt::format("{} must be positive, got {}",
+                                   IVF_ROUTER_EF_CONSTRUCTION_KEY,
+                                   this->router_ef_construction));
+    }
+    if (json.Contains(IVF_ROUTER_EF_SEARCH_KEY)) {
+        this->router_ef_search = json[IVF_ROUTER_EF_SEARCH_KEY].GetInt();
+        CHECK_ARGUMENT(this->router_ef_search >= 0,
+                       fmt::format("{} must be non-negative, got {}",
+                                   IVF_ROUTER_EF_SEARCH_KEY,
+                                   this->router_ef_search));
+    }
 }
 
 JsonType
@@ -70,6 +92,9 @@ IVFPartitionStrategyParameters::ToJson() const {
     if (this->partition_strategy_type == IVFPartitionStrategyType::GNO_IMI) {
         json[IVF_PARTITION_STRATEGY_TYPE_GNO_IMI].SetJson(this->gnoimi_param->ToJson());
     }
+    json[IVF_ROUTER_MAX_DEGREE_KEY].SetInt(this->router_max_degree);
+    json[IVF_ROUTER_EF_CONSTRUCTION_KEY].SetInt(this->router_ef_construction);
+    json[IVF_ROUTER_EF_SEARCH_KEY].SetInt(this->router_ef_search);
     return json;
 }
 
@@ -52,6 +52,12 @@ public:
         IVFNearestPartitionTrainerType::KMeansTrainer};
     IVFPartitionStrategyType partition_strategy_type{IVFPartitionStrategyType::IVF};
     GNOIMIParameterPtr gnoimi_param{nullptr};
+
+    // the ivf strategy routes vectors through an hgraph over the centroids
+    int64_t router_max_degree{64};
+    int64_t router_ef_construction{300};
+    // 0 derives the ef from the number of buckets asked for
+    int64_t router_ef_search{0};
 };
 
 using IVFPartitionStrategyParametersPtr = std::shared_ptr<IVFPartitionStrategyParameters>;
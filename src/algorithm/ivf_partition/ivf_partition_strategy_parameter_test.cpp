@@ -54,3 +54,34 @@ TEST_CASE("IVF Partition Strategy Parameters CheckCompatibility",
     auto other_type_param = std::make_shared<vsag::EmptyParameter>();
     REQUIRE_FALSE(param->CheckCompatibility(other_type_param));
 }
+
+TEST_CASE("IVF Partition Strategy Router Parameters", "[ut][IVFPartitionStrategyParameters]") {
+    auto param = std::make_shared<vsag::IVFPartitionStrategyParameters>();
+    param->FromString(R"({"partition_strategy_type": "ivf", "ivf_train_type": "kmeans"})");
+    REQUIRE(param->router_max_degree == 64);
+    REQUIRE(param->router_ef_construction == 300);
+    REQUIRE(param->router_ef_search == 0);
+
+    param->FromString(R"({
+        "partition_strategy_type": "ivf",
+        "ivf_train_type": "kmeans",
+        "router_max_degree": 32,
+        "router_ef_construction": 200,
+        "router_ef_search": 80
+    })");
+    REQUIRE(param->router_max_degree == 32);
+    REQUIRE(param->router_ef_construction == 200);
+    REQUIRE(param->router_ef_search == 80);
+    vsag::ParameterTest::TestToJson(param);
+
+    REQUIRE_THROWS(param->FromString(R"({
+        "partition_strategy_type": "ivf",
+        "ivf_train_type": "kmeans",
+        "router_max_degree": 0
+    })"));
+    REQUIRE_THROWS(param->FromString(R"({
+        "partition_strategy_type": "ivf",
+        "ivf_train_type": "kmeans",
+        "router_ef_search": -1
+    })"));
+}
@@ -15,10 +15,12 @@
 
 #include "pyramid.h"
 
+#include <atomic>
 #include <chrono>
 
 #include "algorithm/inner_index_interface.h"
 #include "analyzer/analyzer.h"
+#include "datacell/flatten_datacell_parameter.h"
 #include "datacell/flatten_interface.h"
 #include "impl/heap/standard_heap.h"
 #include "impl/odescent/odescent_graph_builder.h"
@@ -42,6 +44,31 @@ split(const std::string& str, char delimiter) {
     return vec;
 }
 
+std::vector<std::vector<std::string>>
+remove_covered_paths(const std::vector<std::vector<std::string>>& paths) {
+    // path j covers path i when it is a prefix of it; of two equal paths the first one is kept
+    auto is_covered = [&paths](uint64_t i) {
+        for (uint64_t j = 0; j < paths.size(); ++j) {
+            if (j == i or paths[j].size() > paths[i].size() or
+                (paths[j].size() == paths[i].size() and j > i)) {
+                continue;
+            }
+            if (std::equal(paths[j].begin(), paths[j].end(), paths[i].begin())) {
+                return true;
+            }
+        }
+        return false;
+    };
+    std::vector<std::vector<std::string>> remaining;
+    remaining.reserve(paths.size());
+    for (uint64_t i = 0; i < paths.size(); ++i) {
+        if (not is_covered(i)) {
+            remaining.push_back(paths[i]);
+        }
+    }
+    return remaining;
+}
+
 static inline uint64_t
 get_suitable_max_degree(int64_t data_num) {
     if (data_num < 100'000) {
@@ -97,6 +124,21 @@ IndexNode::Build(ODescent& odescent) {
     }
 }
 
+void
+IndexNode::BuildFlat(std::vector<IndexNode*>& pending) {
+    std::unique_lock lock(mutex_);
+    if (not ids_.empty() and status_ == Status::NO_INDEX) {
+        status_ = Status::FLAT;
+        if (ids_.size() >= index_min_size_) {
+            build_scheduled_ = true;
+            pending.push_back(this);
+        }
+    }
+    for (const auto& item : children_) {
+        item.second->BuildFlat(pending);
+    }
+}
+
 void
 IndexNode::AddChild(const std::string& key) {
     // AddChild is not thread-safe; ensure thread safety in calls to it.
@@ -125,7 +167,9 @@ IndexNode::Deserialize(StreamReader& reader) {
     // deserialize `level_`
     StreamReader::ReadObj(reader, level_);
     // deserialize `status_`
-    StreamReader::ReadObj(reader, status_);
+    auto status = Status::NO_INDEX;
+    StreamReader::ReadObj(reader, status);
+    status_ = status;
     if (status_ == Status::GRAPH) {
         graph_ = std::make_shared<SparseGraphDataCell>(
             std::dynamic_pointer_cast<SparseGraphDatacellParameter>(graph_param_), allocator_);
@@ -150,10 +194,11 @@ IndexNode::Serialize(StreamWriter& writer) const {
     // serialize `level_`
     StreamWriter::WriteObj(writer, level_);
     // serialize `status_`
-    StreamWriter::WriteObj(writer, status_);
-    if (status_ == Status::GRAPH) {
+    auto status = status_.load();
+    StreamWriter::WriteObj(writer, status);
+    if (status == Status::GRAPH) {
         graph_->Serialize(writer);
-    } else if (status_ == Status::FLAT) {
+    } else if (status == Status::FLAT) {
         StreamWriter::WriteVector(writer, ids_);
     }
     // serialize `children`
@@ -170,18 +215,7 @@ void
 IndexNode::Init() {
     if (status_ == Status::NO_INDEX) {
         if (ids_.size() >= index_min_size_) {
-            if (not ids_.empty() and level_ != 0) {
-                auto new_max_degree = get_suitable_max_degree(static_cast<int64_t>(ids_.size()));
-                if (new_max_degree < graph_param_->max_degree_) {
-                    auto new_graph_param = std::make_shared<SparseGraphDatacellParameter>();
-                    new_graph_param->FromJson(graph_param_->ToJson());
-                    new_graph_param->max_degree_ =
-                        get_suitable_max_degree(static_cast<int64_t>(ids_.size()));
-                    graph_param_ = new_graph_param;
-                }
-            }
-            graph_ = std::make_shared<SparseGraphDataCell>(
-                std::dynamic_pointer_cast<SparseGraphDatacellParameter>(graph_param_), allocator_);
+            graph_ = CreateGraph(ids_.size());
             status_ = Status::GRAPH;
         } else {
             status_ = Status::FLAT;
@@ -189,22 +223,30 @@ IndexNode::Init() {
     }
 }
 
+GraphInterfacePtr
+IndexNode::CreateGraph(uint64_t size) {
+    if (size != 0 and level_ != 0) {
+        auto new_max_degree = get_suitable_max_degree(static_cast<int64_t>(size));
+        if (new_max_degree < graph_param_->max_degree_) {
+            auto new_graph_param = std::make_shared<SparseGraphDatacellParameter>();
+            new_graph_param->FromJson(graph_param_->ToJson());
+            new_graph_param->max_degree_ = new_max_degree;
+            graph_param_ = new_graph_param;
+        }
+    }
+    return std::make_shared<SparseGraphDataCell>(
+        std::dynamic_pointer_cast<SparseGraphDatacellParameter>(graph_param_), allocator_);
+}
+
 void
-IndexNode::Search(const SearchFunc& search_func,
-                  const VisitedListPtr& vl,
-                  const DistHeapPtr& search_result,
-                  uint64_t ef_search) const {
+IndexNode::CollectIndexedNodes(std::vector<const IndexNode*>& nodes) const {
     if (status_ != IndexNode::Status::NO_INDEX) {
-        auto self_search_result = search_func(this, vl);
-        search_result->Merge(*self_search_result);
-        while (search_result->Size() > ef_search) {
-            search_result->Pop();
-        }
+        nodes.push_back(this);
         return;
     }
 
     for (const auto& [key, node] : children_) {
-        node->Search(search_func, vl, search_result, ef_search);
+        node->CollectIndexedNodes(nodes);
     }
 }
 
@@ -225,9 +267,17 @@ Pyramid::build_by_odescent(const DatasetPtr& base) {
     }
     auto codes = use_reorder_ ? precise_codes_ : base_codes_;
 
+    cur_element_count_ = data_num;
+    if (async_build_) {
+        std::vector<IndexNode*> pending;
+        root_->BuildFlat(pending);
+        for (auto* node : pending) {
+            this->schedule_subindex_build(node);
+        }
+        return {};
+    }
     ODescent graph_builder(odescent_param_, codes, allocator_, this->thread_pool_.get());
     root_->Build(graph_builder);
-    cur_element_count_ = data_num;
     return {};
 }
 
@@ -265,9 +315,15 @@ Pyramid::KnnSearch(const DatasetPtr& query,
         search_param.is_inner_id_allowed =
             std::make_shared<InnerIdWrapperFilter>(filter, *label_table_);
     }
-    SearchFunc search_func = [&](const IndexNode* node, const VisitedListPtr& vl) {
-        return this->search_node(
-            node, vl, search_param, query, base_codes_, ctx, parsed_param.subindex_ef_search);
+    SearchFunc search_func = [&](const IndexNode* node, const VisitedListPtr& vl, float bound) {
+        return this->search_node(node,
+                                 vl,
+                                 search_param,
+                                 query,
+                                 base_codes_,
+                                 ctx,
+                                 parsed_param.subindex_ef_search,
+                                 bound);
     };
 
     auto result = this->search_impl(query, search_func, search_param);
@@ -307,9 +363,15 @@ Pyramid::RangeSearch(const DatasetPtr& query,
         search_param.is_inner_id_allowed =
             std::make_shared<InnerIdWrapperFilter>(filter, *label_table_);
     }
-    SearchFunc search_func = [&](const IndexNode* node, const VisitedListPtr& vl) {
-        return this->search_node(
-            node, vl, search_param, query, base_codes_, ctx, parsed_param.subindex_ef_search);
+    SearchFunc search_func = [&](const IndexNode* node, const VisitedListPtr& vl, float bound) {
+        return this->search_node(node,
+                                 vl,
+                                 search_param,
+                                 query,
+                                 base_codes_,
+                                 ctx,
+                                 parsed_param.subindex_ef_search,
+                                 bound);
     };
 
     auto result = this->search_impl(query, search_func, search_param);
@@ -330,54 +392,27 @@ Pyramid::search_impl(const DatasetPtr& query,
         "query_path is required when level0 is not built");
     CHECK_ARGUMENT(query->GetFloat32Vectors() != nullptr, "query vectors is required");
 
-    DistHeapPtr search_result = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
-
     std::shared_lock<std::shared_mutex> lock(resize_mutex_);
-    auto vl = pool_->TakeOne();
+    std::vector<const IndexNode*> nodes;
     if (query_path != nullptr) {
-        std::vector<std::future<void>> futures;
-        const std::string& current_path = query_path[0];
-        auto parsed_path = parse_path(current_path);
-        Vector<DistHeapPtr> search_result_lists(parsed_path.size(), allocator_);
-        for (uint32_t i = 0; i < parsed_path.size(); ++i) {
-            const auto& one_path = parsed_path[i];
-            search_result_lists[i] = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+        // a subtree named by several paths is searched once
+        auto parsed_path = remove_covered_paths(parse_path(query_path[0]));
+        for (const auto& one_path : parsed_path) {
             IndexNode* node = root_.get();
-            bool valid = true;
             for (const auto& item : one_path) {
                 node = node->GetChild(item, false);
                 if (node == nullptr) {
-                    valid = false;
                     break;
                 }
             }
-            if (valid) {
-                if (thread_pool_ != nullptr && search_param.parallel_search_thread_count > 1) {
-                    futures.push_back(thread_pool_->GeneralEnqueue([&, node, i]() -> void {
-                        node->Search(search_func, vl, search_result_lists[i], search_param.ef);
-                    }));
-                } else {
-                    node->Search(search_func, vl, search_result_lists[i], search_param.ef);
-                }
-            }
-        }
-
-        for (auto& future : futures) {
-            future.get();
-        }
-
-        for (uint32_t i = 0; i < search_result_lists.size(); ++i) {
-            if (i != 0) {
-                search_result->Merge(*search_result_lists[i]);
-            } else {
-                search_result = search_result_lists[i];
+            if (node != nullptr) {
+                node->CollectIndexedNodes(nodes);
             }
         }
-
     } else {
-        root_->Search(search_func, vl, search_result, search_param.ef);
+        root_->CollectIndexedNodes(nodes);
     }
-    pool_->ReturnOne(vl);
+    DistHeapPtr search_result = this->search_subtrees(nodes, search_func, search_param);
 
     if (use_reorder_) {
         search_result = this->reorder_->Reorder(
@@ -421,6 +456,8 @@ Pyramid::GetNumElements() const {
 
 void
 Pyramid::Serialize(StreamWriter& writer) const {
+    // the nodes are written as they are once no background build can swap them
+    this->wait_subindex_builds();
     label_table_->Serialize(writer);
     base_codes_->Serialize(writer);
     if (use_reorder_) {
@@ -434,6 +471,7 @@ Pyramid::Serialize(StreamWriter& writer) const {
     basic_info[INDEX_PARAM].SetString(this->create_param_ptr_->ToString());
     auto metadata = std::make_shared<Metadata>();
     metadata->Set(BASIC_INFO, basic_info);
+    this->write_operation_lsn(metadata);
     auto footer = std::make_shared<Footer>(metadata);
     footer->Write(writer);
 }
@@ -445,6 +483,7 @@ Pyramid::Deserialize(StreamReader& reader) {
     auto metadata = footer->GetMetadata();
     auto basic_info = metadata->Get(BASIC_INFO);
     auto max_capacity = basic_info["max_capacity"].GetInt();
+    this->read_operation_lsn(metadata);
 
     BufferStreamReader buffer_reader(
         &reader, std::numeric_limits<uint64_t>::max(), this->allocator_);
@@ -697,6 +736,8 @@ Pyramid::CheckAndMappingExternalParam(const JsonType& external_param,
          {GRAPH_KEY, ODESCENT_PARAMETER_NEIGHBOR_SAMPLE_RATE}},
         {PYRAMID_INDEX_MIN_SIZE, {INDEX_MIN_SIZE}},
         {PYRAMID_SUPPORT_DUPLICATE, {SUPPORT_DUPLICATE}},
+        {PYRAMID_ASYNC_BUILD, {ASYNC_BUILD_KEY}},
+        {PYRAMID_MAX_BACKGROUND_BUILDS, {MAX_BACKGROUND_BUILDS_KEY}},
         {PYRAMID_SUPPORT_DUPLICATE, {GRAPH_KEY, SUPPORT_DUPLICATE}}};
 
     std::string str = format_map(HGRAPH_PARAMS_TEMPLATE, DEFAULT_MAP);
@@ -752,12 +793,23 @@ Pyramid::add_one_point(IndexNode* node, InnerIdType inner_id, const float* vecto
     std::unique_lock graph_lock(node->mutex_);
 
     if (node->status_ == IndexNode::Status::NO_INDEX) {
-        node->Init();
+        if (async_build_) {
+            // the graph is built in the background once the node is large enough
+            node->status_ = IndexNode::Status::FLAT;
+        } else {
+            node->Init();
+        }
         Vector<InnerIdType>(allocator_).swap(node->ids_);
     }
 
     if (node->status_ == IndexNode::Status::FLAT) {
         node->ids_.push_back(inner_id);
+        if (async_build_ and not node->build_scheduled_ and
+            node->ids_.size() >= node->index_min_size_) {
+            node->build_scheduled_ = true;
+            graph_lock.unlock();
+            this->schedule_subindex_build(node);
+        }
         return;
     }
 
@@ -765,41 +817,256 @@ Pyramid::add_one_point(IndexNode* node, InnerIdType inner_id, const float* vecto
         node->graph_->InsertNeighborsById(inner_id, Vector<InnerIdType>(allocator_));
         node->entry_point_ = inner_id;
     } else {
-        InnerSearchParam search_param;
-        search_param.ef = ef_construction_;
-        search_param.topk = static_cast<int64_t>(ef_construction_);
-        search_param.search_mode = KNN_SEARCH;
-        search_param.hops_limit = 10000;  // Add hops limit to prevent infinite loop
-        if (support_duplicate_) {
-            search_param.find_duplicate = true;
-        }
-        auto codes = use_reorder_ ? precise_codes_ : base_codes_;
         bool update_entry_point;
         {
             std::scoped_lock<std::mutex> entry_point_lock(entry_point_mutex_);
             update_entry_point = is_update_entry_point(node->graph_->TotalCount());
         }
-        search_param.ep = node->entry_point_;
+        auto graph = node->graph_;
+        auto entry_point = node->entry_point_;
         if (not update_entry_point) {
             graph_lock.unlock();
         }
 
+        if (this->link_into_graph(graph, entry_point, inner_id, vector) and update_entry_point) {
+            node->entry_point_ = inner_id;
+        }
+    }
+}
+
+bool
+Pyramid::link_into_graph(const GraphInterfacePtr& graph,
+                         InnerIdType entry_point,
+                         InnerIdType inner_id,
+                         const float* vector) {
+    InnerSearchParam search_param;
+    search_param.ef = ef_construction_;
+    search_param.topk = static_cast<int64_t>(ef_construction_);
+    search_param.search_mode = KNN_SEARCH;
+    search_param.hops_limit = 10000;  // Add hops limit to prevent infinite loop
+    if (support_duplicate_) {
+        search_param.find_duplicate = true;
+    }
+    search_param.ep = entry_point;
+    auto codes = use_reorder_ ? precise_codes_ : base_codes_;
+
+    auto vl = pool_->TakeOne();
+    auto results =
+        searcher_->Search(graph, codes, vl, vector, search_param, (LabelTablePtr) nullptr, nullptr);
+    pool_->ReturnOne(vl);
+    if (this->support_duplicate_ && search_param.duplicate_id >= 0) {
+        std::unique_lock lock(this->label_lookup_mutex_);
+        graph->SetDuplicateId(static_cast<InnerIdType>(search_param.duplicate_id), inner_id);
+        return false;
+    }
+    mutually_connect_new_element(
+        inner_id, results, graph, codes, points_mutex_, allocator_, alpha_);
+    return true;
+}
+
+void
+Pyramid::schedule_subindex_build(IndexNode* node) {
+    std::lock_guard lock(build_queue_mutex_);
+    build_queue_.push_back(node);
+    if (running_builds_ >= max_background_builds_) {
+        // picked up by a running builder once it is done with its node
+        return;
+    }
+    ++running_builds_;
+    this->thread_pool_->Enqueue([this]() { this->run_subindex_builds(); });
+}
+
+void
+Pyramid::run_subindex_builds() {
+    while (true) {
+        IndexNode* node = nullptr;
+        {
+            std::lock_guard lock(build_queue_mutex_);
+            if (build_queue_.empty()) {
+                --running_builds_;
+                build_finished_.notify_all();
+                return;
+            }
+            node = build_queue_.front();
+            build_queue_.pop_front();
+        }
+        try {
+            this->build_subindex(node);
+        } catch (const std::exception& e) {
+            // the node stays FLAT, its next add schedules the build again
+            logger::error("[Pyramid] background subindex build failed: {}", e.what());
+            std::unique_lock node_lock(node->mutex_);
+            node->build_scheduled_ = false;
+        }
+    }
+}
+
+void
+Pyramid::build_subindex(IndexNode* node) {
+    auto codes = use_reorder_ ? precise_codes_ : base_codes_;
+    Vector<InnerIdType> ids(allocator_);
+    GraphInterfacePtr graph = nullptr;
+    {
+        std::unique_lock node_lock(node->mutex_);
+        ids.assign(node->ids_.begin(), node->ids_.end());
+        graph = node->CreateGraph(ids.size());
+    }
+    InnerIdType entry_point = ids.empty() ? 0 : ids[0];
+    uint64_t linked_count = 0;
+    if (odescent_param_ != nullptr and not ids.empty()) {
+        // the build must not hold the resize lock: codes that stay in place while growing are
+        // read directly, the others through a copy taken under the lock
+        auto build_codes = codes;
+        if (not codes->SupportConcurrentResize()) {
+            build_codes = this->copy_vectors(codes, ids);
+        }
+        ODescent graph_builder(odescent_param_, build_codes, allocator_, nullptr);
+        graph_builder.SetMaxDegree(static_cast<int32_t>(graph->MaximumDegree()));
+        if (build_codes == codes) {
+            graph_builder.Build(ids);
+            graph_builder.SaveGraph(graph);
+        } else {
+            graph_builder.Build();
+            graph_builder.SaveGraph(graph, ids);
+        }
+        linked_count = ids.size();
+    }
+
+    Vector<float> vector(dim_, allocator_);
+    while (true) {
+        {
+            std::unique_lock node_lock(node->mutex_);
+            if (linked_count == node->ids_.size()) {
+                node->graph_ = graph;
+                node->entry_point_ = entry_point;
+                node->status_ = IndexNode::Status::GRAPH;
+                node->build_scheduled_ = false;
+                Vector<InnerIdType>(allocator_).swap(node->ids_);
+                return;
+            }
+            // the points added while the graph was built
+            ids.assign(node->ids_.begin() + static_cast<int64_t>(linked_count), node->ids_.end());
+        }
+        for (const auto& inner_id : ids) {
+            std::shared_lock resize_lock(resize_mutex_);
+            bool release = false;
+            const auto* buffer = codes->GetCodesById(inner_id, release);
+            codes->Decode(buffer, vector.data());
+            if (release) {
+                codes->Release(buffer);
+            }
+            if (graph->TotalCount() == 0) {
+                graph->InsertNeighborsById(inner_id, Vector<InnerIdType>(allocator_));
+                entry_point = inner_id;
+                continue;
+            }
+            bool update_entry_point;
+            {
+                std::scoped_lock<std::mutex> entry_point_lock(entry_point_mutex_);
+                update_entry_point = is_update_entry_point(graph->TotalCount());
+            }
+            if (this->link_into_graph(graph, entry_point, inner_id, vector.data()) and
+                update_entry_point) {
+                entry_point = inner_id;
+            }
+        }
+        linked_count += ids.size();
+    }
+}
+
+FlattenInterfacePtr
+Pyramid::copy_vectors(const FlattenInterfacePtr& codes, const Vector<InnerIdType>& ids) const {
+    auto param = std::make_shared<FlattenDataCellParameter>();
+    param->quantizer_parameter = std::make_shared<FP32QuantizerParameter>();
+    param->io_parameter = std::make_shared<MemoryIOParameter>();
+    auto copy = FlattenInterface::MakeInstance(param, codes->ExportCommonParam());
+    auto count = static_cast<InnerIdType>(ids.size());
+    Vector<float> vectors(static_cast<uint64_t>(count) * dim_, allocator_);
+    {
+        std::shared_lock resize_lock(resize_mutex_);
+        for (InnerIdType i = 0; i < count; ++i) {
+            bool release = false;
+            const auto* buffer = codes->GetCodesById(ids[i], release);
+            codes->Decode(buffer, vectors.data() + static_cast<uint64_t>(i) * dim_);
+            if (release) {
+                codes->Release(buffer);
+            }
+        }
+    }
+    copy->Train(vectors.data(), count);
+    copy->BatchInsertVector(vectors.data(), count);
+    return copy;
+}
+
+void
+Pyramid::wait_subindex_builds() const {
+    std::unique_lock lock(build_queue_mutex_);
+    build_finished_.wait(lock, [this]() { return running_builds_ == 0; });
+}
+
+DistHeapPtr
+Pyramid::search_subtrees(const std::vector<const IndexNode*>& nodes,
+                         const SearchFunc& search_func,
+                         const InnerSearchParam& search_param) const {
+    auto capacity = search_param.ef;
+    uint64_t worker_count = 1;
+    if (this->thread_pool_ != nullptr and search_param.parallel_search_thread_count > 1) {
+        worker_count = std::min<uint64_t>(search_param.parallel_search_thread_count, nodes.size());
+        worker_count = std::max<uint64_t>(worker_count, 1);
+    }
+
+    // the ef-th distance of any worker bounds the ef-th distance of the merged result, so the
+    // workers share the smallest one to drop the candidates of their subtrees early
+    std::atomic<float> bound(search_param.radius);
+    auto tighten_bound = [&bound](float dist) {
+        auto current = bound.load(std::memory_order_relaxed);
+        while (dist < current and
+               not bound.compare_exchange_weak(current, dist, std::memory_order_relaxed)) {
+        }
+    };
+
+    std::vector<DistHeapPtr> heaps(worker_count);
+    std::atomic<uint64_t> next_node(0);
+    auto search_worker = [&](uint64_t worker_id) -> void {
+        auto heap = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+        // the subtrees are disjoint, so one visited list serves all those of a worker
         auto vl = pool_->TakeOne();
-        auto results = searcher_->Search(
-            node->graph_, codes, vl, vector, search_param, (LabelTablePtr) nullptr, nullptr);
+        for (auto i = next_node.fetch_add(1); i < nodes.size(); i = next_node.fetch_add(1)) {
+            auto node_result = search_func(nodes[i], vl, bound.load(std::memory_order_relaxed));
+            if (node_result == nullptr) {
+                continue;
+            }
+            const auto* data = node_result->GetData();
+            for (uint64_t j = 0; j < node_result->Size(); ++j) {
+                if (data[j].first > bound.load(std::memory_order_relaxed)) {
+                    continue;
+                }
+                heap->Push(data[j].first, data[j].second);
+                if (heap->Size() > capacity) {
+                    heap->Pop();
+                }
+            }
+            if (heap->Size() == capacity) {
+                tighten_bound(heap->Top().first);
+            }
+        }
         pool_->ReturnOne(vl);
-        if (this->support_duplicate_ && search_param.duplicate_id >= 0) {
-            std::unique_lock lock(this->label_lookup_mutex_);
-            node->graph_->SetDuplicateId(static_cast<InnerIdType>(search_param.duplicate_id),
-                                         inner_id);
-            return;
-        }
-        mutually_connect_new_element(
-            inner_id, results, node->graph_, codes, points_mutex_, allocator_, alpha_);
-        if (update_entry_point) {
-            node->entry_point_ = inner_id;
+        heaps[worker_id] = heap;
+    };
+
+    if (worker_count == 1) {
+        search_worker(0);
+        return heaps[0];
+    }
+    this->thread_pool_->ParallelFor(worker_count, search_worker);
+    auto search_result = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+    for (const auto& heap : heaps) {
+        search_result->Merge(*heap);
+        while (search_result->Size() > capacity) {
+            search_result->Pop();
         }
     }
+    return search_result;
 }
 
 std::vector<std::vector<std::string>>
@@ -820,7 +1087,8 @@ Pyramid::search_node(const IndexNode* node,
                      const DatasetPtr& query,
                      const FlattenInterfacePtr& codes,
                      QueryContext& ctx,
-                     uint64_t subindex_ef_search) const {
+                     uint64_t subindex_ef_search,
+                     float bound) const {
     std::shared_lock lock(node->mutex_);
     DistHeapPtr results = nullptr;
 
@@ -852,9 +1120,13 @@ Pyramid::search_node(const IndexNode* node,
         codes->Query(dists.data(), computer, ids_ptr, id_count);
 
         for (int i = 0; i < id_count; ++i) {
+            if (dists[i] > bound) {
+                continue;
+            }
             results->Push(dists[i], ids_ptr[i]);
             if (results->Size() > search_param.ef) {
                 results->Pop();
+                bound = std::min(bound, results->Top().first);
             }
         }
     } else if (node->status_ == IndexNode::Status::GRAPH) {
@@ -883,6 +1155,7 @@ Pyramid::SetImmutable() {
     if (this->immutable_) {
         return;
     }
+    this->wait_subindex_builds();
     label_table_->SetImmutable();
     this->points_mutex_.reset();
     this->points_mutex_ = std::make_shared<EmptyMutex>();
@@ -15,6 +15,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <utility>
 
@@ -36,11 +39,18 @@
 namespace vsag {
 
 class IndexNode;
-using SearchFunc = std::function<DistHeapPtr(const IndexNode* node, const VisitedListPtr& vl)>;
+// bound: candidates farther than it can't enter the result of the query anymore
+using SearchFunc =
+    std::function<DistHeapPtr(const IndexNode* node, const VisitedListPtr& vl, float bound)>;
 
 std::vector<std::string>
 split(const std::string& str, char delimiter);
 
+// drops the parsed paths that lie under another one (or repeat it), so that the subtree of
+// every remaining path is disjoint from the others
+std::vector<std::vector<std::string>>
+remove_covered_paths(const std::vector<std::vector<std::string>>& paths);
+
 class IndexNode {
 public:
     enum class Status { NO_INDEX = 0, GRAPH = 1, FLAT = 2 };
@@ -51,14 +61,22 @@ public:
     void
     Build(ODescent& odescent);
 
+    // async variant of Build: the nodes to index are served by flat scans, those large enough
+    // for a graph are appended to pending to get it built in the background
+    void
+    BuildFlat(std::vector<IndexNode*>& pending);
+
     void
     Init();
 
+    // creates the empty graph of a node holding size points
+    GraphInterfacePtr
+    CreateGraph(uint64_t size);
+
+    // appends the nodes holding an index that cover this subtree: the node itself, or the
+    // nearest indexed descendants when it is not indexed
     void
-    Search(const SearchFunc& search_func,
-           const VisitedListPtr& vl,
-           const DistHeapPtr& search_result,
-           uint64_t ef_search) const;
+    CollectIndexedNodes(std::vector<const IndexNode*>& nodes) const;
 
     void
     AddChild(const std::string& key);
@@ -82,7 +100,10 @@ public:
 
     Vector<InnerIdType> ids_;
     uint32_t index_min_size_{0};
-    Status status_{Status::NO_INDEX};
+    // written under mutex_, read without it to find the indexed nodes of a subtree
+    std::atomic<Status> status_{Status::NO_INDEX};
+    // set while a FLAT node waits for or runs its background graph build
+    bool build_scheduled_{false};
 
 private:
     UnorderedMap<std::string, std::unique_ptr<IndexNode>> children_;
@@ -107,7 +128,9 @@ public:
           max_degree_(pyramid_param->max_degree),
           index_min_size_(pyramid_param->index_min_size),
           graph_type_(pyramid_param->graph_type),
-          support_duplicate_(pyramid_param->support_duplicate) {
+          support_duplicate_(pyramid_param->support_duplicate),
+          async_build_(pyramid_param->async_build),
+          max_background_builds_(pyramid_param->max_background_builds) {
         base_codes_ = FlattenInterface::MakeInstance(pyramid_param->base_codes_param, common_param);
         root_ =
             std::make_unique<IndexNode>(allocator_, pyramid_param->graph_param, index_min_size_);
@@ -120,12 +143,18 @@ public:
                 FlattenInterface::MakeInstance(pyramid_param->precise_codes_param, common_param);
             reorder_ = std::make_shared<FlattenReorder>(precise_codes_, allocator_);
         }
+        if (thread_pool_ == nullptr) {
+            // without a pool the graphs are built inline
+            async_build_ = false;
+        }
     }
 
     explicit Pyramid(const ParamPtr& param, const IndexCommonParam& common_param)
         : Pyramid(std::dynamic_pointer_cast<PyramidParameters>(param), common_param){};
 
-    ~Pyramid() override = default;
+    ~Pyramid() override {
+        this->wait_subindex_builds();
+    }
 
     std::vector<int64_t>
     Add(const DatasetPtr& base, AddMode mode = AddMode::DEFAULT) override;
@@ -220,9 +249,41 @@ private:
     void
     add_one_point(IndexNode* node, InnerIdType inner_id, const float* vector);
 
+    // links inner_id into graph by a search from entry_point; returns false when the point was
+    // recorded as a duplicate of a linked one instead
+    bool
+    link_into_graph(const GraphInterfacePtr& graph,
+                    InnerIdType entry_point,
+                    InnerIdType inner_id,
+                    const float* vector);
+
+    void
+    schedule_subindex_build(IndexNode* node);
+
+    void
+    run_subindex_builds();
+
+    // builds the graph of a FLAT node aside, catches up with the points added meanwhile and
+    // swaps it in under the node lock
+    void
+    build_subindex(IndexNode* node);
+
+    // copies the vectors of ids into an fp32 datacell, position i holding ids[i], so that a
+    // long build over them does not hold off a resize of codes
+    FlattenInterfacePtr
+    copy_vectors(const FlattenInterfacePtr& codes, const Vector<InnerIdType>& ids) const;
+
+    void
+    wait_subindex_builds() const;
+
     static std::vector<std::vector<std::string>>
     parse_path(const std::string& path);
 
+    DistHeapPtr
+    search_subtrees(const std::vector<const IndexNode*>& nodes,
+                    const SearchFunc& search_func,
+                    const InnerSearchParam& search_param) const;
+
     DistHeapPtr
     search_node(const IndexNode* node,
                 const VisitedListPtr& vl,
@@ -230,7 +291,8 @@ private:
                 const DatasetPtr& query,
                 const FlattenInterfacePtr& codes,
                 QueryContext& ctx,
-                uint64_t subindex_ef_search) const;
+                uint64_t subindex_ef_search,
+                float bound) const;
 
 private:
     ODescentParameterPtr odescent_param_{nullptr};
@@ -260,6 +322,13 @@ private:
     // static
     uint32_t index_min_size_{0};
     bool immutable_{false};
+
+    bool async_build_{false};
+    uint64_t max_background_builds_{2};
+    mutable std::mutex build_queue_mutex_;
+    mutable std::condition_variable build_finished_;
+    std::deque<IndexNode*> build_queue_;
+    uint64_t running_builds_{0};
 };
 
 }  // namespace vsag
@@ -58,3 +58,16 @@ TEST_CASE("Split function tests", "[ut][pyramid]") {
         REQUIRE(result == std::vector<std::string>{"  ", " hello", "  world  "});
     }
 }
+
+TEST_CASE("Remove covered paths tests", "[ut][pyramid]") {
+    using Paths = std::vector<std::vector<std::string>>;
+    REQUIRE(vsag::remove_covered_paths({}).empty());
+    REQUIRE(vsag::remove_covered_paths({{"a", "b"}, {"a", "c"}, {"b"}}) ==
+            Paths{{"a", "b"}, {"a", "c"}, {"b"}});
+    REQUIRE(vsag::remove_covered_paths({{"a", "b", "c"}, {"b"}, {"a"}, {"a", "b"}}) ==
+            Paths{{"b"}, {"a"}});
+    REQUIRE(vsag::remove_covered_paths({{"a", "b"}, {"a", "b"}, {"ab"}}) ==
+            Paths{{"a", "b"}, {"ab"}});
+    // the empty path is the root, it covers all others
+    REQUIRE(vsag::remove_covered_paths({{"a"}, {}, {"b", "c"}}) == Paths{{}});
+}
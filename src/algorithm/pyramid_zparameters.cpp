@@ -68,6 +68,17 @@ PyramidParameters::FromJson(const JsonType& json) {
     if (json.Contains(SUPPORT_DUPLICATE)) {
         this->support_duplicate = json[SUPPORT_DUPLICATE].GetBool();
     }
+
+    if (json.Contains(ASYNC_BUILD_KEY)) {
+        this->async_build = json[ASYNC_BUILD_KEY].GetBool();
+    }
+    if (json.Contains(MAX_BACKGROUND_BUILDS_KEY)) {
+        auto max_background_builds = json[MAX_BACKGROUND_BUILDS_KEY].GetInt();
+        CHECK_ARGUMENT(max_background_builds > 0,
+                       fmt::format("max_background_builds({}) must be greater than 0",
+                                   max_background_builds));
+        this->max_background_builds = static_cast<uint64_t>(max_background_builds);
+    }
 }
 JsonType
 PyramidParameters::ToJson() const {
@@ -87,6 +98,8 @@ PyramidParameters::ToJson() const {
     json[USE_REORDER_KEY].SetBool(this->use_reorder);
     json[INDEX_MIN_SIZE].SetInt(index_min_size);
     json[SUPPORT_DUPLICATE].SetBool(support_duplicate);
+    json[ASYNC_BUILD_KEY].SetBool(async_build);
+    json[MAX_BACKGROUND_BUILDS_KEY].SetInt(static_cast<int64_t>(max_background_builds));
     if (this->use_reorder) {
         json[PRECISE_CODES_KEY].SetJson(precise_codes_param->ToJson());
     }
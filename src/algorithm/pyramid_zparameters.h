@@ -56,6 +56,11 @@ public:
     uint32_t index_min_size{0};
 
     bool support_duplicate{false};
+
+    // serve the nodes as flat scans while their graphs are built on the thread pool, with at
+    // most max_background_builds graphs built at a time
+    bool async_build{false};
+    uint64_t max_background_builds{2};
 };
 
 class PyramidSearchParameters : public IndexSearchParameter {
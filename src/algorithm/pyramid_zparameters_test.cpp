@@ -37,6 +37,8 @@ struct PyramidDefaultParam {
     std::string precise_file_path = "precise_path";
     uint32_t index_min_size = 1000;
     bool support_duplicate = false;
+    bool async_build = false;
+    int max_background_builds = 2;
 };
 
 std::string
@@ -97,7 +99,9 @@ generate_pyramid(const PyramidDefaultParam& param) {
             "type": "pyramid",
             "use_reorder": {},
             "index_min_size": {},
-            "support_duplicate": {}
+            "support_duplicate": {},
+            "async_build": {},
+            "max_background_builds": {}
         }}
     )";
     return fmt::format(param_str,
@@ -117,7 +121,9 @@ generate_pyramid(const PyramidDefaultParam& param) {
                        param.precise_quantization_type,
                        param.use_reorder,
                        param.index_min_size,
-                       param.support_duplicate);
+                       param.support_duplicate,
+                       param.async_build,
+                       param.max_background_builds);
 }
 
 TEST_CASE("Pyramid Parameters Test", "[ut][PyramidParameters]") {
@@ -178,6 +184,16 @@ TEST_CASE("Pyramid Parameters CheckCompatibility", "[ut][PyramidParameter][Check
         "different precise quantization type", precise_quantization_type, "fp32", "fp16", false);
     TEST_COMPATIBILITY_CASE("different index min size", index_min_size, 500, 1500, false);
     TEST_COMPATIBILITY_CASE("different support duplicate", support_duplicate, false, true, false);
+    TEST_COMPATIBILITY_CASE("different async build", async_build, false, true, true);
+    TEST_COMPATIBILITY_CASE("different max background builds", max_background_builds, 1, 4, true);
+}
+
+TEST_CASE("Pyramid Parameters Max Background Builds", "[ut][PyramidParameters]") {
+    PyramidDefaultParam index_param;
+    index_param.async_build = true;
+    index_param.max_background_builds = 0;
+    auto param = std::make_shared<vsag::PyramidParameters>();
+    REQUIRE_THROWS(param->FromString(generate_pyramid(index_param)));
 }
 
 TEST_CASE("Pyramid maps support_duplicate to graph parameter", "[ut][PyramidParameters]") {
@@ -22,6 +22,7 @@
 #include <numeric>
 #include <optional>
 
+#include "algorithm/ivf_partition/ivf_nearest_partition.h"
 #include "attr/argparse.h"
 #include "attr/executor/executor.h"
 #include "datacell/attribute_inverted_interface.h"
@@ -34,6 +35,8 @@
 #include "index_common_param.h"
 #include "index_feature_list.h"
 #include "inner_string_params.h"
+#include "simd/fp32_simd.h"
+#include "simd/normalize.h"
 #include "storage/serialization.h"
 #include "typing.h"
 #include "utils/slow_task_timer.h"
@@ -43,17 +46,53 @@ namespace vsag {
 namespace {
 constexpr InnerIdType MIN_PARALLEL_SEARCH_DOC_COUNT = 1000;
 constexpr float INITIAL_BEST_VECTOR_DISTANCE = std::numeric_limits<float>::infinity();
+// kmeans over the token vectors samples at most this many tokens per centroid
+constexpr uint64_t CENTROID_TRAIN_SAMPLES_PER_CENTROID = 256;
+// the centroids are not trained before this many tokens per centroid have been added, fewer
+// leave most centroids fitted to a handful of tokens
+constexpr uint64_t CENTROID_MIN_TRAIN_TOKENS_PER_CENTROID = 32;
+// documents rescored exactly per topk when the search factor is not given
+constexpr float DEFAULT_RESCORE_FACTOR = 8.0F;
 }  // namespace
 
 WARP::WARP(const WarpParameterPtr& param, const IndexCommonParam& common_param)
-    : InnerIndexInterface(param, common_param), doc_offsets_(allocator_) {
-    inner_codes_ = FlattenInterface::MakeInstance(param->base_codes_param, common_param);
+    : InnerIndexInterface(param, common_param),
+      doc_offsets_(allocator_),
+      token_centroids_(allocator_),
+      centroid_docs_(allocator_),
+      residual_bias_(allocator_) {
+    this->use_residual_ = param->use_residual;
+    IndexCommonParam codes_common_param = common_param;
+    if (this->use_residual_ and this->metric_ == MetricType::METRIC_TYPE_COSINE) {
+        // the residuals of normalized vectors are not normalized, they are scored by inner product
+        codes_common_param.metric_ = MetricType::METRIC_TYPE_IP;
+    }
+    inner_codes_ = FlattenInterface::MakeInstance(param->base_codes_param, codes_common_param);
     auto code_size = this->inner_codes_->code_size_;
     auto increase_count = Options::Instance().block_size_limit() / code_size;
     this->resize_increase_count_bit_ = std::max(
         DEFAULT_RESIZE_BIT, static_cast<uint64_t>(log2(static_cast<double>(increase_count))));
     this->use_attribute_filter_ = param->use_attribute_filter;
     this->has_raw_vector_ = true;
+    // fp32 ip/l2 codes are the token vectors themselves, scored block-wise by the maxsim kernel
+    this->use_max_sim_kernel_ =
+        not this->use_residual_ and
+        this->inner_codes_->GetQuantizerName() == QUANTIZATION_TYPE_VALUE_FP32 and
+        (this->metric_ == MetricType::METRIC_TYPE_IP or
+         this->metric_ == MetricType::METRIC_TYPE_L2SQR);
+    this->centroid_count_ = param->centroid_count;
+    if (this->centroid_count_ > 0) {
+        // tokens are classified inside add tasks of the pool, so the router must not wait on it
+        IndexCommonParam partition_common_param = common_param;
+        partition_common_param.thread_pool_ = nullptr;
+        this->centroid_partition_ = std::make_shared<IVFNearestPartition>(
+            static_cast<BucketIdType>(this->centroid_count_),
+            partition_common_param,
+            std::make_shared<IVFPartitionStrategyParameters>());
+        this->centroid_docs_.resize(this->centroid_count_, Vector<InnerIdType>(allocator_));
+        this->centroid_mutexes_ =
+            std::make_shared<PointsMutex>(this->centroid_count_, common_param.allocator_.get());
+    }
 }
 
 uint64_t
@@ -94,9 +133,52 @@ WARP::Train(const DatasetPtr& data) {
         std::memcpy(buffer.data() + offset, multi_vectors[i].vectors_, num_floats * sizeof(float));
         offset += num_floats;
     }
+    if (this->centroid_partition_ != nullptr and not this->centroid_partition_->is_trained_) {
+        auto min_tokens = this->centroid_count_ * CENTROID_MIN_TRAIN_TOKENS_PER_CENTROID;
+        // the residuals are encoded against the centroids, they cannot wait for more tokens
+        CHECK_ARGUMENT(not this->use_residual_ or total_vectors >= min_tokens,
+                       fmt::format("warp with residual codes needs at least {} token vectors to "
+                                   "train its {} centroids, got {}",
+                                   min_tokens,
+                                   this->centroid_count_,
+                                   total_vectors));
+        if (total_vectors >= min_tokens) {
+            this->train_centroids(buffer.data(), total_vectors);
+        }
+    }
+    if (this->use_residual_) {
+        auto centroids =
+            this->centroid_partition_->ClassifyDatas(buffer.data(), total_vectors, 1, nullptr);
+        this->to_residuals(buffer.data(), total_vectors, centroids.data());
+    }
     this->inner_codes_->Train(buffer.data(), total_vectors);
 }
 
+void
+WARP::train_centroids(const float* data, uint64_t count) {
+    CHECK_ARGUMENT(count > 0, "warp needs token vectors to train its centroids");
+    auto sample_count =
+        std::min(count, this->centroid_count_ * CENTROID_TRAIN_SAMPLES_PER_CENTROID);
+    Vector<float> samples(allocator_);
+    if (sample_count < count) {
+        samples.resize(sample_count * dim_);
+        auto selected =
+            select_k_numbers(static_cast<int64_t>(count), static_cast<int>(sample_count));
+        for (uint64_t i = 0; i < sample_count; ++i) {
+            std::memcpy(samples.data() + i * dim_,
+                        data + static_cast<uint64_t>(selected[i]) * dim_,
+                        dim_ * sizeof(float));
+        }
+        data = samples.data();
+    }
+    auto dataset = Dataset::Make();
+    dataset->NumElements(static_cast<int64_t>(sample_count))
+        ->Dim(dim_)
+        ->Float32Vectors(data)
+        ->Owner(false);
+    this->centroid_partition_->Train(dataset);
+}
+
 std::vector<int64_t>
 WARP::Add(const DatasetPtr& data, AddMode mode) {
     std::vector<int64_t> failed_ids;
@@ -135,6 +217,12 @@ WARP::Add(const DatasetPtr& data, AddMode mode) {
             uint64_t new_vec_capacity = next_multiple_of_power_of_two(
                 required_vec_capacity, this->resize_increase_count_bit_);
             this->inner_codes_->Resize(new_vec_capacity);
+            if (this->centroid_partition_ != nullptr) {
+                this->token_centroids_.resize(new_vec_capacity);
+            }
+            if (this->use_residual_ and this->metric_ == MetricType::METRIC_TYPE_L2SQR) {
+                this->residual_bias_.resize(new_vec_capacity);
+            }
             this->max_vector_capacity_.store(new_vec_capacity);
         }
     }
@@ -209,32 +297,129 @@ WARP::Add(const DatasetPtr& data, AddMode mode) {
         }
     }
 
+    if (this->centroid_partition_ != nullptr) {
+        auto can_train = [&]() {
+            return not this->centroid_partition_->is_trained_ and
+                   this->total_vector_count_ >=
+                       this->centroid_count_ * CENTROID_MIN_TRAIN_TOKENS_PER_CENTROID;
+        };
+        bool train = false;
+        {
+            std::shared_lock global_lock(this->global_mutex_);
+            train = can_train();
+        }
+        if (train) {
+            std::unique_lock global_lock(this->global_mutex_);
+            if (can_train()) {
+                this->train_deferred_centroids();
+            }
+        }
+    }
+
     return failed_ids;
 }
 
+WARP::QueryState
+WARP::make_query_state(const float* query_vectors, uint32_t query_vec_count) const {
+    QueryState query(allocator_);
+    query.vectors = query_vectors;
+    query.vec_count = query_vec_count;
+    if (this->total_count_ == 0) {
+        // no document to score, the codes may not even be trained
+        return query;
+    }
+    if (this->use_residual_ and this->metric_ == MetricType::METRIC_TYPE_COSINE) {
+        query.normalized_vectors.resize(static_cast<uint64_t>(query_vec_count) * dim_);
+        for (uint32_t q = 0; q < query_vec_count; ++q) {
+            Normalize(query_vectors + static_cast<uint64_t>(q) * dim_,
+                      query.normalized_vectors.data() + static_cast<uint64_t>(q) * dim_,
+                      dim_);
+        }
+        query.vectors = query.normalized_vectors.data();
+    }
+
+    // the computers encode the query once for all the documents
+    if (not this->use_max_sim_kernel_) {
+        query.computers.reserve(query_vec_count);
+        for (uint32_t q = 0; q < query_vec_count; ++q) {
+            query.computers.emplace_back(this->inner_codes_->FactoryComputer(
+                query.vectors + static_cast<uint64_t>(q) * dim_));
+        }
+    }
+    return query;
+}
+
+void
+WARP::prepare_centroid_ips(const QueryState& query,
+                           const BucketIdType* centroids,
+                           uint32_t count,
+                           ScoreBuffer& buffer) const {
+    buffer.token_ip_offsets.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        auto offset = buffer.centroid_ips.size();
+        auto [iter, inserted] = buffer.centroid_ip_offsets.try_emplace(centroids[i], offset);
+        buffer.token_ip_offsets[i] = iter->second;
+        if (not inserted) {
+            continue;
+        }
+        buffer.centroid.resize(dim_);
+        this->centroid_partition_->GetCentroid(centroids[i], buffer.centroid);
+        buffer.centroid_ips.resize(offset + query.vec_count);
+        for (uint32_t q = 0; q < query.vec_count; ++q) {
+            buffer.centroid_ips[offset + q] = FP32ComputeIP(
+                query.vectors + static_cast<uint64_t>(q) * dim_, buffer.centroid.data(), dim_);
+        }
+    }
+}
+
 float
-WARP::compute_maxsin_similarity(const float* query_vectors,
-                                uint32_t query_vec_count,
+WARP::compute_maxsin_similarity(const QueryState& query,
                                 uint32_t doc_start_vec_idx,
-                                uint32_t doc_vec_count) const {
-    if (doc_vec_count == 0 || query_vec_count == 0) {
+                                uint32_t doc_vec_count,
+                                ScoreBuffer& buffer) const {
+    if (doc_vec_count == 0 || query.vec_count == 0) {
         return 0.0F;
     }
 
+    if (this->use_max_sim_kernel_) {
+        auto& doc_vectors = buffer.doc_vectors;
+        doc_vectors.resize(static_cast<uint64_t>(doc_vec_count) * dim_);
+        for (uint32_t i = 0; i < doc_vec_count; ++i) {
+            this->inner_codes_->GetCodesById(
+                doc_start_vec_idx + i,
+                reinterpret_cast<uint8_t*>(doc_vectors.data() + static_cast<uint64_t>(i) * dim_));
+        }
+        if (metric_ == MetricType::METRIC_TYPE_L2SQR) {
+            return FP32ComputeL2SqrMaxSim(
+                query.vectors, query.vec_count, doc_vectors.data(), doc_vec_count, dim_);
+        }
+        // the ip distance of the fp32 codes is 1 - ip
+        return static_cast<float>(query.vec_count) -
+               FP32ComputeIPMaxSim(
+                   query.vectors, query.vec_count, doc_vectors.data(), doc_vec_count, dim_);
+    }
+
     float total_score = 0.0F;
 
-    // Allocate once outside the loop to avoid repeated memory allocation
-    Vector<InnerIdType> vec_indices(doc_vec_count, allocator_);
-    Vector<float> dists(doc_vec_count, allocator_);
+    auto& vec_indices = buffer.vec_indices;
+    auto& dists = buffer.dists;
+    vec_indices.resize(doc_vec_count);
+    dists.resize(doc_vec_count);
     std::iota(vec_indices.begin(), vec_indices.end(), doc_start_vec_idx);
 
-    // FactoryComputer returns distances; keep the best document-vector distance per query vector.
-    for (uint32_t q = 0; q < query_vec_count; ++q) {
-        const float* query_vec = query_vectors + q * dim_;
-        auto computer = this->inner_codes_->FactoryComputer(query_vec);
+    if (this->use_residual_) {
+        this->prepare_centroid_ips(
+            query, token_centroids_.data() + doc_start_vec_idx, doc_vec_count, buffer);
+    }
 
+    // FactoryComputer returns distances; keep the best document-vector distance per query vector.
+    for (uint32_t q = 0; q < query.vec_count; ++q) {
         float best_dist = INITIAL_BEST_VECTOR_DISTANCE;
-        this->inner_codes_->Query(dists.data(), computer, vec_indices.data(), doc_vec_count);
+        this->inner_codes_->Query(
+            dists.data(), query.computers[q], vec_indices.data(), doc_vec_count);
+        if (this->use_residual_) {
+            this->apply_residuals(q, doc_start_vec_idx, doc_vec_count, buffer, dists.data());
+        }
         for (const float dist : dists) {
             best_dist = std::min(best_dist, dist);
         }
@@ -243,6 +428,28 @@ WARP::compute_maxsin_similarity(const float* query_vectors,
     return total_score;
 }
 
+void
+WARP::apply_residuals(uint32_t q,
+                      uint32_t doc_start_vec_idx,
+                      uint32_t doc_vec_count,
+                      const ScoreBuffer& buffer,
+                      float* dists) const {
+    // with t = c + r, the codes give the distances to r:
+    // |q - t|^2 = |q - r|^2 + |c|^2 + 2<c, r> - 2<q, c> and 1 - <q, t> = 1 - <q, r> - <q, c>
+    const float* ips = buffer.centroid_ips.data() + q;
+    const uint64_t* offsets = buffer.token_ip_offsets.data();
+    if (metric_ == MetricType::METRIC_TYPE_L2SQR) {
+        const float* biases = residual_bias_.data() + doc_start_vec_idx;
+        for (uint32_t i = 0; i < doc_vec_count; ++i) {
+            dists[i] += biases[i] - 2.0F * ips[offsets[i]];
+        }
+    } else {
+        for (uint32_t i = 0; i < doc_vec_count; ++i) {
+            dists[i] -= ips[offsets[i]];
+        }
+    }
+}
+
 DatasetPtr
 WARP::KnnSearch(const DatasetPtr& query,
                 int64_t k,
@@ -285,11 +492,13 @@ WARP::SearchWithRequest(const SearchRequest& request) const {
     auto parallel_count = warp_params.parallel_search_thread_count;
 
     std::atomic<uint32_t> dist_cmp{0};
+    auto query = this->make_query_state(query_vectors, query_vec_count);
 
     // For each query, compute maxsin score for all documents
     // Use a heap to maintain top-k results
     auto search_func = [&](InnerIdType start_doc, InnerIdType end_doc) -> DistHeapPtr {
         auto heap = DistanceHeap::MakeInstanceBySize<true, true>(this->allocator_, request.topk_);
+        ScoreBuffer buffer(this->allocator_);
 
         for (InnerIdType doc_id = start_doc; doc_id < end_doc; ++doc_id) {
             if (ft != nullptr && not ft->CheckValid(doc_id)) {
@@ -299,8 +508,7 @@ WARP::SearchWithRequest(const SearchRequest& request) const {
             uint32_t doc_start_vec = doc_offsets_[doc_id];
             uint32_t doc_vec_count = doc_offsets_[doc_id + 1] - doc_offsets_[doc_id];
 
-            float score = compute_maxsin_similarity(
-                query_vectors, query_vec_count, doc_start_vec, doc_vec_count);
+            float score = compute_maxsin_similarity(query, doc_start_vec, doc_vec_count, buffer);
 
             // For L2, we use -score as distance; for IP/Cosine, score is already the similarity
             // The heap expects distance (smaller is better for L2)
@@ -314,27 +522,21 @@ WARP::SearchWithRequest(const SearchRequest& request) const {
 
     DistHeapPtr heap = nullptr;
 
-    if (parallel_count == 1 || this->thread_pool_ == nullptr ||
-        total_count_ < MIN_PARALLEL_SEARCH_DOC_COUNT) {
+    if (this->centroid_partition_ != nullptr and this->centroid_partition_->is_trained_ and
+        warp_params.scan_centroids_count > 0) {
+        heap = this->search_by_centroids(query, request.topk_, warp_params, ft, dist_cmp);
+    } else if (parallel_count == 1 || this->thread_pool_ == nullptr ||
+               total_count_ < MIN_PARALLEL_SEARCH_DOC_COUNT) {
         heap = search_func(0, total_count_);
     } else {
-        std::vector<std::future<DistHeapPtr>> futures;
         auto chunk_size = (total_count_ + parallel_count - 1) / parallel_count;
-        for (auto i = 0; i < static_cast<int>(parallel_count); ++i) {
+        auto chunk_count = (total_count_ + chunk_size - 1) / chunk_size;
+        std::vector<DistHeapPtr> heaps(chunk_count);
+        this->thread_pool_->ParallelFor(chunk_count, [&](uint64_t i) {
             auto start = i * chunk_size;
             auto end = std::min(start + chunk_size, static_cast<uint64_t>(total_count_));
-            if (start < end) {
-                auto future = this->thread_pool_->GeneralEnqueue(search_func, start, end);
-                futures.emplace_back(std::move(future));
-            }
-        }
-
-        // Use binary tree merge for better performance
-        std::vector<DistHeapPtr> heaps;
-        heaps.reserve(futures.size());
-        for (auto& future : futures) {
-            heaps.push_back(future.get());
-        }
+            heaps[i] = search_func(start, end);
+        });
 
         while (heaps.size() > 1) {
             std::vector<DistHeapPtr> next_heaps;
@@ -367,6 +569,86 @@ WARP::SearchWithRequest(const SearchRequest& request) const {
     return std::move(dataset_results);
 }
 
+DistHeapPtr
+WARP::search_by_centroids(const QueryState& query,
+                          int64_t topk,
+                          const WarpSearchParameters& params,
+                          const FilterPtr& filter,
+                          std::atomic<uint32_t>& dist_cmp) const {
+    const float* query_vectors = query.vectors;
+    uint32_t query_vec_count = query.vec_count;
+    auto scan_count = static_cast<BucketIdType>(
+        std::min<int64_t>(params.scan_centroids_count, this->centroid_count_));
+    InnerSearchParam inner_param;
+    inner_param.scan_bucket_size = scan_count;
+    auto probed = this->centroid_partition_->ClassifyDatasForSearch(
+        query_vectors, query_vec_count, inner_param, nullptr);
+
+    // the (query token, distance) pairs of every probed centroid; a document token in a centroid
+    // not probed by a query token is given the distance of its farthest probed centroid
+    UnorderedMap<BucketIdType, Vector<std::pair<uint32_t, float>>> probed_dists(allocator_);
+    Vector<float> missing_dists(query_vec_count, 0.0F, allocator_);
+    Vector<float> centroid(dim_, allocator_);
+    for (uint32_t q = 0; q < query_vec_count; ++q) {
+        const float* query_vec = query_vectors + static_cast<uint64_t>(q) * dim_;
+        for (BucketIdType j = 0; j < scan_count; ++j) {
+            auto centroid_id = probed[static_cast<uint64_t>(q) * scan_count + j];
+            if (centroid_id < 0) {
+                continue;
+            }
+            this->centroid_partition_->GetCentroid(centroid_id, centroid);
+            float dist = metric_ == MetricType::METRIC_TYPE_L2SQR
+                             ? FP32ComputeL2Sqr(query_vec, centroid.data(), dim_)
+                             : 1.0F - FP32ComputeIP(query_vec, centroid.data(), dim_);
+            probed_dists.try_emplace(centroid_id, allocator_).first.value().emplace_back(q, dist);
+            missing_dists[q] = std::max(missing_dists[q], dist);
+        }
+    }
+
+    Vector<InnerIdType> candidates(allocator_);
+    for (const auto& [centroid_id, dists] : probed_dists) {
+        LockGuard lock(this->centroid_mutexes_, centroid_id);
+        const auto& docs = this->centroid_docs_[centroid_id];
+        candidates.insert(candidates.end(), docs.begin(), docs.end());
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    auto factor = params.topk_factor > 0 ? params.topk_factor : DEFAULT_RESCORE_FACTOR;
+    auto rescore_count = std::max(topk, static_cast<int64_t>(static_cast<float>(topk) * factor));
+    auto approx_heap = DistanceHeap::MakeInstanceBySize<true, true>(allocator_, rescore_count);
+    Vector<float> best_dists(query_vec_count, allocator_);
+    for (auto doc_id : candidates) {
+        if (filter != nullptr and not filter->CheckValid(doc_id)) {
+            continue;
+        }
+        best_dists.assign(missing_dists.begin(), missing_dists.end());
+        for (auto vec_idx = doc_offsets_[doc_id]; vec_idx < doc_offsets_[doc_id + 1]; ++vec_idx) {
+            auto iter = probed_dists.find(token_centroids_[vec_idx]);
+            if (iter == probed_dists.end()) {
+                continue;
+            }
+            for (const auto& [q, dist] : iter->second) {
+                best_dists[q] = std::min(best_dists[q], dist);
+            }
+        }
+        approx_heap->Push(std::accumulate(best_dists.begin(), best_dists.end(), 0.0F), doc_id);
+    }
+
+    auto heap = DistanceHeap::MakeInstanceBySize<true, true>(allocator_, topk);
+    ScoreBuffer buffer(allocator_);
+    while (not approx_heap->Empty()) {
+        auto doc_id = approx_heap->Top().second;
+        approx_heap->Pop();
+        uint32_t doc_vec_count = doc_offsets_[doc_id + 1] - doc_offsets_[doc_id];
+        heap->Push(
+            compute_maxsin_similarity(query, doc_offsets_[doc_id], doc_vec_count, buffer),
+            doc_id);
+        dist_cmp.fetch_add(query_vec_count * doc_vec_count, std::memory_order_relaxed);
+    }
+    return heap;
+}
+
 DatasetPtr
 WARP::RangeSearch(const vsag::DatasetPtr& query,
                   float radius,
@@ -389,11 +671,13 @@ WARP::RangeSearch(const vsag::DatasetPtr& query,
     // Parse search parameters
     auto warp_params = WarpSearchParameters::FromJson(parameters);
     auto parallel_count = warp_params.parallel_search_thread_count;
+    auto query_state = this->make_query_state(query_vectors, query_vec_count);
 
     // Use serial version if no thread pool or small dataset
     if (parallel_count == 1 || this->thread_pool_ == nullptr ||
         total_count_ < MIN_PARALLEL_SEARCH_DOC_COUNT) {
         auto heap = std::make_shared<StandardHeap<true, true>>(this->allocator_, limited_size);
+        ScoreBuffer buffer(this->allocator_);
 
         for (InnerIdType doc_id = 0; doc_id < total_count_; ++doc_id) {
             if (filter != nullptr and
@@ -404,8 +688,8 @@ WARP::RangeSearch(const vsag::DatasetPtr& query,
             uint32_t doc_start_vec = doc_offsets_[doc_id];
             uint32_t doc_vec_count_val = doc_offsets_[doc_id + 1] - doc_offsets_[doc_id];
 
-            float score = compute_maxsin_similarity(
-                query_vectors, query_vec_count, doc_start_vec, doc_vec_count_val);
+            float score =
+                compute_maxsin_similarity(query_state, doc_start_vec, doc_vec_count_val, buffer);
 
             float heap_dist = score;
             if (heap_dist > radius) {
@@ -435,6 +719,7 @@ WARP::RangeSearch(const vsag::DatasetPtr& query,
             // Pre-allocate to avoid frequent reallocations
             local_results.reserve(std::min(static_cast<size_t>(1024),
                                            static_cast<size_t>(total_count_) / parallel_count));
+            ScoreBuffer buffer(this->allocator_);
 
             while (true) {
                 auto doc_id = next_doc.fetch_add(1);
@@ -451,7 +736,7 @@ WARP::RangeSearch(const vsag::DatasetPtr& query,
                 uint32_t doc_vec_count_val = doc_offsets_[doc_id + 1] - doc_offsets_[doc_id];
 
                 float score = compute_maxsin_similarity(
-                    query_vectors, query_vec_count, doc_start_vec, doc_vec_count_val);
+                    query_state, doc_start_vec, doc_vec_count_val, buffer);
 
                 if (score <= radius) {
                     local_results.emplace_back(score, doc_id);
@@ -505,6 +790,18 @@ WARP::Serialize(StreamWriter& writer) const {
 
     this->inner_codes_->Serialize(writer);
     this->label_table_->Serialize(writer);
+    if (this->centroid_partition_ != nullptr) {
+        this->centroid_partition_->Serialize(writer);
+        // the same layout as WriteVector, only the used part of the token centroids
+        StreamWriter::WriteObj(writer, total_vector_count_);
+        writer.Write(reinterpret_cast<const char*>(token_centroids_.data()),
+                     total_vector_count_ * sizeof(BucketIdType));
+    }
+    if (this->use_residual_ and this->metric_ == MetricType::METRIC_TYPE_L2SQR) {
+        StreamWriter::WriteObj(writer, total_vector_count_);
+        writer.Write(reinterpret_cast<const char*>(residual_bias_.data()),
+                     total_vector_count_ * sizeof(float));
+    }
 
     // Serialize footer
     auto metadata = std::make_shared<Metadata>();
@@ -514,6 +811,7 @@ WARP::Serialize(StreamWriter& writer) const {
     basic_info["total_vector_count"].SetInt(total_vector_count_);
     basic_info[INDEX_PARAM].SetString(this->create_param_ptr_->ToString());
     metadata->Set("basic_info", basic_info);
+    this->write_operation_lsn(metadata);
     auto footer = std::make_shared<Footer>(metadata);
     footer->Write(writer);
 }
@@ -528,6 +826,7 @@ WARP::Deserialize(StreamReader& reader) {
 
     auto metadata = footer->GetMetadata();
     auto basic_info = metadata->Get("basic_info");
+    this->read_operation_lsn(metadata);
     if (basic_info.Contains(INDEX_PARAM)) {
         std::string index_param_string = basic_info[INDEX_PARAM].GetString();
         auto index_param = std::make_shared<WarpParameter>();
@@ -550,6 +849,14 @@ WARP::Deserialize(StreamReader& reader) {
 
     this->inner_codes_->Deserialize(buffer_reader);
     this->label_table_->Deserialize(buffer_reader);
+    if (this->centroid_partition_ != nullptr) {
+        this->centroid_partition_->Deserialize(buffer_reader);
+        StreamReader::ReadVector(buffer_reader, token_centroids_);
+        this->rebuild_centroid_docs();
+    }
+    if (this->use_residual_ and this->metric_ == MetricType::METRIC_TYPE_L2SQR) {
+        StreamReader::ReadVector(buffer_reader, residual_bias_);
+    }
     this->cal_memory_usage();
 }
 
@@ -574,6 +881,20 @@ WARP::resize(uint64_t new_size) {
 
 void
 WARP::add_one_doc(const float* data, uint32_t vec_count, InnerIdType inner_id) {
+    Vector<BucketIdType> centroids(allocator_);
+    Vector<float> residuals(allocator_);
+    if (this->centroid_partition_ != nullptr and not this->centroid_partition_->is_trained_) {
+        // listed in no centroid until train_deferred_centroids assigns the tokens added so far
+        centroids.assign(vec_count, -1);
+    } else if (this->centroid_partition_ != nullptr) {
+        centroids = this->centroid_partition_->ClassifyDatas(data, vec_count, 1, nullptr);
+        if (this->use_residual_) {
+            residuals.assign(data, data + static_cast<uint64_t>(vec_count) * dim_);
+            this->to_residuals(residuals.data(), vec_count, centroids.data());
+            data = residuals.data();
+        }
+    }
+
     // Get the starting position before batch insertion
     auto start_vec_idx = this->inner_codes_->TotalCount();
 
@@ -588,6 +909,91 @@ WARP::add_one_doc(const float* data, uint32_t vec_count, InnerIdType inner_id) {
 
     // Update total vector count to match inner_codes_
     total_vector_count_ = start_vec_idx + vec_count;
+
+    if (this->centroid_partition_ != nullptr) {
+        this->assign_centroids(centroids, inner_id);
+    }
+    if (this->use_residual_ and this->metric_ == MetricType::METRIC_TYPE_L2SQR) {
+        this->update_residual_bias(start_vec_idx, vec_count);
+    }
+}
+
+void
+WARP::assign_centroids(const Vector<BucketIdType>& centroids, InnerIdType inner_id) {
+    auto start_vec_idx = doc_offsets_[inner_id];
+    std::copy(centroids.begin(), centroids.end(), token_centroids_.begin() + start_vec_idx);
+    Vector<BucketIdType> unique_centroids(centroids.begin(), centroids.end(), allocator_);
+    std::sort(unique_centroids.begin(), unique_centroids.end());
+    unique_centroids.erase(std::unique(unique_centroids.begin(), unique_centroids.end()),
+                           unique_centroids.end());
+    for (auto centroid : unique_centroids) {
+        if (centroid < 0) {
+            continue;
+        }
+        LockGuard lock(this->centroid_mutexes_, centroid);
+        this->centroid_docs_[centroid].emplace_back(inner_id);
+    }
+}
+
+void
+WARP::to_residuals(float* vectors, uint64_t count, const BucketIdType* centroids) const {
+    Vector<float> centroid(dim_, allocator_);
+    for (uint64_t i = 0; i < count; ++i) {
+        float* vector = vectors + i * dim_;
+        if (this->metric_ == MetricType::METRIC_TYPE_COSINE) {
+            Normalize(vector, vector, dim_);
+        }
+        this->centroid_partition_->GetCentroid(centroids[i], centroid);
+        FP32Sub(vector, centroid.data(), vector, dim_);
+    }
+}
+
+void
+WARP::update_residual_bias(uint32_t start_vec_idx, uint32_t vec_count) {
+    // the bias is computed from the decoded residual, the one the codes are scored with
+    Vector<uint8_t> codes(inner_codes_->code_size_, allocator_);
+    Vector<float> residual(dim_, allocator_);
+    Vector<float> centroid(dim_, allocator_);
+    for (uint32_t vec_idx = start_vec_idx; vec_idx < start_vec_idx + vec_count; ++vec_idx) {
+        inner_codes_->GetCodesById(vec_idx, codes.data());
+        inner_codes_->Decode(codes.data(), residual.data());
+        this->centroid_partition_->GetCentroid(token_centroids_[vec_idx], centroid);
+        residual_bias_[vec_idx] = FP32ComputeIP(centroid.data(), centroid.data(), dim_) +
+                                  2.0F * FP32ComputeIP(centroid.data(), residual.data(), dim_);
+    }
+}
+
+void
+WARP::rebuild_centroid_docs() {
+    for (auto& docs : this->centroid_docs_) {
+        docs.clear();
+    }
+    for (InnerIdType doc_id = 0; doc_id < total_count_; ++doc_id) {
+        auto begin = token_centroids_.begin() + doc_offsets_[doc_id];
+        auto end = token_centroids_.begin() + doc_offsets_[doc_id + 1];
+        for (auto iter = begin; iter != end; ++iter) {
+            // a document lists itself once per centroid
+            if (*iter >= 0 and std::find(begin, iter, *iter) == iter) {
+                this->centroid_docs_[*iter].emplace_back(doc_id);
+            }
+        }
+    }
+}
+
+void
+WARP::train_deferred_centroids() {
+    auto count = this->total_vector_count_;
+    Vector<float> tokens(count * dim_, allocator_);
+    Vector<uint8_t> codes(inner_codes_->code_size_, allocator_);
+    for (uint64_t i = 0; i < count; ++i) {
+        inner_codes_->GetCodesById(i, codes.data());
+        inner_codes_->Decode(codes.data(), tokens.data() + i * dim_);
+    }
+    this->train_centroids(tokens.data(), count);
+    auto centroids = this->centroid_partition_->ClassifyDatas(tokens.data(), count, 1, nullptr);
+    std::copy(centroids.begin(), centroids.end(), token_centroids_.begin());
+    this->rebuild_centroid_docs();
+    this->cal_memory_usage();
 }
 
 void
@@ -597,6 +1003,11 @@ WARP::GetVectorByInnerId(InnerIdType inner_id, float* data) const {
     Vector<uint8_t> codes(inner_codes_->code_size_, allocator_);
     inner_codes_->GetCodesById(vec_idx, codes.data());
     inner_codes_->Decode(codes.data(), data);
+    if (this->use_residual_) {
+        Vector<float> centroid(dim_, allocator_);
+        this->centroid_partition_->GetCentroid(token_centroids_[vec_idx], centroid);
+        FP32Add(data, centroid.data(), data, dim_);
+    }
 }
 
 void
@@ -605,6 +1016,11 @@ WARP::cal_memory_usage() {
     memory_usage += sizeof(WARP);
     memory_usage += this->label_table_->GetMemoryUsage();
     memory_usage += static_cast<int64_t>(doc_offsets_.size() * sizeof(uint32_t));
+    if (this->centroid_partition_ != nullptr) {
+        memory_usage += this->centroid_partition_->GetMemoryUsage();
+        memory_usage += static_cast<int64_t>(token_centroids_.size() * sizeof(BucketIdType));
+    }
+    memory_usage += static_cast<int64_t>(residual_bias_.size() * sizeof(float));
     std::unique_lock lock(this->memory_usage_mutex_);
     this->current_memory_usage_.store(memory_usage);
 }
@@ -714,6 +1130,26 @@ WARP::CheckAndMappingExternalParam(const JsonType& external_param,
                 IO_FILE_PATH_KEY,
             },
         },
+        {
+            RABITQ_BITS_PER_DIM_BASE,
+            {
+                BASE_CODES_KEY,
+                QUANTIZATION_PARAMS_KEY,
+                RABITQ_QUANTIZATION_BITS_PER_DIM_BASE_KEY,
+            },
+        },
+        {
+            WARP_CENTROID_COUNT_KEY,
+            {
+                WARP_CENTROID_COUNT_KEY,
+            },
+        },
+        {
+            WARP_USE_RESIDUAL_KEY,
+            {
+                WARP_USE_RESIDUAL_KEY,
+            },
+        },
     };
 
     if (common_param.data_type_ == DataTypes::DATA_TYPE_INT8) {
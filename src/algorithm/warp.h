@@ -15,9 +15,15 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "algorithm/inner_index_interface.h"
+#include "algorithm/ivf_partition/ivf_partition_strategy.h"
+#include "impl/heap/distance_heap.h"
 #include "impl/label_table.h"
+#include "quantization/computer.h"
 #include "typing.h"
+#include "utils/lock_strategy.h"
 #include "utils/pointer_define.h"
 #include "vsag/filter.h"
 #include "warp_parameter.h"
@@ -112,10 +118,58 @@ public:
     int64_t
     GetMemoryUsage() const override;
 
+private:
+    // the state of one query shared by every document scored in a search
+    struct QueryState {
+        explicit QueryState(Allocator* allocator)
+            : computers(allocator), normalized_vectors(allocator) {
+        }
+
+        const float* vectors{nullptr};
+
+        uint32_t vec_count{0};
+
+        Vector<ComputerInterfacePtr> computers;  // one per query vector
+
+        Vector<float> normalized_vectors;  // residual codes of a cosine index only
+    };
+
+    // the buffers of one search thread, reused for every document it scores
+    struct ScoreBuffer {
+        explicit ScoreBuffer(Allocator* allocator)
+            : doc_vectors(allocator),
+              vec_indices(allocator),
+              dists(allocator),
+              centroid(allocator),
+              centroid_ip_offsets(allocator),
+              centroid_ips(allocator),
+              token_ip_offsets(allocator) {
+        }
+
+        Vector<float> doc_vectors;  // maxsim kernel only: the codes of the document
+
+        Vector<InnerIdType> vec_indices;
+
+        Vector<float> dists;
+
+        // residual codes only: <query vector q, centroid c> at centroid_ip_offsets[c] + q in
+        // centroid_ips, for the centroids of the documents this thread scored only
+        Vector<float> centroid;
+
+        UnorderedMap<BucketIdType, uint64_t> centroid_ip_offsets;
+
+        Vector<float> centroid_ips;
+
+        Vector<uint64_t> token_ip_offsets;  // the offset of each token of the scored document
+    };
+
 private:
     void
     resize(uint64_t new_size);
 
+    QueryState
+    make_query_state(const float* query_vectors, uint32_t query_vec_count) const;
+
     void
     add_one_doc(const float* data, uint32_t vec_count, InnerIdType inner_id);
 
@@ -124,10 +178,59 @@ private:
 
     // Compute maxsin similarity between query vectors and a document's vectors
     float
-    compute_maxsin_similarity(const float* query_vectors,
-                              uint32_t query_vec_count,
+    compute_maxsin_similarity(const QueryState& query,
                               uint32_t doc_start_vec_idx,
-                              uint32_t doc_vec_count) const;
+                              uint32_t doc_vec_count,
+                              ScoreBuffer& buffer) const;
+
+    void
+    train_centroids(const float* data, uint64_t count);
+
+    // trains the centroids from the tokens added while there were too few of them, then lists
+    // those tokens in their centroids; called under the exclusive global lock
+    void
+    train_deferred_centroids();
+
+    // lists the document in the centroids of its token vectors
+    void
+    assign_centroids(const Vector<BucketIdType>& centroids, InnerIdType inner_id);
+
+    // replaces the vectors by their residuals to their centroids, cosine vectors are normalized
+    // first
+    void
+    to_residuals(float* vectors, uint64_t count, const BucketIdType* centroids) const;
+
+    void
+    update_residual_bias(uint32_t start_vec_idx, uint32_t vec_count);
+
+    // computes <q, c> for every query vector of the centroids c not seen by this search thread
+    // yet, and points the tokens of the document at them
+    void
+    prepare_centroid_ips(const QueryState& query,
+                         const BucketIdType* centroids,
+                         uint32_t count,
+                         ScoreBuffer& buffer) const;
+
+    // turns the distances of query vector q to the residuals of a document into distances to
+    // its token vectors
+    void
+    apply_residuals(uint32_t q,
+                    uint32_t doc_start_vec_idx,
+                    uint32_t doc_vec_count,
+                    const ScoreBuffer& buffer,
+                    float* dists) const;
+
+    void
+    rebuild_centroid_docs();
+
+    // scores the documents listed in the centroids probed by the query tokens from the centroid
+    // distances, then computes the exact maxsin similarity of the best ones only
+    DistHeapPtr
+    search_by_centroids(const QueryState& query,
+                        int64_t topk,
+                        const WarpSearchParameters& params,
+                        const FilterPtr& filter,
+                        std::atomic<uint32_t>& dist_cmp) const;
 
 private:
     FlattenInterfacePtr inner_codes_{nullptr};
@@ -153,6 +256,29 @@ private:
     // Vector count for document i: doc_offsets_[i+1] - doc_offsets_[i]
     Vector<uint32_t> doc_offsets_;
 
+    // set when centroid_count > 0 (PLAID-style pruning): every token vector is assigned to its
+    // nearest centroid, and every centroid lists the documents owning one of its tokens
+    uint32_t centroid_count_{0};
+
+    IVFPartitionStrategyPtr centroid_partition_{nullptr};
+
+    Vector<BucketIdType> token_centroids_;  // sized like inner_codes_
+
+    Vector<Vector<InnerIdType>> centroid_docs_;
+
+    MutexArrayPtr centroid_mutexes_{nullptr};
+
+    // set when use_residual: inner_codes_ holds the residual r of every token vector t to its
+    // centroid c, its distances are corrected by the <query, centroid> inner products
+    bool use_residual_{false};
+
+    // set for fp32 ip/l2 codes: documents are rescored by FP32ComputeIPMaxSim/L2SqrMaxSim over
+    // their gathered token vectors instead of one computer query per query vector
+    bool use_max_sim_kernel_{false};
+
+    // l2 residual codes only: |c|^2 + 2<c, r> per token vector, sized like inner_codes_
+    Vector<float> residual_bias_;
+
     static constexpr uint64_t DEFAULT_RESIZE_BIT = 10;
 };
 
@@ -26,6 +26,16 @@ WarpParameter::FromJson(const JsonType& json) {
                    fmt::format("warp parameters must contains {}", BASE_CODES_KEY));
     const auto& base_codes_json = json[BASE_CODES_KEY];
     this->base_codes_param = CreateFlattenParam(base_codes_json);
+    if (json.Contains(WARP_CENTROID_COUNT_KEY)) {
+        this->centroid_count = json[WARP_CENTROID_COUNT_KEY].GetInt();
+    }
+    if (json.Contains(WARP_USE_RESIDUAL_KEY)) {
+        this->use_residual = json[WARP_USE_RESIDUAL_KEY].GetBool();
+    }
+    CHECK_ARGUMENT(not this->use_residual or this->centroid_count > 0,
+                   fmt::format("warp {} needs {} > 0",
+                               WARP_USE_RESIDUAL_KEY,
+                               WARP_CENTROID_COUNT_KEY));
 }
 
 JsonType
@@ -33,6 +43,8 @@ WarpParameter::ToJson() const {
     JsonType json = InnerIndexParameter::ToJson();
     json[TYPE_KEY].SetString(INDEX_WARP);
     json[BASE_CODES_KEY].SetJson(this->base_codes_param->ToJson());
+    json[WARP_CENTROID_COUNT_KEY].SetInt(this->centroid_count);
+    json[WARP_USE_RESIDUAL_KEY].SetBool(this->use_residual);
     return json;
 }
 
@@ -45,6 +57,10 @@ WarpParameter::CheckCompatibility(const vsag::ParamPtr& other) const {
     if (other_param == nullptr) {
         return false;
     }
+    if (this->centroid_count != other_param->centroid_count or
+        this->use_residual != other_param->use_residual) {
+        return false;
+    }
     return this->base_codes_param->CheckCompatibility(other_param->base_codes_param);
 }
 
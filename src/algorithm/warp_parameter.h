@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <fmt/format.h>
+
 #include "datacell/flatten_interface_parameter.h"
 #include "index_search_parameter.h"
 #include "inner_index_parameter.h"
@@ -36,6 +38,14 @@ public:
 
 public:
     FlattenInterfaceParamPtr base_codes_param{nullptr};
+
+    // clusters the token vectors into centroid_count centroids to prune knn search, 0 scans all;
+    // until enough tokens for the centroids have been added, knn search scans all documents
+    uint32_t centroid_count{0};
+
+    // stores every token vector as its residual to its centroid, needs centroid_count > 0 and
+    // a first Add (or Train) with enough tokens to train the centroids
+    bool use_residual{false};
 };
 
 DEFINE_POINTER(WarpParameter);
@@ -50,8 +60,23 @@ public:
         auto params = JsonType::Parse(json_string);
         WarpSearchParameters obj;
         obj.IndexSearchParameter::FromJson(params);
+        if (params.Contains(INDEX_WARP)) {
+            obj.IndexSearchParameter::FromJson(params[INDEX_WARP]);
+            if (params[INDEX_WARP].Contains(WARP_SEARCH_PARAM_SCAN_CENTROIDS_COUNT)) {
+                obj.scan_centroids_count =
+                    params[INDEX_WARP][WARP_SEARCH_PARAM_SCAN_CENTROIDS_COUNT].GetInt();
+                CHECK_ARGUMENT(obj.scan_centroids_count >= 0,
+                               fmt::format("{} must be non-negative, got {}",
+                                           WARP_SEARCH_PARAM_SCAN_CENTROIDS_COUNT,
+                                           obj.scan_centroids_count));
+            }
+        }
         return obj;
     }
+
+public:
+    // centroids probed per query token when the index is clustered, 0 scans all documents
+    int64_t scan_centroids_count{4};
 };
 
 }  // namespace vsag
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <random>
 
 #include "impl/heap/standard_heap.h"
@@ -885,8 +886,14 @@ PyramidAnalyzer::search_single_node(const IndexNode* node,
 
         DistHeapPtr result;
         try {
-            result = pyramid_->search_node(
-                node, vl, inner_param, query_dataset, pyramid_->base_codes_, ctx, ef_search);
+            result = pyramid_->search_node(node,
+                                           vl,
+                                           inner_param,
+                                           query_dataset,
+                                           pyramid_->base_codes_,
+                                           ctx,
+                                           ef_search,
+                                           std::numeric_limits<float>::max());
 
             if (pyramid_->use_reorder_ && result != nullptr && !result->Empty()) {
                 result = pyramid_->reorder_->Reorder(result, query, inner_param.topk, ctx);
@@ -44,6 +44,12 @@ public:
         return this->scan_bucket_by_id(result_dists, comp, bucket_id);
     }
 
+    void
+    ScanBucketByIdBatch(float* result_dists,
+                        const ComputerInterfacePtr* computers,
+                        uint64_t query_count,
+                        const BucketIdType& bucket_id) override;
+
     float
     QueryOneById(const ComputerInterfacePtr& computer,
                  const BucketIdType& bucket_id,
@@ -99,6 +105,13 @@ public:
     void
     Deserialize(lvalue_or_rvalue<StreamReader> reader) override;
 
+    void
+    InitIO(const IOParamPtr& io_param) override {
+        for (BucketIdType i = 0; i < this->bucket_count_; ++i) {
+            datas_[i].InitIO(io_param);
+        }
+    }
+
     [[nodiscard]] std::string
     GetQuantizerName() override {
         return this->quantizer_->Name();
@@ -118,6 +131,12 @@ public:
     void
     GetCodesById(BucketIdType bucket_id, InnerIdType offset_id, uint8_t* data) const override;
 
+    void
+    DecodeById(BucketIdType bucket_id, InnerIdType offset_id, float* vector) override;
+
+    void
+    ResetBucket(BucketIdType bucket_id) override;
+
     [[nodiscard]] int64_t
     GetMemoryUsage() const override {
         int64_t memory = sizeof(BucketDataCell);
@@ -125,6 +144,7 @@ public:
             memory += this->datas_[bucket_id].GetMemoryUsage();
             memory += this->inner_ids_[bucket_id].size() * sizeof(InnerIdType);
             memory += this->residual_bias_[bucket_id].size() * sizeof(float);
+            memory += this->code_norms_[bucket_id].size() * sizeof(float);
             memory += sizeof(std::shared_mutex) + sizeof(InnerIdType);
         }
         return memory;
@@ -143,6 +163,14 @@ private:
                       Computer<QuantTmpl>* computer,
                       const BucketIdType& bucket_id);
 
+    // turns the residual distances of one query into distances to the original vectors
+    inline void
+    apply_residual(float* result_dists,
+                   Computer<QuantTmpl>* computer,
+                   const Vector<float>& centroid,
+                   const BucketIdType& bucket_id,
+                   InnerIdType count);
+
     inline float
     query_one_by_id(const std::shared_ptr<Computer<QuantTmpl>>& computer,
                     const BucketIdType& bucket_id,
@@ -154,6 +182,9 @@ private:
     inline void
     unpack_fastscan();
 
+    void
+    rebuild_code_norms(BucketIdType bucket_id);
+
 private:
     std::shared_ptr<QuantTmpl> quantizer_{nullptr};
 
@@ -169,6 +200,9 @@ private:
 
     Vector<Vector<float>> residual_bias_;
 
+    // CodeNorm of every code when the quantizer scans with them, rebuilt on Deserialize
+    Vector<Vector<float>> code_norms_;
+
     MetricType metric_{MetricType::METRIC_TYPE_L2SQR};
 };
 
@@ -187,6 +221,7 @@ BucketDataCell<QuantTmpl, IOTmpl>::BucketDataCell(const QuantizerParamPtr& quant
       bucket_mutexes_(bucket_count, common_param.allocator_.get()),
       allocator_(common_param.allocator_.get()),
       residual_bias_(bucket_count, Vector<float>(allocator_), allocator_),
+      code_norms_(bucket_count, Vector<float>(allocator_), allocator_),
       metric_(common_param.metric_) {
     this->bucket_count_ = bucket_count;
     this->quantizer_ = std::make_shared<QuantTmpl>(quantization_param, common_param);
@@ -259,20 +294,81 @@ BucketDataCell<QuantTmpl, IOTmpl>::scan_bucket_by_id(float* result_dists,
         offset += compute_count;
     }
 
-    auto ip_distance = 0.0F;
-    Vector<float> centroid(this->quantizer_->GetDim(), allocator_);
     if (use_residual_) {
+        Vector<float> centroid(this->quantizer_->GetDim(), allocator_);
         strategy_->GetCentroid(bucket_id, centroid);
-        ip_distance =
-            FP32ComputeIP(computer->raw_query_.data(), centroid.data(), this->quantizer_->GetDim());
-        if (metric_ == MetricType::METRIC_TYPE_L2SQR) {
-            ip_distance *= 2;
-            FP32Sub(result_dists, residual_bias_[bucket_id].data(), result_dists, offset);
+        this->apply_residual(result_dists, computer, centroid, bucket_id, offset);
+    }
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+BucketDataCell<QuantTmpl, IOTmpl>::ScanBucketByIdBatch(float* result_dists,
+                                                       const ComputerInterfacePtr* computers,
+                                                       uint64_t query_count,
+                                                       const BucketIdType& bucket_id) {
+    if (bucket_id >= this->bucket_count_ or bucket_id < 0) {
+        throw VsagException(ErrorType::INTERNAL_ERROR, "visited invalid bucket id");
+    }
+    Vector<Computer<QuantTmpl>*> comps(query_count, allocator_);
+    for (uint64_t q = 0; q < query_count; ++q) {
+        comps[q] = static_cast<Computer<QuantTmpl>*>(computers[q].get());
+    }
+    std::shared_lock lock(this->bucket_mutexes_[bucket_id]);
+    // every block of codes is read once and scanned by all queries while it is in cache
+    constexpr InnerIdType scan_block_size = 256;
+    InnerIdType offset = 0;
+    auto bucket_size = this->bucket_sizes_[bucket_id];
+    auto data_count = bucket_size;
+    while (data_count > 0) {
+        auto compute_count = std::min(data_count, scan_block_size);
+        bool need_release = false;
+        const auto* codes = this->datas_[bucket_id].Read(
+            code_size_ * compute_count, offset * code_size_, need_release);
+        const float* code_norms = nullptr;
+        if (this->quantizer_->NeedCodeNorms()) {
+            code_norms = this->code_norms_[bucket_id].data() + offset;
         }
-        // TODO(inabao): optimize this loop with simd
-        for (InnerIdType i = 0; i < offset; ++i) {
-            result_dists[i] -= ip_distance;
+        this->quantizer_->ScanQueriesBatchDists(comps.data(),
+                                                query_count,
+                                                compute_count,
+                                                codes,
+                                                code_norms,
+                                                result_dists + offset,
+                                                bucket_size);
+        if (need_release) {
+            this->datas_[bucket_id].Release(codes);
         }
+        data_count -= compute_count;
+        offset += compute_count;
+    }
+
+    if (use_residual_) {
+        Vector<float> centroid(this->quantizer_->GetDim(), allocator_);
+        strategy_->GetCentroid(bucket_id, centroid);
+        for (uint64_t q = 0; q < query_count; ++q) {
+            this->apply_residual(
+                result_dists + q * bucket_size, comps[q], centroid, bucket_id, bucket_size);
+        }
+    }
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+BucketDataCell<QuantTmpl, IOTmpl>::apply_residual(float* result_dists,
+                                                  Computer<QuantTmpl>* computer,
+                                                  const Vector<float>& centroid,
+                                                  const BucketIdType& bucket_id,
+                                                  InnerIdType count) {
+    auto ip_distance =
+        FP32ComputeIP(computer->raw_query_.data(), centroid.data(), this->quantizer_->GetDim());
+    if (metric_ == MetricType::METRIC_TYPE_L2SQR) {
+        ip_distance *= 2;
+        FP32Sub(result_dists, residual_bias_[bucket_id].data(), result_dists, count);
+    }
+    // TODO(inabao): optimize this loop with simd
+    for (InnerIdType i = 0; i < count; ++i) {
+        result_dists[i] -= ip_distance;
     }
 }
 
@@ -353,6 +449,8 @@ BucketDataCell<QuantTmpl, IOTmpl>::InsertVector(const void* vector,
             -2 * FP32ComputeIP(centroid.data(), normalize_data.data(), this->quantizer_->GetDim()) -
             FP32ComputeIP(centroid.data(), centroid.data(), this->quantizer_->GetDim());
     }
+    auto need_code_norm = this->quantizer_->NeedCodeNorms();
+    float code_norm = need_code_norm ? this->quantizer_->CodeNorm(codes.data) : 0.0F;
     {
         std::unique_lock lock(this->bucket_mutexes_[bucket_id]);
         offset_id = this->bucket_sizes_[bucket_id];
@@ -365,6 +463,9 @@ BucketDataCell<QuantTmpl, IOTmpl>::InsertVector(const void* vector,
         if (use_residual_ && metric_ == MetricType::METRIC_TYPE_L2SQR) {
             residual_bias_[bucket_id].emplace_back(res_score);
         }
+        if (need_code_norm) {
+            code_norms_[bucket_id].emplace_back(code_norm);
+        }
     }
     return offset_id;
 }
@@ -397,6 +498,30 @@ BucketDataCell<QuantTmpl, IOTmpl>::Deserialize(lvalue_or_rvalue<StreamReader> re
         }
     }
     StreamReader::ReadVector(reader, this->bucket_sizes_);
+    if (this->quantizer_->NeedCodeNorms()) {
+        for (BucketIdType i = 0; i < this->bucket_count_; ++i) {
+            this->rebuild_code_norms(i);
+        }
+    }
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+BucketDataCell<QuantTmpl, IOTmpl>::rebuild_code_norms(BucketIdType bucket_id) {
+    auto bucket_size = this->bucket_sizes_[bucket_id];
+    auto& code_norms = this->code_norms_[bucket_id];
+    code_norms.resize(bucket_size);
+    if (bucket_size == 0) {
+        return;
+    }
+    bool need_release = false;
+    const auto* codes = this->datas_[bucket_id].Read(code_size_ * bucket_size, 0, need_release);
+    for (InnerIdType i = 0; i < bucket_size; ++i) {
+        code_norms[i] = this->quantizer_->CodeNorm(codes + i * code_size_);
+    }
+    if (need_release) {
+        this->datas_[bucket_id].Release(codes);
+    }
 }
 
 template <typename QuantTmpl, typename IOTmpl>
@@ -490,6 +615,9 @@ BucketDataCell<QuantTmpl, IOTmpl>::MergeOther(const BucketInterfacePtr& other, I
         for (auto id : ptr->inner_ids_[i]) {
             this->inner_ids_[i].emplace_back(id + bias);
         }
+        this->code_norms_[i].insert(this->code_norms_[i].end(),
+                                    ptr->code_norms_[i].begin(),
+                                    ptr->code_norms_[i].end());
     }
 }
 
@@ -511,4 +639,33 @@ BucketDataCell<QuantTmpl, IOTmpl>::GetCodesById(BucketIdType bucket_id,
     this->datas_[bucket_id].Read(this->code_size_, offset_id * this->code_size_, data);
 }
 
+template <typename QuantTmpl, typename IOTmpl>
+void
+BucketDataCell<QuantTmpl, IOTmpl>::DecodeById(BucketIdType bucket_id,
+                                              InnerIdType offset_id,
+                                              float* vector) {
+    ByteBuffer codes(static_cast<uint64_t>(code_size_), this->allocator_);
+    {
+        std::shared_lock lock(this->bucket_mutexes_[bucket_id]);
+        this->GetCodesById(bucket_id, offset_id, codes.data);
+    }
+    this->quantizer_->DecodeOne(codes.data, vector);
+    if (use_residual_) {
+        Vector<float> centroid(this->quantizer_->GetDim(), allocator_);
+        strategy_->GetCentroid(bucket_id, centroid);
+        FP32Add(vector, centroid.data(), vector, this->quantizer_->GetDim());
+    }
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+BucketDataCell<QuantTmpl, IOTmpl>::ResetBucket(BucketIdType bucket_id) {
+    check_valid_bucket_id(bucket_id);
+    std::unique_lock lock(this->bucket_mutexes_[bucket_id]);
+    this->bucket_sizes_[bucket_id] = 0;
+    this->inner_ids_[bucket_id].clear();
+    this->residual_bias_[bucket_id].clear();
+    this->code_norms_[bucket_id].clear();
+}
+
 }  // namespace vsag
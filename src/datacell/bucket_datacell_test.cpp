@@ -16,6 +16,7 @@
 #include "bucket_datacell.h"
 
 #include <algorithm>
+#include <random>
 #include <utility>
 
 #include "impl/allocator/default_allocator.h"
@@ -90,6 +91,53 @@ BucketInterfaceTest::BasicTest(int64_t dim, uint64_t base_count, float error) {
         REQUIRE_THROWS(bucket_->QueryOneById(computer, 0, 10000));
     }
 
+    // Test ScanBucketByIdBatch, the batch kernels may round differently from the single ones
+    std::vector<ComputerInterfacePtr> computers;
+    for (int64_t i = 0; i < query_count; ++i) {
+        computers.emplace_back(bucket_->FactoryComputer(queries.data() + i * dim));
+    }
+    for (auto bucket_id = 0; bucket_id < bucket_count; ++bucket_id) {
+        auto bucket_size = bucket_->GetBucketSize(bucket_id);
+        std::vector<float> batch_dists(query_count * bucket_size);
+        bucket_->ScanBucketByIdBatch(batch_dists.data(), computers.data(), query_count, bucket_id);
+        for (int64_t i = 0; i < query_count; ++i) {
+            bucket_->ScanBucketById(dists.data(), computers[i], bucket_id);
+            for (int64_t j = 0; j < bucket_size; ++j) {
+                REQUIRE(std::abs(batch_dists[i * bucket_size + j] - dists[j]) <
+                        std::max(error, 1e-4F) * std::max(1.0F, std::abs(dists[j])));
+            }
+        }
+    }
+    REQUIRE_THROWS(
+        bucket_->ScanBucketByIdBatch(dists.data(), computers.data(), 1, bucket_count * 2));
+
+    // Test DecodeById and ResetBucket, re-inserting the decoded vectors keeps the bucket
+    BucketIdType moved_bucket = 0;
+    auto moved_size = bucket_->GetBucketSize(moved_bucket);
+    std::vector<InnerIdType> moved_ids(bucket_->GetInnerIds(moved_bucket),
+                                       bucket_->GetInnerIds(moved_bucket) + moved_size);
+    std::vector<float> decoded(moved_size * dim);
+    for (InnerIdType j = 0; j < moved_size; ++j) {
+        bucket_->DecodeById(moved_bucket, j, decoded.data() + j * dim);
+    }
+    bucket_->ResetBucket(moved_bucket);
+    REQUIRE(bucket_->GetBucketSize(moved_bucket) == 0);
+    for (InnerIdType j = 0; j < moved_size; ++j) {
+        bucket_->InsertVector(decoded.data() + j * dim, moved_bucket, moved_ids[j]);
+    }
+    REQUIRE(bucket_->GetBucketSize(moved_bucket) == moved_size);
+    bucket_->ScanBucketById(dists.data(), computers[0], moved_bucket);
+    for (InnerIdType j = 0; j < moved_size; ++j) {
+        REQUIRE(bucket_->GetInnerIds(moved_bucket)[j] == moved_ids[j]);
+        float gt = 0;
+        if (metric_ == vsag::MetricType::METRIC_TYPE_L2SQR) {
+            gt = L2Sqr(vectors.data() + moved_ids[j] * dim, queries.data(), &dim);
+        } else {
+            gt = 1 - InnerProduct(vectors.data() + moved_ids[j] * dim, queries.data(), &dim);
+        }
+        REQUIRE(std::abs(gt - dists[j]) < 2 * error);
+    }
+
     // exceptions
     REQUIRE_THROWS(bucket_->InsertVector(vectors.data() + 1 * dim, bucket_count, 98));
 }
@@ -122,6 +170,21 @@ BucketInterfaceTest::TestSerializeAndDeserialize(int64_t dim, const BucketInterf
                 REQUIRE(dists_1[j] == dists_2[j]);
             }
         }
+
+        // the batch scan of the deserialized bucket reads the norms rebuilt from its codes
+        std::vector<ComputerInterfacePtr> computers;
+        for (int64_t i = 0; i < query_count; ++i) {
+            computers.emplace_back(other->FactoryComputer(queries.data() + i * dim));
+        }
+        std::vector<float> batch_dists(query_count * bucket_size);
+        other->ScanBucketByIdBatch(batch_dists.data(), computers.data(), query_count, bucket_id);
+        for (int64_t i = 0; i < query_count; ++i) {
+            this->bucket_->ScanBucketById(dists_1.data(), computers[i], bucket_id);
+            for (int64_t j = 0; j < bucket_size; ++j) {
+                REQUIRE(std::abs(batch_dists[i * bucket_size + j] - dists_1[j]) <
+                        1e-2F * std::max(1.0F, std::abs(dists_1[j])));
+            }
+        }
     }
 }
 
@@ -187,3 +250,62 @@ TEST_CASE("BucketDataCell Basic Test", "[ut][BucketDataCell] ") {
 
     TestBucketDataCell(param1, param2, common_param, quantizer_error.second);
 }
+
+TEST_CASE("BucketDataCell Batch Scan Of Near Duplicates", "[ut][BucketDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 128;
+    int64_t base_count = 300;
+    int64_t query_count = 16;
+    constexpr const char* param_str =
+        R"(
+        {
+            "io_params": {
+                "type": "memory_io"
+            },
+            "quantization_params": {
+                "type": "fp32"
+            },
+            "buckets_count": 1
+        }
+        )";
+    auto param = std::make_shared<BucketDataCellParameter>();
+    param->FromJson(JsonType::Parse(param_str));
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    common_param.dim_ = dim;
+    common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    auto bucket = BucketInterface::MakeInstance(param, common_param);
+
+    // away from the origin |q|^2 + |x|^2 dwarfs the distance of a near duplicate, so the
+    // expansion |q|^2 + |x|^2 - 2 <q, x> alone loses all of its digits
+    auto vectors = fixtures::generate_vectors(base_count, dim, false);
+    for (auto& value : vectors) {
+        value += 10.0F;
+    }
+    bucket->Train(vectors.data(), base_count);
+    for (int64_t i = 0; i < base_count; ++i) {
+        bucket->InsertVector(vectors.data() + i * dim, 0, i);
+    }
+    std::vector<float> queries(vectors.begin(), vectors.begin() + query_count * dim);
+    std::mt19937 rng(47);
+    std::uniform_real_distribution<float> noise(-1e-3F, 1e-3F);
+    for (auto& value : queries) {
+        value += noise(rng);
+    }
+
+    std::vector<ComputerInterfacePtr> computers;
+    for (int64_t i = 0; i < query_count; ++i) {
+        computers.emplace_back(bucket->FactoryComputer(queries.data() + i * dim));
+    }
+    std::vector<float> batch_dists(query_count * base_count);
+    std::vector<float> dists(base_count);
+    bucket->ScanBucketByIdBatch(batch_dists.data(), computers.data(), query_count, 0);
+    for (int64_t i = 0; i < query_count; ++i) {
+        bucket->ScanBucketById(dists.data(), computers[i], 0);
+        // the i-th base vector is the near duplicate of the i-th query
+        REQUIRE(dists[i] > 0.0F);
+        for (int64_t j = 0; j < base_count; ++j) {
+            REQUIRE(std::abs(batch_dists[i * base_count + j] - dists[j]) <= 1e-3F * dists[j]);
+        }
+    }
+}
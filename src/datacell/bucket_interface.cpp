@@ -106,9 +106,15 @@ BucketInterface::MakeInstance(const BucketDataCellParamPtr& param,
     if (io_type_name == IO_TYPE_VALUE_ASYNC_IO) {
         return make_instance<NonContinuousIO<AsyncIO>>(param, common_param);
     }
+    if (io_type_name == IO_TYPE_VALUE_IO_URING_IO) {
+        return make_instance<NonContinuousIO<IOUringIO>>(param, common_param);
+    }
     if (io_type_name == IO_TYPE_VALUE_BUFFER_IO) {
         return make_instance<NonContinuousIO<BufferIO>>(param, common_param);
     }
+    if (io_type_name == IO_TYPE_VALUE_READER_IO) {
+        return make_instance<ReaderIO>(param, common_param);
+    }
     return nullptr;
 }
 }  // namespace vsag
@@ -42,6 +42,22 @@ public:
                    const ComputerInterfacePtr& computer,
                    const BucketIdType& bucket_id) = 0;
 
+    /**
+     * @brief Scans the codes of a bucket once for several queries.
+     *
+     * The distances of the q-th query are written to result_dists + q * GetBucketSize(bucket_id).
+     */
+    virtual void
+    ScanBucketByIdBatch(float* result_dists,
+                        const ComputerInterfacePtr* computers,
+                        uint64_t query_count,
+                        const BucketIdType& bucket_id) {
+        auto bucket_size = this->GetBucketSize(bucket_id);
+        for (uint64_t q = 0; q < query_count; ++q) {
+            this->ScanBucketById(result_dists + q * bucket_size, computers[q], bucket_id);
+        }
+    }
+
     virtual float
     QueryOneById(const ComputerInterfacePtr& computer,
                  const BucketIdType& bucket_id,
@@ -65,6 +81,19 @@ public:
     virtual void
     GetCodesById(BucketIdType bucket_id, InnerIdType offset_id, uint8_t* data) const = 0;
 
+    /**
+     * @brief Decodes a stored vector back to float (normalized for cosine), used to move vectors
+     * between buckets. The codes must be unpacked.
+     */
+    virtual void
+    DecodeById(BucketIdType bucket_id, InnerIdType offset_id, float* vector) = 0;
+
+    /**
+     * @brief Empties a bucket so its vectors can be inserted again under a new centroid.
+     */
+    virtual void
+    ResetBucket(BucketIdType bucket_id) = 0;
+
     [[nodiscard]] virtual std::string
     GetQuantizerName() = 0;
 
@@ -85,6 +114,13 @@ public:
     virtual void
     MergeOther(const BucketInterfacePtr& other, InnerIdType bias) = 0;
 
+    /**
+     * @brief Attaches the Reader of a deserialized index to reader backed buckets.
+     */
+    virtual void
+    InitIO(const IOParamPtr& io_param) {
+    }
+
     virtual void
     SetStrategy(const IVFPartitionStrategyPtr& strategy) {
         strategy_ = strategy;
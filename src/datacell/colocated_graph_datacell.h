@@ -0,0 +1,93 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+
+#include "colocated_graph_datacell_parameter.h"
+#include "graph_datacell.h"
+#include "utils/util_functions.h"
+
+namespace vsag {
+
+/**
+ * A graph datacell whose per-node record also holds the vector code of the node:
+ *
+ *   | neighbor count | neighbor ids (maximum degree) | pad | code | pad to cache line |
+ *
+ * A hop reads the neighbor list and the code from the same few cache lines and the same
+ * page, instead of from two unrelated IO objects. The record layout is fixed by
+ * AttachCodes, which the flatten datacell holding the codes calls through ColocateWith.
+ */
+template <typename IOTmpl>
+class ColocatedGraphDataCell : public GraphDataCell<IOTmpl> {
+public:
+    static constexpr uint64_t RECORD_ALIGNMENT = 64;
+    static constexpr uint64_t CODE_ALIGNMENT = 16;
+
+public:
+    explicit ColocatedGraphDataCell(const GraphInterfaceParamPtr& graph_param,
+                                    const IndexCommonParam& common_param)
+        : GraphDataCell<IOTmpl>(graph_param, common_param) {
+        neighbor_part_size_ = this->code_line_size_;
+        this->code_line_size_ = static_cast<uint32_t>(
+            align_up(static_cast<int64_t>(neighbor_part_size_), RECORD_ALIGNMENT));
+    }
+
+    /**
+     * Reserves code_size bytes for the vector code in every record and returns the offset of
+     * the code inside a record. Must be called before any neighbor is inserted.
+     */
+    uint64_t
+    AttachCodes(uint32_t code_size) {
+        if (this->total_count_ > 0) {
+            throw VsagException(ErrorType::INTERNAL_ERROR,
+                                "codes must be attached to an empty colocated graph");
+        }
+        auto code_offset = align_up(static_cast<int64_t>(neighbor_part_size_), CODE_ALIGNMENT);
+        this->code_line_size_ = static_cast<uint32_t>(
+            align_up(code_offset + static_cast<int64_t>(code_size), RECORD_ALIGNMENT));
+        return static_cast<uint64_t>(code_offset);
+    }
+
+    [[nodiscard]] std::shared_ptr<BasicIO<IOTmpl>>
+    GetIO() const {
+        return this->io_;
+    }
+
+    [[nodiscard]] uint64_t
+    RecordSize() const {
+        return this->code_line_size_;
+    }
+
+    void
+    Deserialize(StreamReader& reader) override {
+        auto record_size = this->code_line_size_;
+        GraphDataCell<IOTmpl>::Deserialize(reader);
+        if (this->code_line_size_ != record_size) {
+            throw VsagException(
+                ErrorType::INVALID_ARGUMENT,
+                fmt::format("colocated graph record size mismatch: serialized {} vs expected {}",
+                            this->code_line_size_,
+                            record_size));
+        }
+    }
+
+private:
+    // bytes of the neighbor count and the neighbor ids at the head of a record
+    uint32_t neighbor_part_size_{0};
+};
+
+}  // namespace vsag
@@ -0,0 +1,49 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "graph_datacell_parameter.h"
+#include "impl/logger/logger.h"
+#include "inner_string_params.h"
+#include "utils/pointer_define.h"
+
+namespace vsag {
+DEFINE_POINTER2(ColocatedGraphDataCellParam, ColocatedGraphDataCellParameter);
+class ColocatedGraphDataCellParameter : public GraphDataCellParameter {
+public:
+    ColocatedGraphDataCellParameter()
+        : GraphDataCellParameter(GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_COLOCATED) {
+    }
+
+    JsonType
+    ToJson() const override {
+        JsonType json = GraphDataCellParameter::ToJson();
+        json[GRAPH_STORAGE_TYPE_KEY].SetString(GRAPH_STORAGE_TYPE_VALUE_COLOCATED);
+        return json;
+    }
+
+    bool
+    CheckCompatibility(const vsag::ParamPtr& other) const override {
+        auto graph_param = std::dynamic_pointer_cast<ColocatedGraphDataCellParameter>(other);
+        if (not graph_param) {
+            logger::error(
+                "ColocatedGraphDataCellParameter::CheckCompatibility: other parameter "
+                "is not a ColocatedGraphDataCellParameter");
+            return false;
+        }
+        return GraphDataCellParameter::CheckCompatibility(other);
+    }
+};
+}  // namespace vsag
@@ -0,0 +1,191 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "colocated_graph_datacell.h"
+
+#include <fmt/format.h>
+
+#include <filesystem>
+#include <sstream>
+
+#include "flatten_interface.h"
+#include "graph_interface_parameter.h"
+#include "graph_interface_test.h"
+#include "impl/allocator/safe_allocator.h"
+#include "io/memory_io.h"
+#include "unittest.h"
+
+using namespace vsag;
+
+namespace {
+
+constexpr const char* COLOCATED_GRAPH_PARAM_TEMP =
+    R"(
+    {{
+        "io_params": {{
+            "type": "{}",
+            "file_path": "{}"
+        }},
+        "max_degree": {},
+        "init_capacity": 100
+    }}
+    )";
+
+constexpr const char* CODES_PARAM_TEMP =
+    R"(
+    {{
+        "io_params": {{
+            "type": "{}",
+            "file_path": "{}"
+        }},
+        "quantization_params": {{
+            "type": "{}"
+        }}
+    }}
+    )";
+
+std::pair<GraphInterfacePtr, FlattenInterfacePtr>
+MakeColocatedPair(const GraphInterfaceParamPtr& graph_param,
+                  const FlattenInterfaceParamPtr& codes_param,
+                  const IndexCommonParam& common_param) {
+    auto graph = GraphInterface::MakeInstance(graph_param, common_param);
+    auto codes = FlattenInterface::MakeInstance(codes_param, common_param);
+    codes->ColocateWith(graph);
+    return {graph, codes};
+}
+
+}  // namespace
+
+TEST_CASE("ColocatedGraphDataCell Basic Test", "[ut][ColocatedGraphDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto max_degree = GENERATE(5, 32);
+    auto io_type = GENERATE("memory_io", "block_memory_io");
+
+    IndexCommonParam common_param;
+    common_param.dim_ = 32;
+    common_param.allocator_ = allocator;
+    auto param_json =
+        JsonType::Parse(fmt::format(COLOCATED_GRAPH_PARAM_TEMP, io_type, "", max_degree));
+    auto graph_param = GraphInterfaceParameter::GetGraphParameterByJson(
+        GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_COLOCATED, param_json);
+    REQUIRE(graph_param->ToJson()[GRAPH_STORAGE_TYPE_KEY].GetString() ==
+            GRAPH_STORAGE_TYPE_VALUE_COLOCATED);
+
+    auto graph = GraphInterface::MakeInstance(graph_param, common_param);
+    GraphInterfaceTest test(graph);
+    auto other = GraphInterface::MakeInstance(graph_param, common_param);
+    test.BasicTest(10000, 1000, other, false);
+}
+
+TEST_CASE("ColocatedGraphDataCell Codes Share Records", "[ut][ColocatedGraphDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto dim = GENERATE(17, 128);
+    auto max_degree = 16;
+    auto count = 500;
+    std::string io_type = GENERATE("memory_io", "block_memory_io", "mmap_io");
+    std::string quantization_type = GENERATE("fp32", "sq4_uniform");
+
+    IndexCommonParam common_param;
+    common_param.dim_ = dim;
+    common_param.allocator_ = allocator;
+    common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    fixtures::TempDir temp_dir("colocated_graph_datacell");
+    auto make_params = [&](const std::string& file_path) {
+        auto graph_param = GraphInterfaceParameter::GetGraphParameterByJson(
+            GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_COLOCATED,
+            JsonType::Parse(
+                fmt::format(COLOCATED_GRAPH_PARAM_TEMP, io_type, file_path, max_degree)));
+        auto codes_param = std::make_shared<FlattenDataCellParameter>();
+        codes_param->FromJson(
+            JsonType::Parse(fmt::format(CODES_PARAM_TEMP, io_type, file_path, quantization_type)));
+        codes_param->colocated = true;
+        return std::make_pair(graph_param, codes_param);
+    };
+    auto file_path = temp_dir.GenerateRandomFile(false);
+    auto [graph_param, codes_param] = make_params(file_path);
+
+    auto [graph, codes] = MakeColocatedPair(graph_param, codes_param, common_param);
+    if (io_type == "mmap_io") {
+        // the codes own no io, nothing but the graph may create or remove the mapped file
+        REQUIRE(std::filesystem::exists(file_path));
+    }
+    auto colocated = std::dynamic_pointer_cast<ColocatedGraphDataCell<MemoryIO>>(graph);
+    if (colocated != nullptr) {
+        REQUIRE(colocated->RecordSize() % ColocatedGraphDataCell<MemoryIO>::RECORD_ALIGNMENT == 0);
+    }
+
+    auto vectors = fixtures::generate_vectors(count, dim);
+    graph->Resize(count);
+    codes->Resize(count);
+    codes->Train(vectors.data(), count);
+    // interleave the writes of both datacells, neither may clobber the other one
+    for (InnerIdType i = 0; i < count; ++i) {
+        codes->InsertVector(vectors.data() + i * dim, i);
+        Vector<InnerIdType> neighbors(allocator.get());
+        for (InnerIdType j = 1; j <= max_degree; ++j) {
+            neighbors.emplace_back((i + j) % count);
+        }
+        graph->InsertNeighborsById(i, neighbors);
+    }
+
+    std::vector<InnerIdType> ids(count);
+    std::vector<float> expected(count);
+    for (InnerIdType i = 0; i < count; ++i) {
+        ids[i] = i;
+        expected[i] = codes->ComputePairVectors(0, i);
+    }
+    auto check = [&](const GraphInterfacePtr& g, const FlattenInterfacePtr& c) {
+        std::vector<float> dists(count);
+        auto computer = c->FactoryComputer(vectors.data());
+        c->Query(dists.data(), computer, ids.data(), count);
+        Vector<InnerIdType> neighbors(allocator.get());
+        for (InnerIdType i = 0; i < count; ++i) {
+            REQUIRE(c->ComputePairVectors(0, i) == expected[i]);
+            float dist = 0;
+            c->Query(&dist, computer, ids.data() + i, 1);
+            REQUIRE(fixtures::dist_t(dists[i]) == fixtures::dist_t(dist));
+            g->GetNeighbors(i, neighbors);
+            REQUIRE(neighbors.size() == max_degree);
+            REQUIRE(neighbors.front() == (i + 1) % count);
+            REQUIRE(neighbors.back() == (i + max_degree) % count);
+        }
+    };
+    check(graph, codes);
+
+    SECTION("serialize and deserialize") {
+        std::stringstream ss;
+        IOStreamWriter writer(ss);
+        codes->Serialize(writer);
+        graph->Serialize(writer);
+        auto [graph_param2, codes_param2] = make_params(temp_dir.GenerateRandomFile(false));
+        auto [graph2, codes2] = MakeColocatedPair(graph_param2, codes_param2, common_param);
+        IOStreamReader reader(ss);
+        codes2->Deserialize(reader);
+        graph2->Deserialize(reader);
+        check(graph2, codes2);
+    }
+
+    SECTION("colocate with a flat graph is rejected") {
+        auto flat_param = GraphInterfaceParameter::GetGraphParameterByJson(
+            GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_FLAT,
+            JsonType::Parse(fmt::format(COLOCATED_GRAPH_PARAM_TEMP,
+                                        io_type,
+                                        temp_dir.GenerateRandomFile(false),
+                                        max_degree)));
+        auto flat_graph = GraphInterface::MakeInstance(flat_param, common_param);
+        auto other_codes = FlattenInterface::MakeInstance(codes_param, common_param);
+        REQUIRE_THROWS(other_codes->ColocateWith(flat_graph));
+        REQUIRE_FALSE(flat_param->CheckCompatibility(graph_param));
+    }
+}
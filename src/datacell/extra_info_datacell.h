@@ -57,6 +57,11 @@ public:
         this->max_capacity_ = new_capacity;
     }
 
+    [[nodiscard]] bool
+    SupportConcurrentResize() const override {
+        return IOTmpl::ConcurrentResize;
+    }
+
     void
     Release(const char* extra_info) override {
         if (extra_info == nullptr) {
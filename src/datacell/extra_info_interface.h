@@ -53,6 +53,11 @@ public:
     virtual void
     Resize(InnerIdType capacity) = 0;
 
+    [[nodiscard]] virtual bool
+    SupportConcurrentResize() const {
+        return false;
+    }
+
     virtual void
     Release(const char* extra_info) = 0;
 
@@ -20,8 +20,10 @@
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <numeric>
 
 #include "algorithm/inner_index_interface.h"
+#include "colocated_graph_datacell.h"
 #include "common.h"
 #include "flatten_interface.h"
 #include "io/basic_io.h"
@@ -90,14 +92,25 @@ public:
         if (new_capacity <= this->max_capacity_) {
             return;
         }
-        uint64_t io_size = static_cast<uint64_t>(new_capacity) * static_cast<uint64_t>(code_size_);
-        this->io_->Resize(io_size);
+        if (not this->colocated()) {
+            uint64_t io_size =
+                static_cast<uint64_t>(new_capacity) * static_cast<uint64_t>(code_size_);
+            this->io_->Resize(io_size);
+        }
         this->max_capacity_ = new_capacity;
+        if (this->delta_tracker_ != nullptr) {
+            this->delta_tracker_->Resize(new_capacity);
+        }
+    }
+
+    [[nodiscard]] bool
+    SupportConcurrentResize() const override {
+        return IOTmpl::ConcurrentResize;
     }
 
     void
     Prefetch(InnerIdType id) override {
-        io_->Prefetch(id * code_size_, code_size_);
+        io_->Prefetch(this->code_position(id), code_size_);
     };
 
     void
@@ -115,6 +128,9 @@ public:
         ptr->quantizer_->Deserialize(reader);
     }
 
+    void
+    ColocateWith(const GraphInterfacePtr& graph) override;
+
     void
     MergeOther(const FlattenInterfacePtr& other, InnerIdType bias) override;
 
@@ -123,8 +139,10 @@ public:
 
     void
     ShrinkToFit(InnerIdType capacity) override {
-        uint64_t io_size = static_cast<uint64_t>(capacity) * static_cast<uint64_t>(code_size_);
-        this->io_->Shrink(io_size);
+        if (not this->colocated()) {
+            uint64_t io_size = static_cast<uint64_t>(capacity) * static_cast<uint64_t>(code_size_);
+            this->io_->Shrink(io_size);
+        }
         this->max_capacity_ = capacity;
     }
 
@@ -155,6 +173,12 @@ public:
     void
     Deserialize(lvalue_or_rvalue<StreamReader> reader) override;
 
+    void
+    SerializeDelta(StreamWriter& writer, uint32_t base_epoch) override;
+
+    void
+    DeserializeDelta(StreamReader& reader) override;
+
     inline void
     SetQuantizer(std::shared_ptr<Quantizer<QuantTmpl>> quantizer) {
         this->quantizer_ = quantizer;
@@ -171,6 +195,16 @@ public:
         this->io_->InitIO(io_param);
     }
 
+    void
+    SetBlockCache(const BlockCachePtr& cache) override {
+        this->io_->SetBlockCache(cache);
+    }
+
+    bool
+    PinInBlockCache(InnerIdType id) override {
+        return this->io_->PinRange(this->code_position(id), code_size_);
+    }
+
     IndexCommonParam
     ExportCommonParam() override {
         return common_param_;
@@ -188,6 +222,29 @@ public:
     Allocator* const allocator_{nullptr};
 
 private:
+    // ids whose distances are computed together, matching the widest batch kernels
+    static constexpr InnerIdType QUERY_TILE_SIZE = 16;
+
+    [[nodiscard]] inline bool
+    colocated() const {
+        return this->record_size_ != 0;
+    }
+
+    [[nodiscard]] inline uint64_t
+    code_position(InnerIdType id) const {
+        if (this->colocated()) {
+            return static_cast<uint64_t>(id) * record_size_ + code_offset_;
+        }
+        return static_cast<uint64_t>(id) * static_cast<uint64_t>(code_size_);
+    }
+
+    // disjoint ranges may be merged concurrently, the count only moves forward
+    inline void
+    grow_total_count(InnerIdType count) {
+        std::lock_guard lock(mutex_);
+        this->total_count_ = std::max(this->total_count_, count);
+    }
+
     inline void
     query(float* result_dists,
           Computer<QuantTmpl>* computer,
@@ -201,6 +258,12 @@ private:
         computer->SetQuery(query);
         return computer;
     }
+
+private:
+    // set by ColocateWith: the codes live at code_offset_ inside records of record_size_
+    // bytes owned by a colocated graph, 0 means they are packed back to back in io_
+    uint64_t record_size_{0};
+    uint64_t code_offset_{0};
 };
 
 template <typename QuantTmpl, typename IOTmpl>
@@ -222,7 +285,10 @@ FlattenDataCell<QuantTmpl, IOTmpl>::FlattenDataCell(const QuantizerParamPtr& qua
     : allocator_(common_param.allocator_.get()) {
     this->common_param_ = common_param;
     this->quantizer_ = std::make_shared<QuantTmpl>(quantization_param, common_param);
-    this->io_ = std::make_shared<IOTmpl>(io_param, common_param);
+    if (io_param != nullptr) {
+        // colocated codes come without io, ColocateWith attaches the one of the graph
+        this->io_ = std::make_shared<IOTmpl>(io_param, common_param);
+    }
     this->code_size_ = quantizer_->GetCodeSize();
 }
 
@@ -248,8 +314,8 @@ FlattenDataCell<QuantTmpl, IOTmpl>::InsertVector(const void* vector, InnerIdType
     }
     ByteBuffer codes(static_cast<uint64_t>(code_size_), allocator_);
     quantizer_->EncodeOne(static_cast<const float*>(vector), codes.data);
-    io_->Write(
-        codes.data, code_size_, static_cast<uint64_t>(idx) * static_cast<uint64_t>(code_size_));
+    io_->Write(codes.data, code_size_, this->code_position(idx));
+    this->touch(idx, idx + 1);
 }
 
 template <typename QuantTmpl, typename IOTmpl>
@@ -261,8 +327,8 @@ FlattenDataCell<QuantTmpl, IOTmpl>::UpdateVector(const void* vector, InnerIdType
     std::lock_guard lock(mutex_);
     ByteBuffer codes(static_cast<uint64_t>(code_size_), allocator_);
     quantizer_->EncodeOne(static_cast<const float*>(vector), codes.data);
-    io_->Write(
-        codes.data, code_size_, static_cast<uint64_t>(idx) * static_cast<uint64_t>(code_size_));
+    io_->Write(codes.data, code_size_, this->code_position(idx));
+    this->touch(idx, idx + 1);
     return true;
 }
 
@@ -271,7 +337,7 @@ void
 FlattenDataCell<QuantTmpl, IOTmpl>::BatchInsertVector(const void* vectors,
                                                       InnerIdType count,
                                                       InnerIdType* idx_vec) {
-    if (idx_vec == nullptr) {
+    if (idx_vec == nullptr and not this->colocated()) {
         ByteBuffer codes(static_cast<uint64_t>(count) * static_cast<uint64_t>(code_size_),
                          allocator_);
         quantizer_->EncodeBatch(static_cast<const float*>(vectors), codes.data, count);
@@ -284,6 +350,7 @@ FlattenDataCell<QuantTmpl, IOTmpl>::BatchInsertVector(const void* vectors,
         io_->Write(codes.data,
                    static_cast<uint64_t>(count) * static_cast<uint64_t>(code_size_),
                    cur_count * static_cast<uint64_t>(code_size_));
+        this->touch(cur_count, cur_count + count);
     } else {
         auto dim = quantizer_->GetDim();
         for (int64_t i = 0; i < count; ++i) {
@@ -320,8 +387,7 @@ FlattenDataCell<QuantTmpl, IOTmpl>::query(float* result_dists,
     Allocator* search_alloc = select_query_allocator(ctx, allocator_);
 
     for (uint32_t i = 0; i < this->prefetch_stride_code_ and i < id_count; i++) {
-        this->io_->Prefetch(static_cast<uint64_t>(idx[i]) * static_cast<uint64_t>(code_size_),
-                            this->prefetch_depth_code_ * 64);
+        this->io_->Prefetch(this->code_position(idx[i]), this->prefetch_depth_code_ * 64);
     }
     if constexpr (not IOTmpl::InMemory) {
         if (id_count > 1) {
@@ -329,7 +395,7 @@ FlattenDataCell<QuantTmpl, IOTmpl>::query(float* result_dists,
             Vector<uint64_t> sizes(id_count, this->code_size_, search_alloc);
             Vector<uint64_t> offsets(id_count, this->code_size_, search_alloc);
             for (int64_t i = 0; i < id_count; ++i) {
-                offsets[i] = static_cast<uint64_t>(idx[i]) * this->code_size_;
+                offsets[i] = this->code_position(idx[i]);
             }
 
             double io_cost_ms = 0.0F;
@@ -349,70 +415,36 @@ FlattenDataCell<QuantTmpl, IOTmpl>::query(float* result_dists,
         }
     }
 
-    memset(result_dists, 0, sizeof(float) * id_count);
-    int64_t i = 0;
-    for (; i + 3 < id_count; i += 4) {
-        for (int64_t j = 0; j < 4; ++j) {
+    // gather the codes of a whole tile so that the quantizer computes it with its widest kernel
+    const uint8_t* codes[QUERY_TILE_SIZE];
+    bool releases[QUERY_TILE_SIZE];
+    for (InnerIdType i = 0; i < id_count; i += QUERY_TILE_SIZE) {
+        auto tile_size = std::min<InnerIdType>(QUERY_TILE_SIZE, id_count - i);
+        for (InnerIdType j = 0; j < tile_size; ++j) {
             if (i + j + this->prefetch_stride_code_ < id_count) {
-                this->io_->Prefetch(
-                    static_cast<uint64_t>(idx[i + j + this->prefetch_stride_code_]) *
-                        static_cast<uint64_t>(code_size_),
-                    this->prefetch_depth_code_ * 64);
+                this->io_->Prefetch(this->code_position(idx[i + j + this->prefetch_stride_code_]),
+                                    this->prefetch_depth_code_ * 64);
             }
         }
-        bool release1 = false, release2 = false, release3 = false, release4 = false;
-        const uint8_t* codes1 = nullptr;
-        const uint8_t* codes2 = nullptr;
-        const uint8_t* codes3 = nullptr;
-        const uint8_t* codes4 = nullptr;
-        auto release_batch = [&]() {
-            if (release1 && codes1) {
-                this->io_->Release(codes1);
-            }
-            if (release2 && codes2) {
-                this->io_->Release(codes2);
-            }
-            if (release3 && codes3) {
-                this->io_->Release(codes3);
-            }
-            if (release4 && codes4) {
-                this->io_->Release(codes4);
+        InnerIdType gathered = 0;
+        auto release_tile = [&]() {
+            for (InnerIdType j = 0; j < gathered; ++j) {
+                if (releases[j] && codes[j]) {
+                    this->io_->Release(codes[j]);
+                }
             }
         };
         try {
-            codes1 = this->GetCodesById(idx[i], release1);
-            codes2 = this->GetCodesById(idx[i + 1], release2);
-            codes3 = this->GetCodesById(idx[i + 2], release3);
-            codes4 = this->GetCodesById(idx[i + 3], release4);
-            computer->ComputeDistsBatch4(codes1,
-                                         codes2,
-                                         codes3,
-                                         codes4,
-                                         result_dists[i],
-                                         result_dists[i + 1],
-                                         result_dists[i + 2],
-                                         result_dists[i + 3]);
-        } catch (...) {
-            release_batch();
-            throw;
-        }
-        release_batch();
-    }
-    for (; i < id_count; ++i) {
-        bool release = false;
-        const uint8_t* codes = nullptr;
-        try {
-            codes = this->GetCodesById(idx[i], release);
-            computer->ComputeDist(codes, result_dists + i);
-        } catch (...) {
-            if (release && codes) {
-                this->io_->Release(codes);
+            for (; gathered < tile_size; ++gathered) {
+                releases[gathered] = false;
+                codes[gathered] = this->GetCodesById(idx[i + gathered], releases[gathered]);
             }
+            computer->ComputeDistsBatch(tile_size, codes, result_dists + i);
+        } catch (...) {
+            release_tile();
             throw;
         }
-        if (release && codes) {
-            this->io_->Release(codes);
-        }
+        release_tile();
     }
 }
 
@@ -445,22 +477,23 @@ FlattenDataCell<QuantTmpl, IOTmpl>::ComputePairVectors(InnerIdType id1, InnerIdT
 template <typename QuantTmpl, typename IOTmpl>
 const uint8_t*
 FlattenDataCell<QuantTmpl, IOTmpl>::GetCodesById(InnerIdType id, bool& need_release) const {
-    return io_->Read(
-        code_size_, static_cast<uint64_t>(id) * static_cast<uint64_t>(code_size_), need_release);
+    return io_->Read(code_size_, this->code_position(id), need_release);
 }
 
 template <typename QuantTmpl, typename IOTmpl>
 bool
 FlattenDataCell<QuantTmpl, IOTmpl>::GetCodesById(InnerIdType id, uint8_t* codes) const {
-    return io_->Read(
-        code_size_, static_cast<uint64_t>(id) * static_cast<uint64_t>(code_size_), codes);
+    return io_->Read(code_size_, this->code_position(id), codes);
 }
 
 template <typename QuantTmpl, typename IOTmpl>
 void
 FlattenDataCell<QuantTmpl, IOTmpl>::Serialize(StreamWriter& writer) {
     FlattenInterface::Serialize(writer);
-    this->io_->Serialize(writer);
+    // colocated codes are written with the records of the graph
+    if (not this->colocated()) {
+        this->io_->Serialize(writer);
+    }
     this->quantizer_->Serialize(writer);
 }
 
@@ -468,10 +501,92 @@ template <typename QuantTmpl, typename IOTmpl>
 void
 FlattenDataCell<QuantTmpl, IOTmpl>::Deserialize(lvalue_or_rvalue<StreamReader> reader) {
     FlattenInterface::Deserialize(reader);
-    this->io_->Deserialize(reader);
+    if (not this->colocated()) {
+        this->io_->Deserialize(reader);
+    }
     this->quantizer_->Deserialize(reader);
 }
 
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::SerializeDelta(StreamWriter& writer, uint32_t base_epoch) {
+    FlattenInterface::Serialize(writer);
+
+    // without a tracker every code counts as changed
+    Vector<InnerIdType> ids(allocator_);
+    if (this->delta_tracker_ != nullptr) {
+        ids = this->delta_tracker_->ChangedSince(base_epoch, this->total_count_);
+    } else {
+        ids.resize(this->total_count_);
+        std::iota(ids.begin(), ids.end(), 0);
+    }
+    StreamWriter::WriteVector(writer, ids);
+
+    ByteBuffer codes(static_cast<uint64_t>(code_size_), allocator_);
+    for (auto id : ids) {
+        this->GetCodesById(id, codes.data);
+        writer.Write(reinterpret_cast<const char*>(codes.data), code_size_);
+    }
+    this->quantizer_->Serialize(writer);
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::DeserializeDelta(StreamReader& reader) {
+    InnerIdType total_count = 0;
+    InnerIdType max_capacity = 0;
+    uint32_t code_size = 0;
+    StreamReader::ReadObj(reader, total_count);
+    StreamReader::ReadObj(reader, max_capacity);
+    StreamReader::ReadObj(reader, code_size);
+    if (code_size != this->code_size_) {
+        throw VsagException(ErrorType::INVALID_ARGUMENT,
+                            fmt::format("code size mismatch in delta: serialized {} vs expected {}",
+                                        code_size,
+                                        this->code_size_));
+    }
+    if (max_capacity > this->max_capacity_) {
+        this->Resize(max_capacity);
+    } else if (max_capacity < this->max_capacity_) {
+        this->ShrinkToFit(max_capacity);
+    }
+    this->total_count_ = total_count;
+
+    Vector<InnerIdType> ids(allocator_);
+    StreamReader::ReadVector(reader, ids);
+    ByteBuffer codes(static_cast<uint64_t>(code_size_), allocator_);
+    for (auto id : ids) {
+        if (id >= this->total_count_ or id >= this->max_capacity_) {
+            throw VsagException(
+                ErrorType::INVALID_BINARY,
+                fmt::format("code id({}) in delta exceeds total count({}) or capacity({})",
+                            id,
+                            this->total_count_,
+                            this->max_capacity_));
+        }
+        reader.Read(reinterpret_cast<char*>(codes.data), code_size_);
+        this->io_->Write(codes.data, code_size_, this->code_position(id));
+    }
+    this->quantizer_->Deserialize(reader);
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::ColocateWith(const GraphInterfacePtr& graph) {
+    auto colocated_graph = std::dynamic_pointer_cast<ColocatedGraphDataCell<IOTmpl>>(graph);
+    if (colocated_graph == nullptr) {
+        throw VsagException(ErrorType::INVALID_ARGUMENT,
+                            "codes can only be colocated with a colocated graph of the same io");
+    }
+    if (this->total_count_ > 0) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            "codes must be colocated before any vector is inserted");
+    }
+    this->code_offset_ = colocated_graph->AttachCodes(code_size_);
+    this->record_size_ = colocated_graph->RecordSize();
+    this->io_ = colocated_graph->GetIO();
+}
+
 template <typename QuantTmpl, typename IOTmpl>
 void
 FlattenDataCell<QuantTmpl, IOTmpl>::MergeOther(const FlattenInterfacePtr& other, InnerIdType bias) {
@@ -480,8 +595,22 @@ FlattenDataCell<QuantTmpl, IOTmpl>::MergeOther(const FlattenInterfacePtr& other,
         throw VsagException(ErrorType::INTERNAL_ERROR,
                             "Merge flatten datacell failed: not match type");
     }
-    constexpr uint64_t BUFFER_SIZE = 1024 * 1024 * 10;
     uint64_t total_count = ptr->total_count_;
+    if (this->colocated() or ptr->colocated()) {
+        // the codes are strided by records, copy them one by one
+        for (InnerIdType i = 0; i < total_count; ++i) {
+            bool need_release = false;
+            const auto* codes = ptr->GetCodesById(i, need_release);
+            this->io_->Write(codes, code_size_, this->code_position(i + bias));
+            if (need_release) {
+                ptr->io_->Release(codes);
+            }
+        }
+        this->grow_total_count(bias + total_count);
+        this->touch(bias, bias + total_count);
+        return;
+    }
+    constexpr uint64_t BUFFER_SIZE = 1024 * 1024 * 10;
     uint64_t offset = bias * code_size_;
     uint64_t read_count = 0;
     while (read_count < total_count) {
@@ -496,14 +625,16 @@ FlattenDataCell<QuantTmpl, IOTmpl>::MergeOther(const FlattenInterfacePtr& other,
         offset += size;
         read_count += count;
     }
-    this->total_count_ += total_count;
+    this->grow_total_count(bias + total_count);
+    this->touch(bias, bias + total_count);
 }
 
 template <typename QuantTmpl, typename IOTmpl>
 int64_t
 FlattenDataCell<QuantTmpl, IOTmpl>::GetMemoryUsage() const {
     int64_t memory = sizeof(FlattenDataCell<QuantTmpl, IOTmpl>);
-    if (IOTmpl::InMemory) {
+    // colocated codes are accounted for by the graph that owns the records
+    if (IOTmpl::InMemory and not this->colocated()) {
         memory += this->io_->GetMemoryUsage();
     }
     memory += sizeof(QuantTmpl);
@@ -515,11 +646,11 @@ void
 FlattenDataCell<QuantTmpl, IOTmpl>::Move(InnerIdType from, InnerIdType to) {
     bool need_release = false;
     const uint8_t* codes = this->GetCodesById(from, need_release);
-    this->io_->Write(
-        codes, code_size_, static_cast<uint64_t>(to) * static_cast<uint64_t>(code_size_));
+    this->io_->Write(codes, code_size_, this->code_position(to));
     if (need_release) {
         this->io_->Release(codes);
     }
+    this->touch(to, to + 1);
 }
 
 }  // namespace vsag
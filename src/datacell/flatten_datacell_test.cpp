@@ -16,6 +16,7 @@
 #include "flatten_datacell.h"
 
 #include <algorithm>
+#include <sstream>
 #include <utility>
 
 #include "flatten_interface_test.h"
@@ -71,3 +72,54 @@ TEST_CASE("FlattenDataCell Basic Test", "[ut][FlattenDataCell] ") {
         }
     }
 }
+
+TEST_CASE("FlattenDataCell Delta Rejects Out Of Range Ids", "[ut][FlattenDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 16;
+    InnerIdType count = 10;
+    auto param = std::make_shared<FlattenDataCellParameter>();
+    param->FromJson(JsonType::Parse(
+        R"({"io_params": {"type": "memory_io"}, "quantization_params": {"type": "fp32"}})"));
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    common_param.dim_ = dim;
+    common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    auto flatten = FlattenInterface::MakeInstance(param, common_param);
+    auto vectors = fixtures::generate_vectors(count, dim);
+    flatten->Train(vectors.data(), count);
+    flatten->BatchInsertVector(vectors.data(), count);
+
+    auto check_rejected = [&](InnerIdType id) {
+        std::stringstream ss;
+        IOStreamWriter writer(ss);
+        StreamWriter::WriteObj(writer, flatten->total_count_);
+        StreamWriter::WriteObj(writer, flatten->max_capacity_);
+        StreamWriter::WriteObj(writer, flatten->code_size_);
+        StreamWriter::WriteVector(writer, std::vector<InnerIdType>{id});
+        std::vector<char> codes(flatten->code_size_);
+        flatten->GetCodesById(0, reinterpret_cast<uint8_t*>(codes.data()));
+        writer.Write(codes.data(), codes.size());
+        IOStreamReader reader(ss);
+        auto other = FlattenInterface::MakeInstance(param, common_param);
+        try {
+            other->DeserializeDelta(reader);
+            FAIL("Expected VsagException to be thrown");
+        } catch (const VsagException& e) {
+            REQUIRE(e.error_.type == ErrorType::INVALID_BINARY);
+        }
+    };
+
+    // a delta with every code applies onto an empty cell
+    std::stringstream ss;
+    IOStreamWriter writer(ss);
+    flatten->SerializeDelta(writer, 0);
+    IOStreamReader reader(ss);
+    auto other = FlattenInterface::MakeInstance(param, common_param);
+    other->DeserializeDelta(reader);
+    REQUIRE(other->TotalCount() == count);
+    REQUIRE(other->ComputePairVectors(0, count - 1) == flatten->ComputePairVectors(0, count - 1));
+
+    // ids past the count or the capacity must not reach the io
+    check_rejected(count);
+    check_rejected(flatten->max_capacity_);
+}
@@ -32,7 +32,7 @@ make_instance_flatten(const FlattenInterfaceParamPtr& param, const IndexCommonPa
     auto& quantizer_param = param->quantizer_parameter;
     if (param->name == FLATTEN_DATA_CELL) {
         return std::make_shared<FlattenDataCell<QuantTemp, IOTemp>>(
-            quantizer_param, io_param, common_param);
+            quantizer_param, param->colocated ? nullptr : io_param, common_param);
     }
     throw VsagException(ErrorType::INVALID_ARGUMENT,
                         fmt::format("Unknown flatten interface name: {}", param->name));
@@ -204,6 +204,9 @@ FlattenInterface::MakeInstance(const FlattenInterfaceParamPtr& param,
     if (io_type_name == IO_TYPE_VALUE_ASYNC_IO) {
         return make_instance<AsyncIO>(param, common_param);
     }
+    if (io_type_name == IO_TYPE_VALUE_IO_URING_IO) {
+        return make_instance<IOUringIO>(param, common_param);
+    }
     if (io_type_name == IO_TYPE_VALUE_MMAP_IO) {
         return make_instance<MMapIO>(param, common_param);
     }
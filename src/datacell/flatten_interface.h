@@ -22,18 +22,21 @@
 #include "flatten_interface_parameter.h"
 #include "impl/runtime_parameter.h"
 #include "index_common_param.h"
+#include "io/block_cache.h"
 #include "io/reader_io.h"
 #include "quantization/computer.h"
 #include "query_context.h"
 #include "storage/stream_reader.h"
 #include "storage/stream_writer.h"
 #include "typing.h"
+#include "utils/delta_tracker.h"
 #include "utils/pointer_define.h"
 #include "vsag/constants.h"
 
 namespace vsag {
 
 DEFINE_POINTER(FlattenInterface);
+DEFINE_POINTER(GraphInterface);
 
 class FlattenInterface {
 public:
@@ -98,14 +101,52 @@ public:
     virtual void
     Resize(InnerIdType capacity) = 0;
 
+    /**
+     * Whether growing keeps the existing codes in place, so that Resize to a larger capacity
+     * may run while other threads read and insert.
+     */
+    [[nodiscard]] virtual bool
+    SupportConcurrentResize() const {
+        return false;
+    }
+
     virtual void
     ExportModel(const FlattenInterfacePtr& other) const = 0;
 
+    /**
+     * Stores the codes inside the per-node records of a colocated graph datacell, next to
+     * the neighbor list of each id. Must be called while both datacells are empty; the graph
+     * then owns the storage, so it resizes and serializes the codes as well.
+     */
+    virtual void
+    ColocateWith(const GraphInterfacePtr& graph) {
+        throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                            "ColocateWith not implemented in FlattenInterface");
+    }
+
     virtual void
     InitIO(const IOParamPtr& io_param) {
         throw VsagException(ErrorType::INTERNAL_ERROR,
                             "InitIO not implemented in FlattenInterface");
     }
+
+    /**
+     * Serves the code reads of a disk-resident datacell through a block cache shared by the
+     * datacells of an index. Datacells in memory ignore it.
+     */
+    virtual void
+    SetBlockCache(const BlockCachePtr& cache) {
+    }
+
+    /**
+     * Keeps the codes of id in the block cache for good. Returns false when there is no block
+     * cache or the codes can not be read yet.
+     */
+    virtual bool
+    PinInBlockCache(InnerIdType id) {
+        return false;
+    }
+
     virtual int64_t
     GetMemoryUsage() const {
         return 0;
@@ -170,6 +211,28 @@ public:
         StreamReader::ReadObj(reader, this->code_size_);
     }
 
+    /**
+     * Writes the codes changed after base_epoch, DeserializeDelta applies them onto the codes
+     * as they were at base_epoch. Datacells without change tracking write themselves in full.
+     */
+    virtual void
+    SerializeDelta(StreamWriter& writer, uint32_t base_epoch) {
+        this->Serialize(writer);
+    }
+
+    virtual void
+    DeserializeDelta(StreamReader& reader) {
+        this->Deserialize(reader);
+    }
+
+    void
+    SetDeltaTracker(const DeltaTrackerPtr& tracker) {
+        delta_tracker_ = tracker;
+        if (delta_tracker_ != nullptr) {
+            delta_tracker_->Resize(max_capacity_);
+        }
+    }
+
     uint64_t
     CalcSerializeSize() {
         auto calSizeFunc = [](uint64_t cursor, uint64_t size, void* buf) { return; };
@@ -202,6 +265,16 @@ public:
     ShrinkToFit(InnerIdType capacity) {
     }
 
+protected:
+    inline void
+    touch(InnerIdType begin, InnerIdType end) {
+        if (delta_tracker_ != nullptr) {
+            delta_tracker_->TouchRange(begin, end);
+        }
+    }
+
+    DeltaTrackerPtr delta_tracker_{nullptr};
+
 public:
     mutable std::shared_mutex mutex_;
 
@@ -33,6 +33,10 @@ public:
     IOParamPtr io_parameter{nullptr};
 
     std::string name;
+
+    // set for codes stored inside the records of a colocated graph: they get no io of their own,
+    // ColocateWith hands them the io of the graph (not serialized, derived from the graph type)
+    bool colocated{false};
 };
 
 FlattenInterfaceParamPtr
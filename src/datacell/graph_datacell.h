@@ -17,6 +17,7 @@
 
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 #include "algorithm/hnswlib/hnswalg.h"
@@ -28,6 +29,7 @@
 #include "impl/reverse_edge.h"
 #include "index_common_param.h"
 #include "io/basic_io.h"
+#include "utils/byte_buffer.h"
 #include "vsag/constants.h"
 
 namespace vsag {
@@ -72,6 +74,13 @@ public:
     void
     Resize(InnerIdType new_size) override;
 
+    [[nodiscard]] bool
+    SupportConcurrentResize() const override {
+        // node_versions_ and the duplicate tracker are reallocated on growth
+        return IOTmpl::ConcurrentResize and not is_support_delete_ and
+               this->duplicate_tracker_ == nullptr;
+    }
+
     inline void
     SetIO(std::shared_ptr<BasicIO<IOTmpl>> io) {
         this->io_ = io;
@@ -82,6 +91,17 @@ public:
         this->io_->InitIO(io_param);
     }
 
+    void
+    SetBlockCache(const BlockCachePtr& cache) override {
+        this->io_->SetBlockCache(cache);
+    }
+
+    bool
+    PinInBlockCache(InnerIdType id) override {
+        auto start = static_cast<uint64_t>(id) * static_cast<uint64_t>(this->code_line_size_);
+        return this->io_->PinRange(start, this->code_line_size_);
+    }
+
     /****
      * prefetch neighbors of a base point with id
      * @param id of base point
@@ -99,6 +119,12 @@ public:
     void
     Deserialize(StreamReader& reader) override;
 
+    void
+    SerializeDelta(StreamWriter& writer, uint32_t base_epoch) override;
+
+    void
+    DeserializeDelta(StreamReader& reader) override;
+
     bool
     InMemory() const override {
         return IOTmpl::InMemory;
@@ -260,6 +286,7 @@ GraphDataCell<IOTmpl>::InsertNeighborsById(InnerIdType id,
                          static_cast<uint64_t>(neighbor_count) * sizeof(InnerIdType),
                          start);
     }
+    this->touch(id);
 }
 
 template <typename IOTmpl>
@@ -292,7 +319,9 @@ GraphDataCell<IOTmpl>::GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbo
         for (int i = 0; i < neighbor_count; ++i) {
             uint8_t neighbor_version = shared_neighbor_ids[i] >> id_bit_;
             InnerIdType neighbor_id = shared_neighbor_ids[i] & remove_flag_mask_;
-            if (node_versions_[neighbor_id] == neighbor_version) {
+            // an optimistic reader may see a list that is being rewritten, stay in bounds
+            if (neighbor_id < node_versions_.size() and
+                node_versions_[neighbor_id] == neighbor_version) {
                 neighbor_ids.push_back(neighbor_id);
             }
         }
@@ -324,6 +353,9 @@ GraphDataCell<IOTmpl>::Resize(InnerIdType new_size) {
     if (this->duplicate_tracker_ != nullptr) {
         this->duplicate_tracker_->Resize(new_size);
     }
+    if (this->delta_tracker_ != nullptr) {
+        this->delta_tracker_->Resize(new_size);
+    }
 }
 
 template <typename IOTmpl>
@@ -348,6 +380,75 @@ GraphDataCell<IOTmpl>::Deserialize(StreamReader& reader) {
     }
 }
 
+template <typename IOTmpl>
+void
+GraphDataCell<IOTmpl>::SerializeDelta(StreamWriter& writer, uint32_t base_epoch) {
+    GraphInterface::Serialize(writer);
+    StreamWriter::WriteObj(writer, this->code_line_size_);
+
+    // without a tracker every node counts as changed
+    Vector<InnerIdType> ids(allocator_);
+    if (this->delta_tracker_ != nullptr) {
+        ids = this->delta_tracker_->ChangedSince(base_epoch, this->max_capacity_);
+    } else {
+        ids.resize(std::min(this->total_count_.load(), this->max_capacity_));
+        std::iota(ids.begin(), ids.end(), 0);
+    }
+    StreamWriter::WriteVector(writer, ids);
+
+    // the whole record, a colocated graph carries the codes along
+    ByteBuffer record(code_line_size_, allocator_);
+    for (auto id : ids) {
+        auto start = static_cast<uint64_t>(id) * static_cast<uint64_t>(this->code_line_size_);
+        this->io_->Read(code_line_size_, start, record.data);
+        writer.Write(reinterpret_cast<const char*>(record.data), code_line_size_);
+        if (is_support_delete_) {
+            StreamWriter::WriteObj(writer, node_versions_[id]);
+        }
+    }
+}
+
+template <typename IOTmpl>
+void
+GraphDataCell<IOTmpl>::DeserializeDelta(StreamReader& reader) {
+    auto capacity = this->max_capacity_;
+    GraphInterface::Deserialize(reader);
+    std::swap(capacity, this->max_capacity_);
+    if (capacity > this->max_capacity_) {
+        this->Resize(capacity);
+    } else if (capacity < this->max_capacity_) {
+        this->ShrinkToFit(capacity);
+    }
+
+    uint32_t code_line_size = 0;
+    StreamReader::ReadObj(reader, code_line_size);
+    if (code_line_size != this->code_line_size_) {
+        throw VsagException(
+            ErrorType::INVALID_ARGUMENT,
+            fmt::format("graph record size mismatch in delta: serialized {} vs expected {}",
+                        code_line_size,
+                        this->code_line_size_));
+    }
+    Vector<InnerIdType> ids(allocator_);
+    StreamReader::ReadVector(reader, ids);
+
+    ByteBuffer record(code_line_size_, allocator_);
+    for (auto id : ids) {
+        if (id >= this->max_capacity_) {
+            throw VsagException(
+                ErrorType::INVALID_BINARY,
+                fmt::format(
+                    "graph id({}) in delta exceeds capacity({})", id, this->max_capacity_));
+        }
+        reader.Read(reinterpret_cast<char*>(record.data), code_line_size_);
+        auto start = static_cast<uint64_t>(id) * static_cast<uint64_t>(this->code_line_size_);
+        this->io_->Write(record.data, code_line_size_, start);
+        if (is_support_delete_) {
+            StreamReader::ReadObj(reader, node_versions_[id]);
+        }
+    }
+}
+
 template <typename IOTmpl>
 void
 GraphDataCell<IOTmpl>::DeleteNeighborsById(vsag::InnerIdType id) {
@@ -363,6 +464,7 @@ GraphDataCell<IOTmpl>::DeleteNeighborsById(vsag::InnerIdType id) {
                                 fmt::format("remove point {} not exist in GraphDatacell", id));
         }
         node_versions_[id]++;
+        this->touch(id);
     } else {
         throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
                             "disable delete in graph datacell");
@@ -384,6 +486,7 @@ GraphDataCell<IOTmpl>::RecoverDeleteNeighborsById(vsag::InnerIdType id) {
                 fmt::format("recover remove point {} not exist in GraphDatacell", id));
         }
         node_versions_[id]--;
+        this->touch(id);
     } else {
         throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
                             "disable delete in graph datacell");
@@ -430,6 +533,7 @@ GraphDataCell<IOTmpl>::Move(InnerIdType from, InnerIdType to) {
 
     if (is_support_delete_) {
         node_versions_[to] = node_versions_[from];
+        this->touch(to);
     }
 }
 
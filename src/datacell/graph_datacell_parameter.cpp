@@ -68,6 +68,13 @@ GraphDataCellParameter::CheckCompatibility(const ParamPtr& other) const {
             "GraphDataCellParameter");
         return false;
     }
+    if (graph_storage_type_ != graph_param->graph_storage_type_) {
+        logger::error(
+            "GraphDataCellParameter::CheckCompatibility: graph_storage_type_ mismatch: {} vs {}",
+            static_cast<int>(graph_storage_type_),
+            static_cast<int>(graph_param->graph_storage_type_));
+        return false;
+    }
     if (max_degree_ != graph_param->max_degree_) {
         logger::error("GraphDataCellParameter::CheckCompatibility: max_degree_ mismatch: {} vs {}",
                       max_degree_,
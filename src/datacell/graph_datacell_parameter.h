@@ -43,5 +43,10 @@ public:
 
     bool support_remove_{false};
     uint32_t remove_flag_bit_{8};
+
+protected:
+    explicit GraphDataCellParameter(GraphStorageTypes graph_type)
+        : GraphInterfaceParameter(graph_type) {
+    }
 };
 }  // namespace vsag
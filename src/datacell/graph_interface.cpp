@@ -15,6 +15,7 @@
 
 #include "graph_interface.h"
 
+#include "colocated_graph_datacell.h"
 #include "compressed_graph_datacell.h"
 #include "graph_datacell.h"
 #include "io/io_headers.h"
@@ -56,6 +57,24 @@ GraphInterface::MakeInstance(const GraphInterfaceParamPtr& graph_param,
             return std::make_shared<SparseGraphDataCell>(graph_param, common_param);
         case GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_COMPRESSED:
             return std::make_shared<CompressedGraphDataCell>(graph_param, common_param);
+        case GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_COLOCATED: {
+            auto io_string = std::dynamic_pointer_cast<GraphDataCellParameter>(graph_param)
+                                 ->io_parameter_->GetTypeName();
+            if (io_string == IO_TYPE_VALUE_BLOCK_MEMORY_IO) {
+                return std::make_shared<ColocatedGraphDataCell<MemoryBlockIO>>(graph_param,
+                                                                               common_param);
+            }
+            if (io_string == IO_TYPE_VALUE_MEMORY_IO) {
+                return std::make_shared<ColocatedGraphDataCell<MemoryIO>>(graph_param,
+                                                                          common_param);
+            }
+            if (io_string == IO_TYPE_VALUE_MMAP_IO) {
+                return std::make_shared<ColocatedGraphDataCell<MMapIO>>(graph_param, common_param);
+            }
+            throw VsagException(
+                ErrorType::INVALID_ARGUMENT,
+                fmt::format("colocated graph does not support io type {}", io_string));
+        }
         case GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_FLAT:
             auto io_string = std::dynamic_pointer_cast<GraphDataCellParameter>(graph_param)
                                  ->io_parameter_->GetTypeName();
@@ -74,6 +93,9 @@ GraphInterface::MakeInstance(const GraphInterfaceParamPtr& graph_param,
             if (io_string == IO_TYPE_VALUE_ASYNC_IO) {
                 return std::make_shared<GraphDataCell<AsyncIO>>(graph_param, common_param);
             }
+            if (io_string == IO_TYPE_VALUE_IO_URING_IO) {
+                return std::make_shared<GraphDataCell<IOUringIO>>(graph_param, common_param);
+            }
             if (io_string == IO_TYPE_VALUE_READER_IO) {
                 return std::make_shared<GraphDataCell<ReaderIO>>(graph_param, common_param);
             }
@@ -25,10 +25,12 @@
 #include "impl/reverse_edge.h"
 #include "index_common_param.h"
 #include "inner_string_params.h"
+#include "io/block_cache.h"
 #include "io/io_parameter.h"
 #include "storage/stream_reader.h"
 #include "storage/stream_writer.h"
 #include "typing.h"
+#include "utils/delta_tracker.h"
 #include "utils/pointer_define.h"
 
 namespace vsag {
@@ -72,6 +74,15 @@ public:
     virtual void
     Resize(InnerIdType new_size) = 0;
 
+    /**
+     * Whether growing keeps the existing neighbor lists in place, so that Resize to a larger
+     * size may run while other threads read and insert.
+     */
+    [[nodiscard]] virtual bool
+    SupportConcurrentResize() const {
+        return false;
+    }
+
     virtual void
     Prefetch(InnerIdType id, uint32_t neighbor_i) = 0;
 
@@ -132,6 +143,20 @@ public:
         }
     }
 
+    /**
+     * Writes the nodes changed after base_epoch, DeserializeDelta applies them onto the graph
+     * as it was at base_epoch. Graphs without change tracking write themselves in full.
+     */
+    virtual void
+    SerializeDelta(StreamWriter& writer, uint32_t base_epoch) {
+        this->Serialize(writer);
+    }
+
+    virtual void
+    DeserializeDelta(StreamReader& reader) {
+        this->Deserialize(reader);
+    }
+
     uint64_t
     CalcSerializeSize() {
         auto calSizeFunc = [](uint64_t cursor, uint64_t size, void* buf) { return; };
@@ -179,6 +204,23 @@ public:
     InitIO(const IOParamPtr& io_param) {
     }
 
+    /**
+     * Serves the neighbor reads of a disk-resident graph through a block cache shared by the
+     * datacells of an index. Graphs in memory ignore it.
+     */
+    virtual void
+    SetBlockCache(const BlockCachePtr& cache) {
+    }
+
+    /**
+     * Keeps the neighbor list of id in the block cache for good. Returns false when there is
+     * no block cache or the graph can not be read yet.
+     */
+    virtual bool
+    PinInBlockCache(InnerIdType id) {
+        return false;
+    }
+
 protected:
     void
     UpdateReverseEdges(InnerIdType id,
@@ -209,6 +251,14 @@ public:
         duplicate_tracker_ = tracker;
     }
 
+    void
+    SetDeltaTracker(const DeltaTrackerPtr& tracker) {
+        delta_tracker_ = tracker;
+        if (delta_tracker_ != nullptr) {
+            delta_tracker_->Resize(max_capacity_);
+        }
+    }
+
     void
     SetDuplicateId(InnerIdType group_id, InnerIdType duplicate_id) {
         if (duplicate_tracker_) {
@@ -239,8 +289,17 @@ public:
     std::atomic<InnerIdType> total_count_{0};
     Allocator* allocator_{nullptr};
 
+protected:
+    inline void
+    touch(InnerIdType id) {
+        if (delta_tracker_ != nullptr) {
+            delta_tracker_->Touch(id);
+        }
+    }
+
 protected:
     DuplicateTrackerPtr duplicate_tracker_{nullptr};
+    DeltaTrackerPtr delta_tracker_{nullptr};
     std::unique_ptr<ReverseEdge> reverse_edges_{nullptr};
 };
 
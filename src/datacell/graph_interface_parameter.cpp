@@ -15,6 +15,7 @@
 
 #include "graph_interface_parameter.h"
 
+#include "colocated_graph_datacell_parameter.h"
 #include "compressed_graph_datacell_parameter.h"
 #include "graph_datacell_parameter.h"
 #include "sparse_graph_datacell_parameter.h"
@@ -34,6 +35,9 @@ GraphInterfaceParameter::GetGraphParameterByJson(GraphStorageTypes graph_type,
         case GraphStorageTypes::GRAPH_STORAGE_TYPE_SPARSE:
             param = std::make_shared<SparseGraphDatacellParameter>();
             break;
+        case GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_COLOCATED:
+            param = std::make_shared<ColocatedGraphDataCellParameter>();
+            break;
     }
     param->FromJson(json);
     return param;
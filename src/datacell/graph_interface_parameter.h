@@ -23,7 +23,8 @@ DEFINE_POINTER2(GraphInterfaceParam, GraphInterfaceParameter);
 enum class GraphStorageTypes {
     GRAPH_STORAGE_TYPE_VALUE_FLAT = 0,
     GRAPH_STORAGE_TYPE_VALUE_COMPRESSED = 1,
-    GRAPH_STORAGE_TYPE_SPARSE = 2
+    GRAPH_STORAGE_TYPE_SPARSE = 2,
+    GRAPH_STORAGE_TYPE_VALUE_COLOCATED = 3
 };
 
 class GraphInterfaceParameter : public Parameter {
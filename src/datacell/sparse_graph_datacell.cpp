@@ -250,10 +250,8 @@ SparseGraphDataCell::MergeOther(GraphInterfacePtr other, uint64_t bias) {
         for (auto& neighbor_id : neighbor_ids) {
             neighbor_id += bias;
         }
+        // a new id gets its node version from InsertNeighborsById, under the map lock
         this->InsertNeighborsById(id + bias, neighbor_ids);
-        if (is_support_delete_) {
-            this->node_version_[id + bias] = 0;
-        }
     }
 }
 
@@ -19,6 +19,7 @@
 
 #include "common.h"
 #include "impl/allocator/default_allocator.h"
+#include "impl/allocator/huge_page_arena_allocator.h"
 #include "impl/thread_pool/safe_thread_pool.h"
 #include "index_common_param.h"
 #include "index_creators.h"
@@ -72,6 +73,11 @@ Engine::CreateDefaultAllocator() {
     return std::make_shared<DefaultAllocator>();
 }
 
+std::shared_ptr<Allocator>
+Engine::CreateHugePageAllocator() {
+    return std::make_shared<HugePageArenaAllocator>();
+}
+
 tl::expected<std::shared_ptr<ThreadPool>, Error>
 Engine::CreateThreadPool(uint32_t num_threads) {
     if (num_threads <= 0 || num_threads > 512) {
@@ -79,7 +85,7 @@ Engine::CreateThreadPool(uint32_t num_threads) {
                               "failed to create thread pool: invalid number of threads:",
                               std::to_string(num_threads));
     }
-    return std::make_shared<DefaultThreadPool>(num_threads);
+    return std::make_shared<WorkStealingThreadPool>(num_threads);
 }
 
 }  // namespace vsag
@@ -25,6 +25,8 @@
 #include <string>
 
 #include "impl/thread_pool/safe_thread_pool.h"
+#include "io/io_uring_file_reader.h"
+#include "io/mmap_file_reader.h"
 #include "vsag/engine.h"
 #include "vsag/options.h"
 
@@ -105,4 +107,19 @@ Factory::CreateLocalFileReader(const std::string& filename, int64_t base_offset,
     return std::make_shared<LocalFileReader>(filename, base_offset, size);
 }
 
+std::shared_ptr<Reader>
+Factory::CreateIOUringFileReader(const std::string& filename, int64_t base_offset, int64_t size) {
+#if HAVE_IO_URING
+    if (auto ring = IOUringRing::GetShared(false); ring != nullptr) {
+        return std::make_shared<IOUringFileReader>(filename, base_offset, size, ring);
+    }
+#endif
+    return std::make_shared<LocalFileReader>(filename, base_offset, size);
+}
+
+std::shared_ptr<Reader>
+Factory::CreateMMapFileReader(const std::string& filename, int64_t base_offset, int64_t size) {
+    return std::make_shared<MMapFileReader>(filename, base_offset, size);
+}
+
 }  // namespace vsag
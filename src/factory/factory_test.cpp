@@ -125,6 +125,76 @@ TEST_CASE("Create Local File Reader", "[ut][factory]") {
     std::remove(filename.c_str());
 }
 
+TEST_CASE("Create IOUring File Reader", "[ut][factory]") {
+    const std::string filename = "/tmp/test_io_uring_file_reader.bin";
+    {
+        std::ofstream file(filename, std::ios::binary);
+        const std::string content = "HelloWorldTestData";
+        file.write(content.c_str(), content.size());
+        file.close();
+    }
+
+    auto reader = vsag::Factory::CreateIOUringFileReader(filename, 5, 13);
+    REQUIRE(reader->Size() == 13);
+    char buffer[6] = {0};
+    reader->Read(0, 5, buffer);
+    REQUIRE(std::string(buffer) == "World");
+
+    char multi[10] = {0};
+    uint64_t lens[2] = {4, 4};
+    uint64_t offsets[2] = {9, 5};
+    REQUIRE(reader->MultiRead(reinterpret_cast<uint8_t*>(multi), lens, offsets, 2));
+    REQUIRE(std::string(multi) == "DataTest");
+
+    std::promise<void> completion_promise;
+    auto completion_future = completion_promise.get_future();
+    char async_buffer[5] = {0};
+    reader->AsyncRead(5, 4, async_buffer, [&](vsag::IOErrorCode code, const std::string& msg) {
+        REQUIRE(code == vsag::IOErrorCode::IO_SUCCESS);
+        completion_promise.set_value();
+    });
+    REQUIRE(completion_future.wait_for(std::chrono::seconds(1)) == std::future_status::ready);
+    REQUIRE(std::string(async_buffer) == "Test");
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("Create MMap File Reader", "[ut][factory]") {
+    const std::string filename = "/tmp/test_mmap_file_reader.bin";
+    {
+        std::ofstream file(filename, std::ios::binary);
+        const std::string content = "HelloWorldTestData";
+        file.write(content.c_str(), content.size());
+        file.close();
+    }
+
+    auto reader = vsag::Factory::CreateMMapFileReader(filename, 5, 13);
+    REQUIRE(reader->Size() == 13);
+    char buffer[6] = {0};
+    reader->Read(0, 5, buffer);
+    REQUIRE(std::string(buffer) == "World");
+    REQUIRE_THROWS(reader->Read(10, 5, buffer));
+
+    char multi[10] = {0};
+    uint64_t lens[2] = {4, 4};
+    uint64_t offsets[2] = {9, 5};
+    REQUIRE(reader->MultiRead(reinterpret_cast<uint8_t*>(multi), lens, offsets, 2));
+    REQUIRE(std::string(multi) == "DataTest");
+
+    char async_buffer[5] = {0};
+    bool callback_called = false;
+    reader->AsyncRead(5, 4, async_buffer, [&](vsag::IOErrorCode code, const std::string& msg) {
+        REQUIRE(code == vsag::IOErrorCode::IO_SUCCESS);
+        callback_called = true;
+    });
+    REQUIRE(callback_called);
+    REQUIRE(std::string(async_buffer) == "Test");
+
+    // size 0 maps the rest of the file
+    REQUIRE(vsag::Factory::CreateMMapFileReader(filename, 10, 0)->Size() == 8);
+    REQUIRE_THROWS(vsag::Factory::CreateMMapFileReader("/tmp/not_exist_mmap_file.bin", 0, 0));
+    std::remove(filename.c_str());
+}
+
 TEST_CASE("Create HNSW with Incomplete Parameters", "[ut][factory]") {
     vsag::logger::set_level(vsag::logger::level::debug);
 
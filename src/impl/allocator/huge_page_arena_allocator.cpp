@@ -0,0 +1,370 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "huge_page_arena_allocator.h"
+
+#include <fmt/format.h>
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "common.h"
+#include "impl/logger/logger.h"
+#include "safe_allocator.h"
+#include "typing.h"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+namespace vsag {
+
+namespace {
+
+// arena allocations are rounded to whole pages
+constexpr uint64_t ARENA_ALLOCATION_ALIGNMENT = 4096;
+
+inline uint64_t
+round_up(uint64_t value, uint64_t base) {
+    return (value + base - 1) / base * base;
+}
+
+bool
+map_fixed(void* addr, uint64_t size, int prot, int extra_flags) {
+    auto* ret =
+        mmap(addr, size, prot, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | extra_flags, -1, 0);
+    return ret != MAP_FAILED;
+}
+
+}  // namespace
+
+JsonType
+HugePageArenaStats::ToJson() const {
+    JsonType json;
+    json["reserved_bytes"].SetInt(reserved_bytes);
+    json["committed_bytes"].SetInt(committed_bytes);
+    json["huge_page_bytes"].SetInt(huge_page_bytes);
+    json["used_bytes"].SetInt(used_bytes);
+    json["free_bytes"].SetInt(free_bytes);
+    json["largest_free_bytes"].SetInt(largest_free_bytes);
+    json["allocation_count"].SetInt(allocation_count);
+    json["fragmentation"].SetFloat(this->Fragmentation());
+    return json;
+}
+
+HugePageArenaAllocator*
+HugePageArenaAllocator::Unwrap(Allocator* allocator) {
+    if (auto* safe_allocator = dynamic_cast<SafeAllocator*>(allocator); safe_allocator) {
+        allocator = safe_allocator->GetRawAllocator();
+    }
+    return dynamic_cast<HugePageArenaAllocator*>(allocator);
+}
+
+HugePageArenaAllocator::HugePageArenaAllocator(uint64_t reserve_size,
+                                               uint64_t chunk_size,
+                                               uint64_t min_arena_allocation)
+    : chunk_size_(chunk_size), min_arena_allocation_(min_arena_allocation) {
+    CHECK_ARGUMENT(chunk_size_ > 0 and chunk_size_ % HUGE_PAGE_SIZE == 0,
+                   fmt::format("chunk size ({}) must be a multiple of {}",
+                               chunk_size_,
+                               HUGE_PAGE_SIZE));
+    reserve_size = reserve_size / chunk_size_ * chunk_size_;
+    CHECK_ARGUMENT(reserve_size > 0,
+                   fmt::format("reserve size must hold at least one chunk of {}", chunk_size_));
+
+    // 1GB pages need a 1GB aligned address, transparent huge pages a 2MB aligned one
+    uint64_t alignment = chunk_size_ % GIANT_PAGE_SIZE == 0 ? GIANT_PAGE_SIZE : HUGE_PAGE_SIZE;
+    auto* addr = mmap(nullptr,
+                      reserve_size + alignment,
+                      PROT_NONE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                      -1,
+                      0);
+    if (addr == MAP_FAILED) {
+        logger::warn(fmt::format(
+            "{}: failed to reserve {} bytes, falling back to malloc", Name(), reserve_size));
+        return;
+    }
+    auto start = reinterpret_cast<uintptr_t>(addr);
+    auto aligned = round_up(start, alignment);
+    if (aligned > start) {
+        munmap(addr, aligned - start);
+    }
+    auto tail = start + reserve_size + alignment - (aligned + reserve_size);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + reserve_size), tail);
+    }
+    base_ = aligned;
+    reserve_size_ = reserve_size;
+    chunks_.resize(reserve_size_ / chunk_size_, ChunkState::RESERVED);
+    chunk_used_bytes_.resize(chunks_.size(), 0);
+}
+
+HugePageArenaAllocator::~HugePageArenaAllocator() {
+#ifndef NDEBUG
+    if (not allocated_.empty()) {
+        logger::error(fmt::format("There is a memory leak in {}, size: {}",
+                                  HugePageArenaAllocator::Name(),
+                                  allocated_.size()));
+        abort();
+    }
+#endif
+    if (reserve_size_ > 0) {
+        munmap(reinterpret_cast<void*>(base_), reserve_size_);
+    }
+}
+
+std::string
+HugePageArenaAllocator::Name() {
+    return "HugePageArenaAllocator";
+}
+
+void*
+HugePageArenaAllocator::Allocate(uint64_t size) {
+    if (size >= min_arena_allocation_ and reserve_size_ > 0) {
+        auto* ptr = this->allocate_from_arena(size);
+        if (ptr != nullptr) {
+            return ptr;
+        }
+    }
+    return fallback_.Allocate(size);
+}
+
+void
+HugePageArenaAllocator::Deallocate(void* p) {
+    if (p != nullptr and this->InArena(p)) {
+        this->deallocate_from_arena(p);
+        return;
+    }
+    fallback_.Deallocate(p);
+}
+
+void*
+HugePageArenaAllocator::Reallocate(void* p, uint64_t size) {
+    if (p == nullptr) {
+        return this->Allocate(size);
+    }
+    if (not this->InArena(p)) {
+        // the size of a malloc block is unknown here, so it stays on malloc
+        return fallback_.Reallocate(p, size);
+    }
+
+    uint64_t old_size = 0;
+    {
+        std::lock_guard lock(mutex_);
+        auto iter = allocated_.find(reinterpret_cast<uintptr_t>(p) - base_);
+        if (iter == allocated_.end()) {
+            throw VsagException(
+                ErrorType::INTERNAL_ERROR,
+                fmt::format("reallocate: address {} is not allocated by {}", p, Name()));
+        }
+        old_size = iter->second;
+    }
+    if (size <= old_size and size >= min_arena_allocation_) {
+        return p;
+    }
+    auto* ptr = this->Allocate(size);
+    if (ptr == nullptr) {
+        return nullptr;
+    }
+    memcpy(ptr, p, std::min(old_size, size));
+    this->deallocate_from_arena(p);
+    return ptr;
+}
+
+HugePageArenaStats
+HugePageArenaAllocator::GetStats() const {
+    std::lock_guard lock(mutex_);
+    HugePageArenaStats stats;
+    stats.reserved_bytes = reserve_size_;
+    for (const auto& state : chunks_) {
+        if (state != ChunkState::RESERVED) {
+            stats.committed_bytes += chunk_size_;
+        }
+        if (state == ChunkState::HUGE_PAGE) {
+            stats.huge_page_bytes += chunk_size_;
+        }
+    }
+    stats.used_bytes = used_bytes_;
+    stats.free_bytes = stats.committed_bytes - used_bytes_;
+    if (not free_by_size_.empty()) {
+        stats.largest_free_bytes = free_by_size_.rbegin()->first;
+    }
+    stats.allocation_count = allocated_.size();
+    return stats;
+}
+
+void*
+HugePageArenaAllocator::allocate_from_arena(uint64_t size) {
+    size = round_up(size, ARENA_ALLOCATION_ALIGNMENT);
+    std::lock_guard lock(mutex_);
+    auto fit = free_by_size_.lower_bound(size);
+    if (fit == free_by_size_.end()) {
+        // commit the first run of reserved chunks that holds the whole allocation
+        auto chunk_count = (size + chunk_size_ - 1) / chunk_size_;
+        uint64_t run_start = 0;
+        uint64_t run_length = 0;
+        for (uint64_t i = 0; i < chunks_.size() and run_length < chunk_count; ++i) {
+            if (chunks_[i] != ChunkState::RESERVED) {
+                run_length = 0;
+                continue;
+            }
+            if (run_length == 0) {
+                run_start = i;
+            }
+            ++run_length;
+        }
+        if (run_length < chunk_count or not this->commit_chunks(run_start, chunk_count)) {
+            return nullptr;
+        }
+        fit = free_by_size_.lower_bound(size);
+    }
+
+    auto offset = fit->second;
+    auto extent_size = fit->first;
+    this->erase_free_extent(free_by_offset_.find(offset));
+    if (extent_size > size) {
+        this->insert_free_extent(offset + size, extent_size - size);
+    }
+    allocated_.emplace(offset, size);
+    used_bytes_ += size;
+    for (auto chunk = offset / chunk_size_; chunk * chunk_size_ < offset + size; ++chunk) {
+        auto begin = std::max(offset, chunk * chunk_size_);
+        auto end = std::min(offset + size, (chunk + 1) * chunk_size_);
+        chunk_used_bytes_[chunk] += end - begin;
+    }
+    return reinterpret_cast<void*>(base_ + offset);
+}
+
+void
+HugePageArenaAllocator::deallocate_from_arena(void* p) {
+    std::lock_guard lock(mutex_);
+    auto offset = reinterpret_cast<uintptr_t>(p) - base_;
+    auto iter = allocated_.find(offset);
+    if (iter == allocated_.end()) {
+        throw VsagException(
+            ErrorType::INTERNAL_ERROR,
+            fmt::format("deallocate: address {} is not allocated by {}", p, Name()));
+    }
+    auto size = iter->second;
+    allocated_.erase(iter);
+    used_bytes_ -= size;
+    this->insert_free_extent(offset, size);
+    for (auto chunk = offset / chunk_size_; chunk * chunk_size_ < offset + size; ++chunk) {
+        auto begin = std::max(offset, chunk * chunk_size_);
+        auto end = std::min(offset + size, (chunk + 1) * chunk_size_);
+        chunk_used_bytes_[chunk] -= end - begin;
+        if (chunk_used_bytes_[chunk] == 0) {
+            this->decommit_chunk(chunk);
+        }
+    }
+}
+
+bool
+HugePageArenaAllocator::commit_chunks(uint64_t first_chunk, uint64_t chunk_count) {
+    for (uint64_t i = 0; i < chunk_count; ++i) {
+        auto chunk = first_chunk + i;
+        auto* addr = reinterpret_cast<void*>(base_ + chunk * chunk_size_);
+        auto state = ChunkState::HUGE_PAGE;
+        // a MAP_HUGETLB mapping fails when the huge page pool can not serve it, the next
+        // attempt maps over the same range again
+        bool mapped = false;
+#ifdef MAP_HUGETLB
+        if (chunk_size_ % GIANT_PAGE_SIZE == 0) {
+            mapped = map_fixed(
+                addr, chunk_size_, PROT_READ | PROT_WRITE, MAP_HUGETLB | MAP_HUGE_1GB);
+        }
+        if (not mapped) {
+            mapped = map_fixed(addr, chunk_size_, PROT_READ | PROT_WRITE, MAP_HUGETLB);
+        }
+#endif
+        if (not mapped) {
+            state = ChunkState::TRANSPARENT;
+            mapped = map_fixed(addr, chunk_size_, PROT_READ | PROT_WRITE, MAP_NORESERVE);
+#ifdef MADV_HUGEPAGE
+            if (mapped) {
+                madvise(addr, chunk_size_, MADV_HUGEPAGE);
+            }
+#endif
+        }
+        if (not mapped) {
+            // give back the chunks committed for this request
+            for (uint64_t j = 0; j < i; ++j) {
+                this->decommit_chunk(first_chunk + j);
+            }
+            return false;
+        }
+        chunks_[chunk] = state;
+        this->insert_free_extent(chunk * chunk_size_, chunk_size_);
+    }
+    return true;
+}
+
+void
+HugePageArenaAllocator::decommit_chunk(uint64_t chunk) {
+    // the whole chunk is free, so it lies inside a single free extent
+    auto begin = chunk * chunk_size_;
+    auto end = begin + chunk_size_;
+    auto iter = free_by_offset_.upper_bound(begin);
+    --iter;
+    auto extent_offset = iter->first;
+    auto extent_end = iter->first + iter->second;
+    this->erase_free_extent(iter);
+    if (extent_offset < begin) {
+        this->insert_free_extent(extent_offset, begin - extent_offset);
+    }
+    if (extent_end > end) {
+        this->insert_free_extent(end, extent_end - end);
+    }
+    map_fixed(reinterpret_cast<void*>(base_ + begin), chunk_size_, PROT_NONE, MAP_NORESERVE);
+    chunks_[chunk] = ChunkState::RESERVED;
+}
+
+void
+HugePageArenaAllocator::insert_free_extent(uint64_t offset, uint64_t size) {
+    // merge with the free extents right before and right after
+    auto next = free_by_offset_.lower_bound(offset);
+    if (next != free_by_offset_.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            this->erase_free_extent(prev);
+        }
+    }
+    if (next != free_by_offset_.end() and offset + size == next->first) {
+        size += next->second;
+        this->erase_free_extent(next);
+    }
+    free_by_offset_.emplace(offset, size);
+    free_by_size_.emplace(size, offset);
+}
+
+void
+HugePageArenaAllocator::erase_free_extent(std::map<uint64_t, uint64_t>::iterator iter) {
+    auto range = free_by_size_.equal_range(iter->second);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == iter->first) {
+            free_by_size_.erase(it);
+            break;
+        }
+    }
+    free_by_offset_.erase(iter);
+}
+
+}  // namespace vsag
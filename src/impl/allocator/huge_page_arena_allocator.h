@@ -0,0 +1,152 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "default_allocator.h"
+#include "typing.h"
+#include "vsag/allocator.h"
+
+namespace vsag {
+
+struct HugePageArenaStats {
+    uint64_t reserved_bytes{0};
+    uint64_t committed_bytes{0};
+    // committed through explicit huge pages, the rest relies on transparent huge pages
+    uint64_t huge_page_bytes{0};
+    uint64_t used_bytes{0};
+    uint64_t free_bytes{0};
+    uint64_t largest_free_bytes{0};
+    uint64_t allocation_count{0};
+
+    // share of the free committed memory that can not serve an allocation of the size of
+    // all free memory, 0 when the free memory is one extent
+    [[nodiscard]] float
+    Fragmentation() const {
+        if (free_bytes == 0) {
+            return 0.0F;
+        }
+        return 1.0F - static_cast<float>(largest_free_bytes) / static_cast<float>(free_bytes);
+    }
+
+    [[nodiscard]] JsonType
+    ToJson() const;
+};
+
+/**
+ * An allocator that serves large blocks (datacell blocks, visited lists, lock segments) from
+ * one contiguous virtual reservation backed by huge pages, and small blocks from malloc.
+ *
+ * The reservation is committed in chunks. A chunk is first mapped with explicit huge pages
+ * (MAP_HUGETLB, 1GB pages when the chunk size allows it, then 2MB pages); when the huge page
+ * pool can not serve it, it falls back to normal pages advised for transparent huge pages.
+ * Chunks that become entirely free are returned to the system. When the reservation itself
+ * fails every allocation goes to malloc.
+ */
+class HugePageArenaAllocator : public Allocator {
+public:
+    static constexpr uint64_t DEFAULT_RESERVE_SIZE = 1ULL << 40;
+    static constexpr uint64_t DEFAULT_CHUNK_SIZE = 64ULL << 20;
+    static constexpr uint64_t DEFAULT_MIN_ARENA_ALLOCATION = 128ULL << 10;
+    static constexpr uint64_t HUGE_PAGE_SIZE = 2ULL << 20;
+    static constexpr uint64_t GIANT_PAGE_SIZE = 1ULL << 30;
+
+    /**
+     * Returns the arena behind allocator, looking through a SafeAllocator wrapper, or nullptr
+     * when allocator is of another kind.
+     */
+    static HugePageArenaAllocator*
+    Unwrap(Allocator* allocator);
+
+public:
+    explicit HugePageArenaAllocator(uint64_t reserve_size = DEFAULT_RESERVE_SIZE,
+                                    uint64_t chunk_size = DEFAULT_CHUNK_SIZE,
+                                    uint64_t min_arena_allocation = DEFAULT_MIN_ARENA_ALLOCATION);
+
+    ~HugePageArenaAllocator() override;
+
+    HugePageArenaAllocator(const HugePageArenaAllocator&) = delete;
+    HugePageArenaAllocator(HugePageArenaAllocator&&) = delete;
+
+public:
+    std::string
+    Name() override;
+
+    void*
+    Allocate(uint64_t size) override;
+
+    void
+    Deallocate(void* p) override;
+
+    void*
+    Reallocate(void* p, uint64_t size) override;
+
+    [[nodiscard]] HugePageArenaStats
+    GetStats() const;
+
+    [[nodiscard]] bool
+    InArena(const void* p) const {
+        auto addr = reinterpret_cast<uintptr_t>(p);
+        return addr >= base_ and addr < base_ + reserve_size_;
+    }
+
+private:
+    void*
+    allocate_from_arena(uint64_t size);
+
+    void
+    deallocate_from_arena(void* p);
+
+    bool
+    commit_chunks(uint64_t first_chunk, uint64_t chunk_count);
+
+    void
+    decommit_chunk(uint64_t chunk);
+
+    void
+    insert_free_extent(uint64_t offset, uint64_t size);
+
+    void
+    erase_free_extent(std::map<uint64_t, uint64_t>::iterator iter);
+
+private:
+    DefaultAllocator fallback_;
+
+    uintptr_t base_{0};
+    uint64_t reserve_size_{0};
+    const uint64_t chunk_size_;
+    const uint64_t min_arena_allocation_;
+
+    mutable std::mutex mutex_;
+
+    // free committed extents, by offset for coalescing and by size for best fit
+    std::map<uint64_t, uint64_t> free_by_offset_;
+    std::multimap<uint64_t, uint64_t> free_by_size_;
+    // offset -> size of the live arena allocations
+    std::unordered_map<uint64_t, uint64_t> allocated_;
+
+    enum class ChunkState : uint8_t { RESERVED = 0, HUGE_PAGE = 1, TRANSPARENT = 2 };
+    std::vector<ChunkState> chunks_;
+    std::vector<uint64_t> chunk_used_bytes_;
+
+    uint64_t used_bytes_{0};
+};
+
+}  // namespace vsag
@@ -0,0 +1,145 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "huge_page_arena_allocator.h"
+
+#include <cstring>
+
+#include "safe_allocator.h"
+#include "unittest.h"
+
+using namespace vsag;
+
+namespace {
+constexpr uint64_t CHUNK_SIZE = HugePageArenaAllocator::HUGE_PAGE_SIZE;
+constexpr uint64_t RESERVE_SIZE = CHUNK_SIZE * 8;
+constexpr uint64_t MIN_ARENA_ALLOCATION = 64ULL << 10;
+}  // namespace
+
+TEST_CASE("HugePageArenaAllocator Basic Test", "[ut][HugePageArenaAllocator]") {
+    HugePageArenaAllocator allocator(RESERVE_SIZE, CHUNK_SIZE, MIN_ARENA_ALLOCATION);
+
+    auto* small = static_cast<int*>(allocator.Allocate(sizeof(int) * 4));
+    REQUIRE(small != nullptr);
+    REQUIRE_FALSE(allocator.InArena(small));
+
+    uint64_t large_size = 300ULL << 10;
+    auto* large = static_cast<char*>(allocator.Allocate(large_size));
+    REQUIRE(large != nullptr);
+    REQUIRE(allocator.InArena(large));
+    memset(large, 7, large_size);
+
+    auto stats = allocator.GetStats();
+    REQUIRE(stats.reserved_bytes == RESERVE_SIZE);
+    REQUIRE(stats.committed_bytes == CHUNK_SIZE);
+    REQUIRE(stats.used_bytes >= large_size);
+    REQUIRE(stats.used_bytes + stats.free_bytes == stats.committed_bytes);
+    REQUIRE(stats.allocation_count == 1);
+    REQUIRE(stats.Fragmentation() == 0.0F);
+    REQUIRE(stats.ToJson()["committed_bytes"].GetInt() == CHUNK_SIZE);
+
+    auto* grown = static_cast<char*>(allocator.Reallocate(large, large_size * 2));
+    REQUIRE(allocator.InArena(grown));
+    REQUIRE(grown[0] == 7);
+    REQUIRE(grown[large_size - 1] == 7);
+
+    // shrinking below the arena threshold moves the block to malloc
+    auto* shrunk = static_cast<char*>(allocator.Reallocate(grown, 1024));
+    REQUIRE_FALSE(allocator.InArena(shrunk));
+    REQUIRE(shrunk[1023] == 7);
+
+    allocator.Deallocate(shrunk);
+    allocator.Deallocate(small);
+    allocator.Deallocate(nullptr);
+    stats = allocator.GetStats();
+    REQUIRE(stats.used_bytes == 0);
+    REQUIRE(stats.allocation_count == 0);
+    // entirely free chunks are given back
+    REQUIRE(stats.committed_bytes == 0);
+}
+
+TEST_CASE("HugePageArenaAllocator Fragmentation", "[ut][HugePageArenaAllocator]") {
+    HugePageArenaAllocator allocator(RESERVE_SIZE, CHUNK_SIZE, MIN_ARENA_ALLOCATION);
+    uint64_t block_size = CHUNK_SIZE / 8;
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; ++i) {
+        blocks.emplace_back(allocator.Allocate(block_size));
+        REQUIRE(allocator.InArena(blocks.back()));
+    }
+    REQUIRE(allocator.GetStats().committed_bytes == CHUNK_SIZE);
+    REQUIRE(allocator.GetStats().free_bytes == 0);
+
+    // free every other block: 4 holes that can not merge
+    for (int i = 0; i < 8; i += 2) {
+        allocator.Deallocate(blocks[i]);
+    }
+    auto stats = allocator.GetStats();
+    REQUIRE(stats.free_bytes == block_size * 4);
+    REQUIRE(stats.largest_free_bytes == block_size);
+    REQUIRE(stats.Fragmentation() == Approx(0.75F));
+
+    // a hole is reused before a new chunk is committed
+    auto* reused = allocator.Allocate(block_size);
+    REQUIRE(reused == blocks[0]);
+    REQUIRE(allocator.GetStats().committed_bytes == CHUNK_SIZE);
+    blocks[0] = reused;
+
+    // freeing the rest coalesces the holes back into the chunk
+    for (int i = 0; i < 8; ++i) {
+        if (i % 2 == 1 or i == 0) {
+            allocator.Deallocate(blocks[i]);
+        }
+    }
+    stats = allocator.GetStats();
+    REQUIRE(stats.allocation_count == 0);
+    REQUIRE(stats.committed_bytes == 0);
+}
+
+TEST_CASE("HugePageArenaAllocator Multi Chunk And Exhaustion", "[ut][HugePageArenaAllocator]") {
+    HugePageArenaAllocator allocator(CHUNK_SIZE * 4, CHUNK_SIZE, MIN_ARENA_ALLOCATION);
+
+    // spans three chunks
+    auto* span = static_cast<char*>(allocator.Allocate(CHUNK_SIZE * 2 + 4096));
+    REQUIRE(allocator.InArena(span));
+    span[CHUNK_SIZE * 2 + 4095] = 1;
+    REQUIRE(allocator.GetStats().committed_bytes == CHUNK_SIZE * 3);
+
+    // the reservation can not hold this one, it is served by malloc
+    auto* outside = allocator.Allocate(CHUNK_SIZE * 2);
+    REQUIRE(outside != nullptr);
+    REQUIRE_FALSE(allocator.InArena(outside));
+
+    allocator.Deallocate(outside);
+    allocator.Deallocate(span);
+    REQUIRE(allocator.GetStats().committed_bytes == 0);
+}
+
+TEST_CASE("HugePageArenaAllocator Invalid Arguments", "[ut][HugePageArenaAllocator]") {
+    REQUIRE_THROWS(HugePageArenaAllocator(RESERVE_SIZE, 4096));
+    REQUIRE_THROWS(HugePageArenaAllocator(CHUNK_SIZE / 2, CHUNK_SIZE));
+
+    HugePageArenaAllocator allocator(RESERVE_SIZE, CHUNK_SIZE, MIN_ARENA_ALLOCATION);
+    auto* p = static_cast<char*>(allocator.Allocate(MIN_ARENA_ALLOCATION));
+    REQUIRE_THROWS(allocator.Deallocate(p + 4096));
+    allocator.Deallocate(p);
+}
+
+TEST_CASE("HugePageArenaAllocator Unwrap", "[ut][HugePageArenaAllocator]") {
+    auto arena = std::make_shared<HugePageArenaAllocator>(RESERVE_SIZE, CHUNK_SIZE);
+    auto safe_allocator = std::make_shared<SafeAllocator>(arena);
+    REQUIRE(HugePageArenaAllocator::Unwrap(safe_allocator.get()) == arena.get());
+    REQUIRE(HugePageArenaAllocator::Unwrap(arena.get()) == arena.get());
+    DefaultAllocator default_allocator;
+    REQUIRE(HugePageArenaAllocator::Unwrap(&default_allocator) == nullptr);
+}
@@ -55,6 +55,10 @@ public:
     float factor{2.0F};
     float first_order_scan_ratio{1.0F};
     std::vector<ExecutorPtr> executors;
+    bool adaptive_probe{false};
+    float probe_error_bound{0.0F};
+    // ef of the centroid router, 0 falls back to the one of the partition strategy
+    int64_t router_ef_search{0};
 
     // deal with duplicate ids
     mutable int64_t duplicate_id{-1};
@@ -356,10 +356,27 @@ ODescent::parallelize_task(const std::function<void(int64_t, int64_t)>& task) {
 
 void
 ODescent::SaveGraph(GraphInterfacePtr& graph_storage) {
+    this->save_graph(graph_storage, valid_ids_);
+}
+
+void
+ODescent::SaveGraph(GraphInterfacePtr& graph_storage, const Vector<InnerIdType>& id_map) {
+    if (id_map.size() != static_cast<uint64_t>(data_num_)) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            "ODescent id_map size ",
+                            id_map.size(),
+                            " != data_num ",
+                            data_num_);
+    }
+    this->save_graph(graph_storage, id_map.data());
+}
+
+void
+ODescent::save_graph(GraphInterfacePtr& graph_storage, const InnerIdType* id_map) {
     for (int i = 0; i < data_num_; ++i) {
         uint32_t id = i;
-        if (valid_ids_ != nullptr) {
-            id = valid_ids_[i];
+        if (id_map != nullptr) {
+            id = id_map[i];
         }
         Vector<uint32_t> edges(allocator_);
         uint64_t size = graph_[i].neighbors.size();
@@ -367,8 +384,8 @@ ODescent::SaveGraph(GraphInterfacePtr& graph_storage) {
             edges.resize(size);
             for (int j = 0; j < size; ++j) {
                 edges[j] = graph_[i].neighbors[j].id;
-                if (valid_ids_ != nullptr) {
-                    edges[j] = valid_ids_[graph_[i].neighbors[j].id];
+                if (id_map != nullptr) {
+                    edges[j] = id_map[graph_[i].neighbors[j].id];
                 }
             }
         }
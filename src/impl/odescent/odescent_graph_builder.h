@@ -108,6 +108,11 @@ public:
     void
     SaveGraph(GraphInterfacePtr& graph_storage);
 
+    // saves a graph built over the positions of a datacell holding a copy of some points as
+    // the graph of their ids, position i being the copy of id_map[i]
+    void
+    SaveGraph(GraphInterfacePtr& graph_storage, const Vector<InnerIdType>& id_map);
+
     void
     SetMaxDegree(int32_t max_degree) {
         odescent_param_->max_degree = max_degree;
@@ -150,6 +155,9 @@ private:
     void
     prune_graph();
 
+    void
+    save_graph(GraphInterfacePtr& graph_storage, const InnerIdType* id_map);
+
 private:
     void
     parallelize_task(const std::function<void(int64_t i, int64_t end)>& task);
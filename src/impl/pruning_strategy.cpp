@@ -15,6 +15,8 @@
 
 #include "pruning_strategy.h"
 
+#include <algorithm>
+
 #include "datacell/flatten_datacell.h"
 #include "datacell/graph_interface.h"
 #include "impl/heap/standard_heap.h"
@@ -130,6 +132,9 @@ mutually_connect_new_element(InnerIdType cur_c,
             throw VsagException(ErrorType::INTERNAL_ERROR, "Bad value of sz_link_list_other");
         }
         // If cur_c is already present in the neighboring connections of `selected_neighbors[idx]` then no need to modify any connections or run the heuristics.
+        if (std::find(neighbors.begin(), neighbors.end(), cur_c) != neighbors.end()) {
+            continue;
+        }
         if (sz_link_list_other < max_size) {
             neighbors.emplace_back(cur_c);
             graph->InsertNeighborsById(selected_neighbor, neighbors);
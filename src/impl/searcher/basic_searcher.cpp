@@ -45,8 +45,9 @@ BasicSearcher::visit(const GraphInterfacePtr& graph,
     uint32_t count_no_visited = 0;
 
     if (this->mutex_array_ != nullptr) {
-        SharedLock lock(this->mutex_array_, current_node_pair.second);
-        graph->GetNeighbors(current_node_pair.second, neighbors);
+        OptimisticRead(this->mutex_array_, current_node_pair.second, [&]() {
+            graph->GetNeighbors(current_node_pair.second, neighbors);
+        });
     } else {
         graph->GetNeighbors(current_node_pair.second, neighbors);
     }
@@ -458,6 +459,218 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
     return top_candidates;
 }
 
+namespace {
+
+enum class TraversalStage {
+    POP_CANDIDATE,
+    EXPAND_NEIGHBORS,
+    COMPUTE_DISTANCES,
+    FINISHED,
+};
+
+// the state of one suspended traversal in BasicSearcher::SearchInterleaved
+struct InterleavedTraversal {
+    InterleavedTraversal(Allocator* alloc, uint32_t max_degree)
+        : top_candidates(std::make_shared<StandardHeap<true, false>>(alloc, -1)),
+          candidate_set(std::make_shared<StandardHeap<true, false>>(alloc, -1)),
+          to_be_visited_rid(max_degree, alloc),
+          to_be_visited_id(max_degree, alloc),
+          neighbors(max_degree, alloc),
+          line_dists(max_degree, alloc) {
+    }
+
+    TraversalStage stage{TraversalStage::POP_CANDIDATE};
+
+    const InnerSearchParam* param{nullptr};
+    ComputerInterfacePtr computer{nullptr};
+    FilterSearchSkipStrategyPtr skip_strategy{nullptr};
+
+    DistHeapPtr top_candidates{nullptr};
+    DistHeapPtr candidate_set{nullptr};
+    std::pair<float, uint64_t> current_node_pair{0.0F, 0};
+    float lower_bound{std::numeric_limits<float>::max()};
+
+    uint32_t hops{0};
+    uint32_t dist_cmp{0};
+    uint32_t count_no_visited{0};
+
+    Vector<InnerIdType> to_be_visited_rid;
+    Vector<InnerIdType> to_be_visited_id;
+    Vector<InnerIdType> neighbors;
+    Vector<float> line_dists;
+};
+
+}  // namespace
+
+std::vector<DistHeapPtr>
+BasicSearcher::SearchInterleaved(const GraphInterfacePtr& graph,
+                                 const FlattenInterfacePtr& flatten,
+                                 const std::vector<VisitedListPtr>& vls,
+                                 const std::vector<const void*>& queries,
+                                 const std::vector<InnerSearchParam>& inner_search_params,
+                                 QueryContext* ctx) const {
+    Allocator* alloc = select_query_allocator(ctx, allocator_);
+    auto count = queries.size();
+    CHECK_ARGUMENT(vls.size() == count and inner_search_params.size() == count,
+                   "the sizes of queries, visited lists and search params must be equal");
+
+    std::vector<DistHeapPtr> results(count, nullptr);
+    if (not graph or not flatten) {
+        for (auto& result : results) {
+            result = std::make_shared<StandardHeap<true, false>>(alloc, -1);
+        }
+        return results;
+    }
+
+    auto max_degree = static_cast<uint32_t>(graph->MaximumDegree());
+    std::vector<std::unique_ptr<InterleavedTraversal>> traversals;
+    traversals.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        const auto& param = inner_search_params[i];
+        CHECK_ARGUMENT(param.search_mode == KNN_SEARCH and param.executors.empty(),
+                       "interleaved search only supports knn search without executors");
+        auto t = std::make_unique<InterleavedTraversal>(alloc, max_degree);
+        t->param = &param;
+        t->computer = flatten->FactoryComputer(queries[i]);
+        t->skip_strategy = create_filter_search_skip_strategy(
+            param.skip_strategy_type,
+            param.is_inner_id_allowed != nullptr ? param.is_inner_id_allowed->ValidRatio()
+                                                 : 1.0F,
+            param.skip_ratio);
+
+        float dist = 0.0F;
+        auto ep = param.ep;
+        flatten->Query(&dist, t->computer, &ep, 1, ctx);
+        ++t->dist_cmp;
+        if (param.is_inner_id_allowed == nullptr or param.is_inner_id_allowed->CheckValid(ep)) {
+            t->top_candidates->Push(dist, ep);
+            t->lower_bound = dist;
+        }
+        t->candidate_set->Push(-dist, ep);
+        vls[i]->Set(ep);
+        traversals.emplace_back(std::move(t));
+    }
+
+    auto pop_candidate = [&](InterleavedTraversal& t) -> void {
+        const auto& param = *t.param;
+        if (t.candidate_set->Empty()) {
+            t.stage = TraversalStage::FINISHED;
+            return;
+        }
+        ++t.hops;
+        if (t.hops >= param.hops_limit) {
+            t.stage = TraversalStage::FINISHED;
+            return;
+        }
+        if (param.time_cost != nullptr and param.time_cost->CheckOvertime()) {
+            if (ctx != nullptr and ctx->stats != nullptr) {
+                ctx->stats->is_timeout.store(true, std::memory_order_relaxed);
+            }
+            t.stage = TraversalStage::FINISHED;
+            return;
+        }
+        t.current_node_pair = t.candidate_set->Top();
+        if ((-t.current_node_pair.first) > t.lower_bound and
+            t.top_candidates->Size() == param.ef) {
+            t.stage = TraversalStage::FINISHED;
+            return;
+        }
+        t.candidate_set->Pop();
+        // yield until the neighbor list arrives
+        graph->Prefetch(t.current_node_pair.second, 0);
+        t.stage = TraversalStage::EXPAND_NEIGHBORS;
+    };
+
+    auto expand_neighbors = [&](InterleavedTraversal& t, const VisitedListPtr& vl) -> void {
+        t.count_no_visited = visit(graph,
+                                   vl,
+                                   t.current_node_pair,
+                                   t.param->is_inner_id_allowed,
+                                   t.skip_strategy.get(),
+                                   t.to_be_visited_rid,
+                                   t.to_be_visited_id,
+                                   t.neighbors);
+        // yield until the codes of the unvisited neighbors arrive
+        for (uint32_t i = 0; i < t.count_no_visited; ++i) {
+            flatten->Prefetch(t.to_be_visited_id[i]);
+        }
+        t.stage = TraversalStage::COMPUTE_DISTANCES;
+    };
+
+    auto compute_distances = [&](InterleavedTraversal& t) -> void {
+        const auto& param = *t.param;
+        const auto& is_id_allowed = param.is_inner_id_allowed;
+        flatten->Query(
+            t.line_dists.data(), t.computer, t.to_be_visited_id.data(), t.count_no_visited, ctx);
+        t.dist_cmp += t.count_no_visited;
+        for (uint32_t i = 0; i < t.count_no_visited; ++i) {
+            auto dist = t.line_dists[i];
+            auto id = t.to_be_visited_id[i];
+            if (t.top_candidates->Size() < param.ef or t.lower_bound > dist) {
+                t.candidate_set->Push(-dist, id);
+                if (not is_id_allowed or is_id_allowed->CheckValid(id)) {
+                    t.top_candidates->Push(dist, id);
+                }
+                if (param.consider_duplicate) {
+                    const auto duplicate_ids = graph->GetDuplicateIds(id);
+                    for (const auto& item : duplicate_ids) {
+                        if (not is_id_allowed or is_id_allowed->CheckValid(item)) {
+                            t.top_candidates->Push(dist, item);
+                        }
+                    }
+                }
+                if (t.top_candidates->Size() > param.ef) {
+                    t.top_candidates->Pop();
+                }
+                if (not t.top_candidates->Empty()) {
+                    t.lower_bound = t.top_candidates->Top().first;
+                }
+            }
+        }
+        t.stage = TraversalStage::POP_CANDIDATE;
+    };
+
+    auto active = count;
+    while (active > 0) {
+        for (uint64_t i = 0; i < count; ++i) {
+            auto& t = *traversals[i];
+            switch (t.stage) {
+                case TraversalStage::POP_CANDIDATE:
+                    pop_candidate(t);
+                    break;
+                case TraversalStage::EXPAND_NEIGHBORS:
+                    expand_neighbors(t, vls[i]);
+                    break;
+                case TraversalStage::COMPUTE_DISTANCES:
+                    compute_distances(t);
+                    break;
+                case TraversalStage::FINISHED:
+                    continue;
+            }
+            if (t.stage == TraversalStage::FINISHED) {
+                --active;
+            }
+        }
+    }
+
+    uint32_t dist_cmp = 0;
+    uint32_t hops = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        auto& t = *traversals[i];
+        while (t.top_candidates->Size() > t.param->topk) {
+            t.top_candidates->Pop();
+        }
+        dist_cmp += t.dist_cmp;
+        hops += t.hops;
+        results[i] = t.top_candidates;
+    }
+    if (ctx != nullptr and ctx->stats != nullptr) {
+        ctx->stats->dist_cmp.fetch_add(dist_cmp, std::memory_order_relaxed);
+        ctx->stats->hops.fetch_add(hops, std::memory_order_relaxed);
+    }
+    return results;
+}
+
 bool
 BasicSearcher::SetRuntimeParameters(const UnorderedMap<std::string, float>& new_params) {
     bool ret = false;
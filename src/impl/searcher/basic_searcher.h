@@ -58,6 +58,24 @@ public:
            IteratorFilterContext* iter_ctx,
            QueryContext* ctx) const;
 
+    /**
+     * @brief Runs several independent KNN traversals on one thread.
+     *
+     * Each traversal is split into stages (pop a candidate, expand its neighbor list,
+     * compute the distances of the unvisited neighbors). A stage ends right after the
+     * prefetch of the memory needed by the next stage, and the traversals are advanced
+     * round-robin, so the cache misses of one traversal overlap with the work of the others.
+     * The i-th traversal uses queries[i], inner_search_params[i] and vls[i]; attribute
+     * executors are not supported here and should be folded into is_inner_id_allowed.
+     */
+    virtual std::vector<DistHeapPtr>
+    SearchInterleaved(const GraphInterfacePtr& graph,
+                      const FlattenInterfacePtr& flatten,
+                      const std::vector<VisitedListPtr>& vls,
+                      const std::vector<const void*>& queries,
+                      const std::vector<InnerSearchParam>& inner_search_params,
+                      QueryContext* ctx) const;
+
     virtual bool
     SetRuntimeParameters(const UnorderedMap<std::string, float>& new_params);
 
@@ -229,6 +229,102 @@ TEST_CASE("Search with HNSW", "[ut][BasicSearcher]") {
     }
 }
 
+TEST_CASE("Interleaved Search with HNSW", "[ut][BasicSearcher]") {
+    uint32_t base_size = 1000;
+    uint32_t query_size = 20;
+    uint64_t dim = 64;
+    uint32_t M = 16;
+    uint32_t ef_construction = 100;
+    uint32_t ef_search = 100;
+    InnerIdType fixed_entry_point_id = 0;
+
+    auto base_vectors = fixtures::generate_vectors(base_size, dim, true);
+    std::vector<InnerIdType> ids(base_size);
+    std::iota(ids.begin(), ids.end(), 0);
+
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto space = std::make_shared<hnswlib::L2Space>(dim);
+    auto alg_hnsw =
+        std::make_shared<hnswlib::HierarchicalNSW>(space.get(),
+                                                   1,
+                                                   allocator.get(),
+                                                   M / 2,
+                                                   ef_construction,
+                                                   Options::Instance().block_size_limit());
+    alg_hnsw->init_memory_space();
+    for (int64_t i = 0; i < base_size; ++i) {
+        alg_hnsw->addPoint((const void*)(base_vectors.data() + i * dim), ids[i]);
+    }
+    auto graph_data_cell = std::make_shared<AdaptGraphDataCell>(alg_hnsw);
+
+    constexpr const char* param_temp = R"({{"type": "{}"}})";
+    auto fp32_param = QuantizerParameter::GetQuantizerParameterByJson(
+        JsonType::Parse(fmt::format(param_temp, "fp32")));
+    auto io_param =
+        IOParameter::GetIOParameterByJson(JsonType::Parse(fmt::format(param_temp, "memory_io")));
+    IndexCommonParam common;
+    common.dim_ = dim;
+    common.allocator_ = allocator;
+    common.metric_ = vsag::MetricType::METRIC_TYPE_L2SQR;
+    auto vector_data_cell = std::make_shared<
+        FlattenDataCell<FP32Quantizer<vsag::MetricType::METRIC_TYPE_L2SQR>, MemoryIO>>(
+        fp32_param, io_param, common);
+    vector_data_cell->SetQuantizer(
+        std::make_shared<FP32Quantizer<vsag::MetricType::METRIC_TYPE_L2SQR>>(dim, allocator.get()));
+    vector_data_cell->SetIO(std::make_unique<MemoryIO>(allocator.get()));
+    vector_data_cell->Train(base_vectors.data(), base_size);
+    vector_data_cell->BatchInsertVector(base_vectors.data(), base_size, ids.data());
+
+    auto pool = std::make_shared<VisitedListPool>(
+        query_size, allocator.get(), vector_data_cell->TotalCount(), allocator.get());
+    auto searcher = std::make_shared<BasicSearcher>(common);
+
+    auto filter_func = [](LabelType id) -> bool { return id % 2 == 0; };
+    auto use_filter = GENERATE(false, true);
+    InnerSearchParam search_param;
+    search_param.ep = fixed_entry_point_id;
+    search_param.ef = ef_search;
+    search_param.topk = 10;
+    if (use_filter) {
+        search_param.is_inner_id_allowed = std::make_shared<BlackListFilter>(filter_func);
+    }
+
+    std::vector<VisitedListPtr> vls;
+    std::vector<const void*> queries;
+    std::vector<InnerSearchParam> params(query_size, search_param);
+    for (uint32_t i = 0; i < query_size; ++i) {
+        vls.emplace_back(pool->TakeOne());
+        queries.emplace_back(base_vectors.data() + i * dim);
+    }
+    auto results = searcher->SearchInterleaved(
+        graph_data_cell, vector_data_cell, vls, queries, params, nullptr);
+    REQUIRE(results.size() == query_size);
+
+    for (uint32_t i = 0; i < query_size; ++i) {
+        auto vl = pool->TakeOne();
+        auto expected = searcher->Search(graph_data_cell,
+                                         vector_data_cell,
+                                         vl,
+                                         queries[i],
+                                         search_param,
+                                         (LabelTablePtr) nullptr,
+                                         nullptr);
+        pool->ReturnOne(vl);
+        REQUIRE(results[i]->Size() == expected->Size());
+        std::unordered_set<InnerIdType> expected_set, result_set;
+        while (not expected->Empty()) {
+            expected_set.insert(expected->Top().second);
+            result_set.insert(results[i]->Top().second);
+            expected->Pop();
+            results[i]->Pop();
+        }
+        REQUIRE(result_set == expected_set);
+    }
+    for (auto& vl : vls) {
+        pool->ReturnOne(vl);
+    }
+}
+
 TEST_CASE("Optimize SQ4", "[ut][BasicOptimizer]") {
     // avoid too much slow task logs
     fixtures::logger::LoggerReplacer _;
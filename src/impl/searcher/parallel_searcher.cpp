@@ -47,8 +47,9 @@ ParallelSearcher::visit(const GraphInterfacePtr& graph,
 
     if (this->mutex_array_ != nullptr) {
         for (uint64_t i = 0; i < point_visited_num; i++) {
-            SharedLock lock(this->mutex_array_, node_pair[i].second);
-            graph->GetNeighbors(node_pair[i].second, neighbors[i]);
+            OptimisticRead(this->mutex_array_, node_pair[i].second, [&]() {
+                graph->GetNeighbors(node_pair[i].second, neighbors[i]);
+            });
         }
     } else {
         for (uint64_t i = 0; i < point_visited_num; i++) {
@@ -172,6 +173,8 @@ ParallelSearcher::search_impl(const GraphInterfacePtr& graph,
     std::atomic<uint32_t> num_points{0};
 
     auto task = [&](uint64_t thread_id) {
+        // the block cache counts the reads of the worker into the statistics of the query
+        SearchStatistics::ThreadScope stats_scope(ctx != nullptr ? ctx->stats : nullptr);
         std::tuple<float*, InnerIdType*, uint64_t> item;
         while (true) {
             if (queues[thread_id].Pop(item)) {
@@ -18,6 +18,7 @@
 #include "default_thread_pool.h"
 #include "impl/logger/logger.h"
 #include "utils/pointer_define.h"
+#include "work_stealing_thread_pool.h"
 
 namespace vsag {
 DEFINE_POINTER(SafeThreadPool);
@@ -27,15 +28,20 @@ public:
     static std::shared_ptr<SafeThreadPool>
     FactoryDefaultThreadPool() {
         return std::make_shared<SafeThreadPool>(
-            new DefaultThreadPool(Options::Instance().num_threads_building()), true);
+            new WorkStealingThreadPool(Options::Instance().num_threads_building()), true);
     }
 
 public:
-    SafeThreadPool(ThreadPool* thread_pool, bool owner) : pool_(thread_pool), owner_(owner) {
+    SafeThreadPool(ThreadPool* thread_pool, bool owner)
+        : pool_(thread_pool),
+          owner_(owner),
+          work_stealing_pool_(dynamic_cast<WorkStealingThreadPool*>(thread_pool)) {
     }
 
     SafeThreadPool(const std::shared_ptr<ThreadPool>& thread_pool)
-        : pool_ptr_(thread_pool), pool_(thread_pool.get()) {
+        : pool_ptr_(thread_pool),
+          pool_(thread_pool.get()),
+          work_stealing_pool_(dynamic_cast<WorkStealingThreadPool*>(thread_pool.get())) {
     }
 
     ~SafeThreadPool() override {
@@ -58,6 +64,27 @@ public:
         return res;  // NOLINT(clang-analyzer-cplusplus.NewDeleteLeaks)
     }
 
+    /**
+     * Runs func(0), ..., func(count - 1) in parallel and returns when all of them are done,
+     * rethrowing the first exception. On a WorkStealingThreadPool this is a fork/join in
+     * which the caller takes part; any other pool falls back to one task per index.
+     */
+    void
+    ParallelFor(uint64_t count, const std::function<void(uint64_t)>& func) {
+        if (work_stealing_pool_ != nullptr) {
+            work_stealing_pool_->ParallelFor(count, func);
+            return;
+        }
+        std::vector<std::future<void>> futures;
+        futures.reserve(count);
+        for (uint64_t i = 0; i < count; ++i) {
+            futures.emplace_back(this->GeneralEnqueue(func, i));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+    }
+
     std::future<void>
     Enqueue(std::function<void(void)> task) override {
         auto func_wrapper = [task = std::move(task)]() {
@@ -86,6 +113,7 @@ private:
     ThreadPool* pool_{nullptr};
     std::shared_ptr<ThreadPool> pool_ptr_{nullptr};
     bool owner_{false};
+    WorkStealingThreadPool* work_stealing_pool_{nullptr};
 };
 
 }  // namespace vsag
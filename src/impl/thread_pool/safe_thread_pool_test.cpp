@@ -38,3 +38,21 @@ TEST_CASE("SafeThreadPool Basic Test", "[ut][SafeThreadPool]") {
     thread_pool->WaitUntilEmpty();
     REQUIRE(data == round);
 }
+
+TEST_CASE("SafeThreadPool ParallelFor Test", "[ut][SafeThreadPool]") {
+    auto use_default_pool = GENERATE(true, false);
+    std::shared_ptr<vsag::SafeThreadPool> thread_pool;
+    if (use_default_pool) {
+        thread_pool = vsag::SafeThreadPool::FactoryDefaultThreadPool();
+    } else {
+        thread_pool = std::make_shared<vsag::SafeThreadPool>(new vsag::DefaultThreadPool(4), true);
+    }
+    uint64_t count = 100;
+    std::vector<std::atomic<int>> visited(count);
+    thread_pool->ParallelFor(count, [&visited](uint64_t i) { visited[i]++; });
+    for (const auto& v : visited) {
+        REQUIRE(v.load() == 1);
+    }
+    REQUIRE_THROWS(thread_pool->ParallelFor(
+        count, [](uint64_t i) { throw std::runtime_error("throw a error in parallel for"); }));
+}
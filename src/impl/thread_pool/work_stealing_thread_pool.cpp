@@ -0,0 +1,351 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "work_stealing_thread_pool.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace vsag {
+
+namespace {
+
+constexpr std::uint64_t NO_WORKER_INDEX = std::numeric_limits<std::uint64_t>::max();
+
+// the pool the current thread is working for, and its queue index (NO_WORKER_INDEX for a
+// thread that only helps inside ParallelFor)
+thread_local const void* tls_pool = nullptr;
+thread_local std::uint64_t tls_worker_index = NO_WORKER_INDEX;
+
+class PoolThreadGuard {
+public:
+    PoolThreadGuard(const void* pool, std::uint64_t index)
+        : prev_pool_(tls_pool), prev_index_(tls_worker_index) {
+        tls_pool = pool;
+        tls_worker_index = index;
+    }
+
+    ~PoolThreadGuard() {
+        tls_pool = prev_pool_;
+        tls_worker_index = prev_index_;
+    }
+
+private:
+    const void* prev_pool_;
+    std::uint64_t prev_index_;
+};
+
+// a ParallelFor call: its helper tasks and the caller run indices until none is left. The job
+// is owned by the caller and the queued helpers together, since a helper may only be popped
+// after the caller is gone; such a late helper finds no slot left and returns at once
+struct ForkJoinJob {
+    ForkJoinJob(const std::function<void(std::uint64_t)>& func,
+                std::uint64_t count,
+                std::uint64_t helper_count)
+        : func(func), count(count), unstarted_helpers(helper_count), refs(helper_count + 1) {
+    }
+
+    void
+    Run() {
+        while (true) {
+            auto index = next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= count) {
+                return;
+            }
+            try {
+                func(index);
+            } catch (...) {
+                if (not failed.exchange(true, std::memory_order_acq_rel)) {
+                    error = std::current_exception();
+                }
+                next.store(count, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // the body of a helper task: runs the job unless the caller took back its slot
+    void
+    Help() {
+        running_helpers.fetch_add(1, std::memory_order_acq_rel);
+        auto unstarted = unstarted_helpers.load(std::memory_order_acquire);
+        while (unstarted > 0 and
+               not unstarted_helpers.compare_exchange_weak(unstarted,
+                                                           unstarted - 1,
+                                                           std::memory_order_acq_rel,
+                                                           std::memory_order_acquire)) {
+        }
+        if (unstarted > 0) {
+            this->Run();
+        }
+        running_helpers.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    // called by the caller once it ran out of indices: the helpers not started yet will not
+    // touch func anymore, so only the running ones are waited for
+    void
+    Join() {
+        unstarted_helpers.exchange(0, std::memory_order_acq_rel);
+        while (running_helpers.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    void
+    Release() {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    const std::function<void(std::uint64_t)>& func;
+    const std::uint64_t count;
+    std::atomic<std::uint64_t> next{0};
+    std::atomic<std::uint64_t> unstarted_helpers;
+    std::atomic<std::uint64_t> running_helpers{0};
+    std::atomic<std::uint64_t> refs;
+    std::atomic<bool> failed{false};
+    std::exception_ptr error{nullptr};
+};
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(std::uint64_t threads) {
+    this->start_workers(threads);
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    this->stop_workers();
+}
+
+std::future<void>
+WorkStealingThreadPool::Enqueue(std::function<void(void)> task) {
+    // packaged_task is move-only while Task must be copyable
+    auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+    auto future = packaged->get_future();
+    if (this->in_pool_thread()) {
+        // never block a worker on the queue limit, it may be the one that drains the queue
+        this->push_task([packaged]() { (*packaged)(); });
+        return future;
+    }
+    auto limit = queue_size_limit_.load(std::memory_order_relaxed);
+    if (limit > 0) {
+        std::unique_lock lock(space_mutex_);
+        space_cv_.wait(lock, [&]() { return pending_.load() < limit; });
+    }
+    std::shared_lock lock(pool_mutex_);
+    this->push_task([packaged]() { (*packaged)(); });
+    return future;
+}
+
+void
+WorkStealingThreadPool::WaitUntilEmpty() {
+    std::unique_lock lock(done_mutex_);
+    done_cv_.wait(lock, [&]() { return in_flight_.load() == 0; });
+}
+
+void
+WorkStealingThreadPool::SetQueueSizeLimit(std::uint64_t limit) {
+    queue_size_limit_.store(limit, std::memory_order_relaxed);
+    std::lock_guard lock(space_mutex_);
+    space_cv_.notify_all();
+}
+
+void
+WorkStealingThreadPool::SetPoolSize(std::uint64_t limit) {
+    limit = std::max<std::uint64_t>(limit, 1);
+    while (true) {
+        this->WaitUntilEmpty();
+        std::unique_lock lock(pool_mutex_);
+        // a task may have been submitted between the wait and the lock
+        if (in_flight_.load() != 0) {
+            continue;
+        }
+        if (limit != workers_.size()) {
+            this->stop_workers();
+            this->start_workers(limit);
+        }
+        return;
+    }
+}
+
+std::uint64_t
+WorkStealingThreadPool::GetPoolSize() const {
+    return pool_size_.load(std::memory_order_relaxed);
+}
+
+void
+WorkStealingThreadPool::ParallelFor(std::uint64_t count,
+                                    const std::function<void(std::uint64_t)>& func) {
+    if (count == 0) {
+        return;
+    }
+    if (count == 1) {
+        func(0);
+        return;
+    }
+
+    std::shared_lock lock(pool_mutex_, std::defer_lock);
+    auto self = tls_worker_index;
+    if (not this->in_pool_thread()) {
+        lock.lock();
+        self = NO_WORKER_INDEX;
+    }
+    // the indices run on this thread submit without taking pool_mutex_ again
+    PoolThreadGuard guard(this, self);
+
+    auto helper_count = std::min<std::uint64_t>(count - 1, workers_.size());
+    auto* job = new ForkJoinJob(func, count, helper_count);
+    for (std::uint64_t i = 0; i < helper_count; ++i) {
+        // captures a single pointer, so std::function keeps it inline without allocation
+        this->push_task([job]() {
+            job->Help();
+            job->Release();
+        });
+    }
+    job->Run();
+    // never runs tasks of other jobs while waiting: a search calling ParallelFor must not end
+    // up running a long background task inline
+    job->Join();
+
+    auto error = job->error;
+    job->Release();
+    if (error != nullptr) {
+        std::rethrow_exception(error);
+    }
+}
+
+void
+WorkStealingThreadPool::start_workers(std::uint64_t threads) {
+    threads = std::max<std::uint64_t>(threads, 1);
+    queues_.clear();
+    for (std::uint64_t i = 0; i < threads; ++i) {
+        queues_.emplace_back(std::make_unique<WorkerQueue>());
+    }
+    stop_.store(false);
+    for (std::uint64_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this, i]() { this->worker_loop(i); });
+    }
+    pool_size_.store(threads, std::memory_order_relaxed);
+}
+
+void
+WorkStealingThreadPool::stop_workers() {
+    {
+        std::lock_guard lock(idle_mutex_);
+        stop_.store(true);
+    }
+    idle_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+void
+WorkStealingThreadPool::worker_loop(std::uint64_t index) {
+    PoolThreadGuard guard(this, index);
+    Task task;
+    while (true) {
+        if (this->try_pop_task(index, task)) {
+            this->run_task(task);
+            continue;
+        }
+        std::unique_lock lock(idle_mutex_);
+        sleeping_.fetch_add(1);
+        idle_cv_.wait(lock, [&]() { return stop_.load() or pending_.load() > 0; });
+        sleeping_.fetch_sub(1);
+        // drain the queues before leaving
+        if (stop_.load() and pending_.load() == 0) {
+            return;
+        }
+    }
+}
+
+void
+WorkStealingThreadPool::push_task(Task task) {
+    in_flight_.fetch_add(1);
+    auto index = tls_worker_index;
+    if (not this->in_pool_thread() or index == NO_WORKER_INDEX) {
+        index = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    }
+    // counted before it becomes visible so that a stealer never drives pending_ below zero
+    pending_.fetch_add(1);
+    {
+        auto& queue = *queues_[index];
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.emplace_back(std::move(task));
+    }
+    // pairs with the sleeping_ increment in worker_loop: either the pusher sees a sleeper,
+    // or the sleeper sees the new pending_ in its wait predicate
+    if (sleeping_.load() > 0) {
+        std::lock_guard lock(idle_mutex_);
+        idle_cv_.notify_one();
+    }
+}
+
+bool
+WorkStealingThreadPool::try_pop_task(std::uint64_t self, Task& task) {
+    auto queue_count = queues_.size();
+    if (self < queue_count) {
+        auto& queue = *queues_[self];
+        std::lock_guard lock(queue.mutex);
+        if (not queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+
+    auto start = self < queue_count ? self + 1 : next_queue_.load(std::memory_order_relaxed);
+    for (std::uint64_t i = 0; i < queue_count; ++i) {
+        auto victim = (start + i) % queue_count;
+        if (victim == self) {
+            continue;
+        }
+        auto& queue = *queues_[victim];
+        std::lock_guard lock(queue.mutex);
+        if (not queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            pending_.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+WorkStealingThreadPool::run_task(Task& task) {
+    if (queue_size_limit_.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard lock(space_mutex_);
+        space_cv_.notify_all();
+    }
+    task();
+    // release the captured state before the task is reported as finished
+    task = nullptr;
+    if (in_flight_.fetch_sub(1) == 1) {
+        std::lock_guard lock(done_mutex_);
+        done_cv_.notify_all();
+    }
+}
+
+bool
+WorkStealingThreadPool::in_pool_thread() const {
+    return tls_pool == this;
+}
+
+}  // namespace vsag
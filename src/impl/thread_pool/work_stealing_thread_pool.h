@@ -0,0 +1,126 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "vsag/thread_pool.h"
+
+namespace vsag {
+
+/**
+ * A thread pool where every worker owns a task deque. A worker pops its own deque from the
+ * back and steals from the front of the others when it runs dry, so there is no global
+ * queue lock on the hot path. Tasks submitted by a worker stay in its own deque.
+ *
+ * Besides the ThreadPool interface it provides ParallelFor, a fork/join primitive whose
+ * caller takes part in the work and which submits no per-index task object.
+ */
+class WorkStealingThreadPool : public ThreadPool {
+public:
+    explicit WorkStealingThreadPool(std::uint64_t threads);
+
+    ~WorkStealingThreadPool() override;
+
+    std::future<void>
+    Enqueue(std::function<void(void)> task) override;
+
+    void
+    WaitUntilEmpty() override;
+
+    void
+    SetQueueSizeLimit(std::uint64_t limit) override;
+
+    void
+    SetPoolSize(std::uint64_t limit) override;
+
+    /**
+     * Runs func(0), ..., func(count - 1) on the pool and returns after all of them are done.
+     * The calling thread executes indices itself and then takes back the helper tasks no
+     * worker has started, so it only waits for helpers already running indices and never
+     * runs unrelated tasks. This also makes it safe to call from inside a task of the same
+     * pool. The first exception thrown by func stops the remaining indices and is rethrown to
+     * the caller.
+     */
+    void
+    ParallelFor(std::uint64_t count, const std::function<void(std::uint64_t)>& func);
+
+    [[nodiscard]] std::uint64_t
+    GetPoolSize() const;
+
+private:
+    using Task = std::function<void()>;
+
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void
+    start_workers(std::uint64_t threads);
+
+    void
+    stop_workers();
+
+    void
+    worker_loop(std::uint64_t index);
+
+    void
+    push_task(Task task);
+
+    bool
+    try_pop_task(std::uint64_t self, Task& task);
+
+    void
+    run_task(Task& task);
+
+    [[nodiscard]] bool
+    in_pool_thread() const;
+
+private:
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    // held shared by threads outside the pool while they touch queues_, exclusively by resize
+    mutable std::shared_mutex pool_mutex_;
+
+    std::atomic<std::uint64_t> pool_size_{0};
+    std::atomic<std::uint64_t> next_queue_{0};
+    std::atomic<std::uint64_t> pending_{0};
+    std::atomic<std::uint64_t> in_flight_{0};
+    std::atomic<std::uint64_t> sleeping_{0};
+    std::atomic<std::uint64_t> queue_size_limit_{0};
+    std::atomic<bool> stop_{false};
+
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+
+    std::mutex done_mutex_;
+    std::condition_variable done_cv_;
+
+    std::mutex space_mutex_;
+    std::condition_variable space_cv_;
+};
+
+}  // namespace vsag
@@ -0,0 +1,142 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "work_stealing_thread_pool.h"
+
+#include <atomic>
+#include <thread>
+
+#include "unittest.h"
+using namespace vsag;
+
+TEST_CASE("WorkStealingThreadPool Basic Test", "[ut][WorkStealingThreadPool]") {
+    WorkStealingThreadPool pool(4);
+    REQUIRE(pool.GetPoolSize() == 4);
+
+    SECTION("Enqueue and Execute") {
+        std::atomic<int> counter{0};
+        std::vector<std::future<void>> futures;
+        for (int i = 0; i < 100; ++i) {
+            futures.emplace_back(pool.Enqueue([&counter]() { counter++; }));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+        REQUIRE(counter == 100);
+    }
+
+    SECTION("Nested Enqueue") {
+        std::atomic<int> counter{0};
+        for (int i = 0; i < 10; ++i) {
+            pool.Enqueue([&pool, &counter]() {
+                for (int j = 0; j < 10; ++j) {
+                    pool.Enqueue([&counter]() { counter++; });
+                }
+            });
+        }
+        pool.WaitUntilEmpty();
+        REQUIRE(counter == 100);
+    }
+
+    SECTION("Exception is Kept in Future") {
+        auto future = pool.Enqueue([]() { throw std::runtime_error("error in task"); });
+        REQUIRE_THROWS_AS(future.get(), std::runtime_error);
+    }
+}
+
+TEST_CASE("WorkStealingThreadPool ParallelFor Test", "[ut][WorkStealingThreadPool]") {
+    WorkStealingThreadPool pool(4);
+    uint64_t count = GENERATE(0, 1, 3, 1000);
+
+    SECTION("Every Index Runs Once") {
+        std::vector<std::atomic<int>> visited(count);
+        pool.ParallelFor(count, [&visited](uint64_t i) { visited[i]++; });
+        for (const auto& v : visited) {
+            REQUIRE(v.load() == 1);
+        }
+    }
+
+    SECTION("Nested ParallelFor") {
+        std::atomic<uint64_t> sum{0};
+        pool.ParallelFor(count, [&](uint64_t i) {
+            pool.ParallelFor(8, [&](uint64_t j) { sum.fetch_add(j); });
+        });
+        REQUIRE(sum == count * 28);
+    }
+
+    SECTION("Exception is Rethrown") {
+        auto func = [](uint64_t i) {
+            if (i == 0) {
+                throw std::runtime_error("error in parallel for");
+            }
+        };
+        if (count == 0) {
+            REQUIRE_NOTHROW(pool.ParallelFor(count, func));
+        } else {
+            REQUIRE_THROWS_AS(pool.ParallelFor(count, func), std::runtime_error);
+        }
+    }
+    pool.WaitUntilEmpty();
+}
+
+TEST_CASE("WorkStealingThreadPool ParallelFor Runs No Unrelated Task",
+          "[ut][WorkStealingThreadPool]") {
+    WorkStealingThreadPool pool(2);
+    std::atomic<int> blocked{0};
+    std::atomic<bool> release{false};
+    for (int i = 0; i < 2; ++i) {
+        pool.Enqueue([&]() {
+            blocked++;
+            while (not release.load()) {
+                std::this_thread::yield();
+            }
+        });
+    }
+    while (blocked.load() < 2) {
+        std::this_thread::yield();
+    }
+    // queued behind the busy workers, like a background build behind a search
+    std::atomic<bool> unrelated_on_caller{false};
+    auto caller = std::this_thread::get_id();
+    pool.Enqueue([&]() { unrelated_on_caller = std::this_thread::get_id() == caller; });
+
+    std::atomic<uint64_t> sum{0};
+    pool.ParallelFor(100, [&](uint64_t i) { sum.fetch_add(i); });
+    REQUIRE(sum == 4950);
+
+    release = true;
+    pool.WaitUntilEmpty();
+    REQUIRE_FALSE(unrelated_on_caller.load());
+}
+
+TEST_CASE("WorkStealingThreadPool SetPoolSize Test", "[ut][WorkStealingThreadPool]") {
+    WorkStealingThreadPool pool(2);
+    pool.SetQueueSizeLimit(16);
+
+    std::atomic<int> counter{0};
+    for (int i = 0; i < 50; ++i) {
+        pool.Enqueue([&counter]() { counter++; });
+    }
+    pool.SetPoolSize(4);
+    REQUIRE(pool.GetPoolSize() == 4);
+    REQUIRE(counter == 50);
+
+    pool.SetPoolSize(1);
+    REQUIRE(pool.GetPoolSize() == 1);
+    for (int i = 0; i < 50; ++i) {
+        pool.Enqueue([&counter]() { counter++; });
+    }
+    pool.WaitUntilEmpty();
+    REQUIRE(counter == 100);
+}
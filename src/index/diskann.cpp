@@ -31,6 +31,7 @@
 #include "datacell/flatten_datacell.h"
 #include "dataset_impl.h"
 #include "impl/odescent/odescent_graph_builder.h"
+#include "io/io_uring_file_reader.h"
 #include "io/memory_io_parameter.h"
 #include "quantization/fp32_quantizer_parameter.h"
 #include "storage/empty_index_binary_set.h"
@@ -245,6 +246,16 @@ DiskANN::DiskANN(DiskannParameters& diskann_params, const IndexCommonParam& inde
                 disk_layout_reader_->AsyncRead(offset, len, dest, callBack);
             }
         } else {
+#if HAVE_IO_URING
+            // one submission for the whole beam instead of a pool task per sector
+            if (auto* uring_reader = dynamic_cast<IOUringFileReader*>(disk_layout_reader_.get());
+                uring_reader != nullptr) {
+                if (not uring_reader->BatchRead(requests)) {
+                    throw VsagException(ErrorType::READ_ERROR, "failed to read diskann index");
+                }
+                return;
+            }
+#endif
             std::atomic<bool> succeed(true);
             std::string error_message;
             std::atomic<int> counter(static_cast<int>(requests.size()));
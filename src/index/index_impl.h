@@ -73,7 +73,7 @@ public:
     Add(const DatasetPtr& base, AddMode mode = AddMode::DEFAULT) override {
         CHECK_IMMUTABLE_INDEX("add");
         CHECK_NONEMPTY_DATASET(base);
-        SAFE_CALL(return this->inner_index_->Add(base, mode));
+        SAFE_CALL(return this->inner_index_->LoggedAdd(base, mode));
     }
 
     std::string
@@ -81,6 +81,12 @@ public:
         return this->inner_index_->AnalyzeIndexBySearch(request);
     }
 
+    tl::expected<uint64_t, Error>
+    AttachOperationLog(const std::string& path, uint64_t group_commit_delay_us = 0) override {
+        CHECK_IMMUTABLE_INDEX("attach operation log");
+        SAFE_CALL(return this->inner_index_->AttachOperationLog(path, group_commit_delay_us));
+    }
+
     tl::expected<std::vector<int64_t>, Error>
     Build(const DatasetPtr& base) override {
         CHECK_IMMUTABLE_INDEX("build");
@@ -128,6 +134,11 @@ public:
             query, ids, count, calculate_precise_distance));
     }
 
+    tl::expected<void, Error>
+    CheckpointOperationLog() override {
+        SAFE_CALL(this->inner_index_->CheckpointOperationLog());
+    }
+
     [[nodiscard]] bool
     CheckFeature(IndexFeature feature) const override {
         return this->inner_index_->CheckFeature(feature);
@@ -172,6 +183,12 @@ public:
         SAFE_CALL(this->inner_index_->Deserialize(in_stream));
     }
 
+    tl::expected<void, Error>
+    DeserializeDelta(const BinarySet& binary_set) override {
+        CHECK_IMMUTABLE_INDEX("deserialize delta");
+        SAFE_CALL(this->inner_index_->DeserializeDelta(binary_set));
+    }
+
     [[nodiscard]] uint64_t
     EstimateMemory(uint64_t num_elements) const override {
         return this->inner_index_->EstimateMemory(num_elements);
@@ -405,7 +422,7 @@ public:
     tl::expected<uint32_t, Error>
     Remove(const std::vector<int64_t>& ids, RemoveMode mode = RemoveMode::MARK_REMOVE) override {
         CHECK_IMMUTABLE_INDEX("remove");
-        SAFE_CALL(return this->inner_index_->Remove(ids, mode));
+        SAFE_CALL(return this->inner_index_->LoggedRemove(ids, mode));
     }
 
     [[nodiscard]] tl::expected<BinarySet, Error>
@@ -423,6 +440,11 @@ public:
         SAFE_CALL(this->inner_index_->Serialize(out_stream));
     }
 
+    [[nodiscard]] tl::expected<BinarySet, Error>
+    SerializeDelta() override {
+        SAFE_CALL(return this->inner_index_->SerializeDelta());
+    }
+
     [[nodiscard]] tl::expected<DatasetPtr, Error>
     SearchWithRequest(const SearchRequest& request) const override {
         CHECK_AND_RETURN_EMPTY_DATASET;
@@ -446,7 +468,7 @@ public:
     virtual tl::expected<void, Error>
     UpdateAttribute(int64_t id, const AttributeSet& new_attrs) override {
         CHECK_IMMUTABLE_INDEX("update attribute");
-        SAFE_CALL(this->inner_index_->UpdateAttribute(id, new_attrs));
+        SAFE_CALL(this->inner_index_->LoggedUpdateAttribute(id, new_attrs, nullptr));
     }
 
     tl::expected<void, Error>
@@ -454,7 +476,7 @@ public:
                     const AttributeSet& new_attrs,
                     const AttributeSet& origin_attrs) override {
         CHECK_IMMUTABLE_INDEX("update attribute with origin attributes");
-        SAFE_CALL(this->inner_index_->UpdateAttribute(id, new_attrs, origin_attrs));
+        SAFE_CALL(this->inner_index_->LoggedUpdateAttribute(id, new_attrs, &origin_attrs));
     }
 
     virtual tl::expected<bool, Error>
@@ -463,13 +485,13 @@ public:
         if (new_base->GetNumElements() == 0) {
             return false;
         }
-        SAFE_CALL(return this->inner_index_->UpdateExtraInfo(new_base));
+        SAFE_CALL(return this->inner_index_->LoggedUpdateExtraInfo(new_base));
     }
 
     tl::expected<bool, Error>
     UpdateId(int64_t old_id, int64_t new_id) override {
         CHECK_IMMUTABLE_INDEX("update id");
-        SAFE_CALL(return this->inner_index_->UpdateId(old_id, new_id));
+        SAFE_CALL(return this->inner_index_->LoggedUpdateId(old_id, new_id));
     }
 
     tl::expected<bool, Error>
@@ -478,7 +500,7 @@ public:
         if (new_base->GetNumElements() == 0) {
             return false;
         }
-        SAFE_CALL(return this->inner_index_->UpdateVector(id, new_base, force_update));
+        SAFE_CALL(return this->inner_index_->LoggedUpdateVector(id, new_base, force_update));
     }
 
 public:
@@ -59,8 +59,10 @@ const char* const IO_TYPE_VALUE_BUFFER_IO = "buffer_io";
 const char* const IO_TYPE_VALUE_MMAP_IO = "mmap_io";
 const char* const IO_TYPE_VALUE_READER_IO = "reader_io";
 const char* const IO_TYPE_VALUE_ASYNC_IO = "async_io";
+const char* const IO_TYPE_VALUE_IO_URING_IO = "io_uring_io";
 const char* const IO_TYPE_VALUE_BLOCK_MEMORY_IO = "block_memory_io";
 const char* const BLOCK_IO_BLOCK_SIZE_KEY = "block_size";
+const char* const IO_URING_SQPOLL_KEY = "sqpoll";
 
 // IO param for file
 const char* const IO_FILE_PATH_KEY = "file_path";
@@ -130,10 +132,14 @@ const char* const GRAPH_TYPE_VALUE_NSW = "nsw";
 const char* const GRAPH_STORAGE_TYPE_KEY = "graph_storage_type";
 const char* const GRAPH_STORAGE_TYPE_VALUE_COMPRESSED = "compressed";
 const char* const GRAPH_STORAGE_TYPE_VALUE_FLAT = "flat";
+const char* const GRAPH_STORAGE_TYPE_VALUE_COLOCATED = "colocated";
 
 // bucket params for IVF index
 const char* const BUCKET_PARAMS_KEY = "buckets_params";
 const char* const BUCKET_PER_DATA_KEY = "buckets_per_data";
+const char* const IVF_AUTO_REBALANCE_KEY = "auto_rebalance";
+const char* const IVF_REBALANCE_SPLIT_RATIO_KEY = "rebalance_split_ratio";
+const char* const IVF_REBALANCE_MERGE_RATIO_KEY = "rebalance_merge_ratio";
 const char* const BUCKETS_COUNT_KEY = "buckets_count";
 const char* const BUCKET_USE_RESIDUAL_KEY = "use_residual";
 
@@ -151,23 +157,43 @@ const char* const IVF_PARTITION_STRATEGY_TYPE_GNO_IMI = "gno_imi";
 const char* const GNO_IMI_FIRST_ORDER_BUCKETS_COUNT_KEY = "first_order_buckets_count";
 const char* const GNO_IMI_SECOND_ORDER_BUCKETS_COUNT_KEY = "second_order_buckets_count";
 
+// graph router over the centroids of the ivf partition strategy
+const char* const IVF_ROUTER_MAX_DEGREE_KEY = "router_max_degree";
+const char* const IVF_ROUTER_EF_CONSTRUCTION_KEY = "router_ef_construction";
+const char* const IVF_ROUTER_EF_SEARCH_KEY = "router_ef_search";
+
 const char* const GNO_IMI_SEARCH_PARAM_FIRST_ORDER_SCAN_RATIO = "first_order_scan_ratio";
 const char* const FLATTEN_DATA_CELL = "flatten_data_cell";
 const char* const SPARSE_VECTOR_DATA_CELL = "sparse_vector_data_cell";
 
+// for warp index
+const char* const WARP_CENTROID_COUNT_KEY = "centroid_count";
+const char* const WARP_USE_RESIDUAL_KEY = "use_residual";
+const char* const WARP_SEARCH_PARAM_SCAN_CENTROIDS_COUNT = "scan_centroids_count";
+
 // for pyramid index
 const char* const NO_BUILD_LEVELS = "no_build_levels";
 const char* const INDEX_MIN_SIZE = "index_min_size";
+const char* const ASYNC_BUILD_KEY = "async_build";
+const char* const MAX_BACKGROUND_BUILDS_KEY = "max_background_builds";
 
 const char* const GRAPH_SUPPORT_REMOVE = "support_remove";
 const char* const REMOVE_FLAG_BIT = "remove_flag_bit";
 const char* const HOLD_MOLDS = "hold_molds";
 const char* const SUPPORT_DUPLICATE = "support_duplicate";
 const char* const SUPPORT_TOMBSTONE = "support_tombstone";
+const char* const CONCURRENT_INSERT_KEY = "concurrent_insert";
+const char* const BLOCK_CACHE_SIZE_KEY = "block_cache_size";
+const char* const SUPPORT_DELTA_SNAPSHOT_KEY = "support_delta_snapshot";
 const char* const SUPPORT_AUTOTUNE = "support_autotune";
 
 const char* const DATACELL_OFFSETS = "datacell_offsets";
 const char* const DATACELL_SIZES = "datacell_sizes";
+const char* const DATACELL_CHECKSUMS = "datacell_checksums";
+const char* const SECTION_ALIGNMENT_KEY = "section_alignment";
+const char* const SNAPSHOT_ID_KEY = "snapshot_id";
+const char* const BASE_SNAPSHOT_ID_KEY = "base_snapshot_id";
+const char* const OPERATION_LSN_KEY = "operation_lsn";
 const char* const BASIC_INFO = "basic_info";
 
 const char* const CODES_TYPE_KEY = "codes_type";
@@ -175,6 +201,9 @@ const char* const FLATTEN_CODES = "flatten";
 const char* const SPARSE_CODES = "sparse";
 
 const char* const IVF_SEARCH_PARAM_SCAN_BUCKETS_COUNT = "scan_buckets_count";
+const char* const IVF_SEARCH_PARAM_ADAPTIVE_PROBE = "adaptive_probe";
+const char* const IVF_SEARCH_PARAM_PROBE_ERROR_BOUND = "probe_error_bound";
+const char* const IVF_SEARCH_PARAM_ROUTER_EF_SEARCH = "router_ef_search";
 const char* const SEARCH_PARAM_FACTOR = "factor";
 const char* const SEARCH_PARALLELISM = "parallelism";
 const char* const SEARCH_MAX_TIME_COST_MS = "timeout_ms";
@@ -217,6 +246,7 @@ const std::unordered_map<std::string, std::string> DEFAULT_MAP = {
     {"GRAPH_STORAGE_TYPE_KEY", GRAPH_STORAGE_TYPE_KEY},
     {"GRAPH_STORAGE_TYPE_VALUE_FLAT", GRAPH_STORAGE_TYPE_VALUE_FLAT},
     {"GRAPH_STORAGE_TYPE_VALUE_COMPRESSED", GRAPH_STORAGE_TYPE_VALUE_COMPRESSED},
+    {"GRAPH_STORAGE_TYPE_VALUE_COLOCATED", GRAPH_STORAGE_TYPE_VALUE_COLOCATED},
     {"QUANTIZATION_PARAMS_KEY", QUANTIZATION_PARAMS_KEY},
     {"GRAPH_PARAM_MAX_DEGREE_KEY", GRAPH_PARAM_MAX_DEGREE_KEY},
     {"GRAPH_PARAM_INIT_MAX_CAPACITY_KEY", GRAPH_PARAM_INIT_MAX_CAPACITY_KEY},
@@ -257,6 +287,9 @@ const std::unordered_map<std::string, std::string> DEFAULT_MAP = {
     {"GRAPH_SUPPORT_REMOVE", GRAPH_SUPPORT_REMOVE},
     {"REMOVE_FLAG_BIT", REMOVE_FLAG_BIT},
     {"SUPPORT_DUPLICATE", SUPPORT_DUPLICATE},
+    {"CONCURRENT_INSERT_KEY", CONCURRENT_INSERT_KEY},
+    {"BLOCK_CACHE_SIZE_KEY", BLOCK_CACHE_SIZE_KEY},
+    {"SUPPORT_DELTA_SNAPSHOT_KEY", SUPPORT_DELTA_SNAPSHOT_KEY},
     {"HOLD_MOLDS", HOLD_MOLDS},
     {"IVF_PARTITION_STRATEGY_TYPE_GNO_IMI", IVF_PARTITION_STRATEGY_TYPE_GNO_IMI},
     {"STORE_RAW_VECTOR_KEY", STORE_RAW_VECTOR_KEY},
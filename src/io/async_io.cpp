@@ -72,9 +72,7 @@ AsyncIO::WriteImpl(const uint8_t* data, uint64_t size, uint64_t offset) {
         throw VsagException(ErrorType::INTERNAL_ERROR,
                             fmt::format("write bytes {} less than {}", ret, size));
     }
-    if (size + offset > this->size_) {
-        this->size_ = size + offset;
-    }
+    this->grow_size(size + offset);
     fsync(wfd_);
 }
 
@@ -84,7 +82,7 @@ AsyncIO::ResizeImpl(uint64_t size) {
     if (ret == -1) {
         throw VsagException(ErrorType::INTERNAL_ERROR, "ftruncate failed");
     }
-    this->size_ = size;
+    this->set_size(size);
 }
 
 bool
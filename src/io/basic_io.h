@@ -17,13 +17,19 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 
+#include "block_cache.h"
 #include "io_parameter.h"
 #include "storage/stream_reader.h"
 #include "storage/stream_writer.h"
 #include "utils/byte_buffer.h"
 #include "utils/function_exists_check.h"
+#include "vsag_exception.h"
 
 namespace vsag {
 
@@ -41,6 +47,8 @@ public:
     /// Checks if the IO object is in-memory.
     static constexpr bool InMemory = IOTmpl::InMemory;
     static constexpr bool SkipDeserialize = IOTmpl::SkipDeserialize;
+    /// Checks if reads may be served from a BlockCache.
+    static constexpr bool UseBlockCache = IOTmpl::UseBlockCache;
 
 public:
     /**
@@ -55,7 +63,61 @@ public:
     /**
      * @brief Virtual destructor to ensure proper cleanup in derived classes.
      */
-    virtual ~BasicIO() = default;
+    virtual ~BasicIO() {
+        if (this->cache_ != nullptr) {
+            this->cache_->EraseSource(this->cache_source_);
+        }
+    }
+
+    /**
+     * @brief Serves the reads of this IO object through a block cache shared with others.
+     *
+     * Must be called before the first read. IO objects that do not use a block cache (in
+     * memory or memory mapped) ignore it.
+     *
+     * @param cache The cache, nullptr is ignored.
+     */
+    inline void
+    SetBlockCache(const BlockCachePtr& cache) {
+        if constexpr (UseBlockCache) {
+            if (cache != nullptr and this->cache_ == nullptr) {
+                this->cache_ = cache;
+                this->cache_source_ = cache->RegisterSource();
+            }
+        }
+    }
+
+    /**
+     * @brief Loads the blocks covering [offset, offset + size) into the block cache and pins
+     * them, so that they are never evicted.
+     *
+     * @return False when there is no block cache or the IO object can not be read yet.
+     */
+    inline bool
+    PinRange(uint64_t offset, uint64_t size) {
+        if (this->cache_ == nullptr or size == 0 or not check_valid_offset(offset + size)) {
+            return false;
+        }
+        if constexpr (has_InitIOImpl<IOTmpl>::value) {
+            // nothing can be read before InitIO
+            if (not this->io_initialized_) {
+                return false;
+            }
+        }
+        auto block_size = this->cache_->BlockSize();
+        ByteBuffer buffer(block_size, this->allocator_);
+        for (auto block = offset / block_size; block <= (offset + size - 1) / block_size;
+             ++block) {
+            auto block_offset = block * block_size;
+            auto length = std::min(block_size, this->current_size() - block_offset);
+            auto epoch = this->cache_->Epoch(this->cache_source_, block);
+            if (cast().ReadImpl(length, block_offset, buffer.data)) {
+                this->cache_->Insert(
+                    this->cache_source_, block, buffer.data, length, epoch, true);
+            }
+        }
+        return true;
+    }
 
     /**
      * @brief Writes data to the IO object at a specified offset.
@@ -71,6 +133,9 @@ public:
     Write(const uint8_t* data, uint64_t size, uint64_t offset) {
         static_assert(has_WriteImpl<IOTmpl>::value);
         cast().WriteImpl(data, size, offset);
+        if (this->cache_ != nullptr and size > 0) {
+            this->erase_cached(offset, size);
+        }
     }
 
     /**
@@ -87,6 +152,9 @@ public:
     inline bool
     Read(uint64_t size, uint64_t offset, uint8_t* data) const {
         static_assert(has_ReadImpl<IOTmpl>::value);
+        if (this->cache_ != nullptr) {
+            return this->cached_read(size, offset, data);
+        }
         return cast().ReadImpl(size, offset, data);
     }
 
@@ -104,6 +172,20 @@ public:
     [[nodiscard]] inline const uint8_t*
     Read(uint64_t size, uint64_t offset, bool& need_release) const {
         static_assert(has_DirectReadImpl<IOTmpl>::value);
+        if (this->cache_ != nullptr) {
+            if (not check_valid_offset(size + offset)) {
+                return nullptr;
+            }
+            // released by Release through allocator_, whatever DirectReadImpl would return
+            auto* data = static_cast<uint8_t*>(this->allocator_->Allocate(size));
+            if (not this->cached_read(size, offset, data)) {
+                this->allocator_->Deallocate(data);
+                need_release = false;
+                return nullptr;
+            }
+            need_release = true;
+            return data;
+        }
         return cast().DirectReadImpl(size, offset, need_release);  // TODO(LHT129): use IOReadObject
     }
 
@@ -122,6 +204,9 @@ public:
     inline bool
     MultiRead(uint8_t* datas, uint64_t* sizes, uint64_t* offsets, uint64_t count) const {
         static_assert(has_MultiReadImpl<IOTmpl>::value);
+        if (this->cache_ != nullptr) {
+            return this->cached_multi_read(datas, sizes, offsets, count);
+        }
         return cast().MultiReadImpl(datas, sizes, offsets, count);
     }
 
@@ -148,12 +233,25 @@ public:
      */
     inline void
     Serialize(StreamWriter& writer) {
-        StreamWriter::WriteObj(writer, this->size_);
         ByteBuffer buffer(SERIALIZE_BUFFER_SIZE, this->allocator_);
+        auto size = this->current_size();
+        if (size >= ALIGNED_SECTION_MIN_SIZE) {
+            // large payloads start on a page boundary, so a mapped reader serves them in place
+            StreamWriter::WriteObj(writer, size | ALIGNED_SECTION_FLAG);
+            auto payload = writer.GetCursor() + sizeof(uint64_t);
+            uint64_t padding =
+                (SECTION_ALIGNMENT - payload % SECTION_ALIGNMENT) % SECTION_ALIGNMENT;
+            StreamWriter::WriteObj(writer, padding);
+            memset(buffer.data, 0, padding);
+            writer.Write(reinterpret_cast<const char*>(buffer.data), padding);
+        } else {
+            StreamWriter::WriteObj(writer, size);
+        }
         uint64_t offset = 0;
-        while (offset < this->size_) {
-            auto cur_size = std::min(SERIALIZE_BUFFER_SIZE, this->size_ - offset);
-            this->Read(cur_size, offset, buffer.data);
+        while (offset < size) {
+            auto cur_size = std::min(SERIALIZE_BUFFER_SIZE, size - offset);
+            // a full scan would only evict the hot blocks
+            cast().ReadImpl(cur_size, offset, buffer.data);
             writer.Write(reinterpret_cast<const char*>(buffer.data), cur_size);
             offset += cur_size;
         }
@@ -169,8 +267,21 @@ public:
         uint64_t size = 0;
         StreamReader::ReadObj(reader, size);
         ByteBuffer buffer(SERIALIZE_BUFFER_SIZE, this->allocator_);
+        if ((size & ALIGNED_SECTION_FLAG) != 0) {
+            size &= ~ALIGNED_SECTION_FLAG;
+            uint64_t padding = 0;
+            StreamReader::ReadObj(reader, padding);
+            if (padding >= SECTION_ALIGNMENT) {
+                throw VsagException(ErrorType::INVALID_BINARY,
+                                    fmt::format("io section padding({}) exceeds alignment({})",
+                                                padding,
+                                                SECTION_ALIGNMENT));
+            }
+            reader.Read(reinterpret_cast<char*>(buffer.data), padding);
+        }
         uint64_t offset = 0;
-        this->start_ = reader.GetCursor();
+        // offsets of the underlying reader, a slice would hide where the payload really is
+        this->start_ = reader.GetAbsoluteCursor();
         if constexpr (SkipDeserialize) {
             reader.Seek(reader.GetCursor() + size);
             this->Write(nullptr, size, offset);
@@ -197,6 +308,10 @@ public:
 
     inline void
     Release(const uint8_t* data) const {
+        if (this->cache_ != nullptr) {
+            this->allocator_->Deallocate(const_cast<uint8_t*>(data));
+            return;
+        }
         if constexpr (has_ReleaseImpl<IOTmpl>::value) {
             return cast().ReleaseImpl(data);
         }
@@ -214,7 +329,8 @@ public:
     inline void
     InitIO(const IOParamPtr& io_param) {
         if constexpr (has_InitIOImpl<IOTmpl>::value) {
-            return cast().InitIOImpl(io_param);
+            cast().InitIOImpl(io_param);
+            this->io_initialized_ = true;
         }
     }
 
@@ -223,11 +339,11 @@ public:
         if constexpr (has_ResizeImpl<IOTmpl>::value) {
             return cast().ResizeImpl(size);
         } else {
-            if (size <= this->size_) {
+            if (size <= this->current_size()) {
                 return;
             }
             ByteBuffer buffer(SERIALIZE_BUFFER_SIZE, this->allocator_);
-            uint64_t offset = this->size_;
+            uint64_t offset = this->current_size();
             while (offset < size) {
                 auto cur_size = std::min(SERIALIZE_BUFFER_SIZE, size - offset);
                 this->Write(buffer.data, cur_size, offset);
@@ -238,28 +354,56 @@ public:
 
     inline void
     Shrink(uint64_t size) {
+        if (this->cache_ != nullptr) {
+            this->cache_->EraseSource(this->cache_source_);
+        }
         if constexpr (has_ShrinkImpl<IOTmpl>::value) {
             return cast().ShrinkImpl(size);
         } else {
-            if (size <= this->size_) {
-                this->size_ = size;
+            if (size <= this->current_size()) {
+                this->set_size(size);
             }
         }
     }
 
     inline int64_t
     GetMemoryUsage() const {
-        return this->size_;
+        return this->current_size();
     }
 
 public:
     /**
      * @brief The size of the IO object.
+     *
+     * Searches read it while a writer grows it, so it is published with release semantics and
+     * read with acquire semantics through the helpers below.
      */
-    uint64_t size_{0};
+    std::atomic<uint64_t> size_{0};
     uint64_t start_{0};
 
 protected:
+    [[nodiscard]] inline uint64_t
+    current_size() const {
+        return this->size_.load(std::memory_order_acquire);
+    }
+
+    inline void
+    set_size(uint64_t size) {
+        this->size_.store(size, std::memory_order_release);
+    }
+
+    /**
+     * @brief Raises the size to end if it is smaller, concurrent writers never lower it.
+     */
+    inline void
+    grow_size(uint64_t end) {
+        auto size = this->size_.load(std::memory_order_relaxed);
+        while (size < end and
+               not this->size_.compare_exchange_weak(
+                   size, end, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
     /**
      * @brief Checks if the given offset is valid.
      *
@@ -272,7 +416,146 @@ protected:
     [[nodiscard]] inline bool
     check_valid_offset(uint64_t size) const {
         // Check if the given offset is within the bounds of the IO object.
-        return size <= this->size_;
+        return size <= this->current_size();
+    }
+
+    /**
+     * @brief Reads through the block cache, each missing block is read whole and inserted.
+     */
+    bool
+    cached_read(uint64_t size, uint64_t offset, uint8_t* data) const {
+        if (not check_valid_offset(size + offset)) {
+            return cast().ReadImpl(size, offset, data);
+        }
+        auto block_size = this->cache_->BlockSize();
+        std::unique_ptr<ByteBuffer> buffer{nullptr};
+        while (size > 0) {
+            auto block = offset / block_size;
+            auto inner_offset = offset % block_size;
+            auto length = std::min(size, block_size - inner_offset);
+            uint64_t epoch = 0;
+            if (not this->cache_->Lookup(
+                    this->cache_source_, block, inner_offset, length, data, epoch)) {
+                if (buffer == nullptr) {
+                    buffer = std::make_unique<ByteBuffer>(block_size, this->allocator_);
+                }
+                auto block_offset = block * block_size;
+                auto block_length = std::min(block_size, this->current_size() - block_offset);
+                if (not cast().ReadImpl(block_length, block_offset, buffer->data)) {
+                    return false;
+                }
+                this->cache_->Insert(
+                    this->cache_source_, block, buffer->data, block_length, epoch);
+                memcpy(data, buffer->data + inner_offset, length);
+            }
+            data += length;
+            offset += length;
+            size -= length;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Serves the cached parts of a MultiRead and reads all missing blocks with one
+     * MultiReadImpl call.
+     */
+    bool
+    cached_multi_read(uint8_t* datas, uint64_t* sizes, uint64_t* offsets, uint64_t count) const {
+        struct Piece {
+            uint8_t* dest;
+            uint64_t miss_index;
+            uint64_t inner_offset;
+            uint64_t length;
+        };
+        auto block_size = this->cache_->BlockSize();
+        Vector<Piece> pieces(this->allocator_);
+        Vector<uint64_t> miss_blocks(this->allocator_);
+        Vector<uint64_t> miss_epochs(this->allocator_);
+        UnorderedMap<uint64_t, uint64_t> miss_indexes(this->allocator_);
+        for (uint64_t i = 0; i < count; ++i) {
+            if (not check_valid_offset(sizes[i] + offsets[i])) {
+                return cast().MultiReadImpl(datas, sizes, offsets, count);
+            }
+        }
+        auto* dest = datas;
+        for (uint64_t i = 0; i < count; ++i) {
+            auto offset = offsets[i];
+            auto size = sizes[i];
+            while (size > 0) {
+                auto block = offset / block_size;
+                auto inner_offset = offset % block_size;
+                auto length = std::min(size, block_size - inner_offset);
+                uint64_t epoch = 0;
+                if (not this->cache_->Lookup(
+                        this->cache_source_, block, inner_offset, length, dest, epoch)) {
+                    auto iter = miss_indexes.find(block);
+                    uint64_t miss_index = miss_blocks.size();
+                    if (iter == miss_indexes.end()) {
+                        miss_indexes[block] = miss_index;
+                        miss_blocks.emplace_back(block);
+                        miss_epochs.emplace_back(epoch);
+                    } else {
+                        miss_index = iter->second;
+                    }
+                    pieces.push_back({dest, miss_index, inner_offset, length});
+                }
+                dest += length;
+                offset += length;
+                size -= length;
+            }
+        }
+        if (miss_blocks.empty()) {
+            return true;
+        }
+        Vector<uint64_t> block_sizes(miss_blocks.size(), this->allocator_);
+        Vector<uint64_t> block_offsets(miss_blocks.size(), this->allocator_);
+        for (uint64_t i = 0; i < miss_blocks.size(); ++i) {
+            block_offsets[i] = miss_blocks[i] * block_size;
+            block_sizes[i] = std::min(block_size, this->current_size() - block_offsets[i]);
+        }
+        // blocks are laid out block_size apart, MultiReadImpl packs them back to back
+        ByteBuffer buffer(miss_blocks.size() * block_size, this->allocator_);
+        Vector<uint64_t> starts(miss_blocks.size(), this->allocator_);
+        uint64_t start = 0;
+        for (uint64_t i = 0; i < miss_blocks.size(); ++i) {
+            starts[i] = start;
+            start += block_sizes[i];
+        }
+        if (not cast().MultiReadImpl(
+                buffer.data, block_sizes.data(), block_offsets.data(), miss_blocks.size())) {
+            return false;
+        }
+        for (uint64_t i = 0; i < miss_blocks.size(); ++i) {
+            this->cache_->Insert(this->cache_source_,
+                                 miss_blocks[i],
+                                 buffer.data + starts[i],
+                                 block_sizes[i],
+                                 miss_epochs[i]);
+        }
+        for (const auto& piece : pieces) {
+            memcpy(piece.dest,
+                   buffer.data + starts[piece.miss_index] + piece.inner_offset,
+                   piece.length);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Drops the cached blocks overlapping [offset, offset + size).
+     */
+    void
+    erase_cached(uint64_t offset, uint64_t size) {
+        auto block_size = this->cache_->BlockSize();
+        auto first = offset / block_size;
+        auto last = (offset + size - 1) / block_size;
+        if (last - first >= this->cache_->BlockCount()) {
+            // deserialize writes the whole file, walking the cache once is cheaper
+            this->cache_->EraseSource(this->cache_source_);
+            return;
+        }
+        for (auto block = first; block <= last; ++block) {
+            this->cache_->Erase(this->cache_source_, block);
+        }
     }
 
 protected:
@@ -285,6 +568,15 @@ protected:
      */
     Allocator* const allocator_;
 
+    /// The shared block cache, nullptr when reads go straight to the IO object.
+    BlockCachePtr cache_{nullptr};
+
+    /// The source id of this IO object in cache_.
+    uint64_t cache_source_{0};
+
+    /// Whether InitIO has been called, only tracked for IO objects that need it.
+    bool io_initialized_{false};
+
 private:
     /**
      * @brief Casts the current object to the underlying IO object type.
@@ -311,6 +603,21 @@ private:
      */
     static constexpr uint64_t SERIALIZE_BUFFER_SIZE = 1024 * 1024 * 2;
 
+    /**
+     * @brief Payloads of at least this size are serialized page aligned.
+     */
+    static constexpr uint64_t ALIGNED_SECTION_MIN_SIZE = 1024 * 1024;
+
+    /**
+     * @brief The alignment of large payloads relative to the start of the serialization.
+     */
+    static constexpr uint64_t SECTION_ALIGNMENT = 4096;
+
+    /**
+     * @brief Marks a serialized size followed by a padding length and the padding.
+     */
+    static constexpr uint64_t ALIGNED_SECTION_FLAG = 1ULL << 63;
+
 private:
     /**
      * @brief Generates a struct to check if a class has a member function with a specific signature.
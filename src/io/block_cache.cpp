@@ -0,0 +1,265 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "block_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "query_context.h"
+#include "vsag_exception.h"
+
+namespace vsag {
+
+JsonType
+BlockCacheStats::ToJson() const {
+    JsonType json;
+    json["capacity_bytes"].SetInt(static_cast<int64_t>(capacity_bytes));
+    json["used_bytes"].SetInt(static_cast<int64_t>(used_bytes));
+    json["pinned_bytes"].SetInt(static_cast<int64_t>(pinned_bytes));
+    json["hit"].SetInt(static_cast<int64_t>(hit));
+    json["miss"].SetInt(static_cast<int64_t>(miss));
+    json["eviction"].SetInt(static_cast<int64_t>(eviction));
+    return json;
+}
+
+BlockCache::BlockCache(uint64_t capacity,
+                       Allocator* allocator,
+                       uint64_t block_size,
+                       uint32_t shard_count)
+    : allocator_(allocator), block_size_(block_size), shards_(allocator) {
+    if (block_size == 0 or shard_count == 0) {
+        throw VsagException(ErrorType::INVALID_ARGUMENT,
+                            "block cache block size and shard count must be positive");
+    }
+    auto block_count = capacity / block_size;
+    if (block_count < shard_count) {
+        shard_count = std::max(static_cast<uint32_t>(block_count), 1U);
+    }
+    this->slots_per_shard_ = static_cast<uint32_t>(
+        std::min(block_count / shard_count,
+                 static_cast<uint64_t>(std::numeric_limits<uint32_t>::max())));
+    this->shards_.reserve(shard_count);
+    for (uint32_t i = 0; i < shard_count; ++i) {
+        auto shard = std::make_unique<Shard>(allocator);
+        if (this->slots_per_shard_ > 0) {
+            shard->slots.resize(this->slots_per_shard_);
+            shard->data = static_cast<uint8_t*>(
+                allocator->Allocate(this->slots_per_shard_ * this->block_size_));
+        }
+        this->shards_.emplace_back(std::move(shard));
+    }
+}
+
+BlockCache::~BlockCache() {
+    for (auto& shard : this->shards_) {
+        if (shard->data != nullptr) {
+            this->allocator_->Deallocate(shard->data);
+        }
+    }
+}
+
+uint64_t
+BlockCache::RegisterSource() {
+    return this->next_source_.fetch_add(1);
+}
+
+BlockCache::Shard&
+BlockCache::shard_of(uint64_t key) const {
+    // splitmix64 finalizer, consecutive blocks of a source land in different shards
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return *this->shards_[key % this->shards_.size()];
+}
+
+bool
+BlockCache::Lookup(uint64_t source,
+                   uint64_t block,
+                   uint64_t inner_offset,
+                   uint64_t size,
+                   uint8_t* dest,
+                   uint64_t& epoch) {
+    auto key = make_key(source, block);
+    auto& shard = this->shard_of(key);
+    {
+        std::lock_guard lock(shard.mutex);
+        auto iter = shard.index.find(key);
+        if (iter != shard.index.end()) {
+            auto& slot = shard.slots[iter->second];
+            if (inner_offset + size <= slot.size) {
+                slot.referenced = true;
+                memcpy(dest,
+                       shard.data + static_cast<uint64_t>(iter->second) * this->block_size_ +
+                           inner_offset,
+                       size);
+                this->hit_.fetch_add(1, std::memory_order_relaxed);
+                if (auto* stats = SearchStatistics::Current(); stats != nullptr) {
+                    stats->cache_hit.fetch_add(1, std::memory_order_relaxed);
+                }
+                return true;
+            }
+        }
+        epoch = shard.epoch;
+    }
+    this->miss_.fetch_add(1, std::memory_order_relaxed);
+    if (auto* stats = SearchStatistics::Current(); stats != nullptr) {
+        stats->cache_miss.fetch_add(1, std::memory_order_relaxed);
+    }
+    return false;
+}
+
+void
+BlockCache::Insert(uint64_t source,
+                   uint64_t block,
+                   const uint8_t* data,
+                   uint64_t size,
+                   uint64_t epoch,
+                   bool pin) {
+    if (this->slots_per_shard_ == 0) {
+        return;
+    }
+    size = std::min(size, this->block_size_);
+    auto key = make_key(source, block);
+    auto& shard = this->shard_of(key);
+    std::lock_guard lock(shard.mutex);
+    if (shard.epoch != epoch) {
+        return;
+    }
+    pin = pin and shard.pinned_count < this->slots_per_shard_ / 2;
+    auto iter = shard.index.find(key);
+    if (iter != shard.index.end()) {
+        auto& slot = shard.slots[iter->second];
+        if (size > slot.size) {
+            memcpy(shard.data + static_cast<uint64_t>(iter->second) * this->block_size_,
+                   data,
+                   size);
+            slot.size = static_cast<uint32_t>(size);
+        }
+        if (pin and not slot.pinned) {
+            slot.pinned = true;
+            ++shard.pinned_count;
+        }
+        return;
+    }
+    auto index = this->acquire_slot(shard);
+    auto& slot = shard.slots[index];
+    slot.key = key;
+    slot.size = static_cast<uint32_t>(size);
+    slot.used = true;
+    slot.referenced = false;
+    slot.pinned = pin;
+    if (pin) {
+        ++shard.pinned_count;
+    }
+    memcpy(shard.data + static_cast<uint64_t>(index) * this->block_size_, data, size);
+    shard.index[key] = index;
+    ++shard.used_count;
+}
+
+uint32_t
+BlockCache::acquire_slot(Shard& shard) {
+    if (shard.used_count < this->slots_per_shard_) {
+        // slots are handed out in order until the shard is full, later frees are found by
+        // the clock hand below
+        while (shard.slots[shard.hand].used) {
+            shard.hand = (shard.hand + 1) % this->slots_per_shard_;
+        }
+        auto index = shard.hand;
+        shard.hand = (shard.hand + 1) % this->slots_per_shard_;
+        return index;
+    }
+    // at most half of the slots are pinned, so two turns always find a victim
+    while (true) {
+        auto index = shard.hand;
+        shard.hand = (shard.hand + 1) % this->slots_per_shard_;
+        auto& slot = shard.slots[index];
+        if (slot.pinned) {
+            continue;
+        }
+        if (slot.referenced) {
+            slot.referenced = false;
+            continue;
+        }
+        this->free_slot(shard, index);
+        this->eviction_.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+}
+
+void
+BlockCache::free_slot(Shard& shard, uint32_t index) {
+    auto& slot = shard.slots[index];
+    shard.index.erase(slot.key);
+    if (slot.pinned) {
+        --shard.pinned_count;
+    }
+    slot = Slot();
+    --shard.used_count;
+}
+
+uint64_t
+BlockCache::Epoch(uint64_t source, uint64_t block) {
+    auto& shard = this->shard_of(make_key(source, block));
+    std::lock_guard lock(shard.mutex);
+    return shard.epoch;
+}
+
+void
+BlockCache::Erase(uint64_t source, uint64_t block) {
+    if (this->slots_per_shard_ == 0) {
+        return;
+    }
+    auto key = make_key(source, block);
+    auto& shard = this->shard_of(key);
+    std::lock_guard lock(shard.mutex);
+    ++shard.epoch;
+    auto iter = shard.index.find(key);
+    if (iter != shard.index.end()) {
+        this->free_slot(shard, iter->second);
+    }
+}
+
+void
+BlockCache::EraseSource(uint64_t source) {
+    for (auto& shard : this->shards_) {
+        std::lock_guard lock(shard->mutex);
+        ++shard->epoch;
+        for (uint32_t i = 0; i < this->slots_per_shard_; ++i) {
+            if (shard->slots[i].used and (shard->slots[i].key >> 40) == source) {
+                this->free_slot(*shard, i);
+            }
+        }
+    }
+}
+
+BlockCacheStats
+BlockCache::GetStats() const {
+    BlockCacheStats stats;
+    stats.capacity_bytes = this->BlockCount() * this->block_size_;
+    for (const auto& shard : this->shards_) {
+        std::lock_guard lock(shard->mutex);
+        stats.used_bytes += static_cast<uint64_t>(shard->used_count) * this->block_size_;
+        stats.pinned_bytes += static_cast<uint64_t>(shard->pinned_count) * this->block_size_;
+    }
+    stats.hit = this->hit_.load(std::memory_order_relaxed);
+    stats.miss = this->miss_.load(std::memory_order_relaxed);
+    stats.eviction = this->eviction_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+}  // namespace vsag
@@ -0,0 +1,191 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "typing.h"
+#include "utils/pointer_define.h"
+#include "vsag/allocator.h"
+
+namespace vsag {
+
+DEFINE_POINTER(BlockCache);
+
+struct BlockCacheStats {
+    uint64_t capacity_bytes{0};
+    uint64_t used_bytes{0};
+    uint64_t pinned_bytes{0};
+    uint64_t hit{0};
+    uint64_t miss{0};
+    uint64_t eviction{0};
+
+    [[nodiscard]] JsonType
+    ToJson() const;
+};
+
+/**
+ * A sharded block cache for disk-resident IO objects (BufferIO, AsyncIO, IOUringIO, ReaderIO).
+ *
+ * Every IO object that uses the cache registers itself as a source, and its file is split
+ * into fixed-size blocks keyed by (source, block index). A shard holds a fixed number of
+ * slots carved from one buffer of the index allocator and evicts with CLOCK. Pinned blocks
+ * are never evicted; at most half of the slots of a shard can be pinned so that unpinned
+ * reads always find room.
+ *
+ * Writes must call Erase after they reach the IO object. A miss returns the erase epoch of
+ * the shard, and the block read afterwards is only inserted when no erase happened in between,
+ * so a concurrent reader can not put back the data a writer just replaced.
+ */
+class BlockCache {
+public:
+    static constexpr uint64_t DEFAULT_BLOCK_SIZE = 4096;
+    static constexpr uint32_t DEFAULT_SHARD_COUNT = 16;
+
+    /**
+     * @param capacity The memory budget in bytes, rounded down to whole blocks.
+     * @param allocator The allocator of the block memory and the shard tables.
+     */
+    BlockCache(uint64_t capacity,
+               Allocator* allocator,
+               uint64_t block_size = DEFAULT_BLOCK_SIZE,
+               uint32_t shard_count = DEFAULT_SHARD_COUNT);
+
+    ~BlockCache();
+
+    BlockCache(const BlockCache&) = delete;
+    BlockCache&
+    operator=(const BlockCache&) = delete;
+
+    /**
+     * @brief Returns a new source id for an IO object.
+     */
+    uint64_t
+    RegisterSource();
+
+    /**
+     * @brief Copies size bytes at inner_offset of a cached block into dest.
+     *
+     * @param epoch Set to the erase epoch of the shard on a miss, to be passed to Insert.
+     * @return True on a hit.
+     */
+    bool
+    Lookup(uint64_t source,
+           uint64_t block,
+           uint64_t inner_offset,
+           uint64_t size,
+           uint8_t* dest,
+           uint64_t& epoch);
+
+    /**
+     * @brief Caches the first size bytes of a block read after a miss with the given epoch.
+     *
+     * Does nothing when the block was erased in the meantime. A block that is already cached
+     * keeps its data and is only pinned when pin is true.
+     */
+    void
+    Insert(uint64_t source,
+           uint64_t block,
+           const uint8_t* data,
+           uint64_t size,
+           uint64_t epoch,
+           bool pin = false);
+
+    /**
+     * @brief Returns the erase epoch for a block that is read without a Lookup first.
+     */
+    uint64_t
+    Epoch(uint64_t source, uint64_t block);
+
+    void
+    Erase(uint64_t source, uint64_t block);
+
+    /**
+     * @brief Drops every block of source, pinned or not.
+     */
+    void
+    EraseSource(uint64_t source);
+
+    [[nodiscard]] BlockCacheStats
+    GetStats() const;
+
+    [[nodiscard]] uint64_t
+    BlockSize() const {
+        return block_size_;
+    }
+
+    [[nodiscard]] uint64_t
+    BlockCount() const {
+        return static_cast<uint64_t>(slots_per_shard_) * shards_.size();
+    }
+
+private:
+    struct Slot {
+        uint64_t key{0};
+        uint32_t size{0};
+        bool used{false};
+        bool referenced{false};
+        bool pinned{false};
+    };
+
+    struct Shard {
+        explicit Shard(Allocator* allocator) : index(allocator), slots(allocator) {
+        }
+
+        std::mutex mutex;
+        UnorderedMap<uint64_t, uint32_t> index;
+        Vector<Slot> slots;
+        uint8_t* data{nullptr};
+        uint32_t used_count{0};
+        uint32_t pinned_count{0};
+        uint32_t hand{0};
+        uint64_t epoch{0};
+    };
+
+    // source in the high 24 bits, block index in the low 40 bits
+    static uint64_t
+    make_key(uint64_t source, uint64_t block) {
+        return (source << 40) | block;
+    }
+
+    Shard&
+    shard_of(uint64_t key) const;
+
+    // index of a free slot of shard, evicting one if needed, called with shard.mutex held
+    uint32_t
+    acquire_slot(Shard& shard);
+
+    // called with shard.mutex held
+    void
+    free_slot(Shard& shard, uint32_t index);
+
+private:
+    Allocator* const allocator_;
+    const uint64_t block_size_;
+    uint32_t slots_per_shard_{0};
+
+    Vector<std::unique_ptr<Shard>> shards_;
+
+    std::atomic<uint64_t> next_source_{1};
+
+    std::atomic<uint64_t> hit_{0};
+    std::atomic<uint64_t> miss_{0};
+    std::atomic<uint64_t> eviction_{0};
+};
+
+}  // namespace vsag
@@ -0,0 +1,251 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "block_cache.h"
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "basic_io_test.h"
+#include "buffer_io.h"
+#include "impl/allocator/safe_allocator.h"
+#include "query_context.h"
+#include "unittest.h"
+
+using namespace vsag;
+
+namespace {
+constexpr uint64_t BLOCK_SIZE = 64;
+}  // namespace
+
+TEST_CASE("BlockCache Lookup & Insert", "[ut][BlockCache]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    BlockCache cache(BLOCK_SIZE * 8, allocator.get(), BLOCK_SIZE, 1);
+    REQUIRE(cache.BlockCount() == 8);
+    auto source = cache.RegisterSource();
+
+    std::vector<uint8_t> block(BLOCK_SIZE);
+    for (uint64_t i = 0; i < BLOCK_SIZE; ++i) {
+        block[i] = static_cast<uint8_t>(i);
+    }
+    std::vector<uint8_t> dest(BLOCK_SIZE);
+    uint64_t epoch = 0;
+    REQUIRE_FALSE(cache.Lookup(source, 3, 0, 8, dest.data(), epoch));
+    cache.Insert(source, 3, block.data(), BLOCK_SIZE, epoch);
+    REQUIRE(cache.Lookup(source, 3, 10, 8, dest.data(), epoch));
+    REQUIRE(dest[0] == 10);
+    REQUIRE(dest[7] == 17);
+
+    // a partial block only serves the bytes it holds
+    REQUIRE_FALSE(cache.Lookup(source, 4, 0, 8, dest.data(), epoch));
+    cache.Insert(source, 4, block.data(), 16, epoch);
+    REQUIRE(cache.Lookup(source, 4, 8, 8, dest.data(), epoch));
+    REQUIRE_FALSE(cache.Lookup(source, 4, 8, 16, dest.data(), epoch));
+
+    // an erase between the miss and the insert drops the stale block
+    REQUIRE_FALSE(cache.Lookup(source, 5, 0, 8, dest.data(), epoch));
+    cache.Erase(source, 5);
+    cache.Insert(source, 5, block.data(), BLOCK_SIZE, epoch);
+    REQUIRE_FALSE(cache.Lookup(source, 5, 0, 8, dest.data(), epoch));
+
+    cache.Erase(source, 3);
+    REQUIRE_FALSE(cache.Lookup(source, 3, 0, 8, dest.data(), epoch));
+
+    auto stats = cache.GetStats();
+    REQUIRE(stats.capacity_bytes == BLOCK_SIZE * 8);
+    REQUIRE(stats.used_bytes == BLOCK_SIZE);
+    REQUIRE(stats.hit == 2);
+    REQUIRE(stats.ToJson()["hit"].GetInt() == 2);
+}
+
+TEST_CASE("BlockCache Eviction & Pin", "[ut][BlockCache]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    constexpr uint64_t block_count = 8;
+    BlockCache cache(BLOCK_SIZE * block_count, allocator.get(), BLOCK_SIZE, 1);
+    auto source = cache.RegisterSource();
+    std::vector<uint8_t> block(BLOCK_SIZE, 1);
+    std::vector<uint8_t> dest(BLOCK_SIZE);
+    uint64_t epoch = 0;
+
+    // only half of the slots can be pinned
+    for (uint64_t i = 0; i < block_count; ++i) {
+        cache.Insert(source, i, block.data(), BLOCK_SIZE, cache.Epoch(source, i), true);
+    }
+    REQUIRE(cache.GetStats().pinned_bytes == BLOCK_SIZE * block_count / 2);
+
+    for (uint64_t i = block_count; i < block_count * 4; ++i) {
+        REQUIRE_FALSE(cache.Lookup(source, i, 0, BLOCK_SIZE, dest.data(), epoch));
+        cache.Insert(source, i, block.data(), BLOCK_SIZE, epoch);
+    }
+    auto stats = cache.GetStats();
+    REQUIRE(stats.used_bytes == BLOCK_SIZE * block_count);
+    REQUIRE(stats.eviction > 0);
+    for (uint64_t i = 0; i < block_count / 2; ++i) {
+        REQUIRE(cache.Lookup(source, i, 0, BLOCK_SIZE, dest.data(), epoch));
+    }
+
+    cache.EraseSource(source);
+    stats = cache.GetStats();
+    REQUIRE(stats.used_bytes == 0);
+    REQUIRE(stats.pinned_bytes == 0);
+}
+
+TEST_CASE("BlockCache BufferIO Read & Write", "[ut][BlockCache]") {
+    fixtures::TempDir dir("block_cache");
+    auto path = dir.GenerateRandomFile(false);
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto cache = std::make_shared<BlockCache>(BLOCK_SIZE * 32, allocator.get(), BLOCK_SIZE, 4);
+    auto io = std::make_unique<BufferIO>(path, allocator.get());
+    io->SetBlockCache(cache);
+    TestBasicReadWrite(*io);
+}
+
+TEST_CASE("BlockCache BufferIO Hit & Miss", "[ut][BlockCache]") {
+    fixtures::TempDir dir("block_cache");
+    auto path = dir.GenerateRandomFile(false);
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto cache = std::make_shared<BlockCache>(BLOCK_SIZE * 64, allocator.get(), BLOCK_SIZE, 4);
+    auto io = std::make_unique<BufferIO>(path, allocator.get());
+    io->SetBlockCache(cache);
+
+    constexpr uint64_t size = BLOCK_SIZE * 16 + 10;
+    std::vector<uint8_t> data(size);
+    for (uint64_t i = 0; i < size; ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+    io->Write(data.data(), size, 0);
+
+    SearchStatistics stats;
+    SearchStatistics::ThreadScope stats_scope(&stats);
+    std::vector<uint8_t> dest(size);
+    REQUIRE(io->Read(size, 0, dest.data()));
+    REQUIRE(memcmp(dest.data(), data.data(), size) == 0);
+    REQUIRE(io->Read(size, 0, dest.data()));
+    REQUIRE(memcmp(dest.data(), data.data(), size) == 0);
+    auto dump = JsonType::Parse(stats.Dump());
+    REQUIRE(dump["cache_miss"].GetInt() == 17);
+    REQUIRE(dump["cache_hit"].GetInt() == 17);
+
+    // a write replaces the cached blocks it overlaps
+    std::vector<uint8_t> patch(BLOCK_SIZE, 0xFF);
+    io->Write(patch.data(), BLOCK_SIZE, BLOCK_SIZE / 2);
+    memcpy(data.data() + BLOCK_SIZE / 2, patch.data(), BLOCK_SIZE);
+    bool need_release = false;
+    const auto* ptr = io->Read(BLOCK_SIZE * 2, 0, need_release);
+    REQUIRE(need_release);
+    REQUIRE(memcmp(ptr, data.data(), BLOCK_SIZE * 2) == 0);
+    io->Release(ptr);
+
+    std::vector<uint64_t> sizes{8, BLOCK_SIZE + 4, 10};
+    std::vector<uint64_t> offsets{3, BLOCK_SIZE * 5 - 2, size - 10};
+    std::vector<uint8_t> multi(8 + BLOCK_SIZE + 4 + 10);
+    REQUIRE(io->MultiRead(multi.data(), sizes.data(), offsets.data(), sizes.size()));
+    REQUIRE(memcmp(multi.data(), data.data() + 3, 8) == 0);
+    REQUIRE(memcmp(multi.data() + 8, data.data() + BLOCK_SIZE * 5 - 2, BLOCK_SIZE + 4) == 0);
+    REQUIRE(memcmp(multi.data() + 8 + BLOCK_SIZE + 4, data.data() + size - 10, 10) == 0);
+
+    io->PinRange(0, BLOCK_SIZE * 2);
+    REQUIRE(cache->GetStats().pinned_bytes == BLOCK_SIZE * 2);
+
+    io.reset();
+    REQUIRE(cache->GetStats().used_bytes == 0);
+}
+
+TEST_CASE("BlockCache Counts Per Query", "[ut][BlockCache]") {
+    fixtures::TempDir dir("block_cache");
+    auto path = dir.GenerateRandomFile(false);
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto cache = std::make_shared<BlockCache>(BLOCK_SIZE * 64, allocator.get(), BLOCK_SIZE, 4);
+    auto io = std::make_unique<BufferIO>(path, allocator.get());
+    io->SetBlockCache(cache);
+    std::vector<uint8_t> data(BLOCK_SIZE * 8, 0x5A);
+    io->Write(data.data(), data.size(), 0);
+
+    // the workers of a query count into its statistics, reads outside a scope are not counted
+    SearchStatistics stats;
+    SearchStatistics other_stats;
+    SearchStatistics::ThreadScope stats_scope(&other_stats);
+    std::vector<std::thread> workers;
+    for (uint64_t t = 0; t < 4; ++t) {
+        workers.emplace_back([&, t]() {
+            SearchStatistics::ThreadScope worker_scope(&stats);
+            std::vector<uint8_t> dest(BLOCK_SIZE * 2);
+            REQUIRE(io->Read(dest.size(), t * BLOCK_SIZE * 2, dest.data()));
+            REQUIRE(io->Read(dest.size(), t * BLOCK_SIZE * 2, dest.data()));
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::thread([&]() {
+        std::vector<uint8_t> dest(BLOCK_SIZE);
+        REQUIRE(io->Read(dest.size(), 0, dest.data()));
+    }).join();
+    REQUIRE(stats.cache_miss.load() == 8);
+    REQUIRE(stats.cache_hit.load() == 8);
+    REQUIRE(other_stats.cache_miss.load() == 0);
+    REQUIRE(other_stats.cache_hit.load() == 0);
+    REQUIRE(SearchStatistics::Current() == &other_stats);
+}
+
+TEST_CASE("BlockCache Concurrent Read & Write", "[ut][BlockCache]") {
+    fixtures::TempDir dir("block_cache");
+    auto path = dir.GenerateRandomFile(false);
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto cache = std::make_shared<BlockCache>(BLOCK_SIZE * 16, allocator.get(), BLOCK_SIZE, 4);
+    auto io = std::make_unique<BufferIO>(path, allocator.get());
+    io->SetBlockCache(cache);
+
+    // every 8-byte record holds its index twice, a torn or stale read breaks the pair
+    constexpr uint64_t record_count = 256;
+    std::vector<uint32_t> expected(record_count);
+    for (uint64_t i = 0; i < record_count; ++i) {
+        expected[i] = static_cast<uint32_t>(i);
+        uint32_t record[2] = {static_cast<uint32_t>(i), static_cast<uint32_t>(i)};
+        io->Write(reinterpret_cast<uint8_t*>(record), sizeof(record), i * sizeof(record));
+    }
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t]() {
+            for (uint64_t round = 0; round < 2000; ++round) {
+                auto i = (round * 31 + t * 17) % record_count;
+                uint32_t record[2];
+                io->Read(sizeof(record), i * sizeof(record), reinterpret_cast<uint8_t*>(record));
+                if (record[0] != record[1]) {
+                    failed = true;
+                }
+            }
+        });
+    }
+    for (uint32_t round = 1; round <= 200; ++round) {
+        auto i = (round * 13) % record_count;
+        uint32_t record[2] = {round, round};
+        io->Write(reinterpret_cast<uint8_t*>(record), sizeof(record), i * sizeof(record));
+        expected[i] = round;
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    REQUIRE_FALSE(failed);
+    for (uint64_t i = 0; i < record_count; ++i) {
+        uint32_t record[2];
+        io->Read(sizeof(record), i * sizeof(record), reinterpret_cast<uint8_t*>(record));
+        REQUIRE(record[0] == expected[i]);
+        REQUIRE(record[1] == expected[i]);
+    }
+}
@@ -40,6 +40,12 @@ public:
     /// Indicates deserialization is required when loading from disk.
     static constexpr bool SkipDeserialize = false;
 
+    /// Indicates growing must not run concurrently with readers.
+    static constexpr bool ConcurrentResize = false;
+
+    /// Indicates reads may be served from a BlockCache.
+    static constexpr bool UseBlockCache = true;
+
 public:
     /**
      * @brief Constructs a BufferIO object with a filename and allocator.
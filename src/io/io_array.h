@@ -52,7 +52,8 @@ public:
         non_continuous_allocator_ = std::make_unique<NonContinuousAllocator>(allocator);
         using ArgsTuple = std::tuple<std::decay_t<Args>...>;
         ArgsTuple args_tuple(std::forward<Args>(args)...);
-        if constexpr (InMemory) {
+        // reader backed IO objects only view serialized data, they never need fresh regions
+        if constexpr (InMemory or IOTmpl::SkipDeserialize) {
             io_create_func_ = [args_tuple =
                                    std::move(args_tuple)]() mutable -> std::shared_ptr<IOTmpl> {
                 return std::apply(
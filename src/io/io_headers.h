@@ -18,6 +18,7 @@
 #include "async_io.h"
 #include "basic_io.h"
 #include "buffer_io.h"
+#include "io_uring_io.h"
 #include "memory_block_io.h"
 #include "memory_io.h"
 #include "mmap_io.h"
@@ -21,6 +21,7 @@
 #include "buffer_io_parameter.h"
 #include "impl/logger/logger.h"
 #include "inner_string_params.h"
+#include "io_uring_io_parameter.h"
 #include "memory_block_io_parameter.h"
 #include "memory_io_parameter.h"
 #include "mmap_io_parameter.h"
@@ -30,6 +31,7 @@ namespace vsag {
 
 namespace {
 std::once_flag async_io_fallback_warn_once;
+std::once_flag io_uring_io_fallback_warn_once;
 }  // namespace
 
 IOParamPtr
@@ -54,6 +56,16 @@ IOParameter::GetIOParameterByJson(const JsonType& json) {
                 logger::warn("libaio is unavailable, async_io is falling back to buffer_io");
             });
             io_ptr = std::make_shared<BufferIOParameter>();
+#endif
+            io_ptr->FromJson(json);
+        } else if (type_name == IO_TYPE_VALUE_IO_URING_IO) {
+#if HAVE_IO_URING
+            io_ptr = std::make_shared<IOUringIOParameter>();
+#else
+            std::call_once(io_uring_io_fallback_warn_once, []() {
+                logger::warn("io_uring is unavailable, io_uring_io is falling back to buffer_io");
+            });
+            io_ptr = std::make_shared<BufferIOParameter>();
 #endif
             io_ptr->FromJson(json);
         } else if (type_name == IO_TYPE_VALUE_MMAP_IO) {
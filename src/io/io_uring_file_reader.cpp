@@ -0,0 +1,101 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if HAVE_IO_URING
+
+#include "io_uring_file_reader.h"
+
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "impl/thread_pool/safe_thread_pool.h"
+#include "vsag_exception.h"
+
+namespace vsag {
+
+IOUringFileReader::IOUringFileReader(const std::string& filename,
+                                     int64_t base_offset,
+                                     int64_t size,
+                                     std::shared_ptr<IOUringRing> ring)
+    : base_offset_(base_offset), size_(size), ring_(std::move(ring)) {
+    // buffered reads, DiskANN sectors are hot enough to profit from the page cache
+    fd_ = open(filename.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        throw VsagException(ErrorType::READ_ERROR,
+                            fmt::format("open file {} error {}", filename, strerror(errno)));
+    }
+    fixed_slot_ = ring_->RegisterFile(fd_);
+}
+
+IOUringFileReader::~IOUringFileReader() {
+    ring_->UnregisterFile(fixed_slot_);
+    close(fd_);
+}
+
+void
+IOUringFileReader::Read(uint64_t offset, uint64_t len, void* dest) {
+    IOUringRing::ReadRequest request{static_cast<uint8_t*>(dest), len, base_offset_ + offset};
+    if (not ring_->Read(fd_, fixed_slot_, &request, 1, false)) {
+        throw VsagException(ErrorType::READ_ERROR,
+                            fmt::format("io_uring read failed at offset {}", offset));
+    }
+}
+
+void
+IOUringFileReader::AsyncRead(uint64_t offset, uint64_t len, void* dest, CallBack callback) {
+    {
+        std::scoped_lock lock(pool_mutex_);
+        if (not pool_) {
+            pool_ = SafeThreadPool::FactoryDefaultThreadPool();
+        }
+    }
+    pool_->GeneralEnqueue([this, offset, len, dest, callback]() {
+        IOUringRing::ReadRequest request{static_cast<uint8_t*>(dest), len, base_offset_ + offset};
+        if (ring_->Read(fd_, fixed_slot_, &request, 1, false)) {
+            callback(IOErrorCode::IO_SUCCESS, "success");
+        } else {
+            callback(IOErrorCode::IO_ERROR, "io_uring read failed");
+        }
+    });
+}
+
+bool
+IOUringFileReader::MultiRead(uint8_t* dests,
+                             const uint64_t* lens,
+                             const uint64_t* offsets,
+                             uint64_t count) {
+    std::vector<IOUringRing::ReadRequest> requests(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        requests[i] = {dests, lens[i], base_offset_ + offsets[i]};
+        dests += lens[i];
+    }
+    return ring_->Read(fd_, fixed_slot_, requests.data(), count, false);
+}
+
+bool
+IOUringFileReader::BatchRead(const BatchRequest& requests) {
+    std::vector<IOUringRing::ReadRequest> ring_requests(requests.size());
+    for (uint64_t i = 0; i < requests.size(); ++i) {
+        const auto& [offset, len, dest] = requests[i];
+        ring_requests[i] = {static_cast<uint8_t*>(dest), len, base_offset_ + offset};
+    }
+    return ring_->Read(fd_, fixed_slot_, ring_requests.data(), ring_requests.size(), false);
+}
+
+}  // namespace vsag
+
+#endif  // HAVE_IO_URING
@@ -0,0 +1,93 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#if HAVE_IO_URING
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "io_uring_ring.h"
+#include "vsag/readerset.h"
+
+namespace vsag {
+
+class SafeThreadPool;
+
+/**
+ * @brief A file Reader whose reads go through the shared IOUringRing.
+ *
+ * DiskANN recognizes it and issues the sector reads of a beam search step as one batch, so
+ * concurrent searches share one ring instead of a pool task and a pread per sector.
+ */
+class IOUringFileReader : public Reader {
+public:
+    using BatchRequest = std::vector<std::tuple<uint64_t, uint64_t, void*>>;
+
+public:
+    /**
+     * @brief Opens filename, throws a VsagException when it can not be opened.
+     *
+     * @param ring The ring serving the reads, must not be nullptr.
+     */
+    IOUringFileReader(const std::string& filename,
+                      int64_t base_offset,
+                      int64_t size,
+                      std::shared_ptr<IOUringRing> ring);
+
+    ~IOUringFileReader() override;
+
+    void
+    Read(uint64_t offset, uint64_t len, void* dest) override;
+
+    void
+    AsyncRead(uint64_t offset, uint64_t len, void* dest, CallBack callback) override;
+
+    bool
+    MultiRead(uint8_t* dests,
+              const uint64_t* lens,
+              const uint64_t* offsets,
+              uint64_t count) override;
+
+    /**
+     * @brief Reads every (offset, len, dest) of requests with one submission.
+     *
+     * @return True if all reads succeeded.
+     */
+    bool
+    BatchRead(const BatchRequest& requests);
+
+    [[nodiscard]] uint64_t
+    Size() const override {
+        return size_;
+    }
+
+private:
+    int fd_{-1};
+    int fixed_slot_{-1};
+    const uint64_t base_offset_;
+    const uint64_t size_;
+    std::shared_ptr<IOUringRing> ring_;
+
+    std::mutex pool_mutex_;
+    std::shared_ptr<SafeThreadPool> pool_{nullptr};
+};
+
+}  // namespace vsag
+
+#endif  // HAVE_IO_URING
@@ -0,0 +1,162 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if HAVE_IO_URING
+
+#include "io_uring_io.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <filesystem>
+
+#include "direct_io_object.h"
+#include "io_syscall.h"
+
+namespace vsag {
+
+IOUringIO::IOUringIO(std::string filename, Allocator* allocator, bool sqpoll)
+    : BasicIO<IOUringIO>(allocator), filepath_(std::move(filename)) {
+    this->exist_file_ = std::filesystem::exists(this->filepath_);
+    if (std::filesystem::is_directory(this->filepath_)) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            fmt::format("{} is a directory", this->filepath_));
+    }
+    this->rfd_ = open(filepath_.c_str(), O_CREAT | O_RDWR | O_DIRECT, 0644);
+    if (this->rfd_ < 0) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            fmt::format("open file {} error {}", this->filepath_, strerror(errno)));
+    }
+    this->wfd_ = open(filepath_.c_str(), O_CREAT | O_RDWR, 0644);
+    if (this->wfd_ < 0) {
+        close(this->rfd_);
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            fmt::format("open file {} error {}", this->filepath_, strerror(errno)));
+    }
+    this->ring_ = IOUringRing::GetShared(sqpoll);
+    if (this->ring_ != nullptr) {
+        this->fixed_slot_ = this->ring_->RegisterFile(this->rfd_);
+    }
+}
+
+IOUringIO::IOUringIO(const IOUringIOParameterPtr& io_param, const IndexCommonParam& common_param)
+    : IOUringIO(io_param->path_, common_param.allocator_.get(), io_param->sqpoll_){};
+
+IOUringIO::IOUringIO(const IOParamPtr& param, const IndexCommonParam& common_param)
+    : IOUringIO(std::dynamic_pointer_cast<IOUringIOParameter>(param), common_param){};
+
+IOUringIO::~IOUringIO() {
+    if (this->ring_ != nullptr) {
+        this->ring_->UnregisterFile(this->fixed_slot_);
+    }
+    close(this->wfd_);
+    close(this->rfd_);
+    // remove file
+    if (not this->exist_file_) {
+        std::filesystem::remove(this->filepath_);
+    }
+}
+
+void
+IOUringIO::WriteImpl(const uint8_t* data, uint64_t size, uint64_t offset) {
+    auto ret = IOSyscall::PWrite(this->wfd_, data, size, offset);
+    if (ret != static_cast<ssize_t>(size)) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            fmt::format("write bytes {} less than {}", ret, size));
+    }
+    this->grow_size(size + offset);
+    fsync(wfd_);
+}
+
+void
+IOUringIO::ResizeImpl(uint64_t size) {
+    auto ret = IOSyscall::FTruncate(this->wfd_, size);
+    if (ret == -1) {
+        throw VsagException(ErrorType::INTERNAL_ERROR, "ftruncate failed");
+    }
+    this->set_size(size);
+}
+
+bool
+IOUringIO::ReadImpl(uint64_t size, uint64_t offset, uint8_t* data) const {
+    if (size == 0) {
+        return true;
+    }
+    IOUringRing::ReadRequest request{data, size, offset};
+    return this->read_requests(&request, 1);
+}
+
+const uint8_t*
+IOUringIO::DirectReadImpl(uint64_t size, uint64_t offset, bool& need_release) const {
+    if (not check_valid_offset(size + offset)) {
+        return nullptr;
+    }
+    need_release = true;
+    if (size == 0) {
+        return nullptr;
+    }
+    // a single read gains nothing from the ring
+    DirectIOObject obj(size, offset);
+    auto ret = IOSyscall::PRead(this->rfd_, obj.align_data, obj.size, obj.offset);
+    if (ret < 0) {
+        obj.Release();
+        throw VsagException(ErrorType::INTERNAL_ERROR, fmt::format("pread error {}", ret));
+    }
+    return obj.data;
+}
+
+void
+IOUringIO::ReleaseImpl(const uint8_t* data) {
+    auto* ptr = const_cast<uint8_t*>(data);
+    uint64_t align_bit = Options::Instance().direct_IO_object_align_bit();
+    auto raw = reinterpret_cast<uintptr_t>(ptr);
+    raw &= ~((1ULL << align_bit) - 1);
+    // NOLINTNEXTLINE(performance-no-int-to-ptr)
+    free(reinterpret_cast<void*>(raw));
+}
+
+bool
+IOUringIO::MultiReadImpl(uint8_t* datas, uint64_t* sizes, uint64_t* offsets, uint64_t count) const {
+    std::vector<IOUringRing::ReadRequest> requests(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        requests[i] = {datas, sizes[i], offsets[i]};
+        datas += sizes[i];
+    }
+    return this->read_requests(requests.data(), count);
+}
+
+bool
+IOUringIO::read_requests(const IOUringRing::ReadRequest* requests, uint64_t count) const {
+    if (this->ring_ != nullptr) {
+        if (not this->ring_->Read(this->rfd_, this->fixed_slot_, requests, count, true)) {
+            throw VsagException(ErrorType::INTERNAL_ERROR, "io_uring read failed");
+        }
+        return true;
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        DirectIOObject obj(requests[i].size, requests[i].offset);
+        auto ret = IOSyscall::PRead(this->rfd_, obj.align_data, obj.size, obj.offset);
+        if (ret < 0) {
+            obj.Release();
+            throw VsagException(ErrorType::INTERNAL_ERROR, fmt::format("pread error {}", ret));
+        }
+        memcpy(requests[i].dest, obj.data, requests[i].size);
+        obj.Release();
+    }
+    return true;
+}
+
+}  // namespace vsag
+
+#endif  // HAVE_IO_URING
@@ -0,0 +1,167 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#if HAVE_IO_URING
+#include "basic_io.h"
+#include "index_common_param.h"
+#include "io_uring_io_parameter.h"
+#include "io_uring_ring.h"
+namespace vsag {
+
+/**
+ * @brief Asynchronous IO implementation using Linux io_uring.
+ *
+ * Reads go through the process-wide IOUringRing: a MultiRead is one batched submission, and
+ * the reads of concurrent searches share the ring. The read descriptor is opened with O_DIRECT
+ * and registered as a fixed file. When the kernel refuses io_uring, reads fall back to pread.
+ * When io_uring is not available at build time, this class is aliased to BufferIO.
+ */
+class IOUringIO : public BasicIO<IOUringIO> {
+public:
+    /// Indicates this is not an in-memory IO implementation.
+    static constexpr bool InMemory = false;
+
+    /// Indicates deserialization is required when loading from disk.
+    static constexpr bool SkipDeserialize = false;
+
+    /// Indicates growing must not run concurrently with readers.
+    static constexpr bool ConcurrentResize = false;
+
+    /// Indicates reads may be served from a BlockCache.
+    static constexpr bool UseBlockCache = true;
+
+public:
+    /**
+     * @brief Constructs an IOUringIO object with a filename and allocator.
+     *
+     * @param filename The path to the file for IO operations.
+     * @param allocator A pointer to the Allocator for memory management.
+     * @param sqpoll Whether the shared ring polls its submission queue from a kernel thread.
+     */
+    explicit IOUringIO(std::string filename, Allocator* allocator, bool sqpoll = false);
+
+    /**
+     * @brief Constructs an IOUringIO object from IOUringIOParameter.
+     *
+     * @param io_param The IO parameter containing configuration.
+     * @param common_param The common index parameters.
+     */
+    explicit IOUringIO(const IOUringIOParameterPtr& io_param, const IndexCommonParam& common_param);
+
+    /**
+     * @brief Constructs an IOUringIO object from generic IOParamPtr.
+     *
+     * @param param The generic IO parameter pointer.
+     * @param common_param The common index parameters.
+     */
+    explicit IOUringIO(const IOParamPtr& param, const IndexCommonParam& common_param);
+
+    /**
+     * @brief Destructor that closes file descriptors and optionally removes the file.
+     */
+    ~IOUringIO() override;
+
+public:
+    /**
+     * @brief Writes data to the file at a specified offset.
+     *
+     * @param data A pointer to the data to be written.
+     * @param size The size of the data to be written.
+     * @param offset The offset at which to write the data.
+     */
+    void
+    WriteImpl(const uint8_t* data, uint64_t size, uint64_t offset);
+
+    /**
+     * @brief Resizes the file to a specified size.
+     *
+     * @param size The new size of the file.
+     */
+    void
+    ResizeImpl(uint64_t size);
+
+    /**
+     * @brief Reads data from the file at a specified offset.
+     *
+     * @param size The size of the data to be read.
+     * @param offset The offset at which to read the data.
+     * @param data A pointer to the buffer where the read data will be stored.
+     * @return True if the read operation was successful, false otherwise.
+     */
+    bool
+    ReadImpl(uint64_t size, uint64_t offset, uint8_t* data) const;
+
+    /**
+     * @brief Reads data into an allocated aligned buffer and returns a pointer to it.
+     *
+     * @param size The size of the data to be read.
+     * @param offset The offset at which to read the data.
+     * @param need_release Set to true, indicating the returned buffer must be released by caller.
+     * @return A pointer to the allocated buffer containing the read data.
+     */
+    [[nodiscard]] const uint8_t*
+    DirectReadImpl(uint64_t size, uint64_t offset, bool& need_release) const;
+
+    /**
+     * @brief Releases data previously read from the file.
+     *
+     * @param data A pointer to the data to be released.
+     */
+    static void
+    ReleaseImpl(const uint8_t* data);
+
+    /**
+     * @brief Reads multiple blocks of data into a contiguous buffer with one ring submission.
+     *
+     * @param datas A pointer to a contiguous buffer where all read data will be stored sequentially.
+     * @param sizes An array of sizes for each block of data to be read.
+     * @param offsets An array of offsets for each block of data to be read.
+     * @param count The number of blocks of data to be read.
+     * @return True if the read operation was successful, false otherwise.
+     */
+    bool
+    MultiReadImpl(uint8_t* datas, uint64_t* sizes, uint64_t* offsets, uint64_t count) const;
+
+private:
+    bool
+    read_requests(const IOUringRing::ReadRequest* requests, uint64_t count) const;
+
+private:
+    /// Path to the file used for IO operations.
+    std::string filepath_{};
+
+    /// File descriptor for reading operations, opened with O_DIRECT.
+    int rfd_{-1};
+
+    /// File descriptor for writing operations.
+    int wfd_{-1};
+
+    /// Flag indicating if file existed before opening; false means file will be removed on destruction.
+    bool exist_file_{false};
+
+    /// The shared ring, nullptr when io_uring is refused at runtime.
+    std::shared_ptr<IOUringRing> ring_{nullptr};
+
+    /// Fixed file slot of rfd_ in ring_, -1 when not registered.
+    int fixed_slot_{-1};
+};
+
+}  // namespace vsag
+
+#else
+#include "buffer_io.h"
+#define IOUringIO BufferIO
+#endif  // HAVE_IO_URING
@@ -0,0 +1,45 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "io_uring_io_parameter.h"
+
+#include "inner_string_params.h"
+
+namespace vsag {
+
+IOUringIOParameter::IOUringIOParameter() : IOParameter(IO_TYPE_VALUE_IO_URING_IO) {
+}
+
+IOUringIOParameter::IOUringIOParameter(const vsag::JsonType& json) : IOUringIOParameter() {
+    this->FromJson(json);  // NOLINT(clang-analyzer-optin.cplusplus.VirtualCall)
+}
+
+void
+IOUringIOParameter::FromJson(const JsonType& json) {
+    CHECK_ARGUMENT(json.Contains(IO_FILE_PATH_KEY), "miss file_path param in io_uring io type");
+    this->path_ = json[IO_FILE_PATH_KEY].GetString();
+    if (json.Contains(IO_URING_SQPOLL_KEY)) {
+        this->sqpoll_ = json[IO_URING_SQPOLL_KEY].GetBool();
+    }
+}
+
+JsonType
+IOUringIOParameter::ToJson() const {
+    JsonType json;
+    json[TYPE_KEY].SetString(IO_TYPE_VALUE_IO_URING_IO);
+    json[IO_FILE_PATH_KEY].SetString(this->path_);
+    json[IO_URING_SQPOLL_KEY].SetBool(this->sqpoll_);
+    return json;
+}
+}  // namespace vsag
@@ -0,0 +1,40 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "io_parameter.h"
+#include "utils/pointer_define.h"
+
+namespace vsag {
+DEFINE_POINTER(IOUringIOParameter);
+class IOUringIOParameter : public IOParameter {
+public:
+    IOUringIOParameter();
+
+    explicit IOUringIOParameter(const JsonType& json);
+
+    void
+    FromJson(const JsonType& json) override;
+
+    JsonType
+    ToJson() const override;
+
+public:
+    std::string path_{};
+
+    // poll the submission queue from a kernel thread instead of one syscall per batch
+    bool sqpoll_{false};
+};
+}  // namespace vsag
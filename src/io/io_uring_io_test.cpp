@@ -0,0 +1,120 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "io_uring_io.h"
+
+#include <memory>
+#include <thread>
+
+#include "basic_io_test.h"
+#include "buffer_io_parameter.h"
+#include "impl/allocator/safe_allocator.h"
+#include "io_uring_io_parameter.h"
+#include "unittest.h"
+
+using namespace vsag;
+
+TEST_CASE("IOUringIO Read And Write", "[ut][IOUringIO]") {
+    fixtures::TempDir dir("io_uring_io");
+    auto path = dir.GenerateRandomFile(false);
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    TestDistIOWrongInit<IOUringIO>(allocator.get());
+    auto io = std::make_unique<IOUringIO>(path, allocator.get());
+    TestBasicReadWrite(*io);
+
+    // read zero
+    bool need_release = false;
+    auto result = io->DirectReadImpl(0, 0, need_release);
+    REQUIRE(result == nullptr);
+
+    // in memory
+    REQUIRE(IOUringIO::InMemory == false);
+}
+
+TEST_CASE("IOUringIO Parameter", "[ut][IOUringIO]") {
+    fixtures::TempDir dir("io_uring_io");
+    auto path = dir.GenerateRandomFile();
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    constexpr const char* param_str = R"(
+    {{
+        "type": "io_uring_io",
+        "file_path" : "{}",
+        "sqpoll": {}
+    }}
+    )";
+    auto sqpoll = GENERATE(false, true);
+    auto json = JsonType::Parse(fmt::format(param_str, path, sqpoll));
+    auto io_param = IOParameter::GetIOParameterByJson(json);
+#if HAVE_IO_URING
+    REQUIRE(std::dynamic_pointer_cast<IOUringIOParameter>(io_param) != nullptr);
+    REQUIRE(io_param->ToJson()["type"].GetString() == "io_uring_io");
+    REQUIRE(io_param->ToJson()["sqpoll"].GetBool() == sqpoll);
+#else
+    REQUIRE(std::dynamic_pointer_cast<BufferIOParameter>(io_param) != nullptr);
+    REQUIRE(io_param->ToJson()["type"].GetString() == "buffer_io");
+#endif
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    auto io = std::make_unique<IOUringIO>(io_param, common_param);
+    TestBasicReadWrite(*io);
+}
+
+TEST_CASE("IOUringIO Serialize & Deserialize", "[ut][IOUringIO]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    fixtures::TempDir dir("io_uring_io");
+    auto path1 = dir.GenerateRandomFile();
+    auto path2 = dir.GenerateRandomFile();
+    auto wio = std::make_unique<IOUringIO>(path1, allocator.get());
+    auto rio = std::make_unique<IOUringIO>(path2, allocator.get());
+    TestSerializeAndDeserialize(*wio, *rio);
+}
+
+TEST_CASE("IOUringIO Concurrent MultiRead", "[ut][IOUringIO]") {
+    fixtures::TempDir dir("io_uring_io");
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto io = std::make_unique<IOUringIO>(dir.GenerateRandomFile(false), allocator.get());
+    constexpr uint64_t item_size = 1000;
+    constexpr uint64_t item_count = 2000;
+    std::vector<uint8_t> content(item_size * item_count);
+    for (uint64_t i = 0; i < content.size(); ++i) {
+        content[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    io->Write(content.data(), content.size(), 0);
+
+    // more reads in flight than ring entries, from several threads at once
+    std::vector<std::thread> threads;
+    std::atomic<uint64_t> mismatches{0};
+    for (uint64_t t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t]() {
+            std::vector<uint64_t> sizes(item_count, item_size);
+            std::vector<uint64_t> offsets(item_count);
+            for (uint64_t i = 0; i < item_count; ++i) {
+                offsets[i] = ((i * 7 + t) % item_count) * item_size;
+            }
+            std::vector<uint8_t> datas(item_size * item_count);
+            io->MultiRead(datas.data(), sizes.data(), offsets.data(), item_count);
+            for (uint64_t i = 0; i < item_count; ++i) {
+                if (memcmp(datas.data() + i * item_size,
+                           content.data() + offsets[i],
+                           item_size) != 0) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(mismatches == 0);
+}
@@ -0,0 +1,451 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#if HAVE_IO_URING
+
+#include "io_uring_ring.h"
+
+#include <fmt/format.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "impl/logger/logger.h"
+#include "vsag/options.h"
+#include "vsag_exception.h"
+
+namespace vsag {
+
+namespace {
+
+int
+io_uring_setup(uint32_t entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int
+io_uring_register(int fd, uint32_t opcode, const void* arg, uint32_t nr_args) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+inline uint32_t
+load_acquire(const uint32_t* ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+}
+
+inline void
+store_release(uint32_t* ptr, uint32_t value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+}
+
+bool
+is_transient(int err) {
+    return err == EINTR or err == EAGAIN or err == EBUSY;
+}
+
+}  // namespace
+
+std::shared_ptr<IOUringRing>
+IOUringRing::GetShared(bool sqpoll) {
+    static std::mutex mutex;
+    static std::shared_ptr<IOUringRing> rings[2];
+    static bool unavailable = false;
+
+    std::lock_guard lock(mutex);
+    auto& ring = rings[sqpoll ? 1 : 0];
+    if (ring == nullptr and not unavailable) {
+        try {
+            ring = std::make_shared<IOUringRing>(DEFAULT_QUEUE_DEPTH, sqpoll);
+        } catch (const VsagException& e) {
+            logger::warn(fmt::format("io_uring is unavailable, falling back to pread: {}",
+                                     e.error_.message));
+            unavailable = true;
+        }
+    }
+    return ring;
+}
+
+IOUringRing::IOUringRing(uint32_t queue_depth, bool sqpoll) {
+    io_uring_params params{};
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = queue_depth * 2;
+    if (sqpoll) {
+        params.flags |= IORING_SETUP_SQPOLL;
+        params.sq_thread_idle = 1000;
+    }
+    ring_fd_ = io_uring_setup(queue_depth, &params);
+    if (ring_fd_ < 0 and sqpoll) {
+        // unprivileged SQPOLL needs kernel 5.11
+        logger::warn(fmt::format("io_uring SQPOLL setup failed ({}), using a plain ring",
+                                 strerror(errno)));
+        params = io_uring_params{};
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = queue_depth * 2;
+        ring_fd_ = io_uring_setup(queue_depth, &params);
+    }
+    if (ring_fd_ < 0) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            fmt::format("io_uring_setup failed: {}", strerror(errno)));
+    }
+    sqpoll_ = (params.flags & IORING_SETUP_SQPOLL) != 0;
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        cq_ring_size_ = sq_ring_size_;
+    }
+    auto* sq_ring = mmap(nullptr,
+                         sq_ring_size_,
+                         PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE,
+                         ring_fd_,
+                         IORING_OFF_SQ_RING);
+    void* cq_ring = single_mmap ? sq_ring
+                                : mmap(nullptr,
+                                       cq_ring_size_,
+                                       PROT_READ | PROT_WRITE,
+                                       MAP_SHARED | MAP_POPULATE,
+                                       ring_fd_,
+                                       IORING_OFF_CQ_RING);
+    auto* sqes = mmap(nullptr,
+                      params.sq_entries * sizeof(io_uring_sqe),
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE,
+                      ring_fd_,
+                      IORING_OFF_SQES);
+    if (sq_ring == MAP_FAILED or cq_ring == MAP_FAILED or sqes == MAP_FAILED) {
+        auto message = fmt::format("io_uring mmap failed: {}", strerror(errno));
+        if (sq_ring != MAP_FAILED) {
+            munmap(sq_ring, sq_ring_size_);
+        }
+        if (not single_mmap and cq_ring != MAP_FAILED) {
+            munmap(cq_ring, cq_ring_size_);
+        }
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, params.sq_entries * sizeof(io_uring_sqe));
+        }
+        close(ring_fd_);
+        throw VsagException(ErrorType::INTERNAL_ERROR, message);
+    }
+
+    sq_ring_ = static_cast<uint8_t*>(sq_ring);
+    sq_head_ = reinterpret_cast<uint32_t*>(sq_ring_ + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<uint32_t*>(sq_ring_ + params.sq_off.tail);
+    sq_flags_ = reinterpret_cast<uint32_t*>(sq_ring_ + params.sq_off.flags);
+    sq_array_ = reinterpret_cast<uint32_t*>(sq_ring_ + params.sq_off.array);
+    sq_mask_ = *reinterpret_cast<uint32_t*>(sq_ring_ + params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    cq_ring_ = static_cast<uint8_t*>(cq_ring);
+    cq_head_ = reinterpret_cast<uint32_t*>(cq_ring_ + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<uint32_t*>(cq_ring_ + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<uint32_t*>(cq_ring_ + params.cq_off.ring_mask);
+    cq_entries_ = params.cq_entries;
+    cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ring_ + params.cq_off.cqes);
+
+    this->setup_fixed_files();
+    this->setup_fixed_buffers();
+}
+
+IOUringRing::~IOUringRing() {
+    // closing the ring fd releases the registered files and buffers
+    munmap(sqes_, sq_entries_ * sizeof(io_uring_sqe));
+    if (cq_ring_ != sq_ring_) {
+        munmap(cq_ring_, cq_ring_size_);
+    }
+    munmap(sq_ring_, sq_ring_size_);
+    close(ring_fd_);
+    if (fixed_buffers_ != nullptr) {
+        munmap(fixed_buffers_, fixed_buffers_size_);
+    }
+}
+
+void
+IOUringRing::setup_fixed_files() {
+    std::vector<int> fds(FIXED_FILE_COUNT, -1);
+    if (io_uring_register(ring_fd_, IORING_REGISTER_FILES, fds.data(), FIXED_FILE_COUNT) < 0) {
+        logger::debug(fmt::format("io_uring fixed files are unavailable: {}", strerror(errno)));
+        return;
+    }
+    fixed_files_ = std::move(fds);
+}
+
+void
+IOUringRing::setup_fixed_buffers() {
+    auto size = FIXED_BUFFER_SIZE * sq_entries_;
+    auto* buffers =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffers == MAP_FAILED) {
+        return;
+    }
+    std::vector<iovec> iovecs(sq_entries_);
+    for (uint32_t i = 0; i < sq_entries_; ++i) {
+        iovecs[i].iov_base = static_cast<uint8_t*>(buffers) + i * FIXED_BUFFER_SIZE;
+        iovecs[i].iov_len = FIXED_BUFFER_SIZE;
+    }
+    if (io_uring_register(ring_fd_, IORING_REGISTER_BUFFERS, iovecs.data(), sq_entries_) < 0) {
+        // usually RLIMIT_MEMLOCK, direct reads then bounce through malloc buffers
+        logger::debug(
+            fmt::format("io_uring fixed buffers are unavailable: {}", strerror(errno)));
+        munmap(buffers, size);
+        return;
+    }
+    fixed_buffers_ = static_cast<uint8_t*>(buffers);
+    fixed_buffers_size_ = size;
+    free_buffers_.reserve(sq_entries_);
+    for (int i = static_cast<int>(sq_entries_) - 1; i >= 0; --i) {
+        free_buffers_.emplace_back(i);
+    }
+}
+
+int
+IOUringRing::RegisterFile(int fd) {
+    std::lock_guard lock(files_mutex_);
+    for (uint32_t slot = 0; slot < fixed_files_.size(); ++slot) {
+        if (fixed_files_[slot] != -1) {
+            continue;
+        }
+        io_uring_files_update update{};
+        update.offset = slot;
+        update.fds = reinterpret_cast<uint64_t>(&fd);
+        if (io_uring_register(ring_fd_, IORING_REGISTER_FILES_UPDATE, &update, 1) != 1) {
+            return -1;
+        }
+        fixed_files_[slot] = fd;
+        return static_cast<int>(slot);
+    }
+    return -1;
+}
+
+void
+IOUringRing::UnregisterFile(int slot) {
+    if (slot < 0) {
+        return;
+    }
+    std::lock_guard lock(files_mutex_);
+    int fd = -1;
+    io_uring_files_update update{};
+    update.offset = static_cast<uint32_t>(slot);
+    update.fds = reinterpret_cast<uint64_t>(&fd);
+    io_uring_register(ring_fd_, IORING_REGISTER_FILES_UPDATE, &update, 1);
+    fixed_files_[slot] = -1;
+}
+
+int
+IOUringRing::take_fixed_buffer() {
+    std::lock_guard lock(buffers_mutex_);
+    if (free_buffers_.empty()) {
+        return -1;
+    }
+    auto index = free_buffers_.back();
+    free_buffers_.pop_back();
+    return index;
+}
+
+void
+IOUringRing::return_fixed_buffer(int index) {
+    std::lock_guard lock(buffers_mutex_);
+    free_buffers_.emplace_back(index);
+}
+
+bool
+IOUringRing::Read(int fd, int slot, const ReadRequest* requests, uint64_t count, bool direct) {
+    if (count == 0) {
+        return true;
+    }
+    Batch batch;
+    batch.pending.store(count, std::memory_order_relaxed);
+    std::vector<Inflight> items(count);
+    uint64_t align_bit = Options::Instance().direct_IO_object_align_bit();
+    uint64_t align_mask = (1ULL << align_bit) - 1;
+    for (uint64_t i = 0; i < count; ++i) {
+        auto& item = items[i];
+        item.batch = &batch;
+        item.request = requests[i];
+        if (not direct) {
+            item.buffer = requests[i].dest;
+            item.size = requests[i].size;
+            item.offset = requests[i].offset;
+            continue;
+        }
+        item.offset = requests[i].offset & ~align_mask;
+        auto end = requests[i].offset + requests[i].size;
+        item.size = (end - item.offset + align_mask) & ~align_mask;
+        if (item.size <= FIXED_BUFFER_SIZE) {
+            item.buffer_index = this->take_fixed_buffer();
+        }
+        if (item.buffer_index >= 0) {
+            item.buffer = fixed_buffers_ + item.buffer_index * FIXED_BUFFER_SIZE;
+        } else {
+            item.buffer = static_cast<uint8_t*>(std::aligned_alloc(1ULL << align_bit, item.size));
+        }
+    }
+
+    uint64_t submitted = 0;
+    try {
+        while (submitted < count) {
+            auto ret = this->submit(fd, slot, items.data() + submitted, count - submitted);
+            if (ret == 0) {
+                // the queue is full, or the kernel is short of resources
+                this->wait_step();
+            }
+            submitted += ret;
+        }
+    } catch (const VsagException& e) {
+        // the submitted reads still point into items, wait for them before failing
+        logger::error(e.error_.message);
+        for (auto i = submitted; i < count; ++i) {
+            items[i].result = -EIO;
+        }
+        batch.pending.fetch_sub(count - submitted, std::memory_order_release);
+    }
+    while (batch.pending.load(std::memory_order_acquire) > 0) {
+        this->wait_step();
+    }
+
+    bool succeed = true;
+    for (auto& item : items) {
+        auto needed = item.request.offset + item.request.size - item.offset;
+        if (item.result < 0 or static_cast<uint64_t>(item.result) < needed) {
+            succeed = false;
+        } else if (direct) {
+            memcpy(item.request.dest,
+                   item.buffer + (item.request.offset - item.offset),
+                   item.request.size);
+        }
+        if (item.buffer_index >= 0) {
+            this->return_fixed_buffer(item.buffer_index);
+        } else if (direct) {
+            free(item.buffer);
+        }
+    }
+    return succeed;
+}
+
+uint64_t
+IOUringRing::submit(int fd, int slot, Inflight* items, uint64_t count) {
+    std::lock_guard lock(sq_mutex_);
+    auto head = load_acquire(sq_head_);
+    auto tail = *sq_tail_;
+    uint64_t capacity = sq_entries_ - (tail - head);
+    auto inflight = inflight_.load(std::memory_order_acquire);
+    capacity = std::min<uint64_t>(capacity, cq_entries_ > inflight ? cq_entries_ - inflight : 0);
+    auto to_submit = static_cast<uint32_t>(std::min(capacity, count));
+    if (to_submit == 0) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < to_submit; ++i) {
+        auto& item = items[i];
+        auto index = (tail + i) & sq_mask_;
+        auto* sqe = sqes_ + index;
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = item.buffer_index >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe->fd = slot >= 0 ? slot : fd;
+        sqe->flags = slot >= 0 ? IOSQE_FIXED_FILE : 0;
+        sqe->off = item.offset;
+        sqe->addr = reinterpret_cast<uint64_t>(item.buffer);
+        sqe->len = static_cast<uint32_t>(item.size);
+        sqe->buf_index = item.buffer_index >= 0 ? static_cast<uint16_t>(item.buffer_index) : 0;
+        sqe->user_data = reinterpret_cast<uint64_t>(&item);
+        sq_array_[index] = index;
+    }
+    store_release(sq_tail_, tail + to_submit);
+
+    if (sqpoll_) {
+        inflight_.fetch_add(to_submit, std::memory_order_release);
+        // the tail store must be visible before the flags are read
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if ((load_acquire(sq_flags_) & IORING_SQ_NEED_WAKEUP) != 0) {
+            this->enter(0, 0, IORING_ENTER_SQ_WAKEUP);
+        }
+        return to_submit;
+    }
+
+    uint32_t consumed = 0;
+    while (consumed < to_submit) {
+        auto ret = this->enter(to_submit - consumed, 0, 0);
+        if (ret > 0) {
+            consumed += ret;
+        } else if (ret < 0 and errno == EINTR) {
+            continue;
+        } else {
+            break;
+        }
+    }
+    if (consumed < to_submit) {
+        auto err = errno;
+        // nobody but this thread feeds the kernel, the unconsumed entries can be taken back
+        store_release(sq_tail_, tail + consumed);
+        if (consumed == 0 and not is_transient(err)) {
+            throw VsagException(ErrorType::INTERNAL_ERROR,
+                                fmt::format("io_uring_enter failed: {}", strerror(err)));
+        }
+    }
+    inflight_.fetch_add(consumed, std::memory_order_release);
+    return consumed;
+}
+
+void
+IOUringRing::wait_step() {
+    std::lock_guard lock(cq_mutex_);
+    if (this->reap() > 0 or inflight_.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+    // only one thread waits in the kernel, it reaps the completions of every batch
+    auto ret = this->enter(0, 1, IORING_ENTER_GETEVENTS);
+    if (ret < 0 and not is_transient(errno)) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            fmt::format("io_uring_enter failed: {}", strerror(errno)));
+    }
+    this->reap();
+}
+
+uint64_t
+IOUringRing::reap() {
+    auto head = *cq_head_;
+    auto tail = load_acquire(cq_tail_);
+    uint64_t reaped = 0;
+    while (head != tail) {
+        const auto& cqe = cqes_[head & cq_mask_];
+        auto* item = reinterpret_cast<Inflight*>(cqe.user_data);
+        item->result = cqe.res;
+        // the owner may free item as soon as pending drops, item is not touched afterwards
+        item->batch->pending.fetch_sub(1, std::memory_order_release);
+        ++head;
+        ++reaped;
+    }
+    if (reaped > 0) {
+        store_release(cq_head_, head);
+        inflight_.fetch_sub(reaped, std::memory_order_release);
+    }
+    return reaped;
+}
+
+int
+IOUringRing::enter(uint32_t to_submit, uint32_t min_complete, uint32_t flags) const {
+    return static_cast<int>(
+        syscall(__NR_io_uring_enter, ring_fd_, to_submit, min_complete, flags, nullptr, 0));
+}
+
+}  // namespace vsag
+
+#endif  // HAVE_IO_URING
@@ -0,0 +1,190 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#if HAVE_IO_URING
+
+#include <linux/io_uring.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vsag {
+
+/**
+ * @brief A read-only io_uring instance shared by many IO objects and many threads.
+ *
+ * Every thread submits its batch of reads into the same submission queue with one
+ * io_uring_enter call, and whichever thread is waiting reaps the completions of all batches,
+ * so concurrent searches share a single ring instead of one syscall per read. Files are
+ * registered as fixed files, and small direct reads are bounced through registered buffers.
+ * The ring is built on the raw syscalls, without liburing.
+ */
+class IOUringRing {
+public:
+    /// One read. For a direct read the ring aligns offset and size and bounces the data.
+    struct ReadRequest {
+        uint8_t* dest{nullptr};
+        uint64_t size{0};
+        uint64_t offset{0};
+    };
+
+    /// Number of submission queue entries, the completion queue is twice as large.
+    static constexpr uint32_t DEFAULT_QUEUE_DEPTH = 256;
+
+    /// Number of slots in the fixed file table.
+    static constexpr uint32_t FIXED_FILE_COUNT = 1024;
+
+    /// Size of one registered bounce buffer, there is one per submission queue entry.
+    static constexpr uint64_t FIXED_BUFFER_SIZE = 16ULL << 10;
+
+    /**
+     * @brief Returns the process-wide ring, or nullptr when io_uring is not usable here
+     * (old kernel, io_uring disabled by sysctl or seccomp).
+     *
+     * @param sqpoll Whether the ring polls its submission queue from a kernel thread.
+     */
+    static std::shared_ptr<IOUringRing>
+    GetShared(bool sqpoll);
+
+public:
+    /**
+     * @brief Sets up a ring, throws a VsagException when io_uring_setup fails.
+     */
+    IOUringRing(uint32_t queue_depth, bool sqpoll);
+
+    ~IOUringRing();
+
+    IOUringRing(const IOUringRing&) = delete;
+    IOUringRing&
+    operator=(const IOUringRing&) = delete;
+
+    /**
+     * @brief Registers fd in the fixed file table.
+     *
+     * @return The slot of fd, or -1 when the table is full or unsupported; reads then use fd.
+     */
+    int
+    RegisterFile(int fd);
+
+    /**
+     * @brief Releases a slot returned by RegisterFile, -1 is ignored.
+     */
+    void
+    UnregisterFile(int slot);
+
+    /**
+     * @brief Reads all requests from fd and blocks until every one of them has completed.
+     *
+     * @param fd The file to read from.
+     * @param slot The fixed file slot of fd, or -1.
+     * @param requests The reads, their destinations need no alignment when direct is true.
+     * @param count The number of reads.
+     * @param direct Whether fd is opened with O_DIRECT.
+     * @return True if every read returned all of its bytes.
+     */
+    bool
+    Read(int fd, int slot, const ReadRequest* requests, uint64_t count, bool direct);
+
+    [[nodiscard]] bool
+    IsSQPoll() const {
+        return sqpoll_;
+    }
+
+private:
+    struct Batch {
+        std::atomic<uint64_t> pending{0};
+    };
+
+    struct Inflight {
+        Batch* batch{nullptr};
+        ReadRequest request{};
+        // the range that is actually read, differs from request for direct reads
+        uint8_t* buffer{nullptr};
+        uint64_t size{0};
+        uint64_t offset{0};
+        int buffer_index{-1};
+        int64_t result{0};
+    };
+
+    uint64_t
+    submit(int fd, int slot, Inflight* items, uint64_t count);
+
+    void
+    wait_step();
+
+    uint64_t
+    reap();
+
+    int
+    enter(uint32_t to_submit, uint32_t min_complete, uint32_t flags) const;
+
+    void
+    setup_fixed_files();
+
+    void
+    setup_fixed_buffers();
+
+    int
+    take_fixed_buffer();
+
+    void
+    return_fixed_buffer(int index);
+
+private:
+    int ring_fd_{-1};
+    bool sqpoll_{false};
+
+    // submission queue, written under sq_mutex_
+    uint8_t* sq_ring_{nullptr};
+    uint64_t sq_ring_size_{0};
+    uint32_t* sq_head_{nullptr};
+    uint32_t* sq_tail_{nullptr};
+    uint32_t* sq_flags_{nullptr};
+    uint32_t* sq_array_{nullptr};
+    uint32_t sq_mask_{0};
+    uint32_t sq_entries_{0};
+    io_uring_sqe* sqes_{nullptr};
+    std::mutex sq_mutex_;
+
+    // completion queue, consumed under cq_mutex_
+    uint8_t* cq_ring_{nullptr};
+    uint64_t cq_ring_size_{0};
+    uint32_t* cq_head_{nullptr};
+    uint32_t* cq_tail_{nullptr};
+    uint32_t cq_mask_{0};
+    uint32_t cq_entries_{0};
+    io_uring_cqe* cqes_{nullptr};
+    std::mutex cq_mutex_;
+
+    // submitted and not yet reaped, never above cq_entries_ so the completion queue can not
+    // overflow
+    std::atomic<uint64_t> inflight_{0};
+
+    std::mutex files_mutex_;
+    std::vector<int> fixed_files_;
+
+    std::mutex buffers_mutex_;
+    uint8_t* fixed_buffers_{nullptr};
+    uint64_t fixed_buffers_size_{0};
+    std::vector<int> free_buffers_;
+};
+
+}  // namespace vsag
+
+#endif  // HAVE_IO_URING
@@ -25,10 +25,23 @@
 
 namespace vsag {
 
+static int
+countr_zero(uint64_t x) {
+    if (x == 0) {
+        return 64;
+    }
+    int count = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        ++count;
+    }
+    return count;
+}
+
 MemoryBlockIO::MemoryBlockIO(uint64_t block_size, Allocator* allocator)
     : BasicIO<MemoryBlockIO>(allocator),
       block_size_(MemoryBlockIOParameter::NearestPowerOfTwo(block_size)),
-      blocks_(0, allocator) {
+      blocks_(countr_zero(block_size_), allocator) {
     this->update_by_block_size();
 }
 
@@ -41,11 +54,7 @@ MemoryBlockIO::MemoryBlockIO(const IOParamPtr& param, const IndexCommonParam& co
     : MemoryBlockIO(std::dynamic_pointer_cast<MemoryBlockIOParameter>(param), common_param) {
 }
 
-MemoryBlockIO::~MemoryBlockIO() {
-    for (auto* block : blocks_) {
-        this->allocator_->Deallocate(block);
-    }
-}
+MemoryBlockIO::~MemoryBlockIO() = default;
 
 void
 MemoryBlockIO::WriteImpl(const uint8_t* data, uint64_t size, uint64_t offset) {
@@ -55,7 +64,7 @@ MemoryBlockIO::WriteImpl(const uint8_t* data, uint64_t size, uint64_t offset) {
     auto start_off = offset & in_block_mask_;
     auto max_size = block_size_ - start_off;
     while (cur_size < size) {
-        uint8_t* cur_write = blocks_[start_no] + start_off;
+        uint8_t* cur_write = blocks_.Segment(start_no) + start_off;
         auto cur_length = std::min(size - cur_size, max_size);
         memcpy(cur_write, data + cur_size, cur_length);
         cur_size += cur_length;
@@ -63,9 +72,7 @@ MemoryBlockIO::WriteImpl(const uint8_t* data, uint64_t size, uint64_t offset) {
         ++start_no;
         start_off = 0;
     }
-    if (size + offset > this->size_) {
-        this->size_ = size + offset;
-    }
+    this->grow_size(size + offset);
 }
 
 bool
@@ -77,7 +84,7 @@ MemoryBlockIO::ReadImpl(uint64_t size, uint64_t offset, uint8_t* data) const {
         auto start_off = offset & in_block_mask_;
         auto max_size = block_size_ - start_off;
         while (cur_size < size) {
-            const uint8_t* cur_read = blocks_[start_no] + start_off;
+            const uint8_t* cur_read = blocks_.Segment(start_no) + start_off;
             auto cur_length = std::min(size - cur_size, max_size);
             memcpy(data + cur_size, cur_read, cur_length);
             cur_size += cur_length;
@@ -122,57 +129,29 @@ MemoryBlockIO::PrefetchImpl(uint64_t offset, uint64_t cache_line) {
 
 void
 MemoryBlockIO::check_and_realloc(uint64_t size) {
-    if (size <= (blocks_.size() << block_bit_)) {
+    if (size <= this->blocks_.Capacity()) {
         return;
     }
-    const uint64_t new_block_count = (size + this->block_size_ - 1) >> block_bit_;
-    auto cur_block_size = this->blocks_.size();
-    this->blocks_.reserve(new_block_count);
-    while (cur_block_size < new_block_count) {
-        auto* ptr = static_cast<uint8_t*>(this->allocator_->Allocate(block_size_));
-        if (ptr == nullptr) {
-            throw VsagException(ErrorType::NO_ENOUGH_MEMORY, "MemoryBlockIO allocation failed");
-        }
-        this->blocks_.emplace_back(ptr);
-        ++cur_block_size;
-    }
+    this->blocks_.Resize(size);
 }
 
 void
 MemoryBlockIO::ResizeImpl(uint64_t size) {
-    if (size <= this->size_) {
-        this->size_ = size;
+    if (size <= this->current_size()) {
+        this->set_size(size);
         return;
     }
     check_and_realloc(size);
-    this->size_ = size;
+    this->set_size(size);
 }
 
 void
 MemoryBlockIO::ShrinkImpl(uint64_t size) {
-    if (size >= this->size_) {
+    if (size >= this->current_size()) {
         return;
     }
-    uint64_t new_block_count = (size + this->block_size_ - 1) >> this->block_bit_;
-    while (this->blocks_.size() > new_block_count) {
-        auto* block = this->blocks_.back();
-        this->allocator_->Deallocate(block);
-        this->blocks_.pop_back();
-    }
-    this->size_ = size;
-}
-
-static int
-countr_zero(uint64_t x) {
-    if (x == 0) {
-        return 64;
-    }
-    int count = 0;
-    while ((x & 1) == 0) {
-        x >>= 1;
-        ++count;
-    }
-    return count;
+    this->blocks_.Resize(size);
+    this->set_size(size);
 }
 
 void
@@ -17,6 +17,7 @@
 
 #include "basic_io.h"
 #include "memory_block_io_parameter.h"
+#include "utils/segmented_array.h"
 
 namespace vsag {
 class IndexCommonParam;
@@ -27,7 +28,8 @@ class IndexCommonParam;
  * This class manages data across multiple fixed-size memory blocks (default 128MB),
  * useful for large datasets that exceed single allocation limits. Each block is
  * independently allocated, allowing efficient memory management and avoiding
- * large contiguous allocations.
+ * large contiguous allocations. Growing only appends blocks, so it may run concurrently
+ * with reads and writes of the existing data.
  */
 class MemoryBlockIO : public BasicIO<MemoryBlockIO> {
 public:
@@ -37,6 +39,12 @@ public:
     /// Indicates deserialization is required when loading.
     static constexpr bool SkipDeserialize = false;
 
+    /// Indicates growing keeps the existing data in place and never blocks readers.
+    static constexpr bool ConcurrentResize = true;
+
+    /// Indicates reads never use a BlockCache, the data is in memory already.
+    static constexpr bool UseBlockCache = false;
+
 public:
     /**
      * @brief Constructs a MemoryBlockIO with a specified block size.
@@ -168,7 +176,7 @@ private:
     get_data_ptr(uint64_t offset) const {
         auto block_no = offset >> block_bit_;
         auto block_off = offset & in_block_mask_;
-        return blocks_[block_no] + block_off;
+        return blocks_.Segment(block_no) + block_off;
     }
 
     /**
@@ -187,8 +195,8 @@ private:
     /// Size of each memory block (default 128MB).
     uint64_t block_size_{DEFAULT_BLOCK_SIZE};
 
-    /// Vector of pointers to allocated memory blocks.
-    Vector<uint8_t*> blocks_;
+    /// The allocated memory blocks, one segment per block.
+    SegmentedArray<uint8_t> blocks_;
 
     /// Default block size: 128MB.
     static constexpr uint64_t DEFAULT_BLOCK_SIZE = 128 * 1024 * 1024;
@@ -15,7 +15,10 @@
 
 #include "memory_block_io.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <thread>
 
 #include "basic_io_test.h"
 #include "impl/allocator/safe_allocator.h"
@@ -64,3 +67,51 @@ TEST_CASE("MemoryBlockIO Shrink Test", "[ut][MemoryBlockIO]") {
     io->Shrink(2000);
     REQUIRE(io->size_ == 1000);
 }
+
+TEST_CASE("MemoryBlockIO Concurrent Resize Test", "[ut][MemoryBlockIO]") {
+    REQUIRE(MemoryBlockIO::ConcurrentResize);
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto io = std::make_unique<MemoryBlockIO>(4096, allocator.get());
+
+    constexpr uint64_t line_size = 64;
+    std::vector<uint8_t> line(line_size);
+    auto fill_line = [&](uint64_t id) {
+        std::fill(line.begin(), line.end(), static_cast<uint8_t>(id % 251));
+        io->Write(line.data(), line_size, id * line_size);
+    };
+    uint64_t initial_count = 128;
+    io->Resize(initial_count * line_size);
+    for (uint64_t id = 0; id < initial_count; ++id) {
+        fill_line(id);
+    }
+
+    // readers only touch the lines written before the resize started
+    std::atomic<bool> stop{false};
+    std::atomic<bool> mismatch{false};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t]() {
+            std::vector<uint8_t> buffer(line_size);
+            uint64_t id = t;
+            while (not stop.load()) {
+                id = (id + 7) % initial_count;
+                bool need_release = false;
+                const auto* data = io->Read(line_size, id * line_size, need_release);
+                if (data == nullptr or data[0] != static_cast<uint8_t>(id % 251)) {
+                    mismatch.store(true);
+                }
+                if (need_release) {
+                    io->Release(data);
+                }
+            }
+        });
+    }
+    for (uint64_t count = initial_count * 2; count <= initial_count * 64; count *= 2) {
+        io->Resize(count * line_size);
+    }
+    stop.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    REQUIRE_FALSE(mismatch.load());
+}
@@ -25,12 +25,12 @@ MemoryIO::WriteImpl(const uint8_t* data, uint64_t size, uint64_t offset) {
 
 void
 MemoryIO::ResizeImpl(uint64_t size) {
-    if (size <= this->size_) {
-        this->size_ = size;
+    if (size <= this->current_size()) {
+        this->set_size(size);
         return;
     }
     check_and_realloc(size);
-    this->size_ = size;
+    this->set_size(size);
 }
 
 bool
@@ -39,6 +39,12 @@ public:
     /// Indicates deserialization is required when loading (memory needs to be allocated).
     static constexpr bool SkipDeserialize = false;
 
+    /// Indicates growing may move the data, so it must not run concurrently with readers.
+    static constexpr bool ConcurrentResize = false;
+
+    /// Indicates reads never use a BlockCache, the data is in memory already.
+    static constexpr bool UseBlockCache = false;
+
 public:
     /**
      * @brief Constructs a MemoryIO object with an allocator.
@@ -158,7 +164,7 @@ private:
      */
     void
     check_and_realloc(uint64_t size) {
-        if (size <= this->size_) {
+        if (size <= this->current_size()) {
             return;
         }
         uint8_t* new_buffer = static_cast<uint8_t*>(this->allocator_->Reallocate(buffer_, size));
@@ -168,7 +174,7 @@ private:
                                 size);
         }
         buffer_ = new_buffer;
-        this->size_ = size;
+        this->set_size(size);
     }
 
 private:
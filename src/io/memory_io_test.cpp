@@ -16,6 +16,8 @@
 
 #include <cstdlib>
 #include <memory>
+#include <sstream>
+#include <vector>
 
 #include "basic_io_test.h"
 #include "impl/allocator/safe_allocator.h"
@@ -36,6 +38,21 @@ TEST_CASE("MemoryIO Serialize and Deserialize", "[ut][MemoryIO]") {
     TestSerializeAndDeserialize(*wio, *rio);
 }
 
+TEST_CASE("MemoryIO Deserialize Rejects Corrupt Padding", "[ut][MemoryIO]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto rio = std::make_unique<MemoryIO>(allocator.get());
+    // an aligned section header whose padding is not below the 4KB section alignment
+    std::stringstream ss;
+    IOStreamWriter writer(ss);
+    StreamWriter::WriteObj(writer, static_cast<uint64_t>(8) | (1ULL << 63));
+    StreamWriter::WriteObj(writer, static_cast<uint64_t>(4096));
+    std::vector<char> payload(4096 + 8, 0);
+    writer.Write(payload.data(), payload.size());
+    ss.seekg(0, std::ios::beg);
+    IOStreamReader reader(ss);
+    REQUIRE_THROWS_AS(rio->Deserialize(reader), VsagException);
+}
+
 class FailAllocator : public Allocator {
 public:
     std::string
@@ -0,0 +1,111 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mmap_file_reader.h"
+
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "vsag_exception.h"
+
+namespace vsag {
+
+MMapFileReader::MMapFileReader(const std::string& filename, int64_t base_offset, int64_t size) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw VsagException(ErrorType::READ_ERROR,
+                            fmt::format("open file {} error {}", filename, strerror(errno)));
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0 or base_offset < 0 or base_offset > st.st_size) {
+        close(fd);
+        throw VsagException(ErrorType::READ_ERROR,
+                            fmt::format("invalid offset {} of file {}", base_offset, filename));
+    }
+    auto available = static_cast<uint64_t>(st.st_size - base_offset);
+    size_ = size > 0 ? std::min(static_cast<uint64_t>(size), available) : available;
+    if (size_ == 0) {
+        close(fd);
+        return;
+    }
+
+    // mmap wants a page aligned file offset, the head of the first page is skipped by data_
+    auto page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    auto map_offset = static_cast<uint64_t>(base_offset) / page_size * page_size;
+    auto head = static_cast<uint64_t>(base_offset) - map_offset;
+    map_size_ = head + size_;
+    addr_ = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(map_offset));
+    auto saved_errno = errno;
+    // the mapping keeps its own reference to the file
+    close(fd);
+    if (addr_ == MAP_FAILED) {
+        addr_ = nullptr;
+        throw VsagException(ErrorType::READ_ERROR,
+                            fmt::format("mmap file {} error {}", filename, strerror(saved_errno)));
+    }
+    // searches touch codes and neighbors in random order, readahead only wastes the page cache
+    madvise(addr_, map_size_, MADV_RANDOM);
+    data_ = static_cast<const uint8_t*>(addr_) + head;
+}
+
+MMapFileReader::~MMapFileReader() {
+    if (addr_ != nullptr) {
+        munmap(addr_, map_size_);
+    }
+}
+
+void
+MMapFileReader::Read(uint64_t offset, uint64_t len, void* dest) {
+    if (offset + len > size_) {
+        throw VsagException(
+            ErrorType::READ_ERROR,
+            fmt::format("read [{}, {}) out of mapped size {}", offset, offset + len, size_));
+    }
+    memcpy(dest, data_ + offset, len);
+}
+
+void
+MMapFileReader::AsyncRead(uint64_t offset, uint64_t len, void* dest, CallBack callback) {
+    // a copy from the mapping is not worth a pool task
+    if (offset + len > size_) {
+        callback(IOErrorCode::IO_ERROR, "read out of mapped size");
+        return;
+    }
+    memcpy(dest, data_ + offset, len);
+    callback(IOErrorCode::IO_SUCCESS, "success");
+}
+
+bool
+MMapFileReader::MultiRead(uint8_t* dests,
+                          const uint64_t* lens,
+                          const uint64_t* offsets,
+                          uint64_t count) {
+    for (uint64_t i = 0; i < count; ++i) {
+        if (offsets[i] + lens[i] > size_) {
+            return false;
+        }
+        memcpy(dests, data_ + offsets[i], lens[i]);
+        dests += lens[i];
+    }
+    return true;
+}
+
+}  // namespace vsag
@@ -0,0 +1,72 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "vsag/readerset.h"
+
+namespace vsag {
+
+/**
+ * @brief A file Reader backed by a read-only shared mapping of the file.
+ *
+ * ReaderIO recognizes it and serves DirectRead with pointers into the mapping instead of
+ * copies, so an index deserialized through it keeps its codes and graph in the page cache,
+ * shared by every process mapping the same file.
+ */
+class MMapFileReader : public Reader {
+public:
+    /**
+     * @brief Maps [base_offset, base_offset + size) of filename, size 0 maps the rest of the
+     * file. Throws a VsagException when the file can not be opened or mapped.
+     */
+    MMapFileReader(const std::string& filename, int64_t base_offset, int64_t size);
+
+    ~MMapFileReader() override;
+
+    void
+    Read(uint64_t offset, uint64_t len, void* dest) override;
+
+    void
+    AsyncRead(uint64_t offset, uint64_t len, void* dest, CallBack callback) override;
+
+    bool
+    MultiRead(uint8_t* dests,
+              const uint64_t* lens,
+              const uint64_t* offsets,
+              uint64_t count) override;
+
+    [[nodiscard]] uint64_t
+    Size() const override {
+        return size_;
+    }
+
+    /**
+     * @brief The first byte of the mapped range, valid as long as the reader lives.
+     */
+    [[nodiscard]] const uint8_t*
+    Data() const {
+        return data_;
+    }
+
+private:
+    void* addr_{nullptr};
+    uint64_t map_size_{0};
+    const uint8_t* data_{nullptr};
+    uint64_t size_{0};
+};
+
+}  // namespace vsag
@@ -63,8 +63,8 @@ MMapIO::MMapIO(std::string filename, Allocator* allocator)
                         saved_errno,
                         std::error_code(saved_errno, std::system_category()).message()));
     }
-    auto mmap_size = this->size_;
-    if (this->size_ == 0) {
+    auto mmap_size = this->current_size();
+    if (mmap_size == 0) {
         mmap_size = DEFAULT_INIT_MMAP_SIZE;
         auto ret = IOSyscall::FTruncate(this->fd_, mmap_size);
         if (ret == -1) {
@@ -93,7 +93,7 @@ MMapIO::MMapIO(const IOParamPtr& param, const IndexCommonParam& common_param)
     : MMapIO(std::dynamic_pointer_cast<MMapIOParameter>(param), common_param){};
 
 MMapIO::~MMapIO() {
-    munmap(this->start_, this->size_);
+    munmap(this->start_, this->current_size());
     close(this->fd_);
     // remove file
     if (not this->exist_file_) {
@@ -104,7 +104,7 @@ MMapIO::~MMapIO() {
 void
 MMapIO::WriteImpl(const uint8_t* data, uint64_t size, uint64_t offset) {
     auto new_size = size + offset;
-    auto old_size = this->size_;
+    auto old_size = this->current_size();
     if (old_size == 0) {
         old_size = DEFAULT_INIT_MMAP_SIZE;
     }
@@ -129,14 +129,14 @@ MMapIO::WriteImpl(const uint8_t* data, uint64_t size, uint64_t offset) {
         this->start_ = static_cast<uint8_t*>(new_addr);
 #endif
     }
-    this->size_ = std::max(this->size_, new_size);
+    this->grow_size(new_size);
     memcpy(this->start_ + offset, data, size);
 }
 
 void
 MMapIO::ResizeImpl(uint64_t size) {
     auto new_size = size;
-    auto old_size = this->size_;
+    auto old_size = this->current_size();
     if (old_size == 0) {
         old_size = DEFAULT_INIT_MMAP_SIZE;
     }
@@ -180,15 +180,16 @@ MMapIO::ResizeImpl(uint64_t size) {
             throw VsagException(ErrorType::INTERNAL_ERROR, "ftruncate failed");
         }
     }
-    this->size_ = new_size;
+    this->set_size(new_size);
 }
 
 bool
 MMapIO::ReadImpl(uint64_t size, uint64_t offset, uint8_t* data) const {
-    if (offset + size > this->size_) {
+    auto io_size = this->current_size();
+    if (offset + size > io_size) {
         throw VsagException(
             ErrorType::INTERNAL_ERROR,
-            fmt::format("read offset {} + size {} > size {}", offset, size, this->size_));
+            fmt::format("read offset {} + size {} > size {}", offset, size, io_size));
     }
     memcpy(data, this->start_ + offset, size);
     return true;
@@ -38,6 +38,12 @@ public:
     /// Indicates deserialization is required when loading from disk.
     static constexpr bool SkipDeserialize = false;
 
+    /// Indicates growing must not run concurrently with readers.
+    static constexpr bool ConcurrentResize = false;
+
+    /// Indicates reads never use a BlockCache, the page cache serves the mapping.
+    static constexpr bool UseBlockCache = false;
+
 public:
     /**
      * @brief Constructs a MMapIO object with a filename and allocator.
@@ -45,6 +45,12 @@ public:
     /// Indicates deserialization is required when loading.
     static constexpr bool SkipDeserialize = false;
 
+    /// Indicates growing must not run concurrently with readers.
+    static constexpr bool ConcurrentResize = false;
+
+    /// Indicates reads never use a BlockCache, the inner IO objects may.
+    static constexpr bool UseBlockCache = false;
+
     /**
      * @brief Constructs a NonContinuousIO with allocator and inner IO arguments.
      *
@@ -98,9 +104,7 @@ public:
                 start_offset = start_area->first.offset;
             }
         }
-        if (offset + size > this->size_) {
-            this->size_ = offset + size;
-        }
+        this->grow_size(offset + size);
     }
 
     /**
@@ -17,14 +17,18 @@
 
 #include <fmt/format.h>
 
+#include <cstring>
 #include <future>
 
+#include "mmap_file_reader.h"
+#include "utils/prefetch.h"
+
 namespace vsag {
 
 void
 ReaderIO::WriteImpl(const uint8_t* data, uint64_t size, uint64_t offset) {
     // ReaderIO is read-only, so we do nothing here. Just for deserialization.
-    this->size_ += size;
+    this->size_.fetch_add(size, std::memory_order_release);
 }
 
 void
@@ -35,6 +39,10 @@ ReaderIO::InitIOImpl(const vsag::IOParamPtr& io_param) {
                             "ReaderIOParam is required for ReaderIO initialization.");
     }
     reader_ = reader_param->reader;
+    mapped_ = nullptr;
+    if (auto* mmap_reader = dynamic_cast<MMapFileReader*>(reader_.get())) {
+        mapped_ = mmap_reader->Data();
+    }
 }
 
 bool
@@ -44,7 +52,9 @@ ReaderIO::ReadImpl(uint64_t size, uint64_t offset, uint8_t* data) const {
                             "ReaderIO is not initialized, please call Init() first.");
     }
     bool ret = check_valid_offset(size + offset);
-    if (ret) {
+    if (ret and mapped_ != nullptr) {
+        memcpy(data, mapped_ + start_ + offset, size);
+    } else if (ret) {
         reader_->Read(start_ + offset, size, data);
     }
     return ret;
@@ -57,6 +67,10 @@ ReaderIO::DirectReadImpl(uint64_t size, uint64_t offset, bool& need_release) con
                             "ReaderIO is not initialized, please call Init() first.");
     }
     if (check_valid_offset(size + offset)) {
+        if (mapped_ != nullptr) {
+            need_release = false;
+            return mapped_ + start_ + offset;
+        }
         auto* data = static_cast<uint8_t*>(allocator_->Allocate(size));
         need_release = true;
         reader_->Read(start_ + offset, size, data);
@@ -80,6 +94,17 @@ ReaderIO::MultiReadImpl(uint8_t* datas,
                             "ReaderIO is not initialized, please call Init() first.");
     }
 
+    if (mapped_ != nullptr) {
+        for (uint64_t i = 0; i < count; ++i) {
+            if (not check_valid_offset(sizes[i] + offsets[i])) {
+                return false;
+            }
+            memcpy(datas, mapped_ + start_ + offsets[i], sizes[i]);
+            datas += sizes[i];
+        }
+        return true;
+    }
+
     std::vector<uint64_t> real_offsets(count);
     for (uint64_t i = 0; i < count; ++i) {
         real_offsets[i] = start_ + offsets[i];
@@ -87,4 +112,11 @@ ReaderIO::MultiReadImpl(uint8_t* datas,
     return reader_->MultiRead(datas, sizes, real_offsets.data(), count);
 }
 
+void
+ReaderIO::PrefetchImpl(uint64_t offset, uint64_t cache_line) {
+    if (mapped_ != nullptr) {
+        PrefetchLines(mapped_ + start_ + offset, cache_line);
+    }
+}
+
 }  // namespace vsag
@@ -28,7 +28,8 @@ namespace vsag {
  * typically used for loading pre-built indexes from disk without modification.
  * The SkipDeserialize=true design indicates that during deserialization,
  * the data is not copied into memory; instead, the Reader directly accesses
- * the serialized data on disk or in memory.
+ * the serialized data on disk or in memory. When the Reader is a MMapFileReader, direct
+ * reads return pointers into its mapping and nothing is copied at all.
  */
 class ReaderIO : public BasicIO<ReaderIO> {
 public:
@@ -38,6 +39,12 @@ public:
     /// Indicates deserialization skips data copying; Reader directly accesses serialized data.
     static constexpr bool SkipDeserialize = true;
 
+    /// Indicates growing must not run concurrently with readers.
+    static constexpr bool ConcurrentResize = false;
+
+    /// Indicates reads may be served from a BlockCache.
+    static constexpr bool UseBlockCache = true;
+
 public:
     /**
      * @brief Constructs a ReaderIO object with an allocator.
@@ -108,12 +115,13 @@ public:
      * @brief Reads data into an allocated buffer and returns a pointer to it.
      *
      * This method allocates a new buffer, reads data into it via the Reader,
-     * and returns the pointer. The caller must release the buffer.
+     * and returns the pointer. The caller must release the buffer. Over a mapped
+     * Reader the pointer refers to the mapping and need_release is set to false.
      *
      * @param size The size of the data to be read.
      * @param offset The offset at which to read the data.
-     * @param need_release Set to true, indicating the returned buffer must be released by caller.
-     * @return A pointer to the allocated buffer containing the read data.
+     * @param need_release Set to true if the returned buffer must be released by caller.
+     * @return A pointer to the data.
      */
     [[nodiscard]] const uint8_t*
     DirectReadImpl(uint64_t size, uint64_t offset, bool& need_release) const;
@@ -144,9 +152,21 @@ public:
                   const uint64_t* offsets,
                   uint64_t count) const;
 
+    /**
+     * @brief Prefetches mapped data into the CPU cache, a no-op for other Readers.
+     *
+     * @param offset The offset of the data to prefetch.
+     * @param cache_line The size of the data to prefetch.
+     */
+    void
+    PrefetchImpl(uint64_t offset, uint64_t cache_line = 64);
+
 private:
     /// External Reader interface for accessing serialized data without copying.
     std::shared_ptr<Reader> reader_{nullptr};
+
+    /// The mapping of reader_ when it is a MMapFileReader, nullptr otherwise.
+    const uint8_t* mapped_{nullptr};
 };
 
 }  // namespace vsag
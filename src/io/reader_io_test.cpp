@@ -15,9 +15,13 @@
 
 #include "reader_io.h"
 
+#include <fstream>
 #include <memory>
+#include <sstream>
 
 #include "basic_io_test.h"
+#include "memory_io.h"
+#include "mmap_file_reader.h"
 #include "reader_io_parameter.h"
 #include "unittest.h"
 
@@ -129,3 +133,79 @@ TEST_CASE("ReaderIO Read Test", "[ut][ReaderIO]") {
         REQUIRE_THROWS(reader_io.MultiReadImpl(buffer.data(), sizes, offsets, count));
     }
 }
+
+TEST_CASE("ReaderIO Zero Copy Over Mapped File", "[ut][ReaderIO]") {
+    vsag::IndexCommonParam common_param;
+    common_param.allocator_ = vsag::Engine::CreateDefaultAllocator();
+    auto* allocator = common_param.allocator_.get();
+    fixtures::TempDir temp_dir("reader_io_mmap");
+    auto filename = temp_dir.GenerateRandomFile(false);
+
+    // a small section keeps the plain layout, a large one is page aligned
+    uint64_t small_size = 1000;
+    uint64_t large_size = 3 * 1024 * 1024 + 7;
+    vsag::MemoryIO small_io(allocator);
+    vsag::MemoryIO large_io(allocator);
+    std::vector<uint8_t> small_data(small_size);
+    std::vector<uint8_t> large_data(large_size);
+    for (uint64_t i = 0; i < large_size; ++i) {
+        large_data[i] = static_cast<uint8_t>(i * 7 % 251);
+    }
+    for (uint64_t i = 0; i < small_size; ++i) {
+        small_data[i] = static_cast<uint8_t>(i % 13);
+    }
+    small_io.Write(small_data.data(), small_size, 0);
+    large_io.Write(large_data.data(), large_size, 0);
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        vsag::IOStreamWriter writer(ofs);
+        small_io.Serialize(writer);
+        large_io.Serialize(writer);
+        REQUIRE(writer.GetCursor() > small_size + large_size + 2 * sizeof(uint64_t));
+    }
+
+    auto reader = std::make_shared<vsag::MMapFileReader>(filename, 0, 0);
+    auto func = [&](uint64_t offset, uint64_t len, void* dest) { reader->Read(offset, len, dest); };
+    vsag::ReadFuncStreamReader stream(func, 0, reader->Size());
+    auto reader_param = std::make_shared<vsag::ReaderIOParameter>();
+    reader_param->reader = reader;
+    IOParamPtr io_param = reader_param;
+
+    vsag::ReaderIO small_reader_io(io_param, common_param);
+    vsag::ReaderIO large_reader_io(io_param, common_param);
+    small_reader_io.Deserialize(stream);
+    large_reader_io.Deserialize(stream);
+    REQUIRE(stream.GetCursor() == reader->Size());
+    small_reader_io.InitIO(io_param);
+    large_reader_io.InitIO(io_param);
+    REQUIRE(small_reader_io.size_ == small_size);
+    REQUIRE(large_reader_io.size_ == large_size);
+    REQUIRE(large_reader_io.start_ % 4096 == 0);
+
+    bool need_release = true;
+    const auto* data = large_reader_io.Read(large_size, 0, need_release);
+    REQUIRE_FALSE(need_release);
+    REQUIRE(data == reader->Data() + large_reader_io.start_);
+    REQUIRE(memcmp(data, large_data.data(), large_size) == 0);
+
+    std::vector<uint8_t> buffer(small_size);
+    REQUIRE(small_reader_io.Read(small_size, 0, buffer.data()));
+    REQUIRE(buffer == small_data);
+
+    uint64_t offsets[] = {large_size - 10, 5};
+    uint64_t sizes[] = {10, 20};
+    REQUIRE(large_reader_io.MultiRead(buffer.data(), sizes, offsets, 2));
+    REQUIRE(memcmp(buffer.data(), large_data.data() + offsets[0], sizes[0]) == 0);
+    REQUIRE(memcmp(buffer.data() + sizes[0], large_data.data() + offsets[1], sizes[1]) == 0);
+    REQUIRE_FALSE(large_reader_io.MultiRead(buffer.data(), sizes + 1, offsets, 1));
+    REQUIRE(large_reader_io.Read(1, large_size, need_release) == nullptr);
+
+    // the same file read back into memory through the old code path
+    vsag::MemoryIO copied_io(allocator);
+    vsag::ReadFuncStreamReader copy_stream(func, 0, reader->Size());
+    copied_io.Deserialize(copy_stream);
+    copied_io.Deserialize(copy_stream);
+    std::vector<uint8_t> copied(large_size);
+    REQUIRE(copied_io.Read(large_size, 0, copied.data()));
+    REQUIRE(copied == large_data);
+}
@@ -60,6 +60,11 @@ public:
         quantizer_->ScanBatchDists(*this, count, codes, dists);
     }
 
+    inline void
+    ComputeDistsBatch(uint64_t count, const uint8_t* const* codes, float* dists) {
+        quantizer_->ComputeDistsBatch(*this, count, codes, dists);
+    }
+
     inline void
     ComputeDistsBatch4(const uint8_t* codes1,
                        const uint8_t* codes2,
@@ -113,6 +118,11 @@ public:
         quantizer_->ScanBatchDists(*this, count, codes, dists);
     }
 
+    inline void
+    ComputeDistsBatch(uint64_t count, const uint8_t* const* codes, float* dists) {
+        quantizer_->ComputeDistsBatch(*this, count, codes, dists);
+    }
+
     inline void
     ComputeDistsBatch4(const uint8_t* codes1,
                        const uint8_t* codes2,
@@ -15,6 +15,9 @@
 
 #include "fp32_quantizer.h"
 
+#include <algorithm>
+
+#include "impl/blas/blas_function.h"
 #include "simd/fp32_simd.h"
 #include "simd/normalize.h"
 #include "simd/simd.h"
@@ -130,12 +133,106 @@ FP32Quantizer<metric>::ScanBatchDistImpl(Computer<FP32Quantizer<metric>>& comput
                                          uint64_t count,
                                          const uint8_t* codes,
                                          float* dists) const {
-    // TODO(LHT): Optimize batch for simd
-    for (uint64_t i = 0; i < count; ++i) {
-        this->ComputeDistImpl(computer, codes + i * this->code_size_, dists + i);
+    const uint8_t* tile[FP32_BATCH16_SIZE];
+    for (uint64_t i = 0; i < count; i += FP32_BATCH16_SIZE) {
+        auto tile_size = std::min(FP32_BATCH16_SIZE, count - i);
+        for (uint64_t j = 0; j < tile_size; ++j) {
+            tile[j] = codes + (i + j) * this->code_size_;
+        }
+        this->ComputeDistsBatchImpl(computer, tile_size, tile, dists + i);
     }
 }
 
+template <MetricType metric>
+void
+FP32Quantizer<metric>::ScanQueriesBatchDistImpl(Computer<FP32Quantizer<metric>>* const* computers,
+                                                uint64_t query_count,
+                                                uint64_t count,
+                                                const uint8_t* codes,
+                                                const float* code_norms,
+                                                float* dists,
+                                                uint64_t dists_stride) const {
+    // below this many queries the gemm setup costs more than the per-query kernels
+    constexpr uint64_t min_gemm_query_count = 4;
+    if (query_count < min_gemm_query_count or count == 0) {
+        for (uint64_t q = 0; q < query_count; ++q) {
+            this->ScanBatchDistImpl(*computers[q], count, codes, dists + q * dists_stride);
+        }
+        return;
+    }
+    auto dim = this->dim_;
+    Vector<float> queries(query_count * dim, this->allocator_);
+    for (uint64_t q = 0; q < query_count; ++q) {
+        memcpy(queries.data() + q * dim, computers[q]->buf_, dim * sizeof(float));
+    }
+    // dists[q][i] = <query_q, code_i>, the codes are rows of code_size_ bytes
+    const auto* code_floats = reinterpret_cast<const float*>(codes);
+    BlasFunction::Sgemm(BlasFunction::RowMajor,
+                        BlasFunction::NoTrans,
+                        BlasFunction::Trans,
+                        static_cast<int32_t>(query_count),
+                        static_cast<int32_t>(count),
+                        static_cast<int32_t>(dim),
+                        1.0F,
+                        queries.data(),
+                        static_cast<int32_t>(dim),
+                        code_floats,
+                        static_cast<int32_t>(this->code_size_ / sizeof(float)),
+                        0.0F,
+                        dists,
+                        static_cast<int32_t>(dists_stride));
+
+    if constexpr (metric == MetricType::METRIC_TYPE_L2SQR) {
+        // |q - x|^2 = |q|^2 + |x|^2 - 2 <q, x>, the norms come from the caller when it keeps them
+        Vector<float> local_norms(this->allocator_);
+        if (code_norms == nullptr) {
+            local_norms.resize(count);
+            for (uint64_t i = 0; i < count; ++i) {
+                local_norms[i] = this->CodeNormImpl(codes + i * this->code_size_);
+            }
+            code_norms = local_norms.data();
+        }
+        // the expansion cancels when q and x nearly coincide, below this share of
+        // |q|^2 + |x|^2 the distance is recomputed from the difference like the single query
+        constexpr float cancellation_ratio = 1e-2F;
+        for (uint64_t q = 0; q < query_count; ++q) {
+            const auto* query = queries.data() + q * dim;
+            auto query_norm = FP32ComputeIP(query, query, dim);
+            auto* row = dists + q * dists_stride;
+            for (uint64_t i = 0; i < count; ++i) {
+                auto norm_sum = query_norm + code_norms[i];
+                row[i] = norm_sum - 2.0F * row[i];
+                if (row[i] < cancellation_ratio * norm_sum) {
+                    row[i] = FP32ComputeL2Sqr(
+                        query, code_floats + i * (this->code_size_ / sizeof(float)), dim);
+                }
+            }
+        }
+    } else if constexpr (metric == MetricType::METRIC_TYPE_IP or
+                         metric == MetricType::METRIC_TYPE_COSINE) {
+        for (uint64_t q = 0; q < query_count; ++q) {
+            auto* row = dists + q * dists_stride;
+            for (uint64_t i = 0; i < count; ++i) {
+                if (metric == MetricType::METRIC_TYPE_COSINE and this->hold_molds_) {
+                    row[i] /= reinterpret_cast<const float*>(codes + i * this->code_size_)[dim];
+                }
+                row[i] = 1.0F - row[i];
+            }
+        }
+    } else {
+        for (uint64_t q = 0; q < query_count; ++q) {
+            std::fill(dists + q * dists_stride, dists + q * dists_stride + count, 0.0F);
+        }
+    }
+}
+
+template <MetricType metric>
+float
+FP32Quantizer<metric>::CodeNormImpl(const uint8_t* codes) const {
+    const auto* code = reinterpret_cast<const float*>(codes);
+    return FP32ComputeIP(code, code, this->dim_);
+}
+
 template <MetricType metric>
 void
 FP32Quantizer<metric>::ProcessQueryImpl(const float* query,
@@ -253,6 +350,53 @@ FP32Quantizer<metric>::ComputeDistsBatch4Impl(Computer<FP32Quantizer<metric>>& c
     }
 }
 
+template <MetricType metric>
+void
+FP32Quantizer<metric>::ComputeDistsBatchImpl(Computer<FP32Quantizer<metric>>& computer,
+                                             uint64_t count,
+                                             const uint8_t* const* codes,
+                                             float* dists) const {
+    const auto* query = reinterpret_cast<const float*>(computer.buf_);
+    const float* tile[FP32_BATCH16_SIZE];
+    uint64_t i = 0;
+    // without AVX512 the codes go through the Batch4 kernels below
+    uint64_t wide_count = FP32HasWideBatch16 ? count : 0;
+    for (; i + FP32_BATCH16_SIZE <= wide_count; i += FP32_BATCH16_SIZE) {
+        for (uint64_t j = 0; j < FP32_BATCH16_SIZE; ++j) {
+            tile[j] = reinterpret_cast<const float*>(codes[i + j]);
+        }
+        if constexpr (metric == MetricType::METRIC_TYPE_L2SQR) {
+            FP32ComputeL2SqrBatch16(query, this->dim_, tile, dists + i);
+        } else if constexpr (metric == MetricType::METRIC_TYPE_IP or
+                             metric == MetricType::METRIC_TYPE_COSINE) {
+            FP32ComputeIPBatch16(query, this->dim_, tile, dists + i);
+            for (uint64_t j = 0; j < FP32_BATCH16_SIZE; ++j) {
+                if (metric == MetricType::METRIC_TYPE_COSINE and this->hold_molds_) {
+                    dists[i + j] /= tile[j][this->dim_];
+                }
+                dists[i + j] = 1.0F - dists[i + j];
+            }
+        } else {
+            std::fill(dists + i, dists + i + FP32_BATCH16_SIZE, 0.0F);
+        }
+    }
+    for (; i + 3 < count; i += 4) {
+        dists[i] = dists[i + 1] = dists[i + 2] = dists[i + 3] = 0.0F;
+        this->ComputeDistsBatch4Impl(computer,
+                                     codes[i],
+                                     codes[i + 1],
+                                     codes[i + 2],
+                                     codes[i + 3],
+                                     dists[i],
+                                     dists[i + 1],
+                                     dists[i + 2],
+                                     dists[i + 3]);
+    }
+    for (; i < count; ++i) {
+        this->ComputeDistImpl(computer, codes[i], dists + i);
+    }
+}
+
 template <MetricType metric>
 void
 FP32Quantizer<metric>::ReleaseComputerImpl(Computer<FP32Quantizer<metric>>& computer) const {
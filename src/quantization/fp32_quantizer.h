@@ -82,6 +82,30 @@ public:
                       uint64_t count,
                       const uint8_t* codes,
                       float* dists) const;
+
+    void
+    ComputeDistsBatchImpl(Computer<FP32Quantizer<metric>>& computer,
+                          uint64_t count,
+                          const uint8_t* const* codes,
+                          float* dists) const;
+
+    void
+    ScanQueriesBatchDistImpl(Computer<FP32Quantizer<metric>>* const* computers,
+                             uint64_t query_count,
+                             uint64_t count,
+                             const uint8_t* codes,
+                             const float* code_norms,
+                             float* dists,
+                             uint64_t dists_stride) const;
+
+    [[nodiscard]] bool
+    NeedCodeNormsImpl() const {
+        return metric == MetricType::METRIC_TYPE_L2SQR;
+    }
+
+    [[nodiscard]] float
+    CodeNormImpl(const uint8_t* codes) const;
+
     void
     ComputeDistsBatch4Impl(Computer<FP32Quantizer<metric>>& computer,
                            const uint8_t* codes1,
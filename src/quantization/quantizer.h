@@ -226,6 +226,89 @@ public:
         }
     }
 
+    /**
+     * @brief Computes the distances of count codes given by their addresses.
+     *
+     * Quantizers with wide kernels provide ComputeDistsBatchImpl, the others are computed
+     * four codes at a time through ComputeDistsBatch4.
+     */
+    inline void
+    ComputeDistsBatch(Computer<QuantT>& computer,
+                      uint64_t count,
+                      const uint8_t* const* codes,
+                      float* dists) const {
+        if constexpr (has_ComputeDistsBatchImpl<QuantT>::value) {
+            cast().ComputeDistsBatchImpl(computer, count, codes, dists);
+        } else {
+            uint64_t i = 0;
+            for (; i + 3 < count; i += 4) {
+                dists[i] = dists[i + 1] = dists[i + 2] = dists[i + 3] = 0.0F;
+                this->ComputeDistsBatch4(computer,
+                                         codes[i],
+                                         codes[i + 1],
+                                         codes[i + 2],
+                                         codes[i + 3],
+                                         dists[i],
+                                         dists[i + 1],
+                                         dists[i + 2],
+                                         dists[i + 3]);
+            }
+            for (; i < count; ++i) {
+                cast().ComputeDistImpl(computer, codes[i], dists + i);
+            }
+        }
+    }
+
+    /**
+     * @brief Computes the distances of count consecutive codes to every query of computers.
+     *
+     * The distances of the q-th query are written to dists + q * dists_stride. Quantizers
+     * with a matrix kernel provide ScanQueriesBatchDistImpl, the others scan the codes once
+     * per query while they are still in cache. code_norms holds CodeNorm of every code when
+     * NeedCodeNorms is true, or is nullptr to let the scan compute them.
+     */
+    inline void
+    ScanQueriesBatchDists(Computer<QuantT>* const* computers,
+                          uint64_t query_count,
+                          uint64_t count,
+                          const uint8_t* codes,
+                          const float* code_norms,
+                          float* dists,
+                          uint64_t dists_stride) const {
+        if constexpr (has_ScanQueriesBatchDistImpl<QuantT>::value) {
+            cast().ScanQueriesBatchDistImpl(
+                computers, query_count, count, codes, code_norms, dists, dists_stride);
+        } else {
+            for (uint64_t q = 0; q < query_count; ++q) {
+                cast().ScanBatchDistImpl(*computers[q], count, codes, dists + q * dists_stride);
+            }
+        }
+    }
+
+    /**
+     * @brief Whether ScanQueriesBatchDists reads a norm per code.
+     *
+     * Callers that scan the same codes many times keep CodeNorm of every code next to them,
+     * so the norms are computed once per code instead of once per scan.
+     */
+    [[nodiscard]] inline bool
+    NeedCodeNorms() const {
+        if constexpr (has_CodeNormImpl<QuantT>::value) {
+            return cast().NeedCodeNormsImpl();
+        } else {
+            return false;
+        }
+    }
+
+    [[nodiscard]] inline float
+    CodeNorm(const uint8_t* codes) const {
+        if constexpr (has_CodeNormImpl<QuantT>::value) {
+            return cast().CodeNormImpl(codes);
+        } else {
+            return 0.0F;
+        }
+    }
+
     inline void
     ReleaseComputer(Computer<QuantT>& computer) const {
         cast().ReleaseComputerImpl(computer);
@@ -321,6 +404,13 @@ private:
     Allocator* const allocator_{nullptr};
     bool hold_molds_{false};
 
+    GENERATE_HAS_MEMBER_FUNCTION(ComputeDistsBatchImpl,
+                                 void,
+                                 std::declval<Computer<QuantT>&>(),
+                                 std::declval<uint64_t>(),
+                                 std::declval<const uint8_t* const*>(),
+                                 std::declval<float*>())
+
     GENERATE_HAS_MEMBER_FUNCTION(ComputeDistsBatch4Impl,
                                  void,
                                  std::declval<Computer<QuantT>&>(),
@@ -332,6 +422,18 @@ private:
                                  std::declval<float&>(),
                                  std::declval<float&>(),
                                  std::declval<float&>())
+
+    GENERATE_HAS_MEMBER_FUNCTION(ScanQueriesBatchDistImpl,
+                                 void,
+                                 std::declval<Computer<QuantT>* const*>(),
+                                 std::declval<uint64_t>(),
+                                 std::declval<uint64_t>(),
+                                 std::declval<const uint8_t*>(),
+                                 std::declval<const float*>(),
+                                 std::declval<float*>(),
+                                 std::declval<uint64_t>())
+
+    GENERATE_HAS_MEMBER_FUNCTION(CodeNormImpl, float, std::declval<const uint8_t*>())
 };
 
 #define TEMPLATE_QUANTIZER(Name)                        \
@@ -374,6 +374,17 @@ TestComputer(Quantizer<T>& quant,
         for (int j = 0; j < count; ++j) {
             REQUIRE(fixtures::dist_t(dists1[j]) == fixtures::dist_t(dists2[j]));
         }
+
+        // Test Compute Dists Batch
+        std::vector<const uint8_t*> code_ptrs(count);
+        std::vector<float> dists3(count);
+        for (int j = 0; j < count; ++j) {
+            code_ptrs[j] = codes1.data() + j * quant.GetCodeSize();
+        }
+        quant.ComputeDistsBatch(*computer, count, code_ptrs.data(), dists3.data());
+        for (int j = 0; j < count; ++j) {
+            REQUIRE(fixtures::dist_t(dists1[j]) == fixtures::dist_t(dists3[j]));
+        }
     }
     REQUIRE(count_unbounded_numeric_error / (query_count * count) <= unbounded_numeric_error_rate);
     REQUIRE(count_unbounded_related_error / (query_count * count) <= unbounded_related_error_rate);
@@ -34,6 +34,36 @@ struct QueryContext {
 
 class SearchStatistics {
 public:
+    /**
+     * Makes stats the statistics of the query running on the calling thread while the scope
+     * lives. Counters updated deep in the read path, e.g. by the block cache, get no
+     * QueryContext and count into Current() instead, so every thread working for a query,
+     * pool workers included, opens a scope with its stats.
+     */
+    class ThreadScope {
+    public:
+        explicit ThreadScope(SearchStatistics* stats) : previous_(current()) {
+            current() = stats;
+        }
+
+        ~ThreadScope() {
+            current() = previous_;
+        }
+
+        ThreadScope(const ThreadScope&) = delete;
+        ThreadScope&
+        operator=(const ThreadScope&) = delete;
+
+    private:
+        SearchStatistics* previous_{nullptr};
+    };
+
+    // nullptr outside of a ThreadScope
+    static SearchStatistics*
+    Current() {
+        return current();
+    }
+
     [[nodiscard]] std::string
     Dump() const {
         JsonType j;
@@ -42,6 +72,8 @@ public:
         j["hops"].SetInt(hops.load(std::memory_order_relaxed));
         j["io_cnt"].SetInt(io_cnt.load(std::memory_order_relaxed));
         j["io_time_ms"].SetInt(io_time_ms.load(std::memory_order_relaxed));
+        j["cache_hit"].SetInt(cache_hit.load(std::memory_order_relaxed));
+        j["cache_miss"].SetInt(cache_miss.load(std::memory_order_relaxed));
         return j.Dump();
     }
 
@@ -51,6 +83,15 @@ public:
     std::atomic<uint32_t> hops{0};
     std::atomic<uint32_t> io_cnt{0};
     std::atomic<uint32_t> io_time_ms{0};
+    std::atomic<uint32_t> cache_hit{0};
+    std::atomic<uint32_t> cache_miss{0};
+
+private:
+    static SearchStatistics*&
+    current() {
+        static thread_local SearchStatistics* stats = nullptr;
+        return stats;
+    }
 };
 
 inline Allocator*
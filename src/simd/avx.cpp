@@ -283,6 +283,24 @@ FP32ComputeL2SqrBatch4(const float* RESTRICT query,
 #endif
 }
 
+float
+FP32ComputeIPMaxSim(const float* RESTRICT query,
+                    uint64_t query_count,
+                    const float* RESTRICT codes,
+                    uint64_t code_count,
+                    uint64_t dim) {
+    return sse::FP32ComputeIPMaxSim(query, query_count, codes, code_count, dim);
+}
+
+float
+FP32ComputeL2SqrMaxSim(const float* RESTRICT query,
+                       uint64_t query_count,
+                       const float* RESTRICT codes,
+                       uint64_t code_count,
+                       uint64_t dim) {
+    return sse::FP32ComputeL2SqrMaxSim(query, query_count, codes, code_count, dim);
+}
+
 void
 FP32Sub(const float* x, const float* y, float* z, uint64_t dim) {
 #if defined(ENABLE_AVX)
@@ -372,6 +390,34 @@ FP32ReduceAdd(const float* x, uint64_t dim) {
     return sse::FP32ReduceAdd(x, dim);
 }
 
+uint64_t
+FP32SelectLessThan(const float* x, uint64_t dim, float threshold, uint32_t* indices) {
+#if defined(ENABLE_AVX)
+    __m256 thresholds = _mm256_set1_ps(threshold);
+    uint64_t count = 0;
+    uint64_t i = 0;
+    for (; i + 7 < dim; i += 8) {
+        __m256 a = _mm256_loadu_ps(x + i);
+        auto mask =
+            static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(a, thresholds, _CMP_LT_OQ)));
+        while (mask != 0) {
+            indices[count++] = static_cast<uint32_t>(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    if (i < dim) {
+        auto tail = sse::FP32SelectLessThan(x + i, dim - i, threshold, indices + count);
+        for (uint64_t j = 0; j < tail; ++j) {
+            indices[count + j] += static_cast<uint32_t>(i);
+        }
+        count += tail;
+    }
+    return count;
+#else
+    return sse::FP32SelectLessThan(x, dim, threshold, indices);
+#endif
+}
+
 #if defined(ENABLE_AVX)
 __inline __m256i __attribute__((__always_inline__)) load_8_short(const uint16_t* data) {
     return _mm256_set_epi16(data[7],
@@ -13,8 +13,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <limits>
 
 #include "simd.h"
 #include "simd/int8_simd.h"
@@ -292,6 +294,137 @@ FP32ComputeL2SqrBatch4(const float* RESTRICT query,
 #endif
 }
 
+#if defined(ENABLE_AVX2)
+// sums the 8 accumulators of a maxsim tile into one register, lane k holds the sum of sums[k]
+__inline __m256 __attribute__((__always_inline__)) reduce_add_8_ps(const __m256* sums) {
+    __m256 low = _mm256_hadd_ps(_mm256_hadd_ps(sums[0], sums[1]), _mm256_hadd_ps(sums[2], sums[3]));
+    __m256 high =
+        _mm256_hadd_ps(_mm256_hadd_ps(sums[4], sums[5]), _mm256_hadd_ps(sums[6], sums[7]));
+    return _mm256_add_ps(_mm256_permute2f128_ps(low, high, 0x20),
+                         _mm256_permute2f128_ps(low, high, 0x31));
+}
+
+constexpr uint64_t MAX_SIM_TILE_QUERY_COUNT = 4;
+constexpr uint64_t MAX_SIM_TILE_CODE_COUNT = 2;
+
+// one register tile of the maxsim kernels: 4 query rows x 2 code rows, 8 accumulators and 6 loads
+// per 8 dimensions; lane i * 2 + j is the inner product (or l2 square) of query i and code j
+template <bool L2Sqr>
+__inline __m256 __attribute__((__always_inline__))
+compute_max_sim_tile(const float* RESTRICT query, const float* RESTRICT codes, uint64_t dim) {
+    __m256 sums[MAX_SIM_TILE_QUERY_COUNT * MAX_SIM_TILE_CODE_COUNT];
+    for (auto& sum : sums) {
+        sum = _mm256_setzero_ps();
+    }
+    uint64_t d = 0;
+    for (; d + 7 < dim; d += 8) {
+        __m256 code0 = _mm256_loadu_ps(codes + d);
+        __m256 code1 = _mm256_loadu_ps(codes + dim + d);
+        for (uint64_t i = 0; i < MAX_SIM_TILE_QUERY_COUNT; ++i) {
+            __m256 value = _mm256_loadu_ps(query + i * dim + d);
+            if constexpr (L2Sqr) {
+                __m256 diff0 = _mm256_sub_ps(value, code0);
+                __m256 diff1 = _mm256_sub_ps(value, code1);
+                sums[i * 2] = _mm256_fmadd_ps(diff0, diff0, sums[i * 2]);
+                sums[i * 2 + 1] = _mm256_fmadd_ps(diff1, diff1, sums[i * 2 + 1]);
+            } else {
+                sums[i * 2] = _mm256_fmadd_ps(value, code0, sums[i * 2]);
+                sums[i * 2 + 1] = _mm256_fmadd_ps(value, code1, sums[i * 2 + 1]);
+            }
+        }
+    }
+    __m256 result = reduce_add_8_ps(sums);
+    if (d < dim) {
+        alignas(32) float tails[8] = {};
+        for (; d < dim; ++d) {
+            for (uint64_t i = 0; i < MAX_SIM_TILE_QUERY_COUNT; ++i) {
+                for (uint64_t j = 0; j < MAX_SIM_TILE_CODE_COUNT; ++j) {
+                    float value = query[i * dim + d];
+                    float code = codes[j * dim + d];
+                    tails[i * 2 + j] += L2Sqr ? (value - code) * (value - code) : value * code;
+                }
+            }
+        }
+        result = _mm256_add_ps(result, _mm256_load_ps(tails));
+    }
+    return result;
+}
+
+template <bool L2Sqr>
+float
+compute_max_sim(const float* RESTRICT query,
+                uint64_t query_count,
+                const float* RESTRICT codes,
+                uint64_t code_count,
+                uint64_t dim) {
+    if (code_count == 0) {
+        return 0.0F;
+    }
+    const float worst =
+        L2Sqr ? std::numeric_limits<float>::max() : std::numeric_limits<float>::lowest();
+    auto better = [](float a, float b) { return L2Sqr ? std::min(a, b) : std::max(a, b); };
+    auto compute = [dim](const float* a, const float* b) {
+        return L2Sqr ? avx2::FP32ComputeL2Sqr(a, b, dim) : avx2::FP32ComputeIP(a, b, dim);
+    };
+
+    float result = 0.0F;
+    uint64_t i = 0;
+    for (; i + MAX_SIM_TILE_QUERY_COUNT <= query_count; i += MAX_SIM_TILE_QUERY_COUNT) {
+        const float* query_tile = query + i * dim;
+        // the best values of the tile lanes stay in a register across the code rows
+        __m256 best_lanes = _mm256_set1_ps(worst);
+        uint64_t j = 0;
+        for (; j + MAX_SIM_TILE_CODE_COUNT <= code_count; j += MAX_SIM_TILE_CODE_COUNT) {
+            __m256 tile = compute_max_sim_tile<L2Sqr>(query_tile, codes + j * dim, dim);
+            best_lanes = L2Sqr ? _mm256_min_ps(best_lanes, tile) : _mm256_max_ps(best_lanes, tile);
+        }
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, best_lanes);
+        for (uint64_t k = 0; k < MAX_SIM_TILE_QUERY_COUNT; ++k) {
+            float best = better(lanes[k * 2], lanes[k * 2 + 1]);
+            for (uint64_t tail = j; tail < code_count; ++tail) {
+                best = better(best, compute(query_tile + k * dim, codes + tail * dim));
+            }
+            result += best;
+        }
+    }
+    for (; i < query_count; ++i) {
+        float best = worst;
+        for (uint64_t j = 0; j < code_count; ++j) {
+            best = better(best, compute(query + i * dim, codes + j * dim));
+        }
+        result += best;
+    }
+    return result;
+}
+#endif
+
+float
+FP32ComputeIPMaxSim(const float* RESTRICT query,
+                    uint64_t query_count,
+                    const float* RESTRICT codes,
+                    uint64_t code_count,
+                    uint64_t dim) {
+#if defined(ENABLE_AVX2)
+    return compute_max_sim<false>(query, query_count, codes, code_count, dim);
+#else
+    return avx::FP32ComputeIPMaxSim(query, query_count, codes, code_count, dim);
+#endif
+}
+
+float
+FP32ComputeL2SqrMaxSim(const float* RESTRICT query,
+                       uint64_t query_count,
+                       const float* RESTRICT codes,
+                       uint64_t code_count,
+                       uint64_t dim) {
+#if defined(ENABLE_AVX2)
+    return compute_max_sim<true>(query, query_count, codes, code_count, dim);
+#else
+    return avx::FP32ComputeL2SqrMaxSim(query, query_count, codes, code_count, dim);
+#endif
+}
+
 void
 FP32Sub(const float* x, const float* y, float* z, uint64_t dim) {
 #if defined(ENABLE_AVX2)
@@ -397,6 +530,11 @@ FP32ReduceAdd(const float* x, uint64_t dim) {
 #endif
 }
 
+uint64_t
+FP32SelectLessThan(const float* x, uint64_t dim, float threshold, uint32_t* indices) {
+    return avx::FP32SelectLessThan(x, dim, threshold, indices);
+}
+
 #if defined(ENABLE_AVX2)
 __inline __m256i __attribute__((__always_inline__)) load_8_short(const uint16_t* data) {
     __m128i bf16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
@@ -17,7 +17,9 @@
 #include <immintrin.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "simd.h"
 
@@ -296,6 +298,206 @@ FP32ComputeL2SqrBatch4(const float* RESTRICT query,
 #endif
 }
 
+void
+FP32ComputeIPBatch16(const float* RESTRICT query,
+                     uint64_t dim,
+                     const float* const* RESTRICT codes,
+                     float* RESTRICT results) {
+#if defined(ENABLE_AVX512)
+    // one accumulator per vector keeps 16 of the 32 zmm registers busy
+    __m512 sum[FP32_BATCH16_SIZE];
+    for (auto& s : sum) {
+        s = _mm512_setzero_ps();
+    }
+    uint64_t i = 0;
+    for (; i + 15 < dim; i += 16) {
+        __m512 q = _mm512_loadu_ps(query + i);
+        for (uint64_t j = 0; j < FP32_BATCH16_SIZE; ++j) {
+            sum[j] = _mm512_fmadd_ps(q, _mm512_loadu_ps(codes[j] + i), sum[j]);
+        }
+    }
+    if (i < dim) {
+        __mmask16 mask = (1U << (dim - i)) - 1;
+        __m512 q = _mm512_maskz_loadu_ps(mask, query + i);
+        for (uint64_t j = 0; j < FP32_BATCH16_SIZE; ++j) {
+            sum[j] = _mm512_fmadd_ps(q, _mm512_maskz_loadu_ps(mask, codes[j] + i), sum[j]);
+        }
+    }
+    for (uint64_t j = 0; j < FP32_BATCH16_SIZE; ++j) {
+        results[j] = _mm512_reduce_add_ps(sum[j]);
+    }
+#else
+    return generic::FP32ComputeIPBatch16(query, dim, codes, results);
+#endif
+}
+
+void
+FP32ComputeL2SqrBatch16(const float* RESTRICT query,
+                        uint64_t dim,
+                        const float* const* RESTRICT codes,
+                        float* RESTRICT results) {
+#if defined(ENABLE_AVX512)
+    __m512 sum[FP32_BATCH16_SIZE];
+    for (auto& s : sum) {
+        s = _mm512_setzero_ps();
+    }
+    uint64_t i = 0;
+    for (; i + 15 < dim; i += 16) {
+        __m512 q = _mm512_loadu_ps(query + i);
+        for (uint64_t j = 0; j < FP32_BATCH16_SIZE; ++j) {
+            __m512 diff = _mm512_sub_ps(q, _mm512_loadu_ps(codes[j] + i));
+            sum[j] = _mm512_fmadd_ps(diff, diff, sum[j]);
+        }
+    }
+    if (i < dim) {
+        __mmask16 mask = (1U << (dim - i)) - 1;
+        __m512 q = _mm512_maskz_loadu_ps(mask, query + i);
+        for (uint64_t j = 0; j < FP32_BATCH16_SIZE; ++j) {
+            __m512 diff = _mm512_sub_ps(q, _mm512_maskz_loadu_ps(mask, codes[j] + i));
+            sum[j] = _mm512_fmadd_ps(diff, diff, sum[j]);
+        }
+    }
+    for (uint64_t j = 0; j < FP32_BATCH16_SIZE; ++j) {
+        results[j] = _mm512_reduce_add_ps(sum[j]);
+    }
+#else
+    return generic::FP32ComputeL2SqrBatch16(query, dim, codes, results);
+#endif
+}
+
+#if defined(ENABLE_AVX512)
+// sums 8 registers into one, lane k holds the sum of sums[k]
+__inline __m256 __attribute__((__always_inline__)) reduce_add_8_ps(const __m256* sums) {
+    __m256 low = _mm256_hadd_ps(_mm256_hadd_ps(sums[0], sums[1]), _mm256_hadd_ps(sums[2], sums[3]));
+    __m256 high =
+        _mm256_hadd_ps(_mm256_hadd_ps(sums[4], sums[5]), _mm256_hadd_ps(sums[6], sums[7]));
+    return _mm256_add_ps(_mm256_permute2f128_ps(low, high, 0x20),
+                         _mm256_permute2f128_ps(low, high, 0x31));
+}
+
+constexpr uint64_t MAX_SIM_TILE_QUERY_COUNT = 4;
+constexpr uint64_t MAX_SIM_TILE_CODE_COUNT = 4;
+constexpr uint64_t MAX_SIM_TILE_SIZE = MAX_SIM_TILE_QUERY_COUNT * MAX_SIM_TILE_CODE_COUNT;
+
+// one register tile of the maxsim kernels: 4 query rows x 4 code rows, 16 accumulators and 8 loads
+// per 16 dimensions, the tail is masked; lane i * 4 + j is the inner product (or l2 square) of
+// query i and code j
+template <bool L2Sqr>
+__inline __m512 __attribute__((__always_inline__))
+compute_max_sim_tile(const float* RESTRICT query, const float* RESTRICT codes, uint64_t dim) {
+    __m512 sums[MAX_SIM_TILE_SIZE];
+    for (auto& sum : sums) {
+        sum = _mm512_setzero_ps();
+    }
+    for (uint64_t d = 0; d < dim; d += 16) {
+        auto mask = dim - d >= 16 ? static_cast<__mmask16>(0xFFFF)
+                                  : static_cast<__mmask16>((1U << (dim - d)) - 1U);
+        __m512 code[MAX_SIM_TILE_CODE_COUNT];
+        for (uint64_t j = 0; j < MAX_SIM_TILE_CODE_COUNT; ++j) {
+            code[j] = _mm512_maskz_loadu_ps(mask, codes + j * dim + d);
+        }
+        for (uint64_t i = 0; i < MAX_SIM_TILE_QUERY_COUNT; ++i) {
+            __m512 value = _mm512_maskz_loadu_ps(mask, query + i * dim + d);
+            for (uint64_t j = 0; j < MAX_SIM_TILE_CODE_COUNT; ++j) {
+                auto& sum = sums[i * MAX_SIM_TILE_CODE_COUNT + j];
+                if constexpr (L2Sqr) {
+                    __m512 diff = _mm512_sub_ps(value, code[j]);
+                    sum = _mm512_fmadd_ps(diff, diff, sum);
+                } else {
+                    sum = _mm512_fmadd_ps(value, code[j], sum);
+                }
+            }
+        }
+    }
+    __m256 halves[MAX_SIM_TILE_SIZE];
+    for (uint64_t k = 0; k < MAX_SIM_TILE_SIZE; ++k) {
+        halves[k] = _mm256_add_ps(
+            _mm512_castps512_ps256(sums[k]),
+            _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(sums[k]), 1)));
+    }
+    __m512d low = _mm512_castps_pd(_mm512_castps256_ps512(reduce_add_8_ps(halves)));
+    __m256d high = _mm256_castps_pd(reduce_add_8_ps(halves + 8));
+    return _mm512_castpd_ps(_mm512_insertf64x4(low, high, 1));
+}
+
+template <bool L2Sqr>
+float
+compute_max_sim(const float* RESTRICT query,
+                uint64_t query_count,
+                const float* RESTRICT codes,
+                uint64_t code_count,
+                uint64_t dim) {
+    if (code_count == 0) {
+        return 0.0F;
+    }
+    const float worst =
+        L2Sqr ? std::numeric_limits<float>::max() : std::numeric_limits<float>::lowest();
+    auto better = [](float a, float b) { return L2Sqr ? std::min(a, b) : std::max(a, b); };
+    auto compute = [dim](const float* a, const float* b) {
+        return L2Sqr ? avx512::FP32ComputeL2Sqr(a, b, dim) : avx512::FP32ComputeIP(a, b, dim);
+    };
+
+    float result = 0.0F;
+    uint64_t i = 0;
+    for (; i + MAX_SIM_TILE_QUERY_COUNT <= query_count; i += MAX_SIM_TILE_QUERY_COUNT) {
+        const float* query_tile = query + i * dim;
+        // the best values of the tile lanes stay in a register across the code rows
+        __m512 best_lanes = _mm512_set1_ps(worst);
+        uint64_t j = 0;
+        for (; j + MAX_SIM_TILE_CODE_COUNT <= code_count; j += MAX_SIM_TILE_CODE_COUNT) {
+            __m512 tile = compute_max_sim_tile<L2Sqr>(query_tile, codes + j * dim, dim);
+            best_lanes = L2Sqr ? _mm512_min_ps(best_lanes, tile) : _mm512_max_ps(best_lanes, tile);
+        }
+        alignas(64) float lanes[MAX_SIM_TILE_SIZE];
+        _mm512_store_ps(lanes, best_lanes);
+        for (uint64_t k = 0; k < MAX_SIM_TILE_QUERY_COUNT; ++k) {
+            float best = worst;
+            for (uint64_t lane = 0; lane < MAX_SIM_TILE_CODE_COUNT; ++lane) {
+                best = better(best, lanes[k * MAX_SIM_TILE_CODE_COUNT + lane]);
+            }
+            for (uint64_t tail = j; tail < code_count; ++tail) {
+                best = better(best, compute(query_tile + k * dim, codes + tail * dim));
+            }
+            result += best;
+        }
+    }
+    for (; i < query_count; ++i) {
+        float best = worst;
+        for (uint64_t j = 0; j < code_count; ++j) {
+            best = better(best, compute(query + i * dim, codes + j * dim));
+        }
+        result += best;
+    }
+    return result;
+}
+#endif
+
+float
+FP32ComputeIPMaxSim(const float* RESTRICT query,
+                    uint64_t query_count,
+                    const float* RESTRICT codes,
+                    uint64_t code_count,
+                    uint64_t dim) {
+#if defined(ENABLE_AVX512)
+    return compute_max_sim<false>(query, query_count, codes, code_count, dim);
+#else
+    return avx2::FP32ComputeIPMaxSim(query, query_count, codes, code_count, dim);
+#endif
+}
+
+float
+FP32ComputeL2SqrMaxSim(const float* RESTRICT query,
+                       uint64_t query_count,
+                       const float* RESTRICT codes,
+                       uint64_t code_count,
+                       uint64_t dim) {
+#if defined(ENABLE_AVX512)
+    return compute_max_sim<true>(query, query_count, codes, code_count, dim);
+#else
+    return avx2::FP32ComputeL2SqrMaxSim(query, query_count, codes, code_count, dim);
+#endif
+}
+
 void
 FP32Sub(const float* x, const float* y, float* z, uint64_t dim) {
 #if defined(ENABLE_AVX512)
@@ -402,6 +604,34 @@ FP32ReduceAdd(const float* x, uint64_t dim) {
 #endif
 }
 
+uint64_t
+FP32SelectLessThan(const float* x, uint64_t dim, float threshold, uint32_t* indices) {
+#if defined(ENABLE_AVX512)
+    __m512 thresholds = _mm512_set1_ps(threshold);
+    __m512i offsets = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i step = _mm512_set1_epi32(16);
+    uint64_t count = 0;
+    uint64_t i = 0;
+    for (; i + 15 < dim; i += 16) {
+        __m512 a = _mm512_loadu_ps(x + i);
+        __mmask16 mask = _mm512_cmp_ps_mask(a, thresholds, _CMP_LT_OQ);
+        _mm512_mask_compressstoreu_epi32(indices + count, mask, offsets);
+        count += __builtin_popcount(static_cast<uint32_t>(mask));
+        offsets = _mm512_add_epi32(offsets, step);
+    }
+    if (i < dim) {
+        auto tail = avx2::FP32SelectLessThan(x + i, dim - i, threshold, indices + count);
+        for (uint64_t j = 0; j < tail; ++j) {
+            indices[count + j] += static_cast<uint32_t>(i);
+        }
+        count += tail;
+    }
+    return count;
+#else
+    return avx2::FP32SelectLessThan(x, dim, threshold, indices);
+#endif
+}
+
 #if defined(ENABLE_AVX512)
 __inline __m512i __attribute__((__always_inline__)) load_16_short(const uint16_t* data) {
     __m256i bf16 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
@@ -23,10 +23,16 @@ VSAG_DEFINE_SIMD_DISPATCH(FP32ComputeIP, FP32ComputeType);
 VSAG_DEFINE_SIMD_DISPATCH(FP32ComputeL2Sqr, FP32ComputeType);
 VSAG_DEFINE_SIMD_DISPATCH(FP32ComputeIPBatch4, FP32ComputeBatch4Type);
 VSAG_DEFINE_SIMD_DISPATCH(FP32ComputeL2SqrBatch4, FP32ComputeBatch4Type);
+VSAG_DEFINE_SIMD_DISPATCH_AVX512(FP32ComputeIPBatch16, FP32ComputeBatch16Type);
+VSAG_DEFINE_SIMD_DISPATCH_AVX512(FP32ComputeL2SqrBatch16, FP32ComputeBatch16Type);
+const bool FP32HasWideBatch16 = FP32ComputeIPBatch16 != generic::FP32ComputeIPBatch16;
+VSAG_DEFINE_SIMD_DISPATCH(FP32ComputeIPMaxSim, FP32ComputeMaxSimType);
+VSAG_DEFINE_SIMD_DISPATCH(FP32ComputeL2SqrMaxSim, FP32ComputeMaxSimType);
 VSAG_DEFINE_SIMD_DISPATCH(FP32Sub, FP32ArithmeticType);
 VSAG_DEFINE_SIMD_DISPATCH(FP32Add, FP32ArithmeticType);
 VSAG_DEFINE_SIMD_DISPATCH(FP32Mul, FP32ArithmeticType);
 VSAG_DEFINE_SIMD_DISPATCH(FP32Div, FP32ArithmeticType);
 VSAG_DEFINE_SIMD_DISPATCH(FP32ReduceAdd, FP32ReduceType);
+VSAG_DEFINE_SIMD_DISPATCH(FP32SelectLessThan, FP32SelectType);
 
 }  // namespace vsag
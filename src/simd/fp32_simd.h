@@ -48,6 +48,18 @@ namespace vsag {
                            float& result2,                                                    \
                            float& result3,                                                    \
                            float& result4);                                                   \
+    float                                                                                     \
+    FP32ComputeIPMaxSim(const float* RESTRICT query,                                          \
+                        uint64_t query_count,                                                 \
+                        const float* RESTRICT codes,                                          \
+                        uint64_t code_count,                                                  \
+                        uint64_t dim);                                                        \
+    float                                                                                     \
+    FP32ComputeL2SqrMaxSim(const float* RESTRICT query,                                       \
+                           uint64_t query_count,                                              \
+                           const float* RESTRICT codes,                                       \
+                           uint64_t code_count,                                               \
+                           uint64_t dim);                                                     \
     void                                                                                      \
     FP32Sub(const float* x, const float* y, float* z, uint64_t dim);                          \
     void                                                                                      \
@@ -58,6 +70,8 @@ namespace vsag {
     FP32Div(const float* x, const float* y, float* z, uint64_t dim);                          \
     float                                                                                     \
     FP32ReduceAdd(const float* x, uint64_t dim);                                              \
+    uint64_t                                                                                  \
+    FP32SelectLessThan(const float* x, uint64_t dim, float threshold, uint32_t* indices);     \
     }  // namespace ns
 
 DECLARE_FP32_FUNCTIONS(generic)
@@ -69,6 +83,25 @@ DECLARE_FP32_FUNCTIONS(neon)
 DECLARE_FP32_FUNCTIONS(sve)
 #undef DECLARE_FP32_FUNCTIONS
 
+// the 16-wide kernels only pay off with 512-bit registers, other ISAs keep their Batch4 kernels
+#define DECLARE_FP32_BATCH16_FUNCTIONS(ns)                         \
+    namespace ns {                                                 \
+    void                                                           \
+    FP32ComputeIPBatch16(const float* RESTRICT query,              \
+                         uint64_t dim,                             \
+                         const float* const* RESTRICT codes,       \
+                         float* RESTRICT results);                 \
+    void                                                           \
+    FP32ComputeL2SqrBatch16(const float* RESTRICT query,           \
+                            uint64_t dim,                          \
+                            const float* const* RESTRICT codes,    \
+                            float* RESTRICT results);              \
+    }  // namespace ns
+
+DECLARE_FP32_BATCH16_FUNCTIONS(generic)
+DECLARE_FP32_BATCH16_FUNCTIONS(avx512)
+#undef DECLARE_FP32_BATCH16_FUNCTIONS
+
 using FP32ComputeType = float (*)(const float* RESTRICT query,
                                   const float* RESTRICT codes,
                                   uint64_t dim);
@@ -88,6 +121,31 @@ using FP32ComputeBatch4Type = void (*)(const float* RESTRICT query,
 extern FP32ComputeBatch4Type FP32ComputeIPBatch4;
 extern FP32ComputeBatch4Type FP32ComputeL2SqrBatch4;
 
+constexpr uint64_t FP32_BATCH16_SIZE = 16;
+
+// results[j] is the inner product (or l2 square) of query and codes[j], j < FP32_BATCH16_SIZE
+using FP32ComputeBatch16Type = void (*)(const float* RESTRICT query,
+                                        uint64_t dim,
+                                        const float* const* RESTRICT codes,
+                                        float* RESTRICT results);
+extern FP32ComputeBatch16Type FP32ComputeIPBatch16;
+extern FP32ComputeBatch16Type FP32ComputeL2SqrBatch16;
+// true when the Batch16 kernels above are the AVX512 ones; the generic fallback is slower than
+// running the Batch4 kernels four times, so callers only batch by 16 when this is set
+extern const bool FP32HasWideBatch16;
+
+// maxsim of query_count query vectors against code_count code vectors, both stored row by row: the
+// sum over the query vectors of their inner product with the best code vector (the largest one),
+// or of their l2 square to it (the smallest one); 0 when there is no code vector. The block is
+// computed by register tiles and reduced on the fly, no query x code matrix is materialized
+using FP32ComputeMaxSimType = float (*)(const float* RESTRICT query,
+                                        uint64_t query_count,
+                                        const float* RESTRICT codes,
+                                        uint64_t code_count,
+                                        uint64_t dim);
+extern FP32ComputeMaxSimType FP32ComputeIPMaxSim;
+extern FP32ComputeMaxSimType FP32ComputeL2SqrMaxSim;
+
 using FP32ArithmeticType = void (*)(const float* x, const float* y, float* z, uint64_t dim);
 extern FP32ArithmeticType FP32Sub;
 extern FP32ArithmeticType FP32Add;
@@ -96,4 +154,12 @@ extern FP32ArithmeticType FP32Div;
 
 using FP32ReduceType = float (*)(const float* x, uint64_t dim);
 extern FP32ReduceType FP32ReduceAdd;
+
+// writes the positions i < dim with x[i] < threshold to indices in increasing order, returns
+// their count; indices must have room for dim entries
+using FP32SelectType = uint64_t (*)(const float* x,
+                                    uint64_t dim,
+                                    float threshold,
+                                    uint32_t* indices);
+extern FP32SelectType FP32SelectLessThan;
 }  // namespace vsag
@@ -15,7 +15,9 @@
 
 #include "fp32_simd.h"
 
+#include <algorithm>
 #include <catch2/benchmark/catch_benchmark.hpp>
+#include <limits>
 
 #include "simd_status.h"
 #include "unittest.h"
@@ -240,6 +242,148 @@ TEST_CASE("FP32 SIMD Compute", "[ut][simd]") {
     }
 }
 
+#define TEST_FP32_COMPUTE_ACCURACY_BATCH16(Simd, Func, FuncBatch16)                 \
+    {                                                                               \
+        std::vector<float> result(FP32_BATCH16_SIZE, 0.0F);                         \
+        Simd::FuncBatch16(vec1.data() + i * dim, dim, codes.data(), result.data()); \
+        for (uint64_t j = 0; j < FP32_BATCH16_SIZE; ++j) {                          \
+            REQUIRE(fixtures::dist_t(gts[j]) == fixtures::dist_t(result[j]));       \
+        }                                                                           \
+    };
+
+#define TEST_FP32_COMPUTE_ACCURACY_BATCH16_ALL(Func, FuncBatch16)                  \
+    {                                                                              \
+        std::vector<float> gts(FP32_BATCH16_SIZE);                                 \
+        std::vector<const float*> codes(FP32_BATCH16_SIZE);                        \
+        for (uint64_t j = 0; j < FP32_BATCH16_SIZE; ++j) {                         \
+            codes[j] = vec2.data() + (i + j) * dim;                                \
+            gts[j] = generic::Func(vec1.data() + i * dim, codes[j], dim);          \
+        }                                                                          \
+        TEST_FP32_COMPUTE_ACCURACY_BATCH16(generic, Func, FuncBatch16);            \
+        if (SimdStatus::SupportAVX512()) {                                         \
+            TEST_FP32_COMPUTE_ACCURACY_BATCH16(avx512, Func, FuncBatch16);         \
+        }                                                                          \
+    };
+
+TEST_CASE("FP32 SIMD Compute Batch16", "[ut][simd]") {
+    REQUIRE(FP32HasWideBatch16 == SimdStatus::SupportAVX512());
+    const std::vector<int64_t> dims = {7, 16, 33, 256};
+    int64_t count = 64;
+    for (const auto& dim : dims) {
+        auto vec1 = fixtures::generate_vectors(count * 2, dim);
+        std::vector<float> vec2(vec1.begin() + count * dim, vec1.end());
+        for (uint64_t i = 0; i + FP32_BATCH16_SIZE <= count; i += FP32_BATCH16_SIZE) {
+            TEST_FP32_COMPUTE_ACCURACY_BATCH16_ALL(FP32ComputeIP, FP32ComputeIPBatch16);
+            TEST_FP32_COMPUTE_ACCURACY_BATCH16_ALL(FP32ComputeL2Sqr, FP32ComputeL2SqrBatch16);
+        }
+    }
+}
+
+#define TEST_FP32_COMPUTE_ACCURACY_MAX_SIM(Simd)                                            \
+    {                                                                                       \
+        auto ip = Simd::FP32ComputeIPMaxSim(                                                \
+            query.data(), query_count, codes.data(), code_count, dim);                      \
+        auto l2 = Simd::FP32ComputeL2SqrMaxSim(                                             \
+            query.data(), query_count, codes.data(), code_count, dim);                      \
+        REQUIRE(fixtures::dist_t(ip) == fixtures::dist_t(gt_ip));                           \
+        REQUIRE(fixtures::dist_t(l2) == fixtures::dist_t(gt_l2));                           \
+    }
+
+TEST_CASE("FP32 SIMD Compute MaxSim", "[ut][simd]") {
+    const std::vector<int64_t> dims = {7, 16, 33, 256};
+    // covers the full register tiles and the query and code rows left over by them
+    const std::vector<uint64_t> query_counts = {1, 4, 5, 32};
+    const std::vector<uint64_t> code_counts = {0, 1, 3, 4, 7, 80};
+    for (const auto& dim : dims) {
+        for (const auto& query_count : query_counts) {
+            for (const auto& code_count : code_counts) {
+                auto query = fixtures::generate_vectors(query_count, dim);
+                auto codes = fixtures::generate_vectors(code_count, dim, false, 97);
+                float gt_ip = 0.0F;
+                float gt_l2 = 0.0F;
+                for (uint64_t i = 0; i < query_count and code_count > 0; ++i) {
+                    float best_ip = std::numeric_limits<float>::lowest();
+                    float best_l2 = std::numeric_limits<float>::max();
+                    for (uint64_t j = 0; j < code_count; ++j) {
+                        const float* code = codes.data() + j * dim;
+                        best_ip = std::max(
+                            best_ip, generic::FP32ComputeIP(query.data() + i * dim, code, dim));
+                        best_l2 = std::min(
+                            best_l2, generic::FP32ComputeL2Sqr(query.data() + i * dim, code, dim));
+                    }
+                    gt_ip += best_ip;
+                    gt_l2 += best_l2;
+                }
+                TEST_FP32_COMPUTE_ACCURACY_MAX_SIM(generic);
+                if (SimdStatus::SupportSSE()) {
+                    TEST_FP32_COMPUTE_ACCURACY_MAX_SIM(sse);
+                }
+                if (SimdStatus::SupportAVX()) {
+                    TEST_FP32_COMPUTE_ACCURACY_MAX_SIM(avx);
+                }
+                if (SimdStatus::SupportAVX2()) {
+                    TEST_FP32_COMPUTE_ACCURACY_MAX_SIM(avx2);
+                }
+                if (SimdStatus::SupportAVX512()) {
+                    TEST_FP32_COMPUTE_ACCURACY_MAX_SIM(avx512);
+                }
+                if (SimdStatus::SupportNEON()) {
+                    TEST_FP32_COMPUTE_ACCURACY_MAX_SIM(neon);
+                }
+                if (SimdStatus::SupportSVE()) {
+                    TEST_FP32_COMPUTE_ACCURACY_MAX_SIM(sve);
+                }
+            }
+        }
+    }
+}
+
+#define TEST_FP32_SELECT_ACCURACY(Simd)                                                    \
+    {                                                                                      \
+        std::vector<uint32_t> indices(dim);                                                \
+        auto count = Simd::FP32SelectLessThan(vec.data(), dim, threshold, indices.data()); \
+        REQUIRE(count == gt_count);                                                        \
+        for (uint64_t j = 0; j < count; ++j) {                                             \
+            REQUIRE(indices[j] == gt_indices[j]);                                          \
+        }                                                                                  \
+    }
+
+TEST_CASE("FP32 SIMD Select", "[ut][simd]") {
+    const std::vector<int64_t> dims = {1, 7, 16, 33, 256, 1000};
+    const std::vector<float> thresholds = {-1.0F, 0.1F, 0.5F, 2.0F};
+    for (const auto& dim : dims) {
+        auto vec = fixtures::generate_vectors(1, dim);
+        for (const auto& threshold : thresholds) {
+            std::vector<uint32_t> gt_indices;
+            for (int64_t j = 0; j < dim; ++j) {
+                if (vec[j] < threshold) {
+                    gt_indices.emplace_back(j);
+                }
+            }
+            uint64_t gt_count = gt_indices.size();
+            TEST_FP32_SELECT_ACCURACY(generic);
+            if (SimdStatus::SupportSSE()) {
+                TEST_FP32_SELECT_ACCURACY(sse);
+            }
+            if (SimdStatus::SupportAVX()) {
+                TEST_FP32_SELECT_ACCURACY(avx);
+            }
+            if (SimdStatus::SupportAVX2()) {
+                TEST_FP32_SELECT_ACCURACY(avx2);
+            }
+            if (SimdStatus::SupportAVX512()) {
+                TEST_FP32_SELECT_ACCURACY(avx512);
+            }
+            if (SimdStatus::SupportNEON()) {
+                TEST_FP32_SELECT_ACCURACY(neon);
+            }
+            if (SimdStatus::SupportSVE()) {
+                TEST_FP32_SELECT_ACCURACY(sve);
+            }
+        }
+    }
+}
+
 #define BENCHMARK_SIMD_COMPUTE(Simd, Comp)                                 \
     BENCHMARK_ADVANCED(#Simd #Comp) {                                      \
         for (int i = 0; i < count; ++i) {                                  \
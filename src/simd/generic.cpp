@@ -13,6 +13,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <limits>
+
 #include "simd.h"
 #include "simd/int8_simd.h"
 
@@ -151,6 +154,66 @@ FP32ComputeL2SqrBatch4(const float* RESTRICT query,
     }
 }
 
+void
+FP32ComputeIPBatch16(const float* RESTRICT query,
+                     uint64_t dim,
+                     const float* const* RESTRICT codes,
+                     float* RESTRICT results) {
+    for (uint64_t j = 0; j < FP32_BATCH16_SIZE; ++j) {
+        results[j] = FP32ComputeIP(query, codes[j], dim);
+    }
+}
+
+void
+FP32ComputeL2SqrBatch16(const float* RESTRICT query,
+                        uint64_t dim,
+                        const float* const* RESTRICT codes,
+                        float* RESTRICT results) {
+    for (uint64_t j = 0; j < FP32_BATCH16_SIZE; ++j) {
+        results[j] = FP32ComputeL2Sqr(query, codes[j], dim);
+    }
+}
+
+float
+FP32ComputeIPMaxSim(const float* RESTRICT query,
+                    uint64_t query_count,
+                    const float* RESTRICT codes,
+                    uint64_t code_count,
+                    uint64_t dim) {
+    if (code_count == 0) {
+        return 0.0F;
+    }
+    float result = 0.0F;
+    for (uint64_t i = 0; i < query_count; ++i) {
+        float best = std::numeric_limits<float>::lowest();
+        for (uint64_t j = 0; j < code_count; ++j) {
+            best = std::max(best, FP32ComputeIP(query + i * dim, codes + j * dim, dim));
+        }
+        result += best;
+    }
+    return result;
+}
+
+float
+FP32ComputeL2SqrMaxSim(const float* RESTRICT query,
+                       uint64_t query_count,
+                       const float* RESTRICT codes,
+                       uint64_t code_count,
+                       uint64_t dim) {
+    if (code_count == 0) {
+        return 0.0F;
+    }
+    float result = 0.0F;
+    for (uint64_t i = 0; i < query_count; ++i) {
+        float best = std::numeric_limits<float>::max();
+        for (uint64_t j = 0; j < code_count; ++j) {
+            best = std::min(best, FP32ComputeL2Sqr(query + i * dim, codes + j * dim, dim));
+        }
+        result += best;
+    }
+    return result;
+}
+
 void
 FP32Sub(const float* x, const float* y, float* z, uint64_t dim) {
     for (uint64_t i = 0; i < dim; ++i) {
@@ -188,6 +251,17 @@ FP32ReduceAdd(const float* x, uint64_t dim) {
     return result;
 }
 
+uint64_t
+FP32SelectLessThan(const float* x, uint64_t dim, float threshold, uint32_t* indices) {
+    uint64_t count = 0;
+    for (uint64_t i = 0; i < dim; ++i) {
+        // branchless: always store, only advance on a hit
+        indices[count] = static_cast<uint32_t>(i);
+        count += static_cast<uint64_t>(x[i] < threshold);
+    }
+    return count;
+}
+
 union FP32Struct {
     uint32_t int_value;
     float float_value;
@@ -17,8 +17,10 @@
 #include <arm_neon.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <limits>
 
 #include "simd.h"
 
@@ -390,6 +392,138 @@ FP32ComputeL2SqrBatch4(const float* RESTRICT query,
 #endif
 }
 
+#if defined(ENABLE_NEON)
+constexpr uint64_t MAX_SIM_TILE_QUERY_COUNT = 4;
+constexpr uint64_t MAX_SIM_TILE_CODE_COUNT = 2;
+
+// one register tile of the maxsim kernels: 4 query rows x 2 code rows, 8 accumulators and 6 loads
+// per 4 dimensions; lane j of results[i / 2] is the inner product (or l2 square) of query i and
+// code j for even i, lane 2 + j for odd i
+template <bool L2Sqr>
+__inline void __attribute__((__always_inline__))
+compute_max_sim_tile(const float* RESTRICT query,
+                     const float* RESTRICT codes,
+                     uint64_t dim,
+                     float32x4_t* results) {
+    float32x4_t sums[MAX_SIM_TILE_QUERY_COUNT * MAX_SIM_TILE_CODE_COUNT];
+    for (auto& sum : sums) {
+        sum = vdupq_n_f32(0.0F);
+    }
+    uint64_t d = 0;
+    for (; d + 3 < dim; d += 4) {
+        float32x4_t code0 = vld1q_f32(codes + d);
+        float32x4_t code1 = vld1q_f32(codes + dim + d);
+        for (uint64_t i = 0; i < MAX_SIM_TILE_QUERY_COUNT; ++i) {
+            float32x4_t value = vld1q_f32(query + i * dim + d);
+            if constexpr (L2Sqr) {
+                float32x4_t diff0 = vsubq_f32(value, code0);
+                float32x4_t diff1 = vsubq_f32(value, code1);
+                sums[i * 2] = vfmaq_f32(sums[i * 2], diff0, diff0);
+                sums[i * 2 + 1] = vfmaq_f32(sums[i * 2 + 1], diff1, diff1);
+            } else {
+                sums[i * 2] = vfmaq_f32(sums[i * 2], value, code0);
+                sums[i * 2 + 1] = vfmaq_f32(sums[i * 2 + 1], value, code1);
+            }
+        }
+    }
+    results[0] = vpaddq_f32(vpaddq_f32(sums[0], sums[1]), vpaddq_f32(sums[2], sums[3]));
+    results[1] = vpaddq_f32(vpaddq_f32(sums[4], sums[5]), vpaddq_f32(sums[6], sums[7]));
+    if (d < dim) {
+        alignas(16) float tails[MAX_SIM_TILE_QUERY_COUNT * MAX_SIM_TILE_CODE_COUNT] = {};
+        for (; d < dim; ++d) {
+            for (uint64_t i = 0; i < MAX_SIM_TILE_QUERY_COUNT; ++i) {
+                for (uint64_t j = 0; j < MAX_SIM_TILE_CODE_COUNT; ++j) {
+                    float value = query[i * dim + d];
+                    float code = codes[j * dim + d];
+                    tails[i * 2 + j] += L2Sqr ? (value - code) * (value - code) : value * code;
+                }
+            }
+        }
+        results[0] = vaddq_f32(results[0], vld1q_f32(tails));
+        results[1] = vaddq_f32(results[1], vld1q_f32(tails + 4));
+    }
+}
+
+template <bool L2Sqr>
+float
+compute_max_sim(const float* RESTRICT query,
+                uint64_t query_count,
+                const float* RESTRICT codes,
+                uint64_t code_count,
+                uint64_t dim) {
+    if (code_count == 0) {
+        return 0.0F;
+    }
+    const float worst =
+        L2Sqr ? std::numeric_limits<float>::max() : std::numeric_limits<float>::lowest();
+    auto better = [](float a, float b) { return L2Sqr ? std::min(a, b) : std::max(a, b); };
+    auto compute = [dim](const float* a, const float* b) {
+        return L2Sqr ? neon::FP32ComputeL2Sqr(a, b, dim) : neon::FP32ComputeIP(a, b, dim);
+    };
+
+    float result = 0.0F;
+    uint64_t i = 0;
+    for (; i + MAX_SIM_TILE_QUERY_COUNT <= query_count; i += MAX_SIM_TILE_QUERY_COUNT) {
+        const float* query_tile = query + i * dim;
+        // the best values of the tile lanes stay in registers across the code rows
+        float32x4_t best_lanes[2] = {vdupq_n_f32(worst), vdupq_n_f32(worst)};
+        float32x4_t tile[2];
+        uint64_t j = 0;
+        for (; j + MAX_SIM_TILE_CODE_COUNT <= code_count; j += MAX_SIM_TILE_CODE_COUNT) {
+            compute_max_sim_tile<L2Sqr>(query_tile, codes + j * dim, dim, tile);
+            for (uint64_t k = 0; k < 2; ++k) {
+                best_lanes[k] = L2Sqr ? vminq_f32(best_lanes[k], tile[k])
+                                      : vmaxq_f32(best_lanes[k], tile[k]);
+            }
+        }
+        alignas(16) float lanes[MAX_SIM_TILE_QUERY_COUNT * MAX_SIM_TILE_CODE_COUNT];
+        vst1q_f32(lanes, best_lanes[0]);
+        vst1q_f32(lanes + 4, best_lanes[1]);
+        for (uint64_t k = 0; k < MAX_SIM_TILE_QUERY_COUNT; ++k) {
+            float best = better(lanes[k * 2], lanes[k * 2 + 1]);
+            for (uint64_t tail = j; tail < code_count; ++tail) {
+                best = better(best, compute(query_tile + k * dim, codes + tail * dim));
+            }
+            result += best;
+        }
+    }
+    for (; i < query_count; ++i) {
+        float best = worst;
+        for (uint64_t j = 0; j < code_count; ++j) {
+            best = better(best, compute(query + i * dim, codes + j * dim));
+        }
+        result += best;
+    }
+    return result;
+}
+#endif
+
+float
+FP32ComputeIPMaxSim(const float* RESTRICT query,
+                    uint64_t query_count,
+                    const float* RESTRICT codes,
+                    uint64_t code_count,
+                    uint64_t dim) {
+#if defined(ENABLE_NEON)
+    return compute_max_sim<false>(query, query_count, codes, code_count, dim);
+#else
+    return generic::FP32ComputeIPMaxSim(query, query_count, codes, code_count, dim);
+#endif
+}
+
+float
+FP32ComputeL2SqrMaxSim(const float* RESTRICT query,
+                       uint64_t query_count,
+                       const float* RESTRICT codes,
+                       uint64_t code_count,
+                       uint64_t dim) {
+#if defined(ENABLE_NEON)
+    return compute_max_sim<true>(query, query_count, codes, code_count, dim);
+#else
+    return generic::FP32ComputeL2SqrMaxSim(query, query_count, codes, code_count, dim);
+#endif
+}
+
 void
 FP32Sub(const float* x, const float* y, float* z, uint64_t dim) {
 #if defined(ENABLE_NEON)
@@ -496,6 +630,37 @@ FP32ReduceAdd(const float* x, uint64_t dim) {
 #endif
 }
 
+uint64_t
+FP32SelectLessThan(const float* x, uint64_t dim, float threshold, uint32_t* indices) {
+#if defined(ENABLE_NEON)
+    float32x4_t thresholds = vdupq_n_f32(threshold);
+    uint64_t count = 0;
+    uint64_t i = 0;
+    for (; i + 3 < dim; i += 4) {
+        uint32x4_t mask = vcltq_f32(vld1q_f32(x + i), thresholds);
+        if (vmaxvq_u32(mask) == 0) {
+            continue;
+        }
+        uint32_t lanes[4];
+        vst1q_u32(lanes, mask);
+        for (uint32_t j = 0; j < 4; ++j) {
+            indices[count] = static_cast<uint32_t>(i + j);
+            count += lanes[j] & 1U;
+        }
+    }
+    if (i < dim) {
+        auto tail = generic::FP32SelectLessThan(x + i, dim - i, threshold, indices + count);
+        for (uint64_t j = 0; j < tail; ++j) {
+            indices[count + j] += static_cast<uint32_t>(i);
+        }
+        count += tail;
+    }
+    return count;
+#else
+    return generic::FP32SelectLessThan(x, dim, threshold, indices);
+#endif
+}
+
 #if defined(ENABLE_NEON)
 __inline uint16x8_t __attribute__((__always_inline__)) load_4_short(const uint16_t* data) {
     uint16_t tmp[] = {data[3], 0, data[2], 0, data[1], 0, data[0], 0};
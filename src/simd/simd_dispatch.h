@@ -174,4 +174,19 @@ namespace vsag {
     }                                                      \
     FnType FnName = Get##FnName()
 
+// Register a narrow dispatch for wide kernels that only have an AVX512
+// implementation. The other ISAs are intentionally skipped and get the
+// generic reference, callers check for it before choosing the kernel.
+//
+// Usage:
+//     VSAG_DEFINE_SIMD_DISPATCH_AVX512(FP32ComputeIPBatch16, FP32ComputeBatch16Type);
+#define VSAG_DEFINE_SIMD_DISPATCH_AVX512(FnName, FnType) \
+    static FnType Get##FnName() {                        \
+        if (SimdStatus::SupportAVX512()) {               \
+            VSAG_SIMD_DISPATCH_BODY_AVX512(FnName)       \
+        }                                                \
+        return generic::FnName;                          \
+    }                                                    \
+    FnType FnName = Get##FnName()
+
 }  // namespace vsag
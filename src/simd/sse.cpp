@@ -268,6 +268,24 @@ FP32ComputeL2SqrBatch4(const float* RESTRICT query,
 #endif
 }
 
+float
+FP32ComputeIPMaxSim(const float* RESTRICT query,
+                    uint64_t query_count,
+                    const float* RESTRICT codes,
+                    uint64_t code_count,
+                    uint64_t dim) {
+    return generic::FP32ComputeIPMaxSim(query, query_count, codes, code_count, dim);
+}
+
+float
+FP32ComputeL2SqrMaxSim(const float* RESTRICT query,
+                       uint64_t query_count,
+                       const float* RESTRICT codes,
+                       uint64_t code_count,
+                       uint64_t dim) {
+    return generic::FP32ComputeL2SqrMaxSim(query, query_count, codes, code_count, dim);
+}
+
 void
 FP32Sub(const float* x, const float* y, float* z, uint64_t dim) {
 #if defined(ENABLE_SSE)
@@ -376,6 +394,33 @@ FP32ReduceAdd(const float* x, uint64_t dim) {
 #endif
 }
 
+uint64_t
+FP32SelectLessThan(const float* x, uint64_t dim, float threshold, uint32_t* indices) {
+#if defined(ENABLE_SSE)
+    __m128 thresholds = _mm_set1_ps(threshold);
+    uint64_t count = 0;
+    uint64_t i = 0;
+    for (; i + 3 < dim; i += 4) {
+        __m128 a = _mm_loadu_ps(x + i);
+        auto mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(a, thresholds)));
+        while (mask != 0) {
+            indices[count++] = static_cast<uint32_t>(i + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    if (i < dim) {
+        auto tail = generic::FP32SelectLessThan(x + i, dim - i, threshold, indices + count);
+        for (uint64_t j = 0; j < tail; ++j) {
+            indices[count + j] += static_cast<uint32_t>(i);
+        }
+        count += tail;
+    }
+    return count;
+#else
+    return generic::FP32SelectLessThan(x, dim, threshold, indices);
+#endif
+}
+
 float
 BF16ComputeIP(const uint8_t* RESTRICT query, const uint8_t* RESTRICT codes, uint64_t dim) {
 #if defined(ENABLE_SSE)
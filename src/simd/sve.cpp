@@ -305,6 +305,24 @@ FP32ComputeL2SqrBatch4(const float* RESTRICT query,
 #endif
 }
 
+float
+FP32ComputeIPMaxSim(const float* RESTRICT query,
+                    uint64_t query_count,
+                    const float* RESTRICT codes,
+                    uint64_t code_count,
+                    uint64_t dim) {
+    return neon::FP32ComputeIPMaxSim(query, query_count, codes, code_count, dim);
+}
+
+float
+FP32ComputeL2SqrMaxSim(const float* RESTRICT query,
+                       uint64_t query_count,
+                       const float* RESTRICT codes,
+                       uint64_t code_count,
+                       uint64_t dim) {
+    return neon::FP32ComputeL2SqrMaxSim(query, query_count, codes, code_count, dim);
+}
+
 void
 FP32Sub(const float* x, const float* y, float* z, uint64_t dim) {
 #if defined(ENABLE_SVE)
@@ -407,6 +425,34 @@ FP32ReduceAdd(const float* x, uint64_t dim) {
 #endif
 }
 
+uint64_t
+FP32SelectLessThan(const float* x, uint64_t dim, float threshold, uint32_t* indices) {
+#if defined(ENABLE_SVE)
+    uint64_t count = 0;
+    uint64_t i = 0;
+    const uint64_t step = svcntw();
+    svuint32_t offsets = svindex_u32(0, 1);
+    svbool_t predicate = svwhilelt_b32(i, dim);
+    do {
+        svfloat32_t x_vec = svld1_f32(predicate, x + i);
+        svbool_t hits = svcmplt_n_f32(predicate, x_vec, threshold);
+        uint64_t hit_count = svcntp_b32(predicate, hits);
+        if (hit_count > 0) {
+            svuint32_t positions = svadd_n_u32_x(predicate, offsets, static_cast<uint32_t>(i));
+            svuint32_t selected = svcompact_u32(hits, positions);
+            svbool_t store_predicate = svwhilelt_b32(static_cast<uint64_t>(0), hit_count);
+            svst1_u32(store_predicate, indices + count, selected);
+            count += hit_count;
+        }
+        i += step;
+        predicate = svwhilelt_b32(i, dim);
+    } while (svptest_first(svptrue_b32(), predicate));
+    return count;
+#else
+    return neon::FP32SelectLessThan(x, dim, threshold, indices);
+#endif
+}
+
 float
 BF16ComputeIP(const uint8_t* RESTRICT query, const uint8_t* RESTRICT codes, uint64_t dim) {
 #if defined(ENABLE_SVE)
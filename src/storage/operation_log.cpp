@@ -0,0 +1,713 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "operation_log.h"
+
+#include <fcntl.h>
+#include <fmt/format.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <thread>
+
+#include "impl/logger/logger.h"
+#include "io/io_syscall.h"
+#include "utils/crc32.h"
+#include "vsag_exception.h"
+
+namespace vsag {
+
+namespace {
+
+constexpr char LOG_MAGIC[8] = {'V', 'S', 'A', 'G', 'O', 'P', 'L', 'G'};
+constexpr uint32_t LOG_VERSION = 1;
+
+constexpr uint32_t HAS_IDS = 1U << 0;
+constexpr uint32_t HAS_FLOAT32 = 1U << 1;
+constexpr uint32_t HAS_INT8 = 1U << 2;
+constexpr uint32_t HAS_FLOAT16 = 1U << 3;
+constexpr uint32_t HAS_SPARSE = 1U << 4;
+constexpr uint32_t HAS_EXTRA_INFO = 1U << 5;
+constexpr uint32_t HAS_ATTRIBUTE = 1U << 6;
+constexpr uint32_t HAS_MULTI_VECTOR = 1U << 7;
+constexpr uint32_t HAS_PATH = 1U << 8;
+
+class StringStreamWriter : public StreamWriter {
+public:
+    explicit StringStreamWriter(std::string& buffer) : buffer_(buffer) {
+    }
+
+    void
+    Write(const char* data, uint64_t size) override {
+        buffer_.append(data, size);
+        bytes_written_ += size;
+    }
+
+private:
+    std::string& buffer_;
+};
+
+void
+write_fully(int fd, const char* data, uint64_t size, uint64_t offset) {
+    while (size > 0) {
+        auto ret = IOSyscall::PWrite(fd, data, size, offset);
+        if (ret <= 0) {
+            throw VsagException(ErrorType::INTERNAL_ERROR,
+                                fmt::format("write operation log error {}", strerror(errno)));
+        }
+        data += ret;
+        size -= ret;
+        offset += ret;
+    }
+}
+
+bool
+read_fully(int fd, char* data, uint64_t size, uint64_t offset) {
+    while (size > 0) {
+        auto ret = IOSyscall::PRead(fd, data, size, offset);
+        if (ret <= 0) {
+            return false;
+        }
+        data += ret;
+        size -= ret;
+        offset += ret;
+    }
+    return true;
+}
+
+void
+sync_file(int fd) {
+#ifdef __APPLE__
+    auto ret = fsync(fd);
+#else
+    auto ret = fdatasync(fd);
+#endif
+    if (ret != 0) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            fmt::format("sync operation log error {}", strerror(errno)));
+    }
+}
+
+// makes a created or renamed file durable in its directory
+void
+sync_directory(const std::string& path) {
+    auto directory = std::filesystem::path(path).parent_path();
+    if (directory.empty()) {
+        directory = ".";
+    }
+    auto fd = open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+template <typename T>
+void
+write_array(StreamWriter& writer, const T* data, uint64_t count) {
+    writer.Write(reinterpret_cast<const char*>(data), count * sizeof(T));
+}
+
+template <typename T>
+T*
+read_array(StreamReader& reader, uint64_t count) {
+    auto* data = new T[count];
+    reader.Read(reinterpret_cast<char*>(data), count * sizeof(T));
+    return data;
+}
+
+template <typename T>
+void
+write_attribute_value(StreamWriter& writer, const Attribute* attr) {
+    const auto& values = dynamic_cast<const AttributeValue<T>*>(attr)->GetValue();
+    if constexpr (std::is_same_v<T, std::string>) {
+        StreamWriter::WriteObj(writer, static_cast<uint64_t>(values.size()));
+        for (const auto& value : values) {
+            StreamWriter::WriteString(writer, value);
+        }
+    } else {
+        StreamWriter::WriteVector(writer, values);
+    }
+}
+
+template <typename T>
+Attribute*
+read_attribute_value(StreamReader& reader) {
+    auto* attr = new AttributeValue<T>();
+    if constexpr (std::is_same_v<T, std::string>) {
+        uint64_t count = 0;
+        StreamReader::ReadObj(reader, count);
+        attr->GetValue().resize(count);
+        for (auto& value : attr->GetValue()) {
+            value = StreamReader::ReadString(reader);
+        }
+    } else {
+        StreamReader::ReadVector(reader, attr->GetValue());
+    }
+    return attr;
+}
+
+}  // namespace
+
+OperationLog::OperationLog(std::string path, uint64_t group_commit_delay_us)
+    : path_(std::move(path)), group_commit_delay_us_(group_commit_delay_us) {
+    if (std::filesystem::is_directory(this->path_)) {
+        throw VsagException(ErrorType::INVALID_ARGUMENT,
+                            fmt::format("operation log {} is a directory", this->path_));
+    }
+    this->open_and_recover();
+}
+
+OperationLog::~OperationLog() {
+    if (this->fd_ >= 0) {
+        close(this->fd_);
+    }
+}
+
+void
+OperationLog::open_and_recover() {
+    bool exist = std::filesystem::exists(this->path_);
+    this->fd_ = open(this->path_.c_str(), O_CREAT | O_RDWR, 0644);
+    if (this->fd_ < 0) {
+        throw VsagException(
+            ErrorType::INTERNAL_ERROR,
+            fmt::format("open operation log {} error {}", this->path_, strerror(errno)));
+    }
+
+    auto size = static_cast<uint64_t>(lseek(this->fd_, 0, SEEK_END));
+    if (not exist or size == 0) {
+        this->write_header(this->fd_, 0);
+        sync_file(this->fd_);
+        sync_directory(this->path_);
+        this->file_end_ = HEADER_SIZE;
+        return;
+    }
+
+    char header[HEADER_SIZE];
+    uint32_t version = 0;
+    if (size < HEADER_SIZE or not read_fully(this->fd_, header, HEADER_SIZE, 0) or
+        std::memcmp(header, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0) {
+        throw VsagException(ErrorType::INVALID_BINARY,
+                            fmt::format("{} is not an operation log", this->path_));
+    }
+    std::memcpy(&version, header + sizeof(LOG_MAGIC), sizeof(version));
+    if (version != LOG_VERSION) {
+        throw VsagException(
+            ErrorType::INVALID_BINARY,
+            fmt::format("unsupported version {} of operation log {}", version, this->path_));
+    }
+    std::memcpy(&this->base_lsn_, header + 16, sizeof(this->base_lsn_));
+
+    this->last_lsn_ = this->base_lsn_;
+    auto valid_end = this->scan(this->fd_, size, [this](uint64_t lsn, OperationType, std::string&) {
+        this->last_lsn_ = lsn;
+    });
+    if (valid_end < size) {
+        // a crash in the middle of an append leaves a partial record, it was never acknowledged
+        logger::warn("operation log {} has {} invalid bytes at its tail, truncated",
+                     this->path_,
+                     size - valid_end);
+        if (IOSyscall::FTruncate(this->fd_, valid_end) != 0) {
+            throw VsagException(ErrorType::INTERNAL_ERROR, "ftruncate failed");
+        }
+        sync_file(this->fd_);
+    }
+    this->file_end_ = valid_end;
+    this->durable_lsn_ = this->last_lsn_;
+    this->pending_lsn_ = this->last_lsn_;
+}
+
+void
+OperationLog::write_header(int fd, uint64_t base_lsn) const {
+    char header[HEADER_SIZE] = {0};
+    std::memcpy(header, LOG_MAGIC, sizeof(LOG_MAGIC));
+    std::memcpy(header + sizeof(LOG_MAGIC), &LOG_VERSION, sizeof(LOG_VERSION));
+    std::memcpy(header + 16, &base_lsn, sizeof(base_lsn));
+    write_fully(fd, header, HEADER_SIZE, 0);
+}
+
+uint64_t
+OperationLog::scan(int fd,
+                   uint64_t end,
+                   const std::function<void(uint64_t, OperationType, std::string&)>& func) const {
+    uint64_t offset = HEADER_SIZE;
+    uint64_t prev_lsn = 0;
+    char record_header[RECORD_HEADER_SIZE];
+    std::string payload;
+    while (offset + RECORD_HEADER_SIZE <= end) {
+        if (not read_fully(fd, record_header, RECORD_HEADER_SIZE, offset)) {
+            break;
+        }
+        uint32_t payload_size = 0;
+        uint32_t crc = 0;
+        uint64_t lsn = 0;
+        std::memcpy(&payload_size, record_header, sizeof(payload_size));
+        std::memcpy(&crc, record_header + 4, sizeof(crc));
+        std::memcpy(&lsn, record_header + 8, sizeof(lsn));
+        auto type = static_cast<OperationType>(record_header[16]);
+        if (offset + RECORD_HEADER_SIZE + payload_size > end or lsn <= prev_lsn) {
+            break;
+        }
+        payload.resize(payload_size);
+        if (not read_fully(fd, payload.data(), payload_size, offset + RECORD_HEADER_SIZE)) {
+            break;
+        }
+        auto expected = Crc32(record_header + 8, 9, Crc32(payload.data(), payload_size));
+        if (expected != crc) {
+            break;
+        }
+        func(lsn, type, payload);
+        prev_lsn = lsn;
+        offset += RECORD_HEADER_SIZE + payload_size;
+    }
+    return offset;
+}
+
+uint64_t
+OperationLog::Append(OperationType type, const PayloadWriter& payload) {
+    auto record = Prepare(type, payload);
+    auto lsn = this->Enqueue(record);
+    this->WaitDurable(lsn);
+    return lsn;
+}
+
+std::string
+OperationLog::Prepare(OperationType type, const PayloadWriter& payload) {
+    // the payload and its checksum are built outside the lock, the lsn is patched in by Enqueue
+    std::string record(RECORD_HEADER_SIZE, '\0');
+    StringStreamWriter writer(record);
+    payload(writer);
+    auto payload_size = record.size() - RECORD_HEADER_SIZE;
+    if (payload_size > std::numeric_limits<uint32_t>::max()) {
+        throw VsagException(ErrorType::INVALID_ARGUMENT,
+                            fmt::format("operation of {} bytes is too large to log", payload_size));
+    }
+    auto payload_crc = Crc32(record.data() + RECORD_HEADER_SIZE, payload_size);
+    auto size32 = static_cast<uint32_t>(payload_size);
+    std::memcpy(record.data(), &size32, sizeof(size32));
+    std::memcpy(record.data() + 4, &payload_crc, sizeof(payload_crc));
+    record[16] = static_cast<char>(type);
+    return record;
+}
+
+uint64_t
+OperationLog::Enqueue(std::string& record) {
+    std::scoped_lock lock(this->mutex_);
+    this->check_writable();
+    uint32_t payload_crc = 0;
+    std::memcpy(&payload_crc, record.data() + 4, sizeof(payload_crc));
+    auto lsn = ++this->last_lsn_;
+    std::memcpy(record.data() + 8, &lsn, sizeof(lsn));
+    auto crc = Crc32(record.data() + 8, 9, payload_crc);
+    std::memcpy(record.data() + 4, &crc, sizeof(crc));
+    this->pending_.append(record);
+    this->pending_lsn_ = lsn;
+    return lsn;
+}
+
+void
+OperationLog::WaitDurable(uint64_t lsn) {
+    std::unique_lock lock(this->mutex_);
+    while (this->durable_lsn_ < lsn) {
+        if (this->broken_) {
+            throw VsagException(ErrorType::INTERNAL_ERROR,
+                                fmt::format("failed to write operation log {}", this->path_));
+        }
+        if (this->flushing_) {
+            this->flushed_cv_.wait(lock);
+        } else {
+            this->flush_batch(lock);
+        }
+    }
+}
+
+void
+OperationLog::CheckWritable() const {
+    std::scoped_lock lock(this->mutex_);
+    this->check_writable();
+}
+
+void
+OperationLog::check_writable() const {
+    if (this->broken_) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            fmt::format("operation log {} failed to write before", this->path_));
+    }
+}
+
+void
+OperationLog::flush_batch(std::unique_lock<std::mutex>& lock) {
+    this->flushing_ = true;
+    if (this->group_commit_delay_us_ > 0) {
+        // let more appenders join the batch
+        lock.unlock();
+        std::this_thread::sleep_for(std::chrono::microseconds(this->group_commit_delay_us_));
+        lock.lock();
+    }
+    std::string batch;
+    batch.swap(this->pending_);
+    auto batch_lsn = this->pending_lsn_;
+    auto offset = this->file_end_;
+
+    lock.unlock();
+    bool success = true;
+    try {
+        write_fully(this->fd_, batch.data(), batch.size(), offset);
+        sync_file(this->fd_);
+    } catch (const VsagException& e) {
+        logger::error("{}", e.what());
+        success = false;
+    }
+    lock.lock();
+
+    if (success) {
+        this->file_end_ += batch.size();
+        this->durable_lsn_ = batch_lsn;
+    } else {
+        // the records after a failed write cannot be made durable in order anymore
+        this->broken_ = true;
+    }
+    this->flushing_ = false;
+    this->flushed_cv_.notify_all();
+}
+
+uint64_t
+OperationLog::Replay(uint64_t after_lsn, const ReplayFunc& func) const {
+    uint64_t end = 0;
+    {
+        std::scoped_lock lock(this->mutex_);
+        end = this->file_end_;
+    }
+    uint64_t count = 0;
+    this->scan(this->fd_, end, [&](uint64_t lsn, OperationType type, std::string& payload) {
+        if (lsn <= after_lsn) {
+            return;
+        }
+        ReadFuncStreamReader reader(
+            [&payload](uint64_t offset, uint64_t size, void* dest) {
+                if (offset + size > payload.size()) {
+                    throw VsagException(ErrorType::INVALID_BINARY,
+                                        "operation log record is shorter than its content");
+                }
+                std::memcpy(dest, payload.data() + offset, size);
+            },
+            0,
+            payload.size());
+        func(lsn, type, reader);
+        ++count;
+    });
+    return count;
+}
+
+void
+OperationLog::Truncate(uint64_t lsn) {
+    std::unique_lock lock(this->mutex_);
+    while (this->flushing_) {
+        this->flushed_cv_.wait(lock);
+    }
+    if (lsn <= this->base_lsn_) {
+        return;
+    }
+
+    // the kept records are copied into a new file which atomically replaces the log
+    auto tmp_path = this->path_ + ".tmp";
+    auto tmp_fd = open(tmp_path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+    if (tmp_fd < 0) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            fmt::format("open file {} error {}", tmp_path, strerror(errno)));
+    }
+    uint64_t tmp_end = HEADER_SIZE;
+    try {
+        this->write_header(tmp_fd, lsn);
+        char record_header[RECORD_HEADER_SIZE];
+        auto copy = [&](uint64_t record_lsn, OperationType type, std::string& payload) {
+            if (record_lsn <= lsn) {
+                return;
+            }
+            uint32_t payload_size = payload.size();
+            std::memcpy(record_header, &payload_size, sizeof(payload_size));
+            std::memcpy(record_header + 8, &record_lsn, sizeof(record_lsn));
+            record_header[16] = static_cast<char>(type);
+            auto crc = Crc32(record_header + 8, 9, Crc32(payload.data(), payload.size()));
+            std::memcpy(record_header + 4, &crc, sizeof(crc));
+            write_fully(tmp_fd, record_header, RECORD_HEADER_SIZE, tmp_end);
+            write_fully(tmp_fd, payload.data(), payload.size(), tmp_end + RECORD_HEADER_SIZE);
+            tmp_end += RECORD_HEADER_SIZE + payload.size();
+        };
+        this->scan(this->fd_, this->file_end_, copy);
+        sync_file(tmp_fd);
+        if (rename(tmp_path.c_str(), this->path_.c_str()) != 0) {
+            throw VsagException(
+                ErrorType::INTERNAL_ERROR,
+                fmt::format("rename {} to {} error {}", tmp_path, this->path_, strerror(errno)));
+        }
+    } catch (...) {
+        close(tmp_fd);
+        std::filesystem::remove(tmp_path);
+        throw;
+    }
+    sync_directory(this->path_);
+
+    close(this->fd_);
+    this->fd_ = tmp_fd;
+    this->file_end_ = tmp_end;
+    this->base_lsn_ = lsn;
+    if (this->last_lsn_ < lsn) {
+        // the log lags behind the snapshot, number the next records after it
+        this->last_lsn_ = lsn;
+        this->durable_lsn_ = lsn;
+        this->pending_lsn_ = lsn;
+    }
+}
+
+uint64_t
+OperationLog::LastLsn() const {
+    std::scoped_lock lock(this->mutex_);
+    return this->last_lsn_;
+}
+
+uint64_t
+OperationLog::FileSize() const {
+    std::scoped_lock lock(this->mutex_);
+    return this->file_end_;
+}
+
+void
+OperationLog::WriteDataset(StreamWriter& writer,
+                           const DatasetPtr& dataset,
+                           int64_t extra_info_size) {
+    auto num = static_cast<uint64_t>(dataset->GetNumElements());
+    auto dim = static_cast<uint64_t>(dataset->GetDim());
+    if (dataset->GetExtraInfoSize() > 0) {
+        extra_info_size = dataset->GetExtraInfoSize();
+    }
+    uint32_t flags = 0;
+    flags |= dataset->GetIds() != nullptr ? HAS_IDS : 0;
+    flags |= dataset->GetFloat32Vectors() != nullptr ? HAS_FLOAT32 : 0;
+    flags |= dataset->GetInt8Vectors() != nullptr ? HAS_INT8 : 0;
+    flags |= dataset->GetFloat16Vectors() != nullptr ? HAS_FLOAT16 : 0;
+    flags |= dataset->GetSparseVectors() != nullptr ? HAS_SPARSE : 0;
+    flags |= dataset->GetExtraInfos() != nullptr and extra_info_size > 0 ? HAS_EXTRA_INFO : 0;
+    flags |= dataset->GetAttributeSets() != nullptr ? HAS_ATTRIBUTE : 0;
+    flags |= dataset->GetMultiVectors() != nullptr ? HAS_MULTI_VECTOR : 0;
+    flags |= dataset->GetPaths() != nullptr ? HAS_PATH : 0;
+
+    StreamWriter::WriteObj(writer, flags);
+    StreamWriter::WriteObj(writer, num);
+    StreamWriter::WriteObj(writer, dim);
+    if ((flags & HAS_IDS) != 0) {
+        write_array(writer, dataset->GetIds(), num);
+    }
+    if ((flags & HAS_FLOAT32) != 0) {
+        write_array(writer, dataset->GetFloat32Vectors(), num * dim);
+    }
+    if ((flags & HAS_INT8) != 0) {
+        write_array(writer, dataset->GetInt8Vectors(), num * dim);
+    }
+    if ((flags & HAS_FLOAT16) != 0) {
+        write_array(writer, dataset->GetFloat16Vectors(), num * dim);
+    }
+    if ((flags & HAS_SPARSE) != 0) {
+        const auto* sparse_vectors = dataset->GetSparseVectors();
+        for (uint64_t i = 0; i < num; ++i) {
+            StreamWriter::WriteObj(writer, sparse_vectors[i].len_);
+            write_array(writer, sparse_vectors[i].ids_, sparse_vectors[i].len_);
+            write_array(writer, sparse_vectors[i].vals_, sparse_vectors[i].len_);
+        }
+    }
+    if ((flags & HAS_EXTRA_INFO) != 0) {
+        StreamWriter::WriteObj(writer, extra_info_size);
+        write_array(writer, dataset->GetExtraInfos(), num * extra_info_size);
+    }
+    if ((flags & HAS_ATTRIBUTE) != 0) {
+        for (uint64_t i = 0; i < num; ++i) {
+            WriteAttributeSet(writer, dataset->GetAttributeSets()[i]);
+        }
+    }
+    if ((flags & HAS_MULTI_VECTOR) != 0) {
+        auto multi_dim = dataset->GetMultiVectorDim();
+        StreamWriter::WriteObj(writer, multi_dim);
+        const auto* multi_vectors = dataset->GetMultiVectors();
+        for (uint64_t i = 0; i < num; ++i) {
+            StreamWriter::WriteObj(writer, multi_vectors[i].len_);
+            write_array(writer, multi_vectors[i].vectors_, multi_vectors[i].len_ * multi_dim);
+        }
+    }
+    if ((flags & HAS_PATH) != 0) {
+        for (uint64_t i = 0; i < num; ++i) {
+            StreamWriter::WriteString(writer, dataset->GetPaths()[i]);
+        }
+    }
+}
+
+DatasetPtr
+OperationLog::ReadDataset(StreamReader& reader) {
+    uint32_t flags = 0;
+    uint64_t num = 0;
+    uint64_t dim = 0;
+    StreamReader::ReadObj(reader, flags);
+    StreamReader::ReadObj(reader, num);
+    StreamReader::ReadObj(reader, dim);
+
+    auto dataset = Dataset::Make();
+    dataset->Owner(true)->NumElements(static_cast<int64_t>(num))->Dim(static_cast<int64_t>(dim));
+    if ((flags & HAS_IDS) != 0) {
+        dataset->Ids(read_array<int64_t>(reader, num));
+    }
+    if ((flags & HAS_FLOAT32) != 0) {
+        dataset->Float32Vectors(read_array<float>(reader, num * dim));
+    }
+    if ((flags & HAS_INT8) != 0) {
+        dataset->Int8Vectors(read_array<int8_t>(reader, num * dim));
+    }
+    if ((flags & HAS_FLOAT16) != 0) {
+        dataset->Float16Vectors(read_array<uint16_t>(reader, num * dim));
+    }
+    if ((flags & HAS_SPARSE) != 0) {
+        auto* sparse_vectors = new SparseVector[num];
+        dataset->SparseVectors(sparse_vectors);
+        for (uint64_t i = 0; i < num; ++i) {
+            StreamReader::ReadObj(reader, sparse_vectors[i].len_);
+            sparse_vectors[i].ids_ = read_array<uint32_t>(reader, sparse_vectors[i].len_);
+            sparse_vectors[i].vals_ = read_array<float>(reader, sparse_vectors[i].len_);
+        }
+    }
+    if ((flags & HAS_EXTRA_INFO) != 0) {
+        int64_t extra_info_size = 0;
+        StreamReader::ReadObj(reader, extra_info_size);
+        dataset->ExtraInfoSize(extra_info_size);
+        dataset->ExtraInfos(read_array<char>(reader, num * extra_info_size));
+    }
+    if ((flags & HAS_ATTRIBUTE) != 0) {
+        auto* attrsets = new AttributeSet[num];
+        dataset->AttributeSets(attrsets);
+        for (uint64_t i = 0; i < num; ++i) {
+            ReadAttributeSet(reader, attrsets[i]);
+        }
+    }
+    if ((flags & HAS_MULTI_VECTOR) != 0) {
+        int64_t multi_dim = 0;
+        StreamReader::ReadObj(reader, multi_dim);
+        dataset->MultiVectorDim(multi_dim);
+        auto* multi_vectors = new MultiVector[num];
+        dataset->MultiVectors(multi_vectors);
+        for (uint64_t i = 0; i < num; ++i) {
+            StreamReader::ReadObj(reader, multi_vectors[i].len_);
+            multi_vectors[i].vectors_ =
+                read_array<float>(reader, multi_vectors[i].len_ * multi_dim);
+        }
+    }
+    if ((flags & HAS_PATH) != 0) {
+        auto* paths = new std::string[num];
+        dataset->Paths(paths);
+        for (uint64_t i = 0; i < num; ++i) {
+            paths[i] = StreamReader::ReadString(reader);
+        }
+    }
+    return dataset;
+}
+
+void
+OperationLog::WriteAttributeSet(StreamWriter& writer, const AttributeSet& attrs) {
+    StreamWriter::WriteObj(writer, static_cast<uint64_t>(attrs.attrs_.size()));
+    for (const auto* attr : attrs.attrs_) {
+        StreamWriter::WriteString(writer, attr->name_);
+        auto type = attr->GetValueType();
+        StreamWriter::WriteObj(writer, type);
+        switch (type) {
+            case AttrValueType::INT32:
+                write_attribute_value<int32_t>(writer, attr);
+                break;
+            case AttrValueType::UINT32:
+                write_attribute_value<uint32_t>(writer, attr);
+                break;
+            case AttrValueType::INT64:
+                write_attribute_value<int64_t>(writer, attr);
+                break;
+            case AttrValueType::UINT64:
+                write_attribute_value<uint64_t>(writer, attr);
+                break;
+            case AttrValueType::INT8:
+                write_attribute_value<int8_t>(writer, attr);
+                break;
+            case AttrValueType::UINT8:
+                write_attribute_value<uint8_t>(writer, attr);
+                break;
+            case AttrValueType::INT16:
+                write_attribute_value<int16_t>(writer, attr);
+                break;
+            case AttrValueType::UINT16:
+                write_attribute_value<uint16_t>(writer, attr);
+                break;
+            case AttrValueType::STRING:
+                write_attribute_value<std::string>(writer, attr);
+                break;
+            default:
+                throw VsagException(ErrorType::INVALID_ARGUMENT,
+                                    fmt::format("unknown attribute type of {}", attr->name_));
+        }
+    }
+}
+
+void
+OperationLog::ReadAttributeSet(StreamReader& reader, AttributeSet& attrs) {
+    uint64_t count = 0;
+    StreamReader::ReadObj(reader, count);
+    attrs.attrs_.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        auto name = StreamReader::ReadString(reader);
+        AttrValueType type;
+        StreamReader::ReadObj(reader, type);
+        Attribute* attr = nullptr;
+        switch (type) {
+            case AttrValueType::INT32:
+                attr = read_attribute_value<int32_t>(reader);
+                break;
+            case AttrValueType::UINT32:
+                attr = read_attribute_value<uint32_t>(reader);
+                break;
+            case AttrValueType::INT64:
+                attr = read_attribute_value<int64_t>(reader);
+                break;
+            case AttrValueType::UINT64:
+                attr = read_attribute_value<uint64_t>(reader);
+                break;
+            case AttrValueType::INT8:
+                attr = read_attribute_value<int8_t>(reader);
+                break;
+            case AttrValueType::UINT8:
+                attr = read_attribute_value<uint8_t>(reader);
+                break;
+            case AttrValueType::INT16:
+                attr = read_attribute_value<int16_t>(reader);
+                break;
+            case AttrValueType::UINT16:
+                attr = read_attribute_value<uint16_t>(reader);
+                break;
+            case AttrValueType::STRING:
+                attr = read_attribute_value<std::string>(reader);
+                break;
+            default:
+                throw VsagException(ErrorType::INVALID_BINARY,
+                                    fmt::format("unknown attribute type of {}", name));
+        }
+        attr->name_ = std::move(name);
+        attrs.attrs_.emplace_back(attr);
+    }
+}
+
+}  // namespace vsag
@@ -0,0 +1,155 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include "storage/stream_reader.h"
+#include "storage/stream_writer.h"
+#include "utils/pointer_define.h"
+#include "vsag/attribute.h"
+#include "vsag/dataset.h"
+
+namespace vsag {
+
+DEFINE_POINTER(OperationLog);
+
+enum class OperationType : uint8_t {
+    ADD = 1,
+    REMOVE = 2,
+    UPDATE_VECTOR = 3,
+    UPDATE_ATTRIBUTE = 4,
+    UPDATE_ID = 5,
+    UPDATE_EXTRA_INFO = 6,
+};
+
+/**
+ * An append-only file of the mutations applied to an index since its last snapshot. Every record
+ * carries a log sequence number (lsn) and a crc32; a torn or corrupted tail left by a crash is cut
+ * off when the log is opened.
+ *
+ * Append returns once its record is durable. Concurrent appends are group committed: the first
+ * waiter writes and syncs the records of every appender queued behind it with a single fdatasync,
+ * optionally after waiting group_commit_delay_us for more appenders to join.
+ *
+ * The file starts with a header holding the base lsn, the lsn of the last record dropped by
+ * Truncate, so that the numbering survives a log emptied by a checkpoint.
+ */
+class OperationLog {
+public:
+    using PayloadWriter = std::function<void(StreamWriter&)>;
+    using ReplayFunc = std::function<void(uint64_t lsn, OperationType type, StreamReader&)>;
+
+    static constexpr uint64_t HEADER_SIZE = 24;
+    static constexpr uint64_t RECORD_HEADER_SIZE = 17;
+
+public:
+    OperationLog(std::string path, uint64_t group_commit_delay_us = 0);
+
+    ~OperationLog();
+
+    // appends a record, returns its lsn once the record is durable
+    uint64_t
+    Append(OperationType type, const PayloadWriter& payload);
+
+    // the three steps of Append, so that a caller can order the records under its own lock and
+    // wait for them outside of it: Prepare builds a record, Enqueue assigns it the next lsn and
+    // queues it, WaitDurable returns once the records up to lsn are synced
+    static std::string
+    Prepare(OperationType type, const PayloadWriter& payload);
+
+    uint64_t
+    Enqueue(std::string& record);
+
+    void
+    WaitDurable(uint64_t lsn);
+
+    // throws once a write failed, no record can be made durable after it
+    void
+    CheckWritable() const;
+
+    // calls func on every record whose lsn is greater than after_lsn, in lsn order
+    uint64_t
+    Replay(uint64_t after_lsn, const ReplayFunc& func) const;
+
+    // drops the records up to lsn, the others are moved into a new file replacing the log
+    void
+    Truncate(uint64_t lsn);
+
+    [[nodiscard]] uint64_t
+    LastLsn() const;
+
+    [[nodiscard]] uint64_t
+    FileSize() const;
+
+public:
+    static void
+    WriteDataset(StreamWriter& writer, const DatasetPtr& dataset, int64_t extra_info_size);
+
+    // the returned dataset owns its arrays
+    static DatasetPtr
+    ReadDataset(StreamReader& reader);
+
+    static void
+    WriteAttributeSet(StreamWriter& writer, const AttributeSet& attrs);
+
+    // the attributes are allocated with new, the caller deletes them
+    static void
+    ReadAttributeSet(StreamReader& reader, AttributeSet& attrs);
+
+private:
+    void
+    open_and_recover();
+
+    void
+    write_header(int fd, uint64_t base_lsn) const;
+
+    // reads the records in [HEADER_SIZE, end) up to the first invalid one, returns its offset
+    uint64_t
+    scan(int fd,
+         uint64_t end,
+         const std::function<void(uint64_t, OperationType, std::string&)>& func) const;
+
+    void
+    check_writable() const;
+
+    void
+    flush_batch(std::unique_lock<std::mutex>& lock);
+
+private:
+    const std::string path_;
+    const uint64_t group_commit_delay_us_{0};
+
+    int fd_{-1};
+
+    mutable std::mutex mutex_;
+    std::condition_variable flushed_cv_;
+
+    uint64_t base_lsn_{0};
+    uint64_t last_lsn_{0};
+    uint64_t durable_lsn_{0};
+    uint64_t file_end_{0};
+
+    std::string pending_;
+    uint64_t pending_lsn_{0};
+    bool flushing_{false};
+    bool broken_{false};
+};
+
+}  // namespace vsag
@@ -0,0 +1,251 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "operation_log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "unittest.h"
+
+using namespace vsag;
+
+namespace {
+
+void
+append_value(OperationLog& log, uint64_t value) {
+    log.Append(OperationType::UPDATE_ID,
+               [value](StreamWriter& writer) { StreamWriter::WriteObj(writer, value); });
+}
+
+std::vector<uint64_t>
+replay_values(const OperationLog& log, uint64_t after_lsn) {
+    std::vector<uint64_t> values;
+    log.Replay(after_lsn, [&values](uint64_t, OperationType type, StreamReader& reader) {
+        REQUIRE(type == OperationType::UPDATE_ID);
+        uint64_t value = 0;
+        StreamReader::ReadObj(reader, value);
+        values.emplace_back(value);
+    });
+    return values;
+}
+
+}  // namespace
+
+TEST_CASE("Operation Log Append And Replay", "[ut][OperationLog]") {
+    fixtures::TempDir dir("operation_log");
+    auto path = dir.GenerateRandomFile(false);
+    {
+        OperationLog log(path);
+        for (uint64_t i = 0; i < 10; ++i) {
+            append_value(log, i * 3);
+        }
+        REQUIRE(log.LastLsn() == 10);
+    }
+
+    // a reopened log continues the numbering
+    OperationLog log(path);
+    REQUIRE(log.LastLsn() == 10);
+    REQUIRE(replay_values(log, 0).size() == 10);
+    REQUIRE(replay_values(log, 7) == std::vector<uint64_t>({21, 24, 27}));
+    append_value(log, 100);
+    REQUIRE(log.LastLsn() == 11);
+    REQUIRE(replay_values(log, 10) == std::vector<uint64_t>({100}));
+
+    // the log is emptied by a checkpoint, but keeps its numbering across a reopen
+    log.Truncate(9);
+    REQUIRE(replay_values(log, 0) == std::vector<uint64_t>({27, 100}));
+    log.Truncate(11);
+    REQUIRE(log.FileSize() == OperationLog::HEADER_SIZE);
+    OperationLog reopened(path);
+    REQUIRE(reopened.LastLsn() == 11);
+    REQUIRE(replay_values(reopened, 0).empty());
+
+    // a checkpoint ahead of the log moves the numbering past it
+    reopened.Truncate(20);
+    append_value(reopened, 5);
+    REQUIRE(reopened.LastLsn() == 21);
+}
+
+TEST_CASE("Operation Log Torn Tail", "[ut][OperationLog]") {
+    fixtures::TempDir dir("operation_log");
+    auto path = dir.GenerateRandomFile(false);
+    uint64_t full_size = 0;
+    {
+        OperationLog log(path);
+        for (uint64_t i = 0; i < 5; ++i) {
+            append_value(log, i);
+        }
+        full_size = log.FileSize();
+    }
+
+    SECTION("partial record") {
+        std::filesystem::resize_file(path, full_size - 3);
+    }
+    SECTION("corrupted record") {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<int64_t>(full_size) - 1);
+        file.put('\x7f');
+    }
+
+    OperationLog log(path);
+    REQUIRE(log.LastLsn() == 4);
+    REQUIRE(replay_values(log, 0) == std::vector<uint64_t>({0, 1, 2, 3}));
+    REQUIRE(std::filesystem::file_size(path) == log.FileSize());
+    append_value(log, 9);
+    REQUIRE(replay_values(log, 3) == std::vector<uint64_t>({3, 9}));
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a log file at all, garbage";
+    REQUIRE_THROWS(std::make_shared<OperationLog>(path));
+}
+
+TEST_CASE("Operation Log Group Commit", "[ut][OperationLog]") {
+    fixtures::TempDir dir("operation_log");
+    auto path = dir.GenerateRandomFile(false);
+    auto delay = GENERATE(0, 200);
+    constexpr uint64_t thread_count = 8;
+    constexpr uint64_t count_per_thread = 50;
+    {
+        OperationLog log(path, delay);
+        std::vector<std::thread> threads;
+        for (uint64_t t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&log, t]() {
+                for (uint64_t i = 0; i < count_per_thread; ++i) {
+                    append_value(log, t * count_per_thread + i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(log.LastLsn() == thread_count * count_per_thread);
+    }
+
+    OperationLog log(path);
+    auto values = replay_values(log, 0);
+    std::sort(values.begin(), values.end());
+    REQUIRE(values.size() == thread_count * count_per_thread);
+    for (uint64_t i = 0; i < values.size(); ++i) {
+        REQUIRE(values[i] == i);
+    }
+}
+
+TEST_CASE("Operation Log Ordered Enqueue", "[ut][OperationLog]") {
+    fixtures::TempDir dir("operation_log");
+    auto path = dir.GenerateRandomFile(false);
+    constexpr uint64_t thread_count = 8;
+    constexpr uint64_t count_per_thread = 50;
+    {
+        // the records are queued in the order of a counter bumped under the same lock, as a
+        // logged mutation is, and their syncs are waited for outside of it
+        OperationLog log(path, 100);
+        std::mutex order_mutex;
+        uint64_t counter = 0;
+        std::vector<std::thread> threads;
+        for (uint64_t t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&]() {
+                for (uint64_t i = 0; i < count_per_thread; ++i) {
+                    uint64_t lsn = 0;
+                    {
+                        std::scoped_lock lock(order_mutex);
+                        auto value = counter++;
+                        auto record = OperationLog::Prepare(
+                            OperationType::UPDATE_ID, [value](StreamWriter& writer) {
+                                StreamWriter::WriteObj(writer, value);
+                            });
+                        lsn = log.Enqueue(record);
+                    }
+                    log.WaitDurable(lsn);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    OperationLog log(path);
+    auto values = replay_values(log, 0);
+    REQUIRE(values.size() == thread_count * count_per_thread);
+    for (uint64_t i = 0; i < values.size(); ++i) {
+        REQUIRE(values[i] == i);
+    }
+}
+
+TEST_CASE("Operation Log Dataset Codec", "[ut][OperationLog]") {
+    int64_t dim = 8;
+    int64_t count = 5;
+    int64_t extra_info_size = 4;
+    auto extra_infos = fixtures::generate_extra_infos(count, extra_info_size);
+    auto vectors = fixtures::generate_vectors(count, dim);
+    std::vector<int64_t> ids = {3, 1, 4, 1, 5};
+    auto* attrsets = new AttributeSet[count];
+    for (int64_t i = 0; i < count; ++i) {
+        auto* int_attr = new AttributeValue<int32_t>();
+        int_attr->name_ = "a";
+        int_attr->GetValue() = {static_cast<int32_t>(i), 7};
+        auto* str_attr = new AttributeValue<std::string>();
+        str_attr->name_ = "b";
+        str_attr->GetValue() = {fmt::format("s{}", i)};
+        attrsets[i].attrs_ = {int_attr, str_attr};
+    }
+    auto base = Dataset::Make();
+    base->NumElements(count)
+        ->Dim(dim)
+        ->Ids(ids.data())
+        ->Float32Vectors(vectors.data())
+        ->ExtraInfos(extra_infos.data())
+        ->AttributeSets(attrsets)
+        ->Owner(false);
+
+    std::vector<char> buffer(1 << 16);
+    BufferStreamWriter writer(buffer.data());
+    OperationLog::WriteDataset(writer, base, extra_info_size);
+    ReadFuncStreamReader func_reader(
+        [&buffer](uint64_t offset, uint64_t size, void* dest) {
+            std::memcpy(dest, buffer.data() + offset, size);
+        },
+        0,
+        writer.GetCursor());
+    auto decoded = OperationLog::ReadDataset(func_reader);
+    REQUIRE(func_reader.GetCursor() == writer.GetCursor());
+
+    REQUIRE(decoded->GetNumElements() == count);
+    REQUIRE(decoded->GetDim() == dim);
+    REQUIRE(std::memcmp(decoded->GetIds(), ids.data(), count * sizeof(int64_t)) == 0);
+    REQUIRE(std::memcmp(
+                decoded->GetFloat32Vectors(), vectors.data(), count * dim * sizeof(float)) == 0);
+    REQUIRE(decoded->GetExtraInfoSize() == extra_info_size);
+    REQUIRE(std::memcmp(
+                decoded->GetExtraInfos(), extra_infos.data(), count * extra_info_size) == 0);
+    for (int64_t i = 0; i < count; ++i) {
+        const auto& attrs = decoded->GetAttributeSets()[i].attrs_;
+        REQUIRE(attrs.size() == 2);
+        REQUIRE(attrs[0]->name_ == "a");
+        REQUIRE(attrs[0]->Equal(attrsets[i].attrs_[0]));
+        REQUIRE(attrs[1]->name_ == "b");
+        REQUIRE(attrs[1]->Equal(attrsets[i].attrs_[1]));
+    }
+
+    for (int64_t i = 0; i < count; ++i) {
+        for (auto* attr : attrsets[i].attrs_) {
+            delete attr;
+        }
+    }
+    delete[] attrsets;
+}
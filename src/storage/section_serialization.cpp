@@ -0,0 +1,242 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "section_serialization.h"
+
+#include <fmt/format.h>
+
+#include "impl/logger/logger.h"
+#include "impl/thread_pool/safe_thread_pool.h"
+#include "inner_string_params.h"
+#include "utils/crc32.h"
+#include "vsag_exception.h"
+
+namespace vsag {
+
+namespace {
+
+// forwards to writer_impl_ and accumulates the crc32 of the written bytes
+class ChecksumStreamWriter : public StreamWriter {
+public:
+    explicit ChecksumStreamWriter(StreamWriter* writer) : writer_impl_(writer) {
+    }
+
+    void
+    Write(const char* data, uint64_t size) override {
+        writer_impl_->Write(data, size);
+        crc_ = Crc32(data, size, crc_);
+        bytes_written_ += size;
+    }
+
+    [[nodiscard]] uint32_t
+    Checksum() const {
+        return crc_;
+    }
+
+private:
+    StreamWriter* const writer_impl_{nullptr};
+    uint32_t crc_{0};
+};
+
+// forwards to reader_impl_ and accumulates the crc32 of the contiguously read prefix, bytes
+// read again after a backward seek are not hashed twice and a forward seek stops the hashing
+class ChecksumStreamReader : public StreamReader {
+public:
+    ChecksumStreamReader(StreamReader* reader, uint64_t length)
+        : StreamReader(length),
+          reader_impl_(reader),
+          begin_(reader->GetCursor()),
+          hashed_end_(begin_) {
+    }
+
+    void
+    Read(char* data, uint64_t size) override {
+        auto cursor = reader_impl_->GetCursor();
+        reader_impl_->Read(data, size);
+        if (cursor <= hashed_end_ and hashed_end_ < cursor + size) {
+            auto skip = hashed_end_ - cursor;
+            crc_ = Crc32(data + skip, size - skip, crc_);
+            hashed_end_ = cursor + size;
+        }
+    }
+
+    void
+    Seek(uint64_t cursor) override {
+        reader_impl_->Seek(cursor);
+    }
+
+    [[nodiscard]] uint64_t
+    GetCursor() const override {
+        return reader_impl_->GetCursor();
+    }
+
+    [[nodiscard]] uint64_t
+    GetAbsoluteCursor() const override {
+        return reader_impl_->GetAbsoluteCursor();
+    }
+
+    [[nodiscard]] bool
+    Complete() const {
+        return hashed_end_ == begin_ + length_;
+    }
+
+    [[nodiscard]] uint32_t
+    Checksum() const {
+        return crc_;
+    }
+
+private:
+    StreamReader* const reader_impl_{nullptr};
+    const uint64_t begin_{0};
+    uint64_t hashed_end_{0};
+    uint32_t crc_{0};
+};
+
+void
+pad_to_alignment(StreamWriter& writer, uint64_t begin) {
+    static const std::vector<char> ZEROS(SectionWriter::SECTION_ALIGNMENT, 0);
+    auto remainder = (writer.GetCursor() - begin) % SectionWriter::SECTION_ALIGNMENT;
+    if (remainder != 0) {
+        writer.Write(ZEROS.data(), SectionWriter::SECTION_ALIGNMENT - remainder);
+    }
+}
+
+}  // namespace
+
+void
+SectionWriter::Write(StreamWriter& writer, const MetadataPtr& metadata) const {
+    auto count = sections_.size();
+    std::vector<uint64_t> offsets(count);
+    std::vector<uint64_t> sizes(count);
+    std::vector<uint32_t> checksums(count);
+    auto begin = writer.GetCursor();
+
+    if (pool_ != nullptr and count > 1 and writer.Reservable()) {
+        // measure every section, then hand out the reserved ranges to the workers
+        pool_->ParallelFor(count, [&](uint64_t i) {
+            WriteFuncStreamWriter counter([](uint64_t, uint64_t, void*) {}, 0);
+            sections_[i].second(counter);
+            sizes[i] = counter.GetCursor();
+        });
+        std::vector<std::unique_ptr<StreamWriter>> reserved(count);
+        for (uint64_t i = 0; i < count; ++i) {
+            pad_to_alignment(writer, begin);
+            offsets[i] = writer.GetCursor() - begin;
+            reserved[i] = writer.Reserve(sizes[i]);
+        }
+        pool_->ParallelFor(count, [&](uint64_t i) {
+            ChecksumStreamWriter checked(reserved[i].get());
+            sections_[i].second(checked);
+            if (checked.GetCursor() != sizes[i]) {
+                throw VsagException(
+                    ErrorType::INTERNAL_ERROR,
+                    fmt::format("section {} wrote {} bytes but measured {} bytes",
+                                sections_[i].first,
+                                checked.GetCursor(),
+                                sizes[i]));
+            }
+            checksums[i] = checked.Checksum();
+        });
+    } else {
+        for (uint64_t i = 0; i < count; ++i) {
+            pad_to_alignment(writer, begin);
+            offsets[i] = writer.GetCursor() - begin;
+            ChecksumStreamWriter checked(&writer);
+            sections_[i].second(checked);
+            sizes[i] = checked.GetCursor();
+            checksums[i] = checked.Checksum();
+        }
+    }
+
+    JsonType datacell_offsets;
+    JsonType datacell_sizes;
+    JsonType datacell_checksums;
+    for (uint64_t i = 0; i < count; ++i) {
+        const auto& name = sections_[i].first;
+        datacell_offsets[name].SetInt(offsets[i]);
+        datacell_sizes[name].SetInt(sizes[i]);
+        datacell_checksums[name].SetInt(checksums[i]);
+    }
+    metadata->Set(DATACELL_OFFSETS, datacell_offsets);
+    metadata->Set(DATACELL_SIZES, datacell_sizes);
+    metadata->Set(DATACELL_CHECKSUMS, datacell_checksums);
+    metadata->Set(SECTION_ALIGNMENT_KEY, SECTION_ALIGNMENT);
+}
+
+bool
+SectionReader::Contains(const MetadataPtr& metadata) {
+    return metadata->Get(SECTION_ALIGNMENT_KEY).IsNumberInteger();
+}
+
+void
+SectionReader::Read(StreamReader& reader, uint64_t begin, const MetadataPtr& metadata) const {
+    auto count = sections_.size();
+    std::vector<uint64_t> offsets(count);
+    std::vector<uint64_t> sizes(count);
+    std::vector<uint32_t> checksums(count);
+    auto datacell_offsets = metadata->Get(DATACELL_OFFSETS);
+    auto datacell_sizes = metadata->Get(DATACELL_SIZES);
+    auto datacell_checksums = metadata->Get(DATACELL_CHECKSUMS);
+    for (uint64_t i = 0; i < count; ++i) {
+        const auto& name = sections_[i].first;
+        if (not datacell_offsets.Contains(name) or not datacell_sizes.Contains(name) or
+            not datacell_checksums.Contains(name)) {
+            throw VsagException(ErrorType::READ_ERROR,
+                                fmt::format("section {} is missing in the index", name));
+        }
+        offsets[i] = datacell_offsets[name].GetInt();
+        sizes[i] = datacell_sizes[name].GetInt();
+        checksums[i] = static_cast<uint32_t>(datacell_checksums[name].GetInt());
+    }
+
+    auto load = [&](uint64_t i, StreamReader& source) {
+        ChecksumStreamReader checked(&source, sizes[i]);
+        BufferStreamReader buffer_reader(&checked, sizes[i], allocator_);
+        sections_[i].second(buffer_reader);
+        if (not checked.Complete()) {
+            logger::debug("section {} is partially read, skip its checksum", sections_[i].first);
+        } else if (checked.Checksum() != checksums[i]) {
+            throw VsagException(
+                ErrorType::READ_ERROR,
+                fmt::format("checksum mismatch in section {}, the index is corrupted",
+                            sections_[i].first));
+        }
+    };
+
+    std::vector<std::unique_ptr<StreamReader>> forks;
+    if (pool_ != nullptr and count > 1) {
+        for (uint64_t i = 0; i < count; ++i) {
+            auto fork = reader.Fork(begin + offsets[i], sizes[i]);
+            if (fork == nullptr) {
+                forks.clear();
+                break;
+            }
+            forks.emplace_back(std::move(fork));
+        }
+    }
+
+    if (not forks.empty()) {
+        pool_->ParallelFor(count, [&](uint64_t i) {
+            auto slice = forks[i]->Slice(begin + offsets[i], sizes[i]);
+            load(i, slice);
+        });
+    } else {
+        for (uint64_t i = 0; i < count; ++i) {
+            auto slice = reader.Slice(begin + offsets[i], sizes[i]);
+            load(i, slice);
+        }
+    }
+}
+
+}  // namespace vsag
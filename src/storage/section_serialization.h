@@ -0,0 +1,103 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "serialization.h"
+#include "stream_reader.h"
+#include "stream_writer.h"
+
+namespace vsag {
+
+class SafeThreadPool;
+
+/**
+ * @brief Writes the datacells of an index as independent sections.
+ *
+ * Every section starts SECTION_ALIGNMENT bytes aligned relative to the start of the index and
+ * its offset, size and crc32 are recorded in the footer metadata (datacell_offsets,
+ * datacell_sizes, datacell_checksums). When a thread pool is given and the writer is
+ * Reservable, the sections are measured and then written concurrently.
+ */
+class SectionWriter {
+public:
+    using SerializeFunc = std::function<void(StreamWriter&)>;
+
+    explicit SectionWriter(SafeThreadPool* pool) : pool_(pool) {
+    }
+
+    void
+    Add(std::string name, SerializeFunc func) {
+        sections_.emplace_back(std::move(name), std::move(func));
+    }
+
+    /**
+     * @brief Writes the sections at the cursor of writer and records the table in metadata.
+     */
+    void
+    Write(StreamWriter& writer, const MetadataPtr& metadata) const;
+
+public:
+    static constexpr uint64_t SECTION_ALIGNMENT = 4096;
+
+private:
+    SafeThreadPool* const pool_{nullptr};
+    std::vector<std::pair<std::string, SerializeFunc>> sections_;
+};
+
+/**
+ * @brief Reads the sections written by a SectionWriter, concurrently when a thread pool is
+ * given and the reader can be forked.
+ *
+ * The crc32 of a section is verified whenever its bytes are all read, sections consumed only
+ * partially (e.g. reader backed datacells skip their payload) are not verified.
+ */
+class SectionReader {
+public:
+    using DeserializeFunc = std::function<void(StreamReader&)>;
+
+    SectionReader(SafeThreadPool* pool, Allocator* allocator)
+        : pool_(pool), allocator_(allocator) {
+    }
+
+    /**
+     * @brief Whether metadata describes an index written by a SectionWriter.
+     */
+    static bool
+    Contains(const MetadataPtr& metadata);
+
+    void
+    Add(std::string name, DeserializeFunc func) {
+        sections_.emplace_back(std::move(name), std::move(func));
+    }
+
+    /**
+     * @brief Reads the sections of the index starting at cursor begin of reader, throws a
+     * VsagException when a section is missing or corrupted.
+     */
+    void
+    Read(StreamReader& reader, uint64_t begin, const MetadataPtr& metadata) const;
+
+private:
+    SafeThreadPool* const pool_{nullptr};
+    Allocator* const allocator_{nullptr};
+    std::vector<std::pair<std::string, DeserializeFunc>> sections_;
+};
+
+}  // namespace vsag
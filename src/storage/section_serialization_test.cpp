@@ -0,0 +1,160 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "section_serialization.h"
+
+#include <cstring>
+
+#include "impl/allocator/safe_allocator.h"
+#include "impl/thread_pool/safe_thread_pool.h"
+#include "inner_string_params.h"
+#include "unittest.h"
+
+using namespace vsag;
+
+namespace {
+
+std::vector<std::vector<char>>
+gen_section_contents() {
+    // sizes straddle the section alignment and the buffer of BufferStreamReader
+    std::vector<uint64_t> sizes = {1, 4096, 5000, 3 * 1024 * 1024 + 7};
+    std::vector<std::vector<char>> contents;
+    for (uint64_t i = 0; i < sizes.size(); ++i) {
+        std::vector<char> content(sizes[i]);
+        for (uint64_t j = 0; j < sizes[i]; ++j) {
+            content[j] = static_cast<char>((i * 131 + j * 7) % 251);
+        }
+        contents.emplace_back(std::move(content));
+    }
+    return contents;
+}
+
+std::vector<char>
+write_sections(const std::vector<std::vector<char>>& contents,
+               SafeThreadPool* pool,
+               const MetadataPtr& metadata) {
+    SectionWriter section_writer(pool);
+    for (uint64_t i = 0; i < contents.size(); ++i) {
+        section_writer.Add(fmt::format("section_{}", i), [&contents, i](StreamWriter& writer) {
+            StreamWriter::WriteVector(writer, contents[i]);
+        });
+    }
+    WriteFuncStreamWriter counter([](uint64_t, uint64_t, void*) {}, 0);
+    section_writer.Write(counter, std::make_shared<Metadata>());
+
+    std::vector<char> binary(counter.GetCursor());
+    BufferStreamWriter writer(binary.data());
+    section_writer.Write(writer, metadata);
+    REQUIRE(writer.GetCursor() == binary.size());
+    return binary;
+}
+
+void
+read_sections(const std::vector<char>& binary,
+              uint64_t count,
+              SafeThreadPool* pool,
+              const MetadataPtr& metadata,
+              std::vector<std::vector<char>>& contents) {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    contents.resize(count);
+    SectionReader section_reader(pool, allocator.get());
+    for (uint64_t i = 0; i < count; ++i) {
+        section_reader.Add(fmt::format("section_{}", i), [&contents, i](StreamReader& reader) {
+            StreamReader::ReadVector(reader, contents[i]);
+        });
+    }
+    ReadFuncStreamReader reader(
+        [&binary](uint64_t offset, uint64_t size, void* dest) {
+            memcpy(dest, binary.data() + offset, size);
+        },
+        0,
+        binary.size());
+    section_reader.Read(reader, 0, metadata);
+}
+
+}  // namespace
+
+TEST_CASE("Section Serialization Round Trip", "[ut][SectionSerialization]") {
+    auto contents = gen_section_contents();
+    auto thread_pool = SafeThreadPool::FactoryDefaultThreadPool();
+    auto* write_pool = GENERATE(0, 1) == 1 ? thread_pool.get() : nullptr;
+    auto* read_pool = GENERATE(0, 1) == 1 ? thread_pool.get() : nullptr;
+
+    auto metadata = std::make_shared<Metadata>();
+    auto binary = write_sections(contents, write_pool, metadata);
+    REQUIRE(SectionReader::Contains(metadata));
+    REQUIRE_FALSE(SectionReader::Contains(std::make_shared<Metadata>()));
+    for (uint64_t i = 0; i < contents.size(); ++i) {
+        auto offset = metadata->Get(DATACELL_OFFSETS)[fmt::format("section_{}", i)].GetInt();
+        REQUIRE(offset % SectionWriter::SECTION_ALIGNMENT == 0);
+    }
+
+    std::vector<std::vector<char>> loaded;
+    read_sections(binary, contents.size(), read_pool, metadata, loaded);
+    REQUIRE(loaded == contents);
+
+    // the sequential and the concurrent writers produce the same bytes
+    auto other_metadata = std::make_shared<Metadata>();
+    auto other_binary = write_sections(contents, thread_pool.get(), other_metadata);
+    REQUIRE(other_binary == binary);
+}
+
+TEST_CASE("Section Serialization Corruption", "[ut][SectionSerialization]") {
+    auto contents = gen_section_contents();
+    auto thread_pool = SafeThreadPool::FactoryDefaultThreadPool();
+    auto* pool = GENERATE(0, 1) == 1 ? thread_pool.get() : nullptr;
+
+    auto metadata = std::make_shared<Metadata>();
+    auto binary = write_sections(contents, pool, metadata);
+    std::vector<std::vector<char>> loaded;
+
+    // a flipped byte in the payload of the last section
+    auto offset = metadata->Get(DATACELL_OFFSETS)["section_3"].GetInt();
+    binary[offset + 4096] ^= 0x01;
+    REQUIRE_THROWS(read_sections(binary, contents.size(), pool, metadata, loaded));
+    binary[offset + 4096] ^= 0x01;
+    read_sections(binary, contents.size(), pool, metadata, loaded);
+    REQUIRE(loaded == contents);
+
+    // a section unknown to the metadata
+    REQUIRE_THROWS(read_sections(binary, contents.size() + 1, pool, metadata, loaded));
+}
+
+TEST_CASE("Stream Reserve And Fork", "[ut][SectionSerialization]") {
+    std::vector<char> binary(16, 0);
+    BufferStreamWriter writer(binary.data());
+    REQUIRE(writer.Reservable());
+    auto reserved = writer.Reserve(8);
+    REQUIRE(writer.GetCursor() == 8);
+    writer.Write("world!!!", 8);
+    reserved->Write("hello, ", 7);
+    REQUIRE(memcmp(binary.data(), "hello, \0world!!!", 16) == 0);
+
+    WriteFuncStreamWriter func_writer([](uint64_t, uint64_t, void*) {}, 0);
+    REQUIRE_FALSE(func_writer.Reservable());
+    REQUIRE(func_writer.Reserve(8) == nullptr);
+
+    ReadFuncStreamReader reader(
+        [&binary](uint64_t offset, uint64_t size, void* dest) {
+            memcpy(dest, binary.data() + offset, size);
+        },
+        0,
+        binary.size());
+    auto fork = reader.Fork(8, 5);
+    REQUIRE(fork != nullptr);
+    char buffer[5];
+    fork->Read(buffer, 5);
+    REQUIRE(std::string(buffer, 5) == "world");
+    REQUIRE(reader.GetCursor() == 0);
+}
@@ -55,6 +55,12 @@ ReadFuncStreamReader::GetCursor() const {
     return cursor_;
 }
 
+std::unique_ptr<StreamReader>
+ReadFuncStreamReader::Fork(uint64_t begin, uint64_t length) const {
+    // read functions are backed by binaries or Readers, both of which allow concurrent reads
+    return std::make_unique<ReadFuncStreamReader>(readFunc_, begin, begin + length);
+}
+
 ReadFuncStreamReader::ReadFuncStreamReader(std::function<void(uint64_t, uint64_t, void*)> read_func,
                                            uint64_t cursor,
                                            uint64_t length)
@@ -163,6 +169,11 @@ BufferStreamReader::GetCursor() const {
     return reader_impl_->GetCursor() - (valid_size_ - buffer_cursor_);
 }
 
+uint64_t
+BufferStreamReader::GetAbsoluteCursor() const {
+    return reader_impl_->GetAbsoluteCursor() - (valid_size_ - buffer_cursor_);
+}
+
 BufferStreamReader::BufferStreamReader(StreamReader* reader,
                                        uint64_t max_size,
                                        vsag::Allocator* allocator)
@@ -209,6 +220,12 @@ SliceStreamReader::GetCursor() const {
     return cursor_;
 }
 
+uint64_t
+SliceStreamReader::GetAbsoluteCursor() const {
+    // the slice keeps reader_impl_ positioned at begin_ + cursor_
+    return reader_impl_->GetAbsoluteCursor();
+}
+
 SliceStreamReader::SliceStreamReader(StreamReader* reader, uint64_t begin, uint64_t length)
     : StreamReader(length), reader_impl_(reader), begin_(begin) {
     // vsag::logger::trace("SliceReader [{}, {})", begin_, begin_ + length_);
@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <functional>
 #include <istream>
+#include <memory>
 #include <stack>
 
 #include "../typing.h"
@@ -72,11 +73,28 @@ public:
     [[nodiscard]] virtual uint64_t
     GetCursor() const = 0;
 
+    /**
+     * @brief The cursor in the outermost reader, which differs from GetCursor inside slices.
+     */
+    [[nodiscard]] virtual uint64_t
+    GetAbsoluteCursor() const {
+        return this->GetCursor();
+    }
+
     [[nodiscard]] virtual uint64_t
     Length() {
         return length_;
     }
 
+    /**
+     * @brief An independent reader of [begin, begin + length) in the cursor space of this one,
+     * which may be used concurrently with it. Returns nullptr when the source is sequential.
+     */
+    [[nodiscard]] virtual std::unique_ptr<StreamReader>
+    Fork(uint64_t begin, uint64_t length) const {
+        return nullptr;
+    }
+
 public:
     [[nodiscard]] SliceStreamReader
     Slice(uint64_t begin, uint64_t length);
@@ -103,6 +121,8 @@ public:
     StreamReader(uint64_t length) : length_(length) {
     }
 
+    virtual ~StreamReader() = default;
+
 protected:
     uint64_t length_{0};
     uint64_t io_count_{0};
@@ -122,7 +142,10 @@ public:
     [[nodiscard]] uint64_t
     GetCursor() const override;
 
-    ~ReadFuncStreamReader();
+    [[nodiscard]] std::unique_ptr<StreamReader>
+    Fork(uint64_t begin, uint64_t length) const override;
+
+    ~ReadFuncStreamReader() override;
 
 public:
     ReadFuncStreamReader(std::function<void(uint64_t, uint64_t, void*)> read_func,
@@ -168,6 +191,9 @@ public:
     [[nodiscard]] uint64_t
     GetCursor() const override;
 
+    [[nodiscard]] uint64_t
+    GetAbsoluteCursor() const override;
+
 public:
     explicit BufferStreamReader(StreamReader* reader, uint64_t max_size, Allocator* allocator);
 
@@ -198,6 +224,9 @@ public:
     [[nodiscard]] uint64_t
     GetCursor() const override;
 
+    [[nodiscard]] uint64_t
+    GetAbsoluteCursor() const override;
+
 public:
     // create a slice from specified position
     SliceStreamReader(StreamReader* reader, uint64_t begin, uint64_t length);
@@ -30,6 +30,14 @@ BufferStreamWriter::Write(const char* data, uint64_t size) {
     bytes_written_ += size;
 }
 
+std::unique_ptr<StreamWriter>
+BufferStreamWriter::Reserve(uint64_t size) {
+    auto reserved = std::make_unique<BufferStreamWriter>(buffer_);
+    buffer_ += size;
+    bytes_written_ += size;
+    return reserved;
+}
+
 IOStreamWriter::IOStreamWriter(std::ostream& ostream) : ostream_(ostream) {
 }
 
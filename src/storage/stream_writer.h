@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <ostream>
 
 #include "typing.h"
@@ -67,6 +68,23 @@ public:
         return bytes_written_;
     }
 
+    /**
+     * @brief Whether Reserve hands out writers, i.e. the destination can be written out of order.
+     */
+    [[nodiscard]] virtual bool
+    Reservable() const {
+        return false;
+    }
+
+    /**
+     * @brief Skips the next size bytes and returns a writer for them, which may be used
+     * concurrently with this one. Returns nullptr and skips nothing if not Reservable.
+     */
+    [[nodiscard]] virtual std::unique_ptr<StreamWriter>
+    Reserve(uint64_t size) {
+        return nullptr;
+    }
+
 public:
     StreamWriter() = default;
 
@@ -83,6 +101,14 @@ public:
     void
     Write(const char* data, uint64_t size) override;
 
+    [[nodiscard]] bool
+    Reservable() const override {
+        return true;
+    }
+
+    [[nodiscard]] std::unique_ptr<StreamWriter>
+    Reserve(uint64_t size) override;
+
 private:
     char* buffer_{nullptr};
 };
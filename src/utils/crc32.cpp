@@ -0,0 +1,79 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "crc32.h"
+
+#include <array>
+#include <cstring>
+
+namespace vsag {
+
+namespace {
+
+constexpr uint32_t CRC32_POLYNOMIAL = 0xEDB88320;
+
+using Crc32Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+// tables_[k][b] is the crc of byte b followed by k zero bytes (slicing-by-8)
+Crc32Tables
+build_tables() {
+    Crc32Tables tables{};
+    for (uint32_t b = 0; b < 256; ++b) {
+        uint32_t crc = b;
+        for (int j = 0; j < 8; ++j) {
+            crc = (crc >> 1) ^ ((crc & 1) != 0 ? CRC32_POLYNOMIAL : 0);
+        }
+        tables[0][b] = crc;
+    }
+    for (uint32_t b = 0; b < 256; ++b) {
+        for (int k = 1; k < 8; ++k) {
+            auto prev = tables[k - 1][b];
+            tables[k][b] = (prev >> 8) ^ tables[0][prev & 0xFF];
+        }
+    }
+    return tables;
+}
+
+const Crc32Tables&
+tables() {
+    static const Crc32Tables instance = build_tables();
+    return instance;
+}
+
+}  // namespace
+
+uint32_t
+Crc32(const void* data, uint64_t size, uint32_t crc) {
+    const auto& t = tables();
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+    while (size >= 8) {
+        uint32_t low = 0;
+        uint32_t high = 0;
+        memcpy(&low, bytes, 4);
+        memcpy(&high, bytes + 4, 4);
+        low ^= crc;
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^
+              t[4][low >> 24] ^ t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^
+              t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        bytes += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *bytes++) & 0xFF];
+    }
+    return ~crc;
+}
+
+}  // namespace vsag
@@ -0,0 +1,32 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+namespace vsag {
+
+/**
+ * @brief CRC-32 (IEEE 802.3) of [data, data + size), computed eight bytes at a time.
+ *
+ * The checksum of a concatenation is obtained incrementally: Crc32(b, size_b, Crc32(a, size_a))
+ * equals the checksum of a followed by b.
+ *
+ * @param crc The checksum of the preceding bytes, 0 for the first chunk.
+ */
+uint32_t
+Crc32(const void* data, uint64_t size, uint32_t crc = 0);
+
+}  // namespace vsag
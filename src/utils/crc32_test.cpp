@@ -0,0 +1,46 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "crc32.h"
+
+#include <string>
+#include <vector>
+
+#include "unittest.h"
+
+TEST_CASE("Crc32 Basic Test", "[ut][Crc32]") {
+    const std::string check = "123456789";
+    REQUIRE(vsag::Crc32(check.data(), check.size()) == 0xCBF43926);
+    REQUIRE(vsag::Crc32(nullptr, 0) == 0);
+
+    // a bitwise reference, and chunked updates equal to the whole
+    auto size = GENERATE(1, 7, 8, 9, 1000, 4099);
+    std::vector<uint8_t> data(size);
+    for (uint64_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 131 + 7);
+    }
+    uint32_t expected = 0xFFFFFFFF;
+    for (auto byte : data) {
+        expected ^= byte;
+        for (int j = 0; j < 8; ++j) {
+            expected = (expected >> 1) ^ ((expected & 1) != 0 ? 0xEDB88320 : 0);
+        }
+    }
+    expected = ~expected;
+    REQUIRE(vsag::Crc32(data.data(), data.size()) == expected);
+    auto split = data.size() / 3;
+    auto head = vsag::Crc32(data.data(), split);
+    REQUIRE(vsag::Crc32(data.data() + split, data.size() - split, head) == expected);
+}
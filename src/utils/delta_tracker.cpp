@@ -0,0 +1,82 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "delta_tracker.h"
+
+#include <fmt/format.h>
+
+namespace vsag {
+
+DeltaTracker::EpochPtr
+DeltaTracker::MakeEpoch() {
+    return std::make_shared<std::atomic<uint32_t>>(1);
+}
+
+uint32_t
+DeltaTracker::Cut(const EpochPtr& epoch) {
+    return epoch->fetch_add(1);
+}
+
+DeltaTracker::DeltaTracker(EpochPtr epoch, Allocator* allocator)
+    : epoch_(std::move(epoch)), allocator_(allocator), stamps_(SEGMENT_BIT, allocator) {
+}
+
+void
+DeltaTracker::Resize(InnerIdType capacity) {
+    // the stamps of the ids beyond a shrunk capacity are kept, ChangedSince is bounded anyway
+    if (capacity > stamps_.Capacity()) {
+        stamps_.Resize(capacity);
+    }
+}
+
+void
+DeltaTracker::Touch(InnerIdType id) {
+    this->stamp(id, epoch_->load());
+}
+
+void
+DeltaTracker::TouchRange(InnerIdType begin, InnerIdType end) {
+    auto epoch = epoch_->load();
+    for (auto id = begin; id < end; ++id) {
+        this->stamp(id, epoch);
+    }
+}
+
+Vector<InnerIdType>
+DeltaTracker::ChangedSince(uint32_t base_epoch, InnerIdType limit) const {
+    Vector<InnerIdType> ids(allocator_);
+    auto end = std::min(static_cast<uint64_t>(limit), stamps_.Capacity());
+    for (uint64_t id = 0; id < end; ++id) {
+        if (stamps_[id].epoch.load(std::memory_order_relaxed) > base_epoch) {
+            ids.emplace_back(static_cast<InnerIdType>(id));
+        }
+    }
+    return ids;
+}
+
+void
+DeltaTracker::stamp(InnerIdType id, uint32_t epoch) {
+    if (id >= stamps_.Capacity()) {
+        throw VsagException(
+            ErrorType::INTERNAL_ERROR,
+            fmt::format("delta tracker touches id {} beyond capacity {}", id, stamps_.Capacity()));
+    }
+    // a late writer of an older epoch must not hide a newer change of the same id
+    auto& stamp = stamps_[id].epoch;
+    auto current = stamp.load(std::memory_order_relaxed);
+    while (current < epoch and not stamp.compare_exchange_weak(current, epoch)) {
+    }
+}
+
+}  // namespace vsag
@@ -0,0 +1,90 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "segmented_array.h"
+#include "typing.h"
+#include "utils/pointer_define.h"
+
+namespace vsag {
+
+DEFINE_POINTER(DeltaTracker);
+
+/**
+ * Stamps every id of a datacell with the snapshot epoch of its last change, so that a delta
+ * snapshot writes only the ids changed after its base. The epoch counter is shared by all the
+ * trackers of an index: a snapshot closes the current epoch with Cut and later changes are
+ * stamped with the next one.
+ *
+ * A change must be stamped after it is applied, then an id stamped with a closed epoch is
+ * complete in every snapshot taken after the cut. Touch may run concurrently with itself, with
+ * ChangedSince and with a single Resize.
+ */
+class DeltaTracker {
+public:
+    using EpochPtr = std::shared_ptr<std::atomic<uint32_t>>;
+
+    // epochs start at 1, a stamp of 0 means never changed
+    static EpochPtr
+    MakeEpoch();
+
+    // closes the current epoch of the counter and returns it
+    static uint32_t
+    Cut(const EpochPtr& epoch);
+
+public:
+    DeltaTracker(EpochPtr epoch, Allocator* allocator);
+
+    void
+    Resize(InnerIdType capacity);
+
+    void
+    Touch(InnerIdType id);
+
+    // stamps the ids in [begin, end)
+    void
+    TouchRange(InnerIdType begin, InnerIdType end);
+
+    // the ids below limit stamped after base_epoch, in ascending order
+    [[nodiscard]] Vector<InnerIdType>
+    ChangedSince(uint32_t base_epoch, InnerIdType limit) const;
+
+    [[nodiscard]] int64_t
+    GetMemoryUsage() const {
+        return stamps_.GetMemoryUsage();
+    }
+
+private:
+    struct Stamp {
+        std::atomic<uint32_t> epoch{0};
+    };
+
+    static constexpr uint64_t SEGMENT_BIT = 16;
+
+    void
+    stamp(InnerIdType id, uint32_t epoch);
+
+private:
+    const EpochPtr epoch_{nullptr};
+    Allocator* const allocator_{nullptr};
+
+    SegmentedArray<Stamp> stamps_;
+};
+
+}  // namespace vsag
@@ -0,0 +1,76 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "delta_tracker.h"
+
+#include <thread>
+
+#include "impl/allocator/default_allocator.h"
+#include "unittest.h"
+using namespace vsag;
+
+TEST_CASE("DeltaTracker Basic Test", "[ut][DeltaTracker]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    auto epoch = DeltaTracker::MakeEpoch();
+    DeltaTracker tracker(epoch, allocator.get());
+    tracker.Resize(100000);
+
+    REQUIRE(tracker.ChangedSince(0, 100000).empty());
+    tracker.Touch(7);
+    tracker.TouchRange(70000, 70003);
+    auto changed = tracker.ChangedSince(0, 100000);
+    REQUIRE(changed == Vector<InnerIdType>({7, 70000, 70001, 70002}, allocator.get()));
+    REQUIRE(tracker.ChangedSince(0, 70001).size() == 2);
+
+    // the changes before a cut belong to the snapshot taken at the cut
+    auto base = DeltaTracker::Cut(epoch);
+    REQUIRE(tracker.ChangedSince(base, 100000).empty());
+    tracker.Touch(7);
+    tracker.Touch(9);
+    REQUIRE(tracker.ChangedSince(base, 100000) == Vector<InnerIdType>({7, 9}, allocator.get()));
+    REQUIRE(tracker.ChangedSince(0, 100000).size() == 5);
+
+    REQUIRE_THROWS(tracker.Touch(200000));
+    tracker.Resize(200001);
+    tracker.Touch(200000);
+    REQUIRE(tracker.ChangedSince(base, 200001).back() == 200000);
+}
+
+TEST_CASE("DeltaTracker Concurrent Touch", "[ut][DeltaTracker]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    auto epoch = DeltaTracker::MakeEpoch();
+    DeltaTracker tracker(epoch, allocator.get());
+    constexpr InnerIdType count = 4096;
+    tracker.Resize(count);
+
+    std::vector<std::thread> threads;
+    for (InnerIdType t = 0; t < 4; ++t) {
+        threads.emplace_back([&tracker, t]() {
+            for (InnerIdType id = t; id < count; id += 4) {
+                tracker.Touch(id);
+            }
+        });
+    }
+    auto base = DeltaTracker::Cut(epoch);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    tracker.Touch(count - 1);
+
+    // every id is changed, whether the cut split the writers or not
+    REQUIRE(tracker.ChangedSince(0, count).size() == count);
+    auto after_cut = tracker.ChangedSince(base, count);
+    REQUIRE_FALSE(after_cut.empty());
+    REQUIRE(after_cut.back() == count - 1);
+}
@@ -15,53 +15,143 @@
 
 #include "lock_strategy.h"
 
+#include <thread>
+
 namespace vsag {
 
-PointsMutex::PointsMutex(uint32_t element_num, Allocator* allocator)
-    : allocator_(allocator),
-      neighbors_mutex_(element_num, nullptr, allocator),
-      element_num_(element_num) {
-    for (int i = 0; i < element_num_; ++i) {
-        neighbors_mutex_[i] = AllocateShared<std::shared_mutex>(allocator_);
+namespace {
+
+constexpr uint32_t SPIN_COUNT_BEFORE_YIELD = 64;
+
+// points per segment of the lock arrays, small enough for tiny indexes
+constexpr uint64_t POINTS_SEGMENT_BIT = 12;
+
+inline void
+spin_wait(uint32_t& spin_count) {
+    if (++spin_count >= SPIN_COUNT_BEFORE_YIELD) {
+        spin_count = 0;
+        std::this_thread::yield();
     }
 }
 
+}  // namespace
+
+PointsMutex::PointsMutex(uint32_t element_num, Allocator* allocator)
+    : neighbors_mutex_(POINTS_SEGMENT_BIT, allocator), allocator_(allocator) {
+    this->Resize(element_num);
+}
+
 void
 PointsMutex::SharedLock(uint32_t i) {
-    neighbors_mutex_[i]->lock_shared();
+    neighbors_mutex_[i].lock_shared();
 }
 
 void
 PointsMutex::SharedUnlock(uint32_t i) {
-    neighbors_mutex_[i]->unlock_shared();
+    neighbors_mutex_[i].unlock_shared();
 }
 
 void
 PointsMutex::Lock(uint32_t i) {
-    neighbors_mutex_[i]->lock();
+    neighbors_mutex_[i].lock();
 }
 
 void
 PointsMutex::Unlock(uint32_t i) {
-    neighbors_mutex_[i]->unlock();
+    neighbors_mutex_[i].unlock();
 }
 
 void
 PointsMutex::Resize(uint32_t new_element_num) {
-    neighbors_mutex_.resize(new_element_num);
-    if (new_element_num > element_num_) {
-        for (auto i = element_num_; i < new_element_num; ++i) {
-            neighbors_mutex_[i] = AllocateShared<std::shared_mutex>(allocator_);
+    neighbors_mutex_.Resize(new_element_num);
+    element_num_.store(new_element_num, std::memory_order_release);
+}
+
+int64_t
+PointsMutex::GetMemoryUsage() {
+    return static_cast<int64_t>(static_cast<uint64_t>(element_num_.load()) *
+                                sizeof(std::shared_mutex));
+}
+
+PointsSpinLock::PointsSpinLock(uint32_t element_num, Allocator* allocator)
+    : states_(POINTS_SEGMENT_BIT, allocator), allocator_(allocator) {
+    this->Resize(element_num);
+}
+
+void
+PointsSpinLock::SharedLock(uint32_t i) {
+    auto& lock = states_[i].lock;
+    uint32_t spin_count = 0;
+    auto cur = lock.load(std::memory_order_relaxed);
+    while (true) {
+        if ((cur & WRITER_BIT) != 0) {
+            spin_wait(spin_count);
+            cur = lock.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (lock.compare_exchange_weak(
+                cur, cur + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            return;
         }
     }
-    element_num_ = new_element_num;
+}
+
+void
+PointsSpinLock::SharedUnlock(uint32_t i) {
+    states_[i].lock.fetch_sub(1, std::memory_order_release);
+}
+
+void
+PointsSpinLock::Lock(uint32_t i) {
+    auto& state = states_[i];
+    uint32_t spin_count = 0;
+    uint32_t expected = 0;
+    while (not state.lock.compare_exchange_weak(
+        expected, WRITER_BIT, std::memory_order_acquire, std::memory_order_relaxed)) {
+        expected = 0;
+        spin_wait(spin_count);
+    }
+    state.version.fetch_add(1, std::memory_order_relaxed);
+    // the odd version must be visible before any write of the critical section
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void
+PointsSpinLock::Unlock(uint32_t i) {
+    auto& state = states_[i];
+    state.version.fetch_add(1, std::memory_order_release);
+    state.lock.store(0, std::memory_order_release);
+}
+
+uint32_t
+PointsSpinLock::ReadBegin(uint32_t i) {
+    const auto& version = states_[i].version;
+    uint32_t spin_count = 0;
+    auto token = version.load(std::memory_order_acquire);
+    while ((token & 1U) != 0) {
+        spin_wait(spin_count);
+        token = version.load(std::memory_order_acquire);
+    }
+    return token;
+}
+
+bool
+PointsSpinLock::ReadValidate(uint32_t i, uint32_t token) {
+    // keep the reads of the critical section before the second version load
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return states_[i].version.load(std::memory_order_relaxed) == token;
+}
+
+void
+PointsSpinLock::Resize(uint32_t new_element_num) {
+    states_.Resize(new_element_num);
+    element_num_.store(new_element_num, std::memory_order_release);
 }
 
 int64_t
-PointsMutex::GetMemoryUsage() {
-    return static_cast<int64_t>(
-        neighbors_mutex_.size() *
-        (sizeof(std::shared_ptr<std::shared_mutex>) + sizeof(std::shared_mutex)));
+PointsSpinLock::GetMemoryUsage() {
+    return static_cast<int64_t>(sizeof(PointsSpinLock) +
+                                static_cast<uint64_t>(element_num_.load()) * sizeof(PointState));
 }
 
 }  // namespace vsag
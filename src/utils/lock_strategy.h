@@ -15,10 +15,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <shared_mutex>
 
 #include "typing.h"
 #include "utils/pointer_define.h"
+#include "utils/segmented_array.h"
 
 namespace vsag {
 DEFINE_POINTER(MutexArray);
@@ -39,11 +41,32 @@ public:
     virtual void
     SharedUnlock(uint32_t i) = 0;
 
+    /**
+     * Growing keeps the existing points in place, so it may run concurrently with the other
+     * calls as long as there is only one resizer. Shrinking requires exclusive access.
+     */
     virtual void
     Resize(uint32_t new_element_num) = 0;
 
     virtual int64_t
     GetMemoryUsage() = 0;
+
+    /**
+     * Starts a read of the data guarded by point i and returns a token for ReadValidate.
+     * By default the shared lock is held until ReadValidate, which then always succeeds;
+     * an optimistic implementation does not block writers and may ask the reader to retry.
+     */
+    virtual uint32_t
+    ReadBegin(uint32_t i) {
+        this->SharedLock(i);
+        return 0;
+    }
+
+    virtual bool
+    ReadValidate(uint32_t i, uint32_t token) {
+        this->SharedUnlock(i);
+        return true;
+    }
 };
 
 class PointsMutex : public MutexArray {
@@ -69,9 +92,58 @@ public:
     GetMemoryUsage() override;
 
 private:
-    Vector<std::shared_ptr<std::shared_mutex>> neighbors_mutex_;
+    SegmentedArray<std::shared_mutex> neighbors_mutex_;
     Allocator* const allocator_{nullptr};
-    uint32_t element_num_{0};
+    std::atomic<uint32_t> element_num_{0};
+};
+
+/**
+ * A compact alternative to PointsMutex for concurrent insert: every point takes 8 bytes, a
+ * reader/writer spinlock word and a seqlock version. Writers bump the version around their
+ * critical section, so ReadBegin/ReadValidate read without blocking writers and retry when
+ * the version changed.
+ */
+class PointsSpinLock : public MutexArray {
+public:
+    PointsSpinLock(uint32_t element_num, Allocator* allocator);
+
+    void
+    SharedLock(uint32_t i) override;
+
+    void
+    SharedUnlock(uint32_t i) override;
+
+    void
+    Lock(uint32_t i) override;
+
+    void
+    Unlock(uint32_t i) override;
+
+    void
+    Resize(uint32_t new_element_num) override;
+
+    int64_t
+    GetMemoryUsage() override;
+
+    uint32_t
+    ReadBegin(uint32_t i) override;
+
+    bool
+    ReadValidate(uint32_t i, uint32_t token) override;
+
+private:
+    struct PointState {
+        // WRITER_BIT marks the exclusive holder, the lower bits count the shared holders
+        std::atomic<uint32_t> lock{0};
+        // odd while a writer is inside its critical section
+        std::atomic<uint32_t> version{0};
+    };
+
+    static constexpr uint32_t WRITER_BIT = 1U << 31;
+
+    SegmentedArray<PointState> states_;
+    Allocator* const allocator_{nullptr};
+    std::atomic<uint32_t> element_num_{0};
 };
 
 class EmptyMutex : public MutexArray {
@@ -119,6 +191,27 @@ private:
     const MutexArrayPtr& mutex_impl_;
 };
 
+/**
+ * Runs read_func, which must only copy the data guarded by point locked_index, until it
+ * observes a consistent state.
+ */
+template <typename ReadFunc>
+void
+OptimisticRead(const MutexArrayPtr& mutex_impl, uint32_t locked_index, ReadFunc&& read_func) {
+    while (true) {
+        auto token = mutex_impl->ReadBegin(locked_index);
+        try {
+            read_func();
+        } catch (...) {
+            mutex_impl->ReadValidate(locked_index, token);
+            throw;
+        }
+        if (mutex_impl->ReadValidate(locked_index, token)) {
+            return;
+        }
+    }
+}
+
 class LockGuard {
 public:
     LockGuard(MutexArrayPtr mutex_impl, uint32_t locked_index)
@@ -65,6 +65,60 @@ TEST_CASE("LockStrategy Basic", "[ut][LockStrategy]") {
         REQUIRE(counter == thread_num * loops);
     }
 
+    SECTION("points spin lock guards and optimistic read") {
+        auto mutex_impl = std::make_shared<PointsSpinLock>(4, allocator.get());
+        REQUIRE(mutex_impl->GetMemoryUsage() > 0);
+        mutex_impl->SharedLock(0);
+        mutex_impl->SharedLock(0);
+        mutex_impl->SharedUnlock(0);
+        mutex_impl->SharedUnlock(0);
+
+        // a writer between ReadBegin and ReadValidate invalidates the read
+        auto token = mutex_impl->ReadBegin(1);
+        mutex_impl->Lock(1);
+        mutex_impl->Unlock(1);
+        REQUIRE_FALSE(mutex_impl->ReadValidate(1, token));
+        token = mutex_impl->ReadBegin(1);
+        REQUIRE(mutex_impl->ReadValidate(1, token));
+
+        // resize keeps the state of the existing points
+        mutex_impl->Resize(16);
+        REQUIRE(mutex_impl->ReadValidate(1, token));
+
+        std::atomic<uint64_t> pair[2] = {0, 0};
+        constexpr int thread_num = 4;
+        constexpr int loops = 1000;
+        std::atomic<bool> torn{false};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < thread_num; ++i) {
+            threads.emplace_back([&]() {
+                for (int j = 0; j < loops; ++j) {
+                    LockGuard guard(mutex_impl, 2);
+                    pair[0].store(pair[0].load() + 1, std::memory_order_relaxed);
+                    pair[1].store(pair[1].load() + 1, std::memory_order_relaxed);
+                }
+            });
+            threads.emplace_back([&]() {
+                for (int j = 0; j < loops; ++j) {
+                    uint64_t first = 0;
+                    uint64_t second = 0;
+                    OptimisticRead(mutex_impl, 2, [&]() {
+                        first = pair[0].load(std::memory_order_relaxed);
+                        second = pair[1].load(std::memory_order_relaxed);
+                    });
+                    if (first != second) {
+                        torn.store(true);
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        REQUIRE_FALSE(torn.load());
+        REQUIRE(pair[0].load() == thread_num * loops);
+    }
+
     SECTION("empty mutex no-op") {
         EmptyMutex mutex_array;
         mutex_array.Lock(0);
@@ -0,0 +1,69 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "resource_object.h"
+#include "resource_object_pool.h"
+#include "typing.h"
+
+namespace vsag {
+
+/**
+ * @brief Scratch space of a bucket scan, reused across searches through a ScanBufferPool.
+ *
+ * dists_ holds the distances of a scanned bucket and selected_ the offsets of the candidates
+ * surviving the selection stage, both only grow so a warm buffer never allocates.
+ */
+class ScanBuffer : public ResourceObject {
+public:
+    explicit ScanBuffer(Allocator* allocator) : dists_(allocator), selected_(allocator) {
+    }
+
+    void
+    Reset() override {
+    }
+
+    [[nodiscard]] int64_t
+    GetMemoryUsage() const override {
+        return static_cast<int64_t>(sizeof(ScanBuffer) + dists_.capacity() * sizeof(float) +
+                                    selected_.capacity() * sizeof(uint32_t));
+    }
+
+    float*
+    Dists(uint64_t size) {
+        if (size > dists_.size()) {
+            dists_.resize(size);
+        }
+        return dists_.data();
+    }
+
+    uint32_t*
+    Selected(uint64_t size) {
+        if (size > selected_.size()) {
+            selected_.resize(size);
+        }
+        return selected_.data();
+    }
+
+private:
+    Vector<float> dists_;
+    Vector<uint32_t> selected_;
+};
+
+using ScanBufferPool = ResourceObjectPool<ScanBuffer>;
+using ScanBufferPoolPtr = std::shared_ptr<ScanBufferPool>;
+
+}  // namespace vsag
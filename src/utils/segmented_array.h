@@ -0,0 +1,179 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#include "typing.h"
+#include "vsag/allocator.h"
+#include "vsag_exception.h"
+
+namespace vsag {
+
+/**
+ * An array built from fixed-size segments of 2^segment_bit elements. A segment never moves
+ * once it is allocated: growing appends segments and publishes a new segment directory, so
+ * a single grower may run concurrently with readers and writers of the existing elements.
+ * The replaced directories are kept until the array is destroyed. Shrinking releases the
+ * trailing segments and must not run concurrently with any other call.
+ *
+ * Elements of a trivially constructible type are left uninitialized.
+ */
+template <typename T>
+class SegmentedArray {
+public:
+    SegmentedArray(uint64_t segment_bit, Allocator* allocator)
+        : segment_bit_(segment_bit),
+          segment_mask_((1ULL << segment_bit) - 1),
+          allocator_(allocator),
+          retired_directories_(allocator) {
+    }
+
+    ~SegmentedArray() {
+        this->release_segments(0);
+        auto* directory = directory_.load(std::memory_order_relaxed);
+        if (directory != nullptr) {
+            allocator_->Deallocate(directory);
+        }
+        for (auto* retired : retired_directories_) {
+            allocator_->Deallocate(retired);
+        }
+    }
+
+    SegmentedArray(const SegmentedArray&) = delete;
+    SegmentedArray&
+    operator=(const SegmentedArray&) = delete;
+
+    inline T&
+    operator[](uint64_t i) const {
+        return this->Segment(i >> segment_bit_)[i & segment_mask_];
+    }
+
+    [[nodiscard]] inline T*
+    Segment(uint64_t segment_no) const {
+        return directory_.load(std::memory_order_acquire)[segment_no];
+    }
+
+    /**
+     * Makes room for at least count elements, rounded up to whole segments. Growing keeps
+     * every existing element in place; shrinking drops the segments beyond count.
+     */
+    void
+    Resize(uint64_t count) {
+        auto new_segment_count = (count + segment_mask_) >> segment_bit_;
+        auto cur_segment_count = segment_count_.load(std::memory_order_relaxed);
+        if (new_segment_count < cur_segment_count) {
+            this->release_segments(new_segment_count);
+            return;
+        }
+        if (new_segment_count == cur_segment_count) {
+            return;
+        }
+
+        auto* directory = directory_.load(std::memory_order_relaxed);
+        if (new_segment_count > directory_capacity_) {
+            auto new_capacity = std::max(new_segment_count, directory_capacity_ * 2);
+            auto* new_directory =
+                static_cast<T**>(allocator_->Allocate(new_capacity * sizeof(T*)));
+            if (new_directory == nullptr) {
+                throw VsagException(ErrorType::NO_ENOUGH_MEMORY,
+                                    "SegmentedArray directory allocation failed");
+            }
+            if (cur_segment_count > 0) {
+                memcpy(new_directory, directory, cur_segment_count * sizeof(T*));
+            }
+            // readers may still hold the old directory, so it is retired instead of freed
+            if (directory != nullptr) {
+                retired_directories_.emplace_back(directory);
+                retired_directory_size_ += directory_capacity_ * sizeof(T*);
+            }
+            directory = new_directory;
+            directory_capacity_ = new_capacity;
+        }
+
+        for (auto i = cur_segment_count; i < new_segment_count; ++i) {
+            directory[i] = this->allocate_segment();
+        }
+        directory_.store(directory, std::memory_order_release);
+        segment_count_.store(new_segment_count, std::memory_order_release);
+    }
+
+    [[nodiscard]] uint64_t
+    SegmentCount() const {
+        return segment_count_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] uint64_t
+    Capacity() const {
+        return this->SegmentCount() << segment_bit_;
+    }
+
+    [[nodiscard]] int64_t
+    GetMemoryUsage() const {
+        return static_cast<int64_t>(sizeof(SegmentedArray) + retired_directory_size_ +
+                                    directory_capacity_ * sizeof(T*) +
+                                    this->Capacity() * sizeof(T));
+    }
+
+private:
+    T*
+    allocate_segment() {
+        auto* segment = static_cast<T*>(allocator_->Allocate(sizeof(T) << segment_bit_));
+        if (segment == nullptr) {
+            throw VsagException(ErrorType::NO_ENOUGH_MEMORY,
+                                "SegmentedArray segment allocation failed");
+        }
+        if constexpr (not std::is_trivially_default_constructible_v<T>) {
+            for (uint64_t i = 0; i <= segment_mask_; ++i) {
+                new (segment + i) T();
+            }
+        }
+        return segment;
+    }
+
+    void
+    release_segments(uint64_t keep_count) {
+        auto* directory = directory_.load(std::memory_order_relaxed);
+        auto cur_segment_count = segment_count_.load(std::memory_order_relaxed);
+        for (auto i = keep_count; i < cur_segment_count; ++i) {
+            if constexpr (not std::is_trivially_destructible_v<T>) {
+                for (uint64_t j = 0; j <= segment_mask_; ++j) {
+                    directory[i][j].~T();
+                }
+            }
+            allocator_->Deallocate(directory[i]);
+        }
+        segment_count_.store(std::min(keep_count, cur_segment_count), std::memory_order_release);
+    }
+
+private:
+    const uint64_t segment_bit_;
+    const uint64_t segment_mask_;
+    Allocator* const allocator_{nullptr};
+
+    std::atomic<T**> directory_{nullptr};
+    uint64_t directory_capacity_{0};
+    uint64_t retired_directory_size_{0};
+    std::atomic<uint64_t> segment_count_{0};
+
+    Vector<T**> retired_directories_;
+};
+
+}  // namespace vsag
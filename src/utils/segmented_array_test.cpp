@@ -0,0 +1,97 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "segmented_array.h"
+
+#include <atomic>
+#include <thread>
+
+#include "impl/allocator/default_allocator.h"
+#include "unittest.h"
+using namespace vsag;
+
+TEST_CASE("SegmentedArray Basic Test", "[ut][SegmentedArray]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    SegmentedArray<uint64_t> array(4, allocator.get());
+    REQUIRE(array.Capacity() == 0);
+
+    array.Resize(20);
+    REQUIRE(array.SegmentCount() == 2);
+    REQUIRE(array.Capacity() == 32);
+    for (uint64_t i = 0; i < 32; ++i) {
+        array[i] = i;
+    }
+    auto* first_segment = array.Segment(0);
+
+    SECTION("grow keeps elements in place") {
+        array.Resize(1000);
+        REQUIRE(array.Capacity() == 1008);
+        REQUIRE(array.Segment(0) == first_segment);
+        for (uint64_t i = 0; i < 32; ++i) {
+            REQUIRE(array[i] == i);
+        }
+        REQUIRE(array.GetMemoryUsage() > 1000 * sizeof(uint64_t));
+    }
+
+    SECTION("shrink drops trailing segments") {
+        array.Resize(10);
+        REQUIRE(array.SegmentCount() == 1);
+        REQUIRE(array.Segment(0) == first_segment);
+        REQUIRE(array[15] == 15);
+    }
+}
+
+TEST_CASE("SegmentedArray Constructs Elements", "[ut][SegmentedArray]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    SegmentedArray<std::atomic<uint32_t>> array(3, allocator.get());
+    array.Resize(17);
+    for (uint64_t i = 0; i < array.Capacity(); ++i) {
+        REQUIRE(array[i].load() == 0);
+    }
+}
+
+TEST_CASE("SegmentedArray Grow While Reading", "[ut][SegmentedArray]") {
+    auto allocator = std::make_shared<DefaultAllocator>();
+    SegmentedArray<std::atomic<uint64_t>> array(6, allocator.get());
+    array.Resize(64);
+    for (uint64_t i = 0; i < 64; ++i) {
+        array[i].store(i);
+    }
+
+    std::atomic<uint64_t> published{64};
+    std::atomic<bool> mismatch{false};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            for (int loop = 0; loop < 20000; ++loop) {
+                auto limit = published.load();
+                auto i = static_cast<uint64_t>(loop) % limit;
+                if (array[i].load() != i) {
+                    mismatch.store(true);
+                }
+            }
+        });
+    }
+    for (uint64_t size = 128; size <= 64 * 256; size += 64) {
+        array.Resize(size);
+        for (uint64_t i = size - 64; i < size; ++i) {
+            array[i].store(i);
+        }
+        published.store(size);
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    REQUIRE_FALSE(mismatch.load());
+}
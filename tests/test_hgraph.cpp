@@ -13,12 +13,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <chrono>
+#include <filesystem>
 #include <limits>
 
 #include "functest.h"
 #include "inner_string_params.h"
+#include "storage/operation_log.h"
 #include "test_index.h"
 #include "typing.h"
 #include "vsag/filter.h"
@@ -53,6 +57,8 @@ public:
         bool use_attr_filter = false;
         bool store_raw_vector = false;
         bool support_duplicate = false;
+        bool concurrent_insert = false;
+        uint64_t block_cache_size = 0;
         std::string graph_io_type = "block_memory_io";
         std::string graph_file_path = "./graph_storage";
         HGraphBuildParam(const std::string& metric_type,
@@ -187,6 +193,8 @@ HGraphTestIndex::GenerateHGraphBuildParametersString(const HGraphBuildParam& par
             "use_attribute_filter": {},
             "store_raw_vector": {},
             "support_duplicate": {},
+            "concurrent_insert": {},
+            "block_cache_size": {},
             "graph_io_type": "{}",
             "graph_file_path": "{}",
             "rabitq_bits_per_dim_base": {},
@@ -216,6 +224,8 @@ HGraphTestIndex::GenerateHGraphBuildParametersString(const HGraphBuildParam& par
             "use_attribute_filter": {},
             "store_raw_vector": {},
             "support_duplicate": {},
+            "concurrent_insert": {},
+            "block_cache_size": {},
             "graph_io_type": "{}",
             "graph_file_path": "{}",
             "rabitq_bits_per_dim_base": {},
@@ -260,6 +270,8 @@ HGraphTestIndex::GenerateHGraphBuildParametersString(const HGraphBuildParam& par
                                            param.use_attr_filter,
                                            param.store_raw_vector,
                                            param.support_duplicate,
+                                           param.concurrent_insert,
+                                           param.block_cache_size,
                                            param.graph_io_type,
                                            param.graph_file_path,
                                            rabitq_num_bit_base,
@@ -279,6 +291,8 @@ HGraphTestIndex::GenerateHGraphBuildParametersString(const HGraphBuildParam& par
                                            param.use_attr_filter,
                                            param.store_raw_vector,
                                            param.support_duplicate,
+                                           param.concurrent_insert,
+                                           param.block_cache_size,
                                            param.graph_io_type,
                                            param.graph_file_path,
                                            param.rabitq_num_bit_base,
@@ -831,6 +845,80 @@ TEST_CASE("(PR) HGraph SearchWithRequest Reasoning", "[ft][hgraph][pr]") {
     REQUIRE(empty_result.value()->GetReasoning().find("diagnosis") != std::string::npos);
 }
 
+TEST_CASE("(PR) HGraph Batch Search", "[ft][hgraph][pr]") {
+    using namespace fixtures;
+
+    HGraphTestIndex::HGraphBuildParam build_param("l2", 32, "sq8");
+    auto param = HGraphTestIndex::GenerateHGraphBuildParametersString(build_param);
+
+    auto index = TestIndex::TestFactory(HGraphTestIndex::name, param, true);
+    auto dataset = HGraphTestIndex::pool.GetDatasetAndCreate(32, 1000, "l2");
+    TestIndex::TestBuildIndex(index, dataset, true);
+    REQUIRE(index->CheckFeature(vsag::SUPPORT_BATCH_SEARCH));
+
+    const auto& queries = dataset->query_;
+    auto query_count = queries->GetNumElements();
+    int64_t topk = 10;
+    auto parallelism = GENERATE(1, 4);
+    auto search_param = fmt::format(R"({{"hgraph": {{"ef_search": 100, "parallelism": {}}}}})",
+                                    parallelism);
+
+    vsag::SearchRequest req;
+    req.topk_ = topk;
+    req.params_str_ = search_param;
+    req.query_ = queries;
+    auto batch_result = index->SearchWithRequest(req);
+    REQUIRE(batch_result.has_value());
+    REQUIRE(batch_result.value()->GetNumElements() == query_count);
+    REQUIRE(batch_result.value()->GetDim() == topk);
+
+    auto single_param = fmt::format(fixtures::search_param_tmp, 100, false);
+    for (int64_t i = 0; i < query_count; ++i) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)
+            ->Dim(queries->GetDim())
+            ->Float32Vectors(queries->GetFloat32Vectors() + i * queries->GetDim())
+            ->Owner(false);
+        auto single_result = index->KnnSearch(query, topk, single_param);
+        REQUIRE(single_result.has_value());
+        for (int64_t j = 0; j < single_result.value()->GetDim(); ++j) {
+            REQUIRE(single_result.value()->GetIds()[j] ==
+                    batch_result.value()->GetIds()[i * topk + j]);
+        }
+    }
+
+    // an empty index answers an empty dataset
+    int64_t small_count = 3;
+    auto small_index = TestIndex::TestFactory(HGraphTestIndex::name, param, true);
+    auto empty_result = small_index->SearchWithRequest(req);
+    REQUIRE(empty_result.has_value());
+    REQUIRE(empty_result.value()->GetNumElements() == 0);
+
+    // an index with fewer than k vectors still answers N x k with unfilled slots
+    auto check_unfilled = [&](int64_t filled) {
+        auto result = small_index->SearchWithRequest(req);
+        REQUIRE(result.has_value());
+        REQUIRE(result.value()->GetNumElements() == query_count);
+        REQUIRE(result.value()->GetDim() == topk);
+        for (int64_t i = 0; i < query_count; ++i) {
+            for (int64_t j = 0; j < topk; ++j) {
+                auto id = result.value()->GetIds()[i * topk + j];
+                auto dist = result.value()->GetDistances()[i * topk + j];
+                REQUIRE((j < filled) == (id != -1));
+                REQUIRE((j < filled) == (dist != std::numeric_limits<float>::max()));
+            }
+        }
+    };
+    auto small_base = vsag::Dataset::Make();
+    small_base->NumElements(small_count)
+        ->Dim(dataset->base_->GetDim())
+        ->Ids(dataset->base_->GetIds())
+        ->Float32Vectors(dataset->base_->GetFloat32Vectors())
+        ->Owner(false);
+    REQUIRE(small_index->Build(small_base).has_value());
+    check_unfilled(small_count);
+}
+
 static void
 TestHGraphGetRawVector(const fixtures::HGraphTestIndexPtr& test_index,
                        const fixtures::HGraphResourcePtr& resource) {
@@ -1132,6 +1220,36 @@ HGRAPH_PR_DAILY_CASE("HGraph Compressed Graph Build",
                      "[ft][build][hgraph]",
                      TestHGraphCompressedBuild)
 
+static void
+TestHGraphColocatedBuild(const fixtures::HGraphTestIndexPtr& test_index,
+                         const fixtures::HGraphResourcePtr& resource) {
+    using namespace fixtures;
+    auto search_param = fmt::format(fixtures::search_param_tmp, 200, false);
+
+    ForEachHGraphCase(
+        resource,
+        resource->test_cases,
+        [&](const auto& metric_type, int64_t dim, const auto& base_quantization_str, float recall) {
+            RunWithGeneratedBlockSizeLimit([&] {
+                HGraphTestIndex::HGraphBuildParam build_param(
+                    metric_type, dim, base_quantization_str);
+                build_param.graph_storage = "colocated";
+                auto param = HGraphTestIndex::GenerateHGraphBuildParametersString(build_param);
+                auto index = TestIndex::TestFactory(test_index->name, param, true);
+                auto dataset = HGraphTestIndex::pool.GetDatasetAndCreate(
+                    dim, resource->base_count, metric_type);
+                TestIndex::TestBuildIndex(index, dataset, true);
+                HGraphTestIndex::TestGeneral(index, dataset, search_param, recall);
+                auto index2 = TestIndex::TestFactory(test_index->name, param, true);
+                TestIndex::TestSerializeFile(index, index2, dataset, search_param, true);
+            });
+        });
+}
+
+HGRAPH_PR_DAILY_CASE("HGraph Colocated Graph Build",
+                     "[ft][build][hgraph]",
+                     TestHGraphColocatedBuild)
+
 static void
 TestHGraphMerge(const fixtures::HGraphTestIndexPtr& test_index,
                 const fixtures::HGraphResourcePtr& resource) {
@@ -1457,6 +1575,7 @@ TestHGraphConcurrentAddSearchRemove(const fixtures::HGraphTestIndexPtr& test_ind
     using namespace fixtures;
     auto origin_size = vsag::Options::Instance().block_size_limit();
     auto size = GENERATE(1024 * 1024 * 2);
+    auto concurrent_insert = GENERATE(false, true);
     auto search_param = fmt::format(fixtures::search_param_tmp, 200, false);
 
     for (auto metric_type : resource->metric_types) {
@@ -1479,6 +1598,7 @@ TestHGraphConcurrentAddSearchRemove(const fixtures::HGraphTestIndexPtr& test_ind
                 HGraphTestIndex::HGraphBuildParam build_param(
                     metric_type, dim, base_quantization_str);
                 build_param.support_remove = true;
+                build_param.concurrent_insert = concurrent_insert;
                 auto param = HGraphTestIndex::GenerateHGraphBuildParametersString(build_param);
                 auto index = TestIndex::TestFactory(test_index->name, param, true);
                 auto dataset = HGraphTestIndex::pool.GetDatasetAndCreate(
@@ -1592,6 +1712,9 @@ TestHGraphReaderIO(const fixtures::HGraphTestIndexPtr& test_index,
                 auto index2 = TestIndex::TestFactory(test_index->name, reader_param, true);
                 TestIndex::TestSerializeReaderSet(
                     index, index2, dataset, search_param, test_index->name, true);
+                auto index3 = TestIndex::TestFactory(test_index->name, reader_param, true);
+                TestIndex::TestSerializeMMapReaderSet(
+                    index, index3, dataset, search_param, test_index->name);
                 vsag::Options::Instance().set_block_size_limit(origin_size);
             }
         }
@@ -1999,8 +2122,9 @@ TestHGraphSearchOverTime(const fixtures::HGraphTestIndexPtr& test_index,
 HGRAPH_PR_DAILY_CASE("HGraph Search Over Time", "[ft][search][hgraph]", TestHGraphSearchOverTime)
 
 static void
-TestHGraphDiskIOType(const fixtures::HGraphTestIndexPtr& test_index,
-                     const fixtures::HGraphResourcePtr& resource) {
+RunHGraphDiskIOType(const fixtures::HGraphTestIndexPtr& test_index,
+                    const fixtures::HGraphResourcePtr& resource,
+                    uint64_t block_cache_size) {
     using namespace fixtures;
     auto origin_size = vsag::Options::Instance().block_size_limit();
     auto size = GENERATE(1024 * 1024 * 2);
@@ -2036,6 +2160,7 @@ TestHGraphDiskIOType(const fixtures::HGraphTestIndexPtr& test_index,
 
                 auto graph_io_type = graph_io_types[select_idx];
                 build_param.graph_io_type = graph_io_type;
+                build_param.block_cache_size = block_cache_size;
                 param = HGraphTestIndex::GenerateHGraphBuildParametersString(build_param);
                 auto disk_index = TestIndex::TestFactory(test_index->name, param, true);
                 TestIndex::TestSerializeFile(index, disk_index, dataset, search_param, true);
@@ -2048,8 +2173,24 @@ TestHGraphDiskIOType(const fixtures::HGraphTestIndexPtr& test_index,
     }
 }
 
+static void
+TestHGraphDiskIOType(const fixtures::HGraphTestIndexPtr& test_index,
+                     const fixtures::HGraphResourcePtr& resource) {
+    RunHGraphDiskIOType(test_index, resource, 0);
+}
+
 HGRAPH_PR_DAILY_CASE("HGraph Disk IO Type Index", "[ft][serialize][hgraph]", TestHGraphDiskIOType)
 
+static void
+TestHGraphDiskIOTypeWithBlockCache(const fixtures::HGraphTestIndexPtr& test_index,
+                                   const fixtures::HGraphResourcePtr& resource) {
+    RunHGraphDiskIOType(test_index, resource, 4 * 1024 * 1024);
+}
+
+HGRAPH_PR_DAILY_CASE("HGraph Disk IO Type Index With Block Cache",
+                     "[ft][serialize][hgraph]",
+                     TestHGraphDiskIOTypeWithBlockCache)
+
 TEST_CASE("HGraph Concurrent Read Write", "[ft][concurrent][hgraph]") {
     uint32_t op_num = 10000;
     uint32_t dim = 128;
@@ -2332,3 +2473,457 @@ TestHGraphReverseEdges(const fixtures::HGraphTestIndexPtr& test_index,
 }
 
 HGRAPH_PR_DAILY_CASE("HGraph Reverse Edges", "[ft][build][hgraph]", TestHGraphReverseEdges)
+
+TEST_CASE("(PR) HGraph Delta Snapshot", "[ft][serialize][hgraph][pr]") {
+    int64_t dim = 32;
+    int64_t base_count = 600;
+    std::mt19937 rng(47);
+    std::uniform_real_distribution<float> dist(-1.0, 1.0);
+    std::vector<float> vectors(base_count * dim);
+    std::vector<int64_t> ids(base_count);
+    for (int64_t i = 0; i < base_count; ++i) {
+        ids[i] = i * 3 + 1;
+        for (int64_t j = 0; j < dim; ++j) {
+            vectors[i * dim + j] = dist(rng);
+        }
+    }
+    auto make_base = [&](int64_t begin, int64_t end) {
+        auto base = vsag::Dataset::Make();
+        base->NumElements(end - begin)
+            ->Dim(dim)
+            ->Ids(ids.data() + begin)
+            ->Float32Vectors(vectors.data() + begin * dim)
+            ->Owner(false);
+        return base;
+    };
+
+    auto support_delta = GENERATE(true, false);
+    std::string hgraph_params = fmt::format(R"({{
+        "dtype": "float32",
+        "metric_type": "l2",
+        "dim": {},
+        "index_param": {{
+            "base_quantization_type": "sq8",
+            "use_reorder": true,
+            "precise_quantization_type": "fp32",
+            "max_degree": 16,
+            "ef_construction": 100,
+            "support_delta_snapshot": {}
+        }}
+    }})",
+                                            dim,
+                                            support_delta);
+    auto index = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+    auto replica = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+    REQUIRE(index->Build(make_base(0, 300)).has_value());
+
+    if (not support_delta) {
+        REQUIRE_FALSE(index->SerializeDelta().has_value());
+        return;
+    }
+    // a delta needs a base snapshot
+    REQUIRE_FALSE(index->SerializeDelta().has_value());
+    auto full = index->Serialize();
+    REQUIRE(full.has_value());
+    REQUIRE(replica->Deserialize(full.value()).has_value());
+    REQUIRE_FALSE(replica->DeserializeDelta(full.value()).has_value());
+
+    REQUIRE(index->Add(make_base(300, 450)).has_value());
+    auto delta1 = index->SerializeDelta();
+    REQUIRE(delta1.has_value());
+    REQUIRE(index->Add(make_base(450, 600)).has_value());
+    auto delta2 = index->SerializeDelta();
+    REQUIRE(delta2.has_value());
+    // the deltas only carry the changed nodes
+    REQUIRE(delta2.value().Get("hgraph").size < full.value().Get("hgraph").size);
+
+    // the chain applies in order only
+    REQUIRE_FALSE(replica->DeserializeDelta(delta2.value()).has_value());
+    REQUIRE(replica->DeserializeDelta(delta1.value()).has_value());
+    REQUIRE(replica->DeserializeDelta(delta2.value()).has_value());
+    REQUIRE_FALSE(replica->DeserializeDelta(delta2.value()).has_value());
+    REQUIRE(replica->GetNumElements() == index->GetNumElements());
+
+    std::string search_params = R"({"hgraph": {"ef_search": 100}})";
+    for (int64_t i = 0; i < base_count; i += 7) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)->Dim(dim)->Float32Vectors(vectors.data() + i * dim)->Owner(false);
+        auto expected = index->KnnSearch(query, 10, search_params);
+        auto result = replica->KnnSearch(query, 10, search_params);
+        REQUIRE(expected.has_value());
+        REQUIRE(result.has_value());
+        REQUIRE(result.value()->GetDim() == expected.value()->GetDim());
+        for (int64_t k = 0; k < expected.value()->GetDim(); ++k) {
+            REQUIRE(result.value()->GetIds()[k] == expected.value()->GetIds()[k]);
+        }
+    }
+
+    // a replica changed on its own no longer holds the snapshot of the deltas
+    auto delta3 = index->SerializeDelta();
+    REQUIRE(delta3.has_value());
+    int64_t extra_id = -1;
+    auto extra = vsag::Dataset::Make();
+    extra->NumElements(1)->Dim(dim)->Ids(&extra_id)->Float32Vectors(vectors.data())->Owner(false);
+    REQUIRE(replica->Add(extra).has_value());
+    REQUIRE_FALSE(replica->DeserializeDelta(delta3.value()).has_value());
+}
+
+TEST_CASE("(PR) HGraph Operation Log Recovery", "[ft][serialize][hgraph][pr]") {
+    int64_t dim = 32;
+    int64_t base_count = 600;
+    std::mt19937 rng(47);
+    std::uniform_real_distribution<float> dist(-1.0, 1.0);
+    std::vector<float> vectors(base_count * dim);
+    std::vector<int64_t> ids(base_count);
+    for (int64_t i = 0; i < base_count; ++i) {
+        ids[i] = i * 3 + 1;
+        for (int64_t j = 0; j < dim; ++j) {
+            vectors[i * dim + j] = dist(rng);
+        }
+    }
+    auto make_base = [&](int64_t begin, int64_t end) {
+        auto base = vsag::Dataset::Make();
+        base->NumElements(end - begin)
+            ->Dim(dim)
+            ->Ids(ids.data() + begin)
+            ->Float32Vectors(vectors.data() + begin * dim)
+            ->Owner(false);
+        return base;
+    };
+
+    std::string hgraph_params = fmt::format(R"({{
+        "dtype": "float32",
+        "metric_type": "l2",
+        "dim": {},
+        "index_param": {{
+            "base_quantization_type": "sq8",
+            "use_reorder": true,
+            "precise_quantization_type": "fp32",
+            "max_degree": 16,
+            "ef_construction": 100
+        }}
+    }})",
+                                            dim);
+    fixtures::TempDir dir("hgraph_operation_log");
+    auto log_path = dir.GenerateRandomFile(false);
+    auto group_commit_delay_us = GENERATE(0, 100);
+
+    auto index = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+    REQUIRE(index->Build(make_base(0, 200)).has_value());
+    REQUIRE(index->AttachOperationLog(log_path, group_commit_delay_us).value() == 0);
+    REQUIRE_FALSE(index->AttachOperationLog(log_path).has_value());
+    auto snapshot1 = index->Serialize().value();
+
+    REQUIRE(index->Add(make_base(200, 400)).has_value());
+    REQUIRE(index->UpdateId(ids[5], -5).value());
+    auto updated = std::vector<float>(vectors.begin() + 500 * dim, vectors.begin() + 501 * dim);
+    auto new_vector = vsag::Dataset::Make();
+    new_vector->NumElements(1)->Dim(dim)->Float32Vectors(updated.data())->Owner(false);
+    REQUIRE(index->UpdateVector(ids[7], new_vector, true).value());
+    auto snapshot2 = index->Serialize().value();
+    REQUIRE(index->Add(make_base(400, 500)).has_value());
+    REQUIRE(index->Remove({ids[3]}).value() == 1);
+
+    auto check = [&](const vsag::IndexPtr& recovered, int64_t count, bool removed) {
+        REQUIRE(recovered->GetNumElements() == count - (removed ? 1 : 0));
+        REQUIRE(recovered->CheckIdExist(ids[3]) != removed);
+        REQUIRE_FALSE(recovered->CheckIdExist(ids[5]));
+        REQUIRE(recovered->CheckIdExist(-5));
+        for (int64_t i = 200; i < count; i += 11) {
+            REQUIRE(recovered->CheckIdExist(ids[i]));
+        }
+        auto distance = recovered->CalcDistanceById(new_vector, ids[7]);
+        REQUIRE(distance.has_value());
+        REQUIRE(distance.value() < 1e-5);
+    };
+
+    // a crash loses nothing acknowledged: recover from either snapshot and the log
+    auto recovered1 = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+    REQUIRE(recovered1->Deserialize(snapshot1).has_value());
+    REQUIRE(recovered1->AttachOperationLog(log_path).value() == 6);
+    check(recovered1, 500, true);
+
+    auto recovered2 = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+    REQUIRE(recovered2->Deserialize(snapshot2).has_value());
+    REQUIRE(recovered2->AttachOperationLog(log_path).value() == 2);
+    check(recovered2, 500, true);
+
+    // a checkpoint drops the records contained in the persisted snapshot
+    REQUIRE(recovered2->Add(make_base(500, 600)).has_value());
+    auto snapshot3 = recovered2->Serialize().value();
+    REQUIRE(recovered2->CheckpointOperationLog().has_value());
+    REQUIRE(std::filesystem::file_size(log_path) == vsag::OperationLog::HEADER_SIZE);
+    auto recovered3 = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+    REQUIRE(recovered3->Deserialize(snapshot3).has_value());
+    REQUIRE(recovered3->AttachOperationLog(log_path).value() == 0);
+    // the marks of Remove are not kept in a snapshot of HGraph
+    check(recovered3, 600, false);
+}
+
+TEST_CASE("(PR) HGraph Operation Log Concurrent Add", "[ft][serialize][hgraph][pr]") {
+    int64_t dim = 32;
+    int64_t thread_count = 4;
+    int64_t batch_count = 8;
+    int64_t batch_size = 16;
+    int64_t base_count = 2 * thread_count * batch_count * batch_size;
+    std::mt19937 rng(59);
+    std::uniform_real_distribution<float> dist(-1.0, 1.0);
+    std::vector<float> vectors(base_count * dim);
+    std::vector<int64_t> ids(base_count);
+    for (int64_t i = 0; i < base_count; ++i) {
+        ids[i] = i * 5 + 2;
+        for (int64_t j = 0; j < dim; ++j) {
+            vectors[i * dim + j] = dist(rng);
+        }
+    }
+    auto make_base = [&](int64_t begin, int64_t end) {
+        auto base = vsag::Dataset::Make();
+        base->NumElements(end - begin)
+            ->Dim(dim)
+            ->Ids(ids.data() + begin)
+            ->Float32Vectors(vectors.data() + begin * dim)
+            ->Owner(false);
+        return base;
+    };
+
+    std::string hgraph_params = fmt::format(R"({{
+        "dtype": "float32",
+        "metric_type": "l2",
+        "dim": {},
+        "index_param": {{
+            "base_quantization_type": "fp32",
+            "max_degree": 16,
+            "ef_construction": 100
+        }}
+    }})",
+                                            dim);
+    fixtures::TempDir dir("hgraph_operation_log_concurrent");
+    auto log_path = dir.GenerateRandomFile(false);
+    int64_t group_commit_delay_us = 2000;
+
+    auto index = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+    REQUIRE(index->Build(make_base(0, batch_size)).has_value());
+    auto snapshot = index->Serialize().value();
+    REQUIRE(index->AttachOperationLog(log_path, group_commit_delay_us).value() == 0);
+
+    // the same batches added one after another and from several threads at once
+    int64_t half = base_count / 2;
+    std::atomic<int64_t> failed_adds{0};
+    auto add_batches = [&](int64_t begin, int64_t first, int64_t step) {
+        for (int64_t b = first; b < thread_count * batch_count; b += step) {
+            auto start = begin + b * batch_size;
+            if (start == 0) {
+                continue;
+            }
+            if (not index->Add(make_base(start, start + batch_size)).has_value()) {
+                ++failed_adds;
+            }
+        }
+    };
+    auto sequential_begin = std::chrono::steady_clock::now();
+    add_batches(0, 0, 1);
+    auto sequential_time = std::chrono::steady_clock::now() - sequential_begin;
+
+    auto concurrent_begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int64_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&, t]() { add_batches(half, t, thread_count); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto concurrent_time = std::chrono::steady_clock::now() - concurrent_begin;
+    REQUIRE(failed_adds == 0);
+    REQUIRE(index->GetNumElements() == base_count);
+    // mutations of disjoint ids do not wait for each other, so they share the group commits
+    REQUIRE(concurrent_time < sequential_time);
+
+    auto recovered = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+    REQUIRE(recovered->Deserialize(snapshot).has_value());
+    auto record_count = 2 * thread_count * batch_count - 1;
+    REQUIRE(recovered->AttachOperationLog(log_path).value() == record_count);
+    REQUIRE(recovered->GetNumElements() == base_count);
+    auto search_param = R"({"hgraph": {"ef_search": 100}})";
+    for (int64_t i = 0; i < base_count; i += 7) {
+        REQUIRE(recovered->CheckIdExist(ids[i]));
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)->Dim(dim)->Float32Vectors(vectors.data() + i * dim)->Owner(false);
+        auto result = recovered->KnnSearch(query, 1, search_param);
+        REQUIRE(result.has_value());
+        REQUIRE(result.value()->GetIds()[0] == ids[i]);
+    }
+}
+
+TEST_CASE("(PR) HGraph Merge Units With More Route Levels", "[ft][merge][hgraph][pr]") {
+    int64_t dim = 32;
+    int64_t small_count = 2;
+    int64_t large_count = 3000;
+    int64_t base_count = 2 * small_count + large_count;
+    std::mt19937 rng(61);
+    std::uniform_real_distribution<float> dist(-1.0, 1.0);
+    std::vector<float> vectors(base_count * dim);
+    std::vector<int64_t> ids(base_count);
+    for (int64_t i = 0; i < base_count; ++i) {
+        ids[i] = i + 500;
+        for (int64_t j = 0; j < dim; ++j) {
+            vectors[i * dim + j] = dist(rng);
+        }
+    }
+    auto make_base = [&](int64_t begin, int64_t end) {
+        auto base = vsag::Dataset::Make();
+        base->NumElements(end - begin)
+            ->Dim(dim)
+            ->Ids(ids.data() + begin)
+            ->Float32Vectors(vectors.data() + begin * dim)
+            ->Owner(false);
+        return base;
+    };
+    std::string hgraph_params = fmt::format(R"({{
+        "dtype": "float32",
+        "metric_type": "l2",
+        "dim": {},
+        "index_param": {{
+            "base_quantization_type": "fp32",
+            "max_degree": 16,
+            "ef_construction": 100
+        }}
+    }})",
+                                            dim);
+    std::string search_params = R"({"hgraph": {"ef_search": 100}})";
+    vsag::IdMapFunction id_map = [](int64_t id) -> std::tuple<bool, int64_t> {
+        return std::make_tuple(true, id);
+    };
+
+    // the large unit has route levels the small target (or the small adopted unit) lacks, the
+    // merged index must enter its graph from the new top level
+    auto empty_target = GENERATE(true, false);
+    auto index = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+    std::vector<vsag::MergeUnit> merge_units;
+    if (empty_target) {
+        auto small = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+        REQUIRE(small->Build(make_base(0, small_count)).has_value());
+        merge_units.push_back({small, id_map});
+    } else {
+        REQUIRE(index->Build(make_base(0, small_count)).has_value());
+    }
+    auto large = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+    REQUIRE(large->Build(make_base(small_count, small_count + large_count)).has_value());
+    merge_units.push_back({large, id_map});
+    auto small2 = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+    REQUIRE(small2->Build(make_base(small_count + large_count, base_count)).has_value());
+    merge_units.push_back({small2, id_map});
+    REQUIRE(index->Merge(merge_units).has_value());
+    REQUIRE(index->GetNumElements() == base_count);
+
+    int64_t hit = 0;
+    for (int64_t i = 0; i < base_count; ++i) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)->Dim(dim)->Float32Vectors(vectors.data() + i * dim)->Owner(false);
+        auto result = index->KnnSearch(query, 1, search_params);
+        REQUIRE(result.has_value());
+        if (result.value()->GetIds()[0] == ids[i]) {
+            ++hit;
+        }
+    }
+    REQUIRE(static_cast<float>(hit) / static_cast<float>(base_count) > 0.95F);
+}
+
+TEST_CASE("(PR) HGraph Parallel Merge With Concurrent Search", "[ft][merge][hgraph][pr]") {
+    int64_t dim = 32;
+    int64_t shard_count = 8;
+    int64_t shard_size = 250;
+    int64_t base_count = 200 + shard_count * shard_size;
+    std::mt19937 rng(53);
+    std::uniform_real_distribution<float> dist(-1.0, 1.0);
+    std::vector<float> vectors(base_count * dim);
+    std::vector<int64_t> ids(base_count);
+    for (int64_t i = 0; i < base_count; ++i) {
+        ids[i] = i + 1000;
+        for (int64_t j = 0; j < dim; ++j) {
+            vectors[i * dim + j] = dist(rng);
+        }
+    }
+    auto make_base = [&](int64_t begin, int64_t end) {
+        auto base = vsag::Dataset::Make();
+        base->NumElements(end - begin)
+            ->Dim(dim)
+            ->Ids(ids.data() + begin)
+            ->Float32Vectors(vectors.data() + begin * dim)
+            ->Owner(false);
+        return base;
+    };
+
+    std::string hgraph_params = fmt::format(R"({{
+        "dtype": "float32",
+        "metric_type": "l2",
+        "dim": {},
+        "index_param": {{
+            "base_quantization_type": "sq8",
+            "use_reorder": true,
+            "precise_quantization_type": "fp32",
+            "max_degree": 16,
+            "ef_construction": 100,
+            "build_thread_count": 4
+        }}
+    }})",
+                                            dim);
+    std::string search_params = R"({"hgraph": {"ef_search": 100}})";
+
+    // the target already holds nodes, the shards are linked into its graph
+    auto index = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+    REQUIRE(index->Build(make_base(0, 200)).has_value());
+    std::vector<vsag::MergeUnit> merge_units;
+    for (int64_t i = 0; i < shard_count; ++i) {
+        auto shard = vsag::Factory::CreateIndex("hgraph", hgraph_params).value();
+        auto begin = 200 + i * shard_size;
+        REQUIRE(shard->Build(make_base(begin, begin + shard_size)).has_value());
+        vsag::IdMapFunction id_map = [](int64_t id) -> std::tuple<bool, int64_t> {
+            return std::make_tuple(true, id);
+        };
+        merge_units.push_back({shard, id_map});
+    }
+
+    // the target answers searches while the shards are merged into it
+    std::atomic<bool> merging{true};
+    std::atomic<int64_t> failed_searches{0};
+    std::thread searcher([&]() {
+        int64_t i = 0;
+        while (merging.load()) {
+            auto query = vsag::Dataset::Make();
+            query->NumElements(1)
+                ->Dim(dim)
+                ->Float32Vectors(vectors.data() + (i % 200) * dim)
+                ->Owner(false);
+            auto result = index->KnnSearch(query, 10, search_params);
+            if (not result.has_value() or result.value()->GetDim() == 0) {
+                ++failed_searches;
+            } else {
+                for (int64_t k = 0; k < result.value()->GetDim(); ++k) {
+                    auto id = result.value()->GetIds()[k];
+                    if (id < ids.front() or id > ids.back()) {
+                        ++failed_searches;
+                    }
+                }
+            }
+            ++i;
+        }
+    });
+    auto merge_result = index->Merge(merge_units);
+    merging.store(false);
+    searcher.join();
+    REQUIRE(merge_result.has_value());
+    REQUIRE(failed_searches.load() == 0);
+    REQUIRE(index->GetNumElements() == base_count);
+
+    int64_t hit = 0;
+    for (int64_t i = 0; i < base_count; ++i) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)->Dim(dim)->Float32Vectors(vectors.data() + i * dim)->Owner(false);
+        auto result = index->KnnSearch(query, 1, search_params);
+        REQUIRE(result.has_value());
+        if (result.value()->GetIds()[0] == ids[i]) {
+            ++hit;
+        }
+    }
+    REQUIRE(static_cast<float>(hit) / static_cast<float>(base_count) > 0.95F);
+}
@@ -1089,6 +1089,44 @@ TestIndex::TestSerializeReaderSet(const IndexPtr& index_from,
     }
 }
 
+void
+TestIndex::TestSerializeMMapReaderSet(const IndexPtr& index_from,
+                                      const IndexPtr& index_to,
+                                      const TestDatasetPtr& dataset,
+                                      const std::string& search_param,
+                                      const std::string& index_name) {
+    if (not index_from->CheckFeature(vsag::SUPPORT_SERIALIZE_FILE) or
+        not index_to->CheckFeature(vsag::SUPPORT_DESERIALIZE_READER_SET)) {
+        return;
+    }
+    auto dir = fixtures::TempDir("serialize_mmap");
+    auto path = dir.GenerateRandomFile();
+    std::ofstream outfile(path, std::ios::out | std::ios::binary);
+    REQUIRE(index_from->Serialize(outfile).has_value());
+    outfile.close();
+
+    vsag::ReaderSet rs;
+    rs.Set(index_name, vsag::Factory::CreateMMapFileReader(path, 0, 0));
+    REQUIRE(index_to->Deserialize(rs).has_value());
+    REQUIRE(index_to->GetNumElements() == index_from->GetNumElements());
+
+    const auto& queries = dataset->query_;
+    auto query_count = queries->GetNumElements();
+    auto topk = 10;
+    for (auto i = 0; i < query_count; ++i) {
+        auto query = get_one_query(queries, i);
+        auto res_from = index_from->KnnSearch(query, topk, search_param);
+        auto res_to = index_to->KnnSearch(query, topk, search_param);
+        REQUIRE(res_from.has_value());
+        REQUIRE(res_to.has_value());
+        REQUIRE(res_from.value()->GetDim() == res_to.value()->GetDim());
+        int64_t result_count = res_from.value()->GetDim();
+        for (int64_t j = 0; j < result_count; ++j) {
+            REQUIRE(res_to.value()->GetIds()[j] == res_from.value()->GetIds()[j]);
+        }
+    }
+}
+
 void
 TestIndex::TestSerializeWriteFunc(const IndexPtr& index_from,
                                   const IndexPtr& index_to,
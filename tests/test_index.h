@@ -217,6 +217,13 @@ public:
                            const std::string& index_name,
                            bool expected_success = true);
 
+    static void
+    TestSerializeMMapReaderSet(const IndexPtr& index_from,
+                               const IndexPtr& index_to,
+                               const TestDatasetPtr& dataset,
+                               const std::string& search_param,
+                               const std::string& index_name);
+
     static void
     TestConcurrentKnnSearch(const IndexPtr& index,
                             const TestDatasetPtr& dataset,
@@ -13,6 +13,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <numeric>
+#include <set>
+
 #include "functest.h"
 #include "storage/serialization_template_test.h"
 #include "test_index.h"
@@ -845,6 +848,338 @@ TEST_CASE("(Daily) IVF IVF Export Model", "[ft][export][ivf][daily]") {
     TestIVFExportModel(resource);
 }
 
+TEST_CASE("(PR) IVF Batch Search", "[ft][ivf][pr]") {
+    using namespace fixtures;
+    int64_t dim = 32;
+    std::string quantization_str = GENERATE("sq8", "fp32", "sq8_uniform,fp32");
+    auto param = IVFTestIndex::GenerateIVFBuildParametersString(
+        "l2", dim, quantization_str, 50, "kmeans", false, 1, false, 4);
+    auto index = TestIndex::TestFactory(IVFTestIndex::name, param, true);
+    auto dataset = IVFTestIndex::pool.GetDatasetAndCreate(dim, 1000, "l2");
+    TestIndex::TestBuildIndex(index, dataset, true);
+    REQUIRE(index->CheckFeature(vsag::SUPPORT_BATCH_SEARCH));
+
+    const auto& queries = dataset->query_;
+    auto query_count = queries->GetNumElements();
+    int64_t topk = 10;
+    auto parallelism = GENERATE(1, 4);
+    constexpr static const char* batch_param_tmp = R"(
+        {{
+            "ivf": {{
+                "scan_buckets_count": {},
+                "factor": 4.0,
+                "parallelism": {}
+            }}
+        }})";
+    auto search_param = fmt::format(batch_param_tmp, 10, parallelism);
+
+    vsag::SearchRequest req;
+    req.topk_ = topk;
+    req.params_str_ = search_param;
+    req.query_ = queries;
+    auto batch_result = index->SearchWithRequest(req);
+    REQUIRE(batch_result.has_value());
+    REQUIRE(batch_result.value()->GetNumElements() == query_count);
+    REQUIRE(batch_result.value()->GetDim() == topk);
+
+    // the fp32 batch kernel rounds differently, so only the sets of ids are compared
+    int64_t mismatch = 0;
+    for (int64_t i = 0; i < query_count; ++i) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)
+            ->Dim(queries->GetDim())
+            ->Float32Vectors(queries->GetFloat32Vectors() + i * queries->GetDim())
+            ->Owner(false);
+        auto single_result = index->KnnSearch(query, topk, fmt::format(batch_param_tmp, 10, 1));
+        REQUIRE(single_result.has_value());
+        std::set<int64_t> batch_ids(batch_result.value()->GetIds() + i * topk,
+                                    batch_result.value()->GetIds() + (i + 1) * topk);
+        for (int64_t j = 0; j < single_result.value()->GetDim(); ++j) {
+            mismatch += batch_ids.count(single_result.value()->GetIds()[j]) == 0 ? 1 : 0;
+        }
+    }
+    REQUIRE(mismatch <= query_count * topk / 100);
+}
+
+TEST_CASE("(PR) IVF Adaptive Probe", "[ft][ivf][pr]") {
+    using namespace fixtures;
+    int64_t dim = 32;
+    std::string metric_type = GENERATE("l2", "ip", "cosine");
+    std::string quantization_str = GENERATE("fp32", "sq8");
+    auto param = IVFTestIndex::GenerateIVFBuildParametersString(
+        metric_type, dim, quantization_str, 50, "kmeans", false, 1, false, 4);
+    auto index = TestIndex::TestFactory(IVFTestIndex::name, param, true);
+    auto dataset = IVFTestIndex::pool.GetDatasetAndCreate(dim, 1000, metric_type);
+    TestIndex::TestBuildIndex(index, dataset, true);
+
+    const auto& queries = dataset->query_;
+    auto query_count = queries->GetNumElements();
+    int64_t topk = 10;
+    constexpr static const char* adaptive_param_tmp = R"(
+        {{
+            "ivf": {{
+                "scan_buckets_count": 20,
+                "adaptive_probe": {}
+            }}
+        }})";
+
+    // the bounds only skip buckets that can't hold a result, so the results match a full probe
+    int64_t mismatch = 0;
+    for (int64_t i = 0; i < query_count; ++i) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)
+            ->Dim(queries->GetDim())
+            ->Float32Vectors(queries->GetFloat32Vectors() + i * queries->GetDim())
+            ->Owner(false);
+        auto full_result = index->KnnSearch(query, topk, fmt::format(adaptive_param_tmp, false));
+        auto adaptive_result =
+            index->KnnSearch(query, topk, fmt::format(adaptive_param_tmp, true));
+        REQUIRE(full_result.has_value());
+        REQUIRE(adaptive_result.has_value());
+        std::set<int64_t> adaptive_ids(
+            adaptive_result.value()->GetIds(),
+            adaptive_result.value()->GetIds() + adaptive_result.value()->GetDim());
+        for (int64_t j = 0; j < full_result.value()->GetDim(); ++j) {
+            mismatch += adaptive_ids.count(full_result.value()->GetIds()[j]) == 0 ? 1 : 0;
+        }
+    }
+    REQUIRE(mismatch <= query_count * topk / 100);
+}
+
+TEST_CASE("(PR) IVF Adaptive Probe From A Small First Add", "[ft][ivf][pr]") {
+    using namespace fixtures;
+    int64_t dim = 32;
+    std::string metric_type = GENERATE("l2", "ip", "cosine");
+    auto param = IVFTestIndex::GenerateIVFBuildParametersString(
+        metric_type, dim, "sq8", 50, "kmeans", false, 1, false, 4);
+    auto index = TestIndex::TestFactory(IVFTestIndex::name, param, true);
+    auto dataset = IVFTestIndex::pool.GetDatasetAndCreate(dim, 1000, metric_type);
+    const auto& base = dataset->base_;
+    REQUIRE(index->Train(base).has_value());
+
+    // a few vectors can't calibrate the error bound, the later batches keep sampling
+    auto add_part = [&](int64_t begin, int64_t end) {
+        auto part = vsag::Dataset::Make();
+        part->NumElements(end - begin)
+            ->Dim(dim)
+            ->Ids(base->GetIds() + begin)
+            ->Float32Vectors(base->GetFloat32Vectors() + begin * dim)
+            ->Owner(false);
+        REQUIRE(index->Add(part).has_value());
+    };
+    add_part(0, 4);
+    add_part(4, 100);
+    add_part(100, base->GetNumElements());
+
+    const auto& queries = dataset->query_;
+    auto query_count = queries->GetNumElements();
+    int64_t topk = 10;
+    constexpr static const char* adaptive_param_tmp = R"(
+        {{
+            "ivf": {{
+                "scan_buckets_count": 20,
+                "adaptive_probe": {}
+            }}
+        }})";
+    int64_t mismatch = 0;
+    for (int64_t i = 0; i < query_count; ++i) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)
+            ->Dim(dim)
+            ->Float32Vectors(queries->GetFloat32Vectors() + i * dim)
+            ->Owner(false);
+        auto full_result = index->KnnSearch(query, topk, fmt::format(adaptive_param_tmp, false));
+        auto adaptive_result =
+            index->KnnSearch(query, topk, fmt::format(adaptive_param_tmp, true));
+        REQUIRE(full_result.has_value());
+        REQUIRE(adaptive_result.has_value());
+        std::set<int64_t> adaptive_ids(
+            adaptive_result.value()->GetIds(),
+            adaptive_result.value()->GetIds() + adaptive_result.value()->GetDim());
+        for (int64_t j = 0; j < full_result.value()->GetDim(); ++j) {
+            mismatch += adaptive_ids.count(full_result.value()->GetIds()[j]) == 0 ? 1 : 0;
+        }
+    }
+    REQUIRE(mismatch <= query_count * topk / 100);
+}
+
+TEST_CASE("(PR) IVF Router EF", "[ft][ivf][pr]") {
+    using namespace fixtures;
+    int64_t dim = 32;
+    int64_t topk = 10;
+    constexpr static const char* build_param_tmp = R"(
+        {{
+            "dtype": "float32",
+            "metric_type": "l2",
+            "dim": {},
+            "index_param": {{
+                "buckets_count": 100,
+                "base_quantization_type": "fp32",
+                "router_max_degree": 16,
+                "router_ef_construction": 100,
+                "router_ef_search": 20
+            }}
+        }})";
+    auto index =
+        TestIndex::TestFactory(IVFTestIndex::name, fmt::format(build_param_tmp, dim), true);
+    auto dataset = IVFTestIndex::pool.GetDatasetAndCreate(dim, 1000, "l2");
+    TestIndex::TestBuildIndex(index, dataset, true);
+
+    // an ef covering every centroid makes the router exact, the recall doesn't drop with it
+    constexpr static const char* router_search_param_tmp = R"(
+        {{
+            "ivf": {{
+                "scan_buckets_count": 10,
+                "router_ef_search": {}
+            }}
+        }})";
+    const auto& queries = dataset->query_;
+    auto query_count = queries->GetNumElements();
+    auto recall = [&](int64_t router_ef) {
+        int64_t hits = 0;
+        for (int64_t i = 0; i < query_count; ++i) {
+            auto query = vsag::Dataset::Make();
+            query->NumElements(1)
+                ->Dim(dim)
+                ->Float32Vectors(queries->GetFloat32Vectors() + i * dim)
+                ->Owner(false);
+            auto result =
+                index->KnnSearch(query, topk, fmt::format(router_search_param_tmp, router_ef));
+            REQUIRE(result.has_value());
+            const auto* gt =
+                dataset->ground_truth_->GetIds() + i * dataset->ground_truth_->GetDim();
+            std::set<int64_t> gt_ids(gt, gt + topk);
+            for (int64_t j = 0; j < result.value()->GetDim(); ++j) {
+                hits += gt_ids.count(result.value()->GetIds()[j]);
+            }
+        }
+        return hits;
+    };
+    REQUIRE(recall(100) * 100 >= recall(0) * 99);
+
+    auto invalid_param = R"(
+        {
+            "dtype": "float32",
+            "metric_type": "l2",
+            "dim": 32,
+            "index_param": {
+                "buckets_count": 10,
+                "router_ef_search": -1
+            }
+        })";
+    REQUIRE_FALSE(vsag::Factory::CreateIndex(IVFTestIndex::name, invalid_param).has_value());
+}
+
+TEST_CASE("(PR) IVF Auto Rebalance", "[ft][ivf][pr]") {
+    int64_t dim = 32;
+    int64_t train_count = 500;
+    int64_t skewed_count = 2000;
+    // lossy base codes are re-encoded from the fp32 precise codes
+    std::string quantization_str = GENERATE("fp32", "sq8");
+    bool use_reorder = quantization_str != "fp32";
+    constexpr static const char* build_param_tmp = R"(
+        {{
+            "dtype": "float32",
+            "metric_type": "l2",
+            "dim": {},
+            "index_param": {{
+                "buckets_count": 16,
+                "base_quantization_type": "{}",
+                "use_reorder": {},
+                "precise_quantization_type": "fp32",
+                "auto_rebalance": {}
+            }}
+        }})";
+
+    // the added vectors crowd around a single point, so almost all of them land in one bucket
+    auto train_vectors = fixtures::generate_vectors(train_count, dim);
+    auto skewed_vectors = fixtures::generate_vectors(skewed_count, dim, false, 71);
+    for (int64_t i = 0; i < skewed_count; ++i) {
+        for (int64_t d = 0; d < dim; ++d) {
+            skewed_vectors[i * dim + d] = train_vectors[d] + skewed_vectors[i * dim + d] * 0.05F;
+        }
+    }
+    std::vector<int64_t> train_ids(train_count);
+    std::iota(train_ids.begin(), train_ids.end(), 0);
+    std::vector<int64_t> skewed_ids(skewed_count);
+    std::iota(skewed_ids.begin(), skewed_ids.end(), train_count);
+
+    auto build_and_add = [&](bool auto_rebalance) {
+        auto index =
+            vsag::Factory::CreateIndex(
+                "ivf",
+                fmt::format(build_param_tmp, dim, quantization_str, use_reorder, auto_rebalance))
+                .value();
+        auto train = vsag::Dataset::Make();
+        train->NumElements(train_count)
+            ->Dim(dim)
+            ->Ids(train_ids.data())
+            ->Float32Vectors(train_vectors.data())
+            ->Owner(false);
+        REQUIRE(index->Build(train).has_value());
+        for (int64_t i = 0; i < skewed_count; i += skewed_count / 4) {
+            auto batch = vsag::Dataset::Make();
+            batch->NumElements(skewed_count / 4)
+                ->Dim(dim)
+                ->Ids(skewed_ids.data() + i)
+                ->Float32Vectors(skewed_vectors.data() + i * dim)
+                ->Owner(false);
+            REQUIRE(index->Add(batch).has_value());
+        }
+        return index;
+    };
+    auto max_bucket_size = [](const vsag::IndexPtr& index) {
+        auto stats = vsag::JsonType::Parse(index->GetStats());
+        return stats["bucket_num"]["max"].GetFloat();
+    };
+
+    auto plain_index = build_and_add(false);
+    auto rebalanced_index = build_and_add(true);
+    REQUIRE(rebalanced_index->GetNumElements() == train_count + skewed_count);
+    REQUIRE(max_bucket_size(rebalanced_index) < max_bucket_size(plain_index) / 2);
+
+    // the moved vectors are found through their new buckets while only a few are probed
+    auto search_param = R"({"ivf": {"scan_buckets_count": 4}})";
+    int64_t query_count = 0;
+    int64_t hit_count = 0;
+    for (int64_t i = 0; i < skewed_count; i += 50) {
+        auto query = vsag::Dataset::Make();
+        query->NumElements(1)
+            ->Dim(dim)
+            ->Float32Vectors(skewed_vectors.data() + i * dim)
+            ->Owner(false);
+        auto result = rebalanced_index->KnnSearch(query, 10, search_param);
+        REQUIRE(result.has_value());
+        const auto* ids = result.value()->GetIds();
+        const auto* ids_end = ids + result.value()->GetDim();
+        ++query_count;
+        hit_count += static_cast<int64_t>(std::find(ids, ids_end, skewed_ids[i]) != ids_end);
+    }
+    REQUIRE(static_cast<float>(hit_count) >= 0.9F * static_cast<float>(query_count));
+}
+
+TEST_CASE("IVF Auto Rebalance Needs Lossless Codes", "[ft][ivf]") {
+    constexpr static const char* build_param_tmp = R"(
+        {{
+            "dtype": "float32",
+            "metric_type": "l2",
+            "dim": 32,
+            "index_param": {{
+                "buckets_count": 16,
+                "base_quantization_type": "sq8",
+                "use_reorder": {},
+                "precise_quantization_type": "{}",
+                "auto_rebalance": true
+            }}
+        }})";
+    REQUIRE_FALSE(
+        vsag::Factory::CreateIndex("ivf", fmt::format(build_param_tmp, false, "fp32")).has_value());
+    REQUIRE_FALSE(
+        vsag::Factory::CreateIndex("ivf", fmt::format(build_param_tmp, true, "sq8")).has_value());
+    REQUIRE(
+        vsag::Factory::CreateIndex("ivf", fmt::format(build_param_tmp, true, "fp32")).has_value());
+}
+
 static void
 TestIVFAdd(const fixtures::IVFResourcePtr& resource) {
     using namespace fixtures;
@@ -987,6 +1322,15 @@ TestIVFSerialize(const fixtures::IVFResourcePtr& resource) {
                         auto index2 = IVFTestIndex::TestFactory(IVFTestIndex::name, param, true);
                         IVFTestIndex::TestSerializeReaderSet(
                             index, index2, dataset, search_param, IVFTestIndex::name, true);
+                        // buckets served from a mapping of the serialized file
+                        auto mmap_param = param;
+                        const std::string index_param_key = R"("index_param": {)";
+                        mmap_param.insert(mmap_param.find(index_param_key) + index_param_key.size(),
+                                          R"("base_io_type": "reader_io",)");
+                        auto index3 =
+                            IVFTestIndex::TestFactory(IVFTestIndex::name, mmap_param, true);
+                        IVFTestIndex::TestSerializeMMapReaderSet(
+                            index, index3, dataset, search_param, IVFTestIndex::name);
                     }
                     if (index->CheckFeature(vsag::SUPPORT_SERIALIZE_WRITE_FUNC)) {
                         auto index2 = IVFTestIndex::TestFactory(IVFTestIndex::name, param, true);
@@ -29,9 +29,11 @@ struct PyramidParam {
     std::vector<int> no_build_levels = std::vector<int>{0, 1, 2};
     std::string base_quantization_type = "fp32";
     std::string precise_quantization_type = "fp32";
+    std::string base_io_type = "block_memory_io";
     std::string graph_type = "nsw";
     bool use_reorder = false;
     bool support_duplicate = false;
+    bool async_build = false;
 };
 
 namespace fixtures {
@@ -84,10 +86,13 @@ PyramidTestIndex::GeneratePyramidBuildParametersString(const std::string& metric
             "no_build_levels": [{}],
             "graph_type": "{}",
             "base_quantization_type": "{}",
+            "base_io_type": "{}",
             "precise_quantization_type": "{}",
             "use_reorder": {},
             "index_min_size": 28,
-            "support_duplicate": {}
+            "support_duplicate": {},
+            "async_build": {},
+            "max_background_builds": 2
         }}
     }}
     )";
@@ -97,9 +102,11 @@ PyramidTestIndex::GeneratePyramidBuildParametersString(const std::string& metric
                                             fmt::join(param.no_build_levels, ","),
                                             param.graph_type,
                                             param.base_quantization_type,
+                                            param.base_io_type,
                                             param.precise_quantization_type,
                                             param.use_reorder,
-                                            param.support_duplicate);
+                                            param.support_duplicate,
+                                            param.async_build);
     return build_parameters_str;
 }
 
@@ -351,6 +358,54 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::PyramidTestIndex,
     REQUIRE(ids_a.count(402) == 0);
 }
 
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::PyramidTestIndex,
+                             "Pyramid Multi Path Parallel Search",
+                             "[ft][build][pyramid]") {
+    PyramidParam pyramid_param;
+    pyramid_param.no_build_levels = {0, 1};
+
+    const auto param = GeneratePyramidBuildParametersString("l2", 4, pyramid_param);
+    auto index = TestFactory("pyramid", param, true);
+
+    std::vector<std::array<float, 4>> vectors;
+    std::vector<int64_t> ids;
+    std::vector<std::string> paths;
+    const std::vector<std::string> leaves = {"a/d/f", "a/d/g", "a/e/h", "b/e/g", "c/f/i"};
+    for (int64_t i = 0; i < 100; ++i) {
+        auto value = static_cast<float>(i);
+        vectors.push_back({value, value * 0.5F, 1.0F, -value});
+        ids.push_back(i);
+        paths.push_back(leaves[i % leaves.size()]);
+    }
+    auto build_result = index->Build(MakeDenseDataset(vectors, ids, paths));
+    REQUIRE(build_result.has_value());
+
+    // `a/d/f` and `a/d` lie under `a`, `b/e/g` is named twice: every point is returned once
+    auto query = MakeSingleQuery({0.0F, 0.0F, 1.0F, 0.0F}, "a/d/f|a|b/e/g|a/d|b/e/g");
+    constexpr auto search_param_tmp = R"({{"pyramid": {{"ef_search": 100, "parallelism": {}}}}})";
+    std::vector<int64_t> expected;
+    for (int64_t i = 0; i < 100; ++i) {
+        if (i % leaves.size() < 4) {
+            expected.push_back(i);
+        }
+    }
+    for (auto parallelism : {1, 4}) {
+        INFO(fmt::format("parallelism={}", parallelism));
+        auto search_param = fmt::format(search_param_tmp, parallelism);
+        auto search_result = index->KnnSearch(query, 100, search_param);
+        REQUIRE(search_result.has_value());
+        auto result = search_result.value();
+        REQUIRE(result->GetDim() == static_cast<int64_t>(expected.size()));
+        REQUIRE(CollectIds(result) == std::set<int64_t>(expected.begin(), expected.end()));
+
+        auto top_result = index->KnnSearch(query, 5, search_param);
+        REQUIRE(top_result.has_value());
+        std::vector<int64_t> top_ids(top_result.value()->GetIds(),
+                                     top_result.value()->GetIds() + top_result.value()->GetDim());
+        REQUIRE(top_ids == std::vector<int64_t>(expected.begin(), expected.begin() + 5));
+    }
+}
+
 TEST_CASE_PERSISTENT_FIXTURE(fixtures::PyramidTestIndex,
                              "Pyramid Add Test",
                              "[ft][build][pyramid]") {
@@ -547,6 +602,41 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::PyramidTestIndex,
     }
 }
 
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::PyramidTestIndex,
+                             "Pyramid Async Subindex Build Test",
+                             "[ft][concurrent][pyramid][build]") {
+    auto metric_type = GENERATE("l2", "cosine");
+    PyramidParam pyramid_param;
+    pyramid_param.graph_type = GENERATE("nsw", "odescent");
+    // memory_io moves its codes on a resize, so odescent builds from a copy of them
+    pyramid_param.base_io_type = GENERATE("block_memory_io", "memory_io");
+    pyramid_param.no_build_levels = {0, 1};
+    pyramid_param.async_build = true;
+    const std::string name = "pyramid";
+    auto search_param = GeneratePyramidSearchParametersString(100);
+    for (auto& dim : dims) {
+        INFO(fmt::format("metric_type={}, dim={}, graph_type={}, base_io_type={}",
+                         metric_type,
+                         dim,
+                         pyramid_param.graph_type,
+                         pyramid_param.base_io_type));
+        auto param = GeneratePyramidBuildParametersString(metric_type, dim, pyramid_param);
+        auto dataset = pool.GetDatasetAndCreate(dim, base_count, metric_type, /*with_path=*/true);
+
+        // nodes are searched by flat scans until their graphs are swapped in
+        auto index = TestFactory(name, param, true);
+        TestBuildIndex(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.94, true);
+        TestFilterSearch(index, dataset, search_param, 0.94, true);
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeFile(index, index2, dataset, search_param, true);
+
+        auto add_index = TestFactory(name, param, true);
+        TestConcurrentAddSearch(add_index, dataset, search_param, 0.94, true);
+        TestRangeSearch(add_index, dataset, search_param, 0.94, 10, true);
+    }
+}
+
 TEST_CASE_PERSISTENT_FIXTURE(fixtures::PyramidTestIndex,
                              "Pyramid OverTime Test",
                              "[ft][search][pyramid]") {
@@ -42,6 +42,8 @@ using namespace vsag;
 struct WarpParam {
     std::string base_quantization_type = "fp32";
     std::string base_io_type = "memory_io";
+    uint32_t centroid_count = 0;
+    bool use_residual = false;
 };
 
 namespace fixtures {
@@ -82,12 +84,19 @@ WarpTestIndex::GenerateWarpBuildParametersString(const std::string& metric_type,
         "dim": {},
         "index_param": {{
             "base_quantization_type": "{}",
-            "base_io_type": "{}"
+            "base_io_type": "{}",
+            "centroid_count": {},
+            "use_residual": {}
         }}
     }}
     )";
-    auto build_parameters_str = fmt::format(
-        parameter_temp, metric_type, dim, param.base_quantization_type, param.base_io_type);
+    auto build_parameters_str = fmt::format(parameter_temp,
+                                            metric_type,
+                                            dim,
+                                            param.base_quantization_type,
+                                            param.base_io_type,
+                                            param.centroid_count,
+                                            param.use_residual);
     return build_parameters_str;
 }
 
@@ -159,3 +168,113 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::WarpTestIndex,
     }
     vsag::Options::Instance().set_block_size_limit(origin_size);
 }
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::WarpTestIndex,
+                             "Warp Centroid Pruning Test",
+                             "[ft][warp]") {
+    auto metric_type = GENERATE("ip", "l2");
+    WarpParam warp_param;
+    warp_param.centroid_count = 64;
+    const std::string name = "warp";
+    auto search_param = R"({"warp": {"scan_centroids_count": 16}})";
+    auto exhaustive_param = R"({"warp": {"scan_centroids_count": 0}})";
+    for (auto& dim : dims) {
+        INFO(fmt::format("metric_type={}, dim={}", metric_type, dim));
+        auto param = GenerateWarpBuildParametersString(metric_type, dim, warp_param);
+        auto index = TestFactory(name, param, true);
+        auto dataset =
+            pool.GetDatasetAndCreate(dim, base_count, metric_type, false, 0.8, 0, 16, "multi");
+        TestBuildIndex(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.9, true);
+        TestKnnSearch(index, dataset, exhaustive_param, 0.99, true);
+
+        // the centroid lists are rebuilt from the token assignments on deserialize
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeBinarySet(index, index2, dataset, search_param, true);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::WarpTestIndex,
+                             "Warp Centroids From A Small First Add",
+                             "[ft][warp]") {
+    auto metric_type = GENERATE("ip", "l2");
+    WarpParam warp_param;
+    warp_param.centroid_count = 64;
+    const std::string name = "warp";
+    auto exhaustive_param = R"({"warp": {"scan_centroids_count": 0}})";
+    auto search_param = R"({"warp": {"scan_centroids_count": 16}})";
+    for (auto& dim : dims) {
+        INFO(fmt::format("metric_type={}, dim={}", metric_type, dim));
+        auto param = GenerateWarpBuildParametersString(metric_type, dim, warp_param);
+        auto index = TestFactory(name, param, true);
+        auto dataset =
+            pool.GetDatasetAndCreate(dim, base_count, metric_type, false, 0.8, 0, 16, "multi");
+        const auto& base = dataset->base_;
+
+        // the first document has too few tokens to train the centroids, they wait for more
+        auto make_part = [&](int64_t begin, int64_t end) {
+            auto part = vsag::Dataset::Make();
+            part->NumElements(end - begin)
+                ->MultiVectorDim(dim)
+                ->Ids(base->GetIds() + begin)
+                ->MultiVectors(base->GetMultiVectors() + begin)
+                ->Owner(false);
+            return part;
+        };
+        auto add_docs = [&](int64_t begin, int64_t end) {
+            auto result = index->Add(make_part(begin, end));
+            REQUIRE(result.has_value());
+            REQUIRE(result.value().empty());
+        };
+        REQUIRE(base->GetMultiVectors()[0].len_ < warp_param.centroid_count);
+        add_docs(0, 1);
+        // meanwhile knn search scans every document
+        auto first = index->KnnSearch(make_part(0, 1), 1, search_param);
+        REQUIRE(first.has_value());
+        REQUIRE(first.value()->GetDim() == 1);
+        REQUIRE(first.value()->GetIds()[0] == base->GetIds()[0]);
+        add_docs(1, base->GetNumElements() / 2);
+        add_docs(base->GetNumElements() / 2, base->GetNumElements());
+        REQUIRE(index->GetNumElements() == base->GetNumElements());
+        TestKnnSearch(index, dataset, search_param, 0.9, true);
+        TestKnnSearch(index, dataset, exhaustive_param, 0.99, true);
+
+        // residual codes need the centroids at once
+        WarpParam residual_param = warp_param;
+        residual_param.use_residual = true;
+        auto residual_index = TestFactory(
+            name, GenerateWarpBuildParametersString(metric_type, dim, residual_param), true);
+        REQUIRE_FALSE(residual_index->Add(make_part(0, 1)).has_value());
+        REQUIRE(residual_index->GetNumElements() == 0);
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::WarpTestIndex,
+                             "Warp Residual Codes Test",
+                             "[ft][warp]") {
+    auto metric_type = GENERATE("ip", "l2", "cosine");
+    std::string base_quantization_str = GENERATE("sq4_uniform", "rabitq");
+    WarpParam warp_param;
+    warp_param.base_quantization_type = base_quantization_str;
+    warp_param.centroid_count = 64;
+    warp_param.use_residual = true;
+    const std::string name = "warp";
+    auto search_param = R"({"warp": {"scan_centroids_count": 16}})";
+    auto exhaustive_param = R"({"warp": {"scan_centroids_count": 0}})";
+    for (auto& dim : dims) {
+        INFO(fmt::format("metric_type={}, dim={}, base_quantization_type={}",
+                         metric_type,
+                         dim,
+                         base_quantization_str));
+        auto param = GenerateWarpBuildParametersString(metric_type, dim, warp_param);
+        auto index = TestFactory(name, param, true);
+        auto dataset =
+            pool.GetDatasetAndCreate(dim, base_count, metric_type, false, 0.8, 0, 16, "multi");
+        TestBuildIndex(index, dataset, true);
+        TestKnnSearch(index, dataset, search_param, 0.8, true);
+        TestKnnSearch(index, dataset, exhaustive_param, 0.8, true);
+
+        auto index2 = TestFactory(name, param, true);
+        TestSerializeBinarySet(index, index2, dataset, search_param, true);
+    }
+}